@@ -0,0 +1,213 @@
+/** @file
+ * Minimal host (native) implementation of the Arduino core API.
+ *
+ * Only the subset of the API that the firmware actually uses is provided. Time, pins and interrupts
+ * are not implemented here: the declarations below are satisfied by the native board
+ * (boards/board_native.cpp), which drives them from a virtual clock so that the firmware can be run,
+ * profiled and tested on the development machine.
+ */
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT         0x0
+#define OUTPUT        0x1
+#define INPUT_PULLUP  0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+#define NOT_AN_INTERRUPT -1
+
+#define NUM_DIGITAL_PINS  70
+#define NUM_ANALOG_INPUTS 16
+#define LED_BUILTIN 13
+
+#define A0  54
+#define A1  55
+#define A2  56
+#define A3  57
+#define A4  58
+#define A5  59
+#define A6  60
+#define A7  61
+#define A8  62
+#define A9  63
+#define A10 64
+#define A11 65
+#define A12 66
+#define A13 67
+#define A14 68
+#define A15 69
+
+//Program memory is ordinary memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+#define memcpy_P  memcpy
+#define strcpy_P  strcpy
+#define strlen_P  strlen
+
+#define lowByte(w)  ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitToggle(value, bit) ((value) ^= (1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+//Arduino min()/max() are type agnostic macros. Templates are used here so that the C++ standard headers can still be included afterwards.
+//The conditional on two lvalues is itself an lvalue, so the return type must be decayed or a reference to a parameter would be returned
+template <typename T, typename U> static inline auto min(T a, U b) -> typename std::decay<decltype(a < b ? a : b)>::type { return (a < b) ? a : b; }
+template <typename T, typename U> static inline auto max(T a, U b) -> typename std::decay<decltype(a > b ? a : b)>::type { return (a > b) ? a : b; }
+
+static inline uint16_t makeWord(uint16_t w) { return w; }
+static inline uint16_t makeWord(uint8_t h, uint8_t l) { return (uint16_t)((h << 8) | l); }
+#define word(...) makeWord(__VA_ARGS__)
+
+//The Cortex-M targets return 0 from an integer division by zero rather than trapping like the host does. A blank tune has equal min/max calibrations
+static inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  if(in_max == in_min) { return out_min; }
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+//Sketch entry points
+void setup(void);
+void loop(void);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+/*
+***********************************************************************************************************
+* Provided by the native board (boards/board_native.cpp)
+*/
+uint32_t micros(void);
+uint32_t millis(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void noInterrupts(void);
+void interrupts(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+#define digitalPinToInterrupt(p) ( ((p) < NUM_DIGITAL_PINS) ? (p) : NOT_AN_INTERRUPT )
+//Each emulated port holds 8 pins, the same as the AVR GPIO ports
+#define digitalPinToPort(p)      ( (uint8_t)((p) >> 3) )
+#define digitalPinToBitMask(p)   ( (uint8_t)(1U << ((p) & 0x07U)) )
+extern volatile uint8_t nativePortOutput[];
+extern volatile uint8_t nativePortInput[];
+#define portOutputRegister(P)    ( &nativePortOutput[(P)] )
+#define portInputRegister(P)     ( &nativePortInput[(P)] )
+
+/*
+***********************************************************************************************************
+* Serial
+*/
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return (str == NULL) ? 0 : write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+  virtual int availableForWrite(void) { return 0; }
+  virtual void flush(void) { }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long n, int base = 10);
+  size_t print(unsigned char n, int base = 10) { return print((long)n, base); }
+  size_t print(int n, int base = 10) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = 10) { return print((long)n, base); }
+  size_t print(unsigned long n, int base = 10) { return print((long)n, base); }
+  size_t println(void) { return write("\r\n"); }
+  size_t println(const char *str) { return print(str) + println(); }
+  template <typename T> size_t println(T n, int base = 10) { return print(n, base) + println(); }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available(void) = 0;
+  virtual int read(void) = 0;
+  virtual int peek(void) = 0;
+  using Print::write;
+};
+
+/**
+ * Host serial port. Bytes written by the firmware are captured into a transmit buffer and bytes to be
+ * received by the firmware are injected into the receive buffer, so a test or a host side tool can
+ * act as the tuning software.
+ */
+class HardwareSerial : public Stream
+{
+public:
+  static const uint16_t BUFFER_SIZE = 1024U;
+
+  void begin(unsigned long baud) { (void)baud; }
+  void end(void) { }
+  operator bool() const { return true; }
+
+  int available(void) override;
+  int read(void) override;
+  int peek(void) override;
+  size_t write(uint8_t value) override;
+  using Print::write;
+  int availableForWrite(void) override;
+
+  //Host side interface
+  size_t inject(const uint8_t *buffer, size_t size); ///< Queue bytes to be received by the firmware
+  size_t drain(uint8_t *buffer, size_t size);        ///< Remove bytes that were transmitted by the firmware
+  void clear(void);
+
+private:
+  uint8_t rxBuffer[BUFFER_SIZE];
+  uint8_t txBuffer[BUFFER_SIZE];
+  uint16_t rxHead = 0, rxTail = 0;
+  uint16_t txHead = 0, txTail = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,29 @@
+/** @file
+ * Host replacement for the Arduino EEPROM library, backed by a RAM array.
+ */
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+
+#define NATIVE_EEPROM_SIZE 4096U
+
+class EEPROMClass
+{
+public:
+  uint8_t read(int address) const { return storage[(unsigned)address % NATIVE_EEPROM_SIZE]; }
+  void write(int address, uint8_t value) { storage[(unsigned)address % NATIVE_EEPROM_SIZE] = value; }
+  void update(int address, uint8_t value) { if (read(address) != value) { write(address, value); } }
+  uint16_t length(void) const { return NATIVE_EEPROM_SIZE; }
+  void clear(uint8_t value = 0xFF) { memset(storage, value, sizeof(storage)); }
+
+  template <typename T> T &get(int address, T &t) const { memcpy(&t, &storage[address], sizeof(T)); return t; }
+  template <typename T> const T &put(int address, const T &t) { memcpy(&storage[address], &t, sizeof(T)); return t; }
+
+private:
+  uint8_t storage[NATIVE_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_EEPROM_H
@@ -0,0 +1,102 @@
+/** @file
+ * Host implementation of the board independent parts of the Arduino API.
+ */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SPI.h>
+#include <stdio.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+SPIClass SPI;
+
+long random(long howbig)
+{
+  return (howbig == 0) ? 0 : (rand() % howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+  return (howsmall >= howbig) ? howsmall : (random(howbig - howsmall) + howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0U) { srand((unsigned)seed); }
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0;
+  while ( (size-- > 0U) && (write(*buffer++) == 1U) ) { ++written; }
+  return written;
+}
+
+size_t Print::print(long n, int base)
+{
+  char buffer[34];
+  if (base == 16) { snprintf(buffer, sizeof(buffer), "%lX", n); }
+  else { snprintf(buffer, sizeof(buffer), "%ld", n); }
+  return write(buffer);
+}
+
+int HardwareSerial::available(void)
+{
+  return (int)((BUFFER_SIZE + rxHead - rxTail) % BUFFER_SIZE);
+}
+
+int HardwareSerial::read(void)
+{
+  if (rxHead == rxTail) { return -1; }
+  uint8_t value = rxBuffer[rxTail];
+  rxTail = (rxTail + 1U) % BUFFER_SIZE;
+  return value;
+}
+
+int HardwareSerial::peek(void)
+{
+  return (rxHead == rxTail) ? -1 : rxBuffer[rxTail];
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+  uint16_t next = (txHead + 1U) % BUFFER_SIZE;
+  if (next == txTail) { return 0; } //Buffer full, the host side has not drained it
+  txBuffer[txHead] = value;
+  txHead = next;
+  return 1;
+}
+
+int HardwareSerial::availableForWrite(void)
+{
+  return (int)(BUFFER_SIZE - 1U - ((BUFFER_SIZE + txHead - txTail) % BUFFER_SIZE));
+}
+
+size_t HardwareSerial::inject(const uint8_t *buffer, size_t size)
+{
+  size_t count = 0;
+  while (count < size)
+  {
+    uint16_t next = (rxHead + 1U) % BUFFER_SIZE;
+    if (next == rxTail) { break; }
+    rxBuffer[rxHead] = buffer[count++];
+    rxHead = next;
+  }
+  return count;
+}
+
+size_t HardwareSerial::drain(uint8_t *buffer, size_t size)
+{
+  size_t count = 0;
+  while ( (count < size) && (txTail != txHead) )
+  {
+    buffer[count++] = txBuffer[txTail];
+    txTail = (txTail + 1U) % BUFFER_SIZE;
+  }
+  return count;
+}
+
+void HardwareSerial::clear(void)
+{
+  rxHead = rxTail = txHead = txTail = 0;
+}
@@ -0,0 +1,71 @@
+/** @file
+ * Host replacement for the SPI library.
+ *
+ * Transfers are forwarded one byte at a time to an optional device model attached with
+ * SPIClass::attachDevice(), which allows peripherals such as the FRAM used for configuration
+ * storage to be emulated. Both the standard Arduino API and the buffer/transfer-mode overloads of
+ * the M451 core are provided.
+ */
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_HAS_TRANSACTION 1
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x02
+#define SPI_MODE3 0x03
+
+enum SPITransferMode {
+  SPI_CONTINUE,
+  SPI_LAST
+};
+
+class SPISettings
+{
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) { (void)clock; (void)bitOrder; (void)dataMode; }
+};
+
+class SPIClass
+{
+public:
+  typedef uint8_t (*device_t)(uint8_t data);
+
+  void begin(void) { }
+  void end(void) { }
+  void beginTransaction(SPISettings settings) { (void)settings; }
+  void endTransaction(void) { }
+
+  void attachDevice(device_t device) { pDevice = device; }
+
+  uint8_t transfer(uint8_t data, SPITransferMode mode = SPI_LAST) { (void)mode; return (pDevice == NULL) ? 0xFFU : pDevice(data); }
+  uint16_t transfer16(uint16_t data)
+  {
+    uint16_t result = (uint16_t)transfer(highByte(data)) << 8;
+    return result | transfer(lowByte(data));
+  }
+  /** Transmit a buffer. Received bytes are discarded */
+  void transfer(const void *txBuffer, size_t count, SPITransferMode mode = SPI_LAST)
+  {
+    const uint8_t *pTx = (const uint8_t *)txBuffer;
+    while (count-- > 0U) { (void)transfer(*pTx++, mode); }
+  }
+  /** Transmit a buffer and then receive into a second buffer */
+  void transfer(const void *txBuffer, size_t txCount, void *rxBuffer, size_t rxCount, SPITransferMode mode = SPI_LAST)
+  {
+    transfer(txBuffer, txCount, mode);
+    uint8_t *pRx = (uint8_t *)rxBuffer;
+    while (rxCount-- > 0U) { *pRx++ = transfer((uint8_t)0x00U, mode); }
+  }
+
+private:
+  device_t pDevice = NULL;
+};
+
+extern SPIClass SPI;
+
+#endif // NATIVE_SPI_H
@@ -0,0 +1,19 @@
+/** @file
+ * Host replacement for the SimplyAtomic library.
+ *
+ * ATOMIC() runs the following block with interrupts disabled and re-enables them on exit, the same
+ * as the target implementation. On the native board interrupts are only ever raised from the
+ * virtual clock, so this is used to detect re-entrancy rather than to prevent it.
+ * As on the target, a cleanup handler restores the interrupts so that the block may be left with return.
+ */
+#ifndef NATIVE_SIMPLY_ATOMIC_H
+#define NATIVE_SIMPLY_ATOMIC_H
+
+#include <Arduino.h>
+
+static inline uint8_t __native_atomic_enter(void) { noInterrupts(); return 1U; }
+static inline void __native_atomic_restore(const uint8_t *active) { if(*active != 0U) { interrupts(); } }
+
+#define ATOMIC() for (uint8_t __atomic_loop __attribute__((__cleanup__(__native_atomic_restore))) = __native_atomic_enter(); __atomic_loop != 0U; interrupts(), __atomic_loop = 0U)
+
+#endif // NATIVE_SIMPLY_ATOMIC_H
@@ -0,0 +1,9 @@
+/** @file
+ * Host replacement for avr/pgmspace.h. Program memory is ordinary memory on the host, the accessors are in Arduino.h
+ */
+#ifndef NATIVE_AVR_PGMSPACE_H
+#define NATIVE_AVR_PGMSPACE_H
+
+#include <Arduino.h>
+
+#endif // NATIVE_AVR_PGMSPACE_H
@@ -0,0 +1,9 @@
+/** @file
+ * Host replacement for pgmspace.h (Non AVR cores). See avr/pgmspace.h
+ */
+#ifndef NATIVE_PGMSPACE_H
+#define NATIVE_PGMSPACE_H
+
+#include "avr/pgmspace.h"
+
+#endif // NATIVE_PGMSPACE_H
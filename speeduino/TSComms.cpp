@@ -29,10 +29,12 @@ A full copy of the license may be found in the projects root directory
 
 #include "TS_CommandButtonHandler.h"
 
-#include "errors.h"
 #include "pages.h"
 #include "page_crc.h"
 #include "logger.h"
+#include "toothLogRing.h"
+#include "loopProfiler.h"
+#include "isrProfiler.h"
 #include "src/FastCRC/FastCRC.h"
 
 #include "TSComms.h"
@@ -825,7 +827,7 @@ void TSCommClass::cmdHandler_d (void){
 //		    case 'd': // Send a CRC32 hash of a given page
 	byte pageNum = serialPayloadRx[2];
 
-	uint32_t CRC32_val = calculatePageCRC32(pageNum);
+	uint32_t CRC32_val = getPageCRC32(pageNum);
 
 	sendReturnCRCMsg((byte *) &CRC32_val);
 }
@@ -882,7 +884,32 @@ void TSCommClass::cmdHandler_k (void){
 }
 
 void TSCommClass::cmdHandler_l (void){
-	sendReturnCodeMsg(SERIAL_RC_UKWN_ERR);
+//    case 'l': //Send the loop profiler results
+// Reply is the task count followed by min, avg, max and overruns for each task (LOOP_TASK_* order), all 16 bit big endian.
+// If the request carries a non-zero byte after the command, the results are cleared once they have been sent
+	uint16_t payLen = 2 + (LOOP_TASK_COUNT * 8);
+
+	serialPayloadTx[0] = payLen >> 8;
+	serialPayloadTx[1] = payLen;
+	serialPayloadTx[2] = SERIAL_RC_OK;
+	serialPayloadTx[3] = LOOP_TASK_COUNT;
+
+	uint8_t *p_data = &serialPayloadTx[4];
+	for(uint8_t task = 0; task < LOOP_TASK_COUNT; task++)
+	{
+		*p_data++ = highByte(loopProfile[task].minTime);
+		*p_data++ = lowByte(loopProfile[task].minTime);
+		*p_data++ = highByte(loopProfile[task].avgTime);
+		*p_data++ = lowByte(loopProfile[task].avgTime);
+		*p_data++ = highByte(loopProfile[task].maxTime);
+		*p_data++ = lowByte(loopProfile[task].maxTime);
+		*p_data++ = highByte(loopProfile[task].overruns);
+		*p_data++ = lowByte(loopProfile[task].overruns);
+	}
+
+	sendSerialPayload(payLen);
+
+	if( (serialPayloadRxLength > 1) && (serialPayloadRx[1] != 0) ) { loopProfileReset(); }
 }
 
 void TSCommClass::cmdHandler_m (void){
@@ -944,7 +971,36 @@ uint16_t offset =  word(serialPayloadRx[4], serialPayloadRx[3]);
 }
 
 void TSCommClass::cmdHandler_q (void){
-	sendReturnCodeMsg(SERIAL_RC_UKWN_ERR);
+//    case 'q': //Send the ISR latency and duration histograms
+// Reply is the source count and bucket count, followed for each source (ISR_PROFILE_* order) by the latency buckets,
+// latency max, duration buckets and duration max, all 16 bit big endian. Values are in uS, see isrProfiler.h for the bucket ranges
+	uint16_t payLen = 3 + (ISR_PROFILE_COUNT * 2 * (ISR_HISTOGRAM_BUCKETS + 1) * 2);
+
+	serialPayloadTx[0] = payLen >> 8;
+	serialPayloadTx[1] = payLen;
+	serialPayloadTx[2] = SERIAL_RC_OK;
+	serialPayloadTx[3] = ISR_PROFILE_COUNT;
+	serialPayloadTx[4] = ISR_HISTOGRAM_BUCKETS;
+
+	uint8_t *p_data = &serialPayloadTx[5];
+	for(uint8_t source = 0; source < ISR_PROFILE_COUNT; source++)
+	{
+		const isrHistogram_t *histograms[2] = { &isrProfile[source].latency, &isrProfile[source].duration };
+		for(uint8_t h = 0; h < 2; h++)
+		{
+			for(uint8_t bucket = 0; bucket < ISR_HISTOGRAM_BUCKETS; bucket++)
+			{
+				uint16_t count = histograms[h]->buckets[bucket];
+				*p_data++ = highByte(count);
+				*p_data++ = lowByte(count);
+			}
+			uint16_t maxTime = histograms[h]->maxTime;
+			*p_data++ = highByte(maxTime);
+			*p_data++ = lowByte(maxTime);
+		}
+	}
+
+	sendSerialPayload(payLen);
 }
 
 void TSCommClass::cmdHandler_r (void){
@@ -1007,6 +1063,7 @@ uint16_t calibrationLength = word(serialPayloadRx[5], serialPayloadRx[6]); // Sh
 		sendReturnCodeMsg(SERIAL_RC_RANGE_ERR);
 	}
 
+	table2D_invalidateAll(); //The calibrations are used through 2D tables
 }
 
 void TSCommClass::cmdHandler_u (void){
@@ -1134,15 +1191,14 @@ void TSCommClass::processTemperatureCalibrationTableUpdate(uint16_t calibrationL
 */
 void TSCommClass::sendToothLog(void)
 {
-	//We need TOOTH_LOG_SIZE number of records to send to TunerStudio. If there aren't that many in the buffer then we just return and wait for the next call
-	if (BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY) == false)
+	//We need TOOTH_LOG_SIZE number of records to send to TunerStudio. Take them from the ring, which keeps logging while this block is sent
+	toothLogRingFill();
+
+	//If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
+	while(toothHistoryIndex < TOOTH_LOG_SIZE)
 	{
-		//If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
-		while(toothHistoryIndex < TOOTH_LOG_SIZE)
-		{
-		  toothHistory[toothHistoryIndex] = 0;
-		  toothHistoryIndex++;
-		}
+	  toothHistory[toothHistoryIndex] = 0;
+	  toothHistoryIndex++;
 	}
 
 		//Setup the transmit buffer
@@ -1152,27 +1208,22 @@ void TSCommClass::sendToothLog(void)
 	serialPayloadTx[1] = payLen;
 	serialPayloadTx[2] = SERIAL_RC_OK;
 
-	memcpy( (void *) &serialPayloadTx[3], toothHistory, sizeof(toothHistory));
+	memcpy( (void *) &serialPayloadTx[3], (const void *) toothHistory, sizeof(toothHistory));
 
 	sendSerialPayload(payLen);
-
-//	BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-//	serialStatusFlag = SERIAL_INACTIVE;
-//	toothHistoryIndex = 0;
-//	logItemsTransmitted = 0;
+	toothLogRingBlockSent();
 }
 
 void TSCommClass::sendCompositeLog(void)
 {
-	if ( BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY) == false )
+	toothLogRingFill();
+
+	//If the buffer is not yet full but TS has timed out, pad the rest of the buffer
+	while( toothHistoryIndex < TOOTH_LOG_SIZE)
 	{
-		//If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
-		while( toothHistoryIndex < TOOTH_LOG_SIZE)
-		{
-		  toothHistory[toothHistoryIndex] = toothHistory[toothHistoryIndex-1]; //Composite logger needs a realistic time value to display correctly. Copy the last value
-		  compositeLogHistory[toothHistoryIndex] = 0;
-		  toothHistoryIndex++;
-		}
+	  toothHistory[toothHistoryIndex] = (toothHistoryIndex > 0U) ? toothHistory[toothHistoryIndex-1U] : micros(); //Composite logger needs a realistic time value to display correctly. Copy the last value
+	  compositeLogHistory[toothHistoryIndex] = 0;
+	  toothHistoryIndex++;
 	}
 
    //Setup the transmit buffer
@@ -1186,7 +1237,7 @@ void TSCommClass::sendCompositeLog(void)
 
 	for(logItemsTransmitted=0; logItemsTransmitted< TOOTH_LOG_SIZE; logItemsTransmitted++)
     {
-		memcpy( (void *) pPayLoad, &toothHistory[logItemsTransmitted], 4);	// edge info
+		memcpy( (void *) pPayLoad, (const void *) &toothHistory[logItemsTransmitted], 4);	// edge info
 
 		pPayLoad += 4;
 
@@ -1194,14 +1245,7 @@ void TSCommClass::sendCompositeLog(void)
     }
 
 	sendSerialPayload(payLen);
-
-      //tx buffer is full. Store the current state so it can be resumed later
-// serialStatusFlag = SERIAL_TRANSMIT_COMPOSITE_INPROGRESS;
-// BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-// toothHistoryIndex = 0;
-// serialStatusFlag = SERIAL_INACTIVE;
-// logItemsTransmitted = 0;
-
+	toothLogRingBlockSent();
 }
 
 
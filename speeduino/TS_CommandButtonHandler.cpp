@@ -12,6 +12,8 @@
 #include "sensors.h"
 #include "storage.h"
 #include "SD_logger.h"
+#include "isrProfiler.h"
+#include "loopProfiler.h"
 #ifdef USE_MC33810
   #include "acc_mc33810.h"
 #endif
@@ -384,6 +386,14 @@ bool TS_CommandButtonsHandler(uint16_t buttonCommand)
       break;
 #endif
 
+    case TS_CMD_ISR_PROFILE_RESET:
+      isrProfileReset();
+      break;
+
+    case TS_CMD_LOOP_PROFILE_RESET:
+      loopProfileReset();
+      break;
+
     default:
       return false;
       break;
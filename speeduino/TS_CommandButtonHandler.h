@@ -62,6 +62,9 @@
 
 #define TS_CMD_SD_FORMAT  13057
 
+#define TS_CMD_ISR_PROFILE_RESET  13313 //0x3401
+#define TS_CMD_LOOP_PROFILE_RESET 13314 //0x3402
+
 #define TS_CMD_VSS_60KMH  39168 //0x99x00
 #define TS_CMD_VSS_RATIO1 39169
 #define TS_CMD_VSS_RATIO2 39170
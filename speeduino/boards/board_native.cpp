@@ -0,0 +1,393 @@
+#include "globals.h"
+#if defined(CORE_NATIVE)
+#include "config.h"
+#include "board_native.h"
+#include "auxiliaries.h"
+#include "comms_secondary.h"
+#include "idle.h"
+#include "scheduler.h"
+#include "schedule_queue.h"
+#include "timers.h"
+
+SPIClass Spi;
+SPIClass Spi1;
+SPIClass Spi2;
+
+volatile uint8_t nativePortOutput[(NUM_DIGITAL_PINS / 8) + 1];
+volatile uint8_t nativePortInput[(NUM_DIGITAL_PINS / 8) + 1];
+static uint8_t nativePinModes[NUM_DIGITAL_PINS];
+static uint16_t nativeAnalogValues[NUM_DIGITAL_PINS];
+
+static void (*nativeExtInterrupts[NUM_DIGITAL_PINS])(void);
+static uint8_t nativeExtInterruptModes[NUM_DIGITAL_PINS];
+static uint32_t nativeInterruptLatency;
+volatile COUNTER_TYPE nativeInputCapture[NUM_DIGITAL_PINS];
+
+volatile COUNTER_TYPE nativeTimerCounter;
+volatile COMPARE_TYPE nativeFuelCompare[8];
+volatile COMPARE_TYPE nativeIgnCompare[8];
+volatile bool nativeFuelTimerEnabled[8];
+volatile bool nativeIgnTimerEnabled[8];
+volatile COMPARE_TYPE nativeQueueCompare;
+volatile bool nativeQueueTimerEnabled;
+volatile COMPARE_TYPE nativeAuxCompare[3];
+volatile bool nativeAuxTimerEnabled[3];
+
+static uint32_t nativeClock; //The virtual clock, in uS
+static bool nativeLowResTimerEnabled; //The 1ms timer only runs once initBoard() has been called
+static uint8_t nativeInterruptDisableDepth;
+static bool nativeInServiceRoutine;
+
+uint8_t nativeFram[NATIVE_FRAM_SIZE];
+
+/** A timer compare channel: the compare register, its interrupt enable and the handler it raises */
+struct native_timer_channel_t {
+  volatile COMPARE_TYPE &compare;
+  volatile bool &enabled;
+  void (*isr)(void);
+};
+
+static const native_timer_channel_t nativeTimerChannels[] = {
+#if defined(USE_SCHEDULE_QUEUE)
+  { nativeQueueCompare, nativeQueueTimerEnabled, scheduleQueueInterrupt },
+#else
+  { nativeFuelCompare[0], nativeFuelTimerEnabled[0], fuelScheduleInterrupt<1> },
+  { nativeFuelCompare[1], nativeFuelTimerEnabled[1], fuelScheduleInterrupt<2> },
+  { nativeFuelCompare[2], nativeFuelTimerEnabled[2], fuelScheduleInterrupt<3> },
+  { nativeFuelCompare[3], nativeFuelTimerEnabled[3], fuelScheduleInterrupt<4> },
+#if INJ_CHANNELS >= 5
+  { nativeFuelCompare[4], nativeFuelTimerEnabled[4], fuelScheduleInterrupt<5> },
+#endif
+#if INJ_CHANNELS >= 6
+  { nativeFuelCompare[5], nativeFuelTimerEnabled[5], fuelScheduleInterrupt<6> },
+#endif
+#if INJ_CHANNELS >= 7
+  { nativeFuelCompare[6], nativeFuelTimerEnabled[6], fuelScheduleInterrupt<7> },
+#endif
+#if INJ_CHANNELS >= 8
+  { nativeFuelCompare[7], nativeFuelTimerEnabled[7], fuelScheduleInterrupt<8> },
+#endif
+  { nativeIgnCompare[0], nativeIgnTimerEnabled[0], ignitionScheduleInterrupt<1> },
+  { nativeIgnCompare[1], nativeIgnTimerEnabled[1], ignitionScheduleInterrupt<2> },
+  { nativeIgnCompare[2], nativeIgnTimerEnabled[2], ignitionScheduleInterrupt<3> },
+  { nativeIgnCompare[3], nativeIgnTimerEnabled[3], ignitionScheduleInterrupt<4> },
+#if IGN_CHANNELS >= 5
+  { nativeIgnCompare[4], nativeIgnTimerEnabled[4], ignitionScheduleInterrupt<5> },
+#endif
+#if IGN_CHANNELS >= 6
+  { nativeIgnCompare[5], nativeIgnTimerEnabled[5], ignitionScheduleInterrupt<6> },
+#endif
+#if IGN_CHANNELS >= 7
+  { nativeIgnCompare[6], nativeIgnTimerEnabled[6], ignitionScheduleInterrupt<7> },
+#endif
+#if IGN_CHANNELS >= 8
+  { nativeIgnCompare[7], nativeIgnTimerEnabled[7], ignitionScheduleInterrupt<8> },
+#endif
+#endif
+  { nativeAuxCompare[NATIVE_AUX_BOOST], nativeAuxTimerEnabled[NATIVE_AUX_BOOST], boostInterrupt },
+  { nativeAuxCompare[NATIVE_AUX_VVT], nativeAuxTimerEnabled[NATIVE_AUX_VVT], vvtInterrupt },
+  { nativeAuxCompare[NATIVE_AUX_IDLE], nativeAuxTimerEnabled[NATIVE_AUX_IDLE], idleInterrupt },
+};
+#define NATIVE_TIMER_CHANNEL_COUNT (sizeof(nativeTimerChannels)/sizeof(nativeTimerChannels[0]))
+
+/*
+***********************************************************************************************************
+* Emulated FRAM (MB85RS64) on Spi2.
+* A transaction starts when the CS pin is driven low: 1 command byte, 2 address bytes and then data.
+*/
+#define FRAM_CMD_WRITE 0x02
+#define FRAM_CMD_READ  0x03
+
+static struct {
+  uint8_t command;
+  uint8_t byteCount; //Number of command and address bytes received so far in this transaction
+  uint16_t address;
+} nativeFramState;
+
+static void nativeFramSelect(void)
+{
+  nativeFramState.command = 0;
+  nativeFramState.byteCount = 0;
+  nativeFramState.address = 0;
+}
+
+static uint8_t nativeFramTransfer(uint8_t data)
+{
+  uint8_t result = 0xFF;
+  if(BIT_CHECK(nativePortOutput[digitalPinToPort(FRAM_PIN_CS_FOR_STORAGE)], (FRAM_PIN_CS_FOR_STORAGE & 0x07U))) { return result; } //Not selected
+
+  if(nativeFramState.byteCount == 0U) { nativeFramState.command = data; }
+  else if(nativeFramState.byteCount < 3U) { nativeFramState.address = (uint16_t)((nativeFramState.address << 8) | data); }
+  else if(nativeFramState.command == FRAM_CMD_READ)
+  {
+    result = nativeFram[nativeFramState.address % NATIVE_FRAM_SIZE];
+    nativeFramState.address++;
+  }
+  else if(nativeFramState.command == FRAM_CMD_WRITE)
+  {
+    nativeFram[nativeFramState.address % NATIVE_FRAM_SIZE] = data;
+    nativeFramState.address++;
+  }
+
+  if(nativeFramState.byteCount < 3U) { nativeFramState.byteCount++; }
+  return result;
+}
+
+/*
+***********************************************************************************************************
+* General
+*/
+void initBoard(void)
+{
+  configPage9.intcan_available = 0;
+  pSecondarySerial = &Serial;
+
+  //Boost and VVT PWM run from the same 1uS counter as the schedules
+  if(configPage6.boostFreq > 0U) { boost_pwm_max_count = (uint16_t)(MICROS_PER_SEC / (configPage6.boostFreq * 2U)); }
+  if(configPage6.vvtFreq > 0U) { vvt_pwm_max_count = (uint16_t)(MICROS_PER_SEC / (configPage6.vvtFreq * 2U)); }
+
+  nativeLowResTimerEnabled = true;
+}
+
+uint16_t freeRam(void) { return UINT16_MAX; }
+void doSystemReset(void) { nativeReset(); }
+void jumpToBootloader(void) { return; }
+
+/*
+***********************************************************************************************************
+* Pin mapping. There is only one native layout, so the boardID is ignored
+*/
+void setupBoardSystemPinNum(void) { }
+
+void setupBoardFixedPinNum(byte boardID)
+{
+  (void)boardID;
+  pinInjector1 = 22;
+  pinInjector2 = 23;
+  pinInjector3 = 24;
+  pinInjector4 = 25;
+  pinInjector5 = 26;
+  pinInjector6 = 27;
+  pinInjector7 = 28;
+  pinInjector8 = 29;
+  pinCoil1 = 30;
+  pinCoil2 = 31;
+  pinCoil3 = 32;
+  pinCoil4 = 33;
+  pinCoil5 = 34;
+  pinCoil6 = 35;
+  pinCoil7 = 36;
+  pinCoil8 = 37;
+  pinTrigger = 19;
+  pinTrigger2 = 18;
+  pinTrigger3 = 3;
+  pinIAT = A0;
+  pinCLT = A1;
+  pinTPS = A2;
+  pinMAP = A3;
+  pinBat = A4;
+  pinBaro = A5;
+  pinO2 = A8;
+  pinO2_2 = A9;
+  pinEMAP = A15;
+  pinTachOut = 49;
+  pinFuelPump = 45;
+  pinFan = 47;
+  pinIdle1 = 5;
+  pinIdle2 = 6;
+  pinBoost = 7;
+  pinVVT_1 = 4;
+  pinVVT_2 = 48;
+  pinStepperDir = 16;
+  pinStepperStep = 17;
+  pinStepperEnable = 44;
+  pinResetControl = 43;
+}
+
+void setupRemappablePinNum(byte boardID) { (void)boardID; }
+
+/*
+***********************************************************************************************************
+* Virtual clock
+*/
+void nativeReset(void)
+{
+  nativeClock = 0;
+  nativeTimerCounter = 0;
+  nativeLowResTimerEnabled = false;
+  nativeInterruptDisableDepth = 0;
+  nativeInServiceRoutine = false;
+  for(uint8_t x = 0; x < NATIVE_TIMER_CHANNEL_COUNT; x++)
+  {
+    nativeTimerChannels[x].compare = 0;
+    nativeTimerChannels[x].enabled = false;
+  }
+  memset((void*)nativePortOutput, 0, sizeof(nativePortOutput));
+  memset((void*)nativePortInput, 0, sizeof(nativePortInput));
+  memset(nativePinModes, INPUT, sizeof(nativePinModes));
+  memset(nativeAnalogValues, 0, sizeof(nativeAnalogValues));
+  memset(nativeExtInterrupts, 0, sizeof(nativeExtInterrupts));
+  memset((void*)nativeInputCapture, 0, sizeof(nativeInputCapture));
+  nativeInterruptLatency = 0;
+  BIT_SET(nativePortOutput[digitalPinToPort(FRAM_PIN_CS_FOR_STORAGE)], (FRAM_PIN_CS_FOR_STORAGE & 0x07U)); //FRAM deselected
+  Spi2.attachDevice(nativeFramTransfer);
+}
+
+static inline void nativeCallISR(void (*isr)(void))
+{
+  //Interrupts do not nest, the same as the target
+  nativeInServiceRoutine = true;
+  nativeInterruptDisableDepth++;
+  isr();
+  nativeInterruptDisableDepth--;
+  nativeInServiceRoutine = false;
+}
+
+/** The number of uS until the given compare channel next matches the counter */
+static inline uint64_t nativeTimeToCompare(const native_timer_channel_t &channel)
+{
+  COMPARE_TYPE ticks = (COMPARE_TYPE)(channel.compare - nativeTimerCounter);
+  return (ticks == 0U) ? ((uint64_t)((COMPARE_TYPE)~(COMPARE_TYPE)0U) + 1U) : ticks;
+}
+
+void nativeAdvanceMicros(uint32_t uS)
+{
+  //Time cannot move on while an interrupt is being serviced (Eg delay() called from an ISR), the target would be stalled too
+  if(nativeInServiceRoutine) { nativeClock += uS; nativeTimerCounter += (COUNTER_TYPE)uS; return; }
+
+  while(uS > 0U)
+  {
+    //Move to the next event (A compare match or the 1ms tick), or the end of the requested period
+    uint32_t step = 1000U - (nativeClock % 1000U);
+    for(uint8_t x = 0; x < NATIVE_TIMER_CHANNEL_COUNT; x++)
+    {
+      if(nativeTimerChannels[x].enabled == true) { step = (uint32_t)min((uint64_t)step, nativeTimeToCompare(nativeTimerChannels[x])); }
+    }
+    step = min(step, uS);
+
+    nativeClock += step;
+    nativeTimerCounter += (COUNTER_TYPE)step;
+    uS -= step;
+
+    //Compare interrupts are raised in channel order. A handler that moves its own compare forward is not called again until that time is reached
+    for(uint8_t x = 0; x < NATIVE_TIMER_CHANNEL_COUNT; x++)
+    {
+      if( (nativeTimerChannels[x].enabled == true) && (nativeTimerChannels[x].compare == nativeTimerCounter) ) { nativeCallISR(nativeTimerChannels[x].isr); }
+    }
+    if( (nativeLowResTimerEnabled == true) && ((nativeClock % 1000U) == 0U) ) { nativeCallISR(oneMSInterval); }
+  }
+}
+
+uint32_t micros(void) { return nativeClock; }
+uint32_t millis(void) { return nativeClock / 1000U; }
+void delay(unsigned long ms) { nativeAdvanceMicros(ms * 1000U); }
+void delayMicroseconds(unsigned int us) { nativeAdvanceMicros(us); }
+void yield(void) { }
+
+void noInterrupts(void) { nativeInterruptDisableDepth++; }
+void interrupts(void) { if(nativeInterruptDisableDepth > 0U) { nativeInterruptDisableDepth--; } }
+
+/*
+***********************************************************************************************************
+* Pins
+*/
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if(pin >= NUM_DIGITAL_PINS) { return; }
+  nativePinModes[pin] = mode;
+  if(mode == INPUT_PULLUP) { BIT_SET(nativePortInput[digitalPinToPort(pin)], (pin & 0x07U)); }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if(pin >= NUM_DIGITAL_PINS) { return; }
+  if(val == LOW)
+  {
+    if( (pin == FRAM_PIN_CS_FOR_STORAGE) && (nativeGetPin(pin) == HIGH) ) { nativeFramSelect(); }
+    BIT_CLEAR(nativePortOutput[digitalPinToPort(pin)], (pin & 0x07U));
+  }
+  else { BIT_SET(nativePortOutput[digitalPinToPort(pin)], (pin & 0x07U)); }
+}
+
+int digitalRead(uint8_t pin)
+{
+  if(pin >= NUM_DIGITAL_PINS) { return LOW; }
+  if(nativePinModes[pin] == OUTPUT) { return nativeGetPin(pin); }
+  return BIT_CHECK(nativePortInput[digitalPinToPort(pin)], (pin & 0x07U)) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  return (pin < NUM_DIGITAL_PINS) ? nativeAnalogValues[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+  digitalWrite(pin, (val > 127) ? HIGH : LOW);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode)
+{
+  if(interruptNum >= NUM_DIGITAL_PINS) { return; }
+  nativeExtInterrupts[interruptNum] = userFunc;
+  nativeExtInterruptModes[interruptNum] = (uint8_t)mode;
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+  if(interruptNum >= NUM_DIGITAL_PINS) { return; }
+  nativeExtInterrupts[interruptNum] = NULL;
+}
+
+void nativeSetPin(uint8_t pin, uint8_t level)
+{
+  if(pin >= NUM_DIGITAL_PINS) { return; }
+  uint8_t previous = BIT_CHECK(nativePortInput[digitalPinToPort(pin)], (pin & 0x07U)) ? HIGH : LOW;
+  if(level == LOW) { BIT_CLEAR(nativePortInput[digitalPinToPort(pin)], (pin & 0x07U)); }
+  else { BIT_SET(nativePortInput[digitalPinToPort(pin)], (pin & 0x07U)); }
+
+  if( (nativeExtInterrupts[pin] != NULL) && (previous != level) )
+  {
+    uint8_t mode = nativeExtInterruptModes[pin];
+    if( (mode == CHANGE) || ((mode == RISING) && (level == HIGH)) || ((mode == FALLING) && (level == LOW)) )
+    {
+      //The capture is latched by the edge. Any latency (Including timer interrupts that fall due in the meantime) is only seen by the handler
+      nativeInputCapture[pin] = nativeTimerCounter;
+      nativeAdvanceMicros(nativeInterruptLatency);
+      nativeCallISR(nativeExtInterrupts[pin]);
+    }
+  }
+}
+
+void nativeSetInterruptLatency(uint32_t uS) { nativeInterruptLatency = uS; }
+
+uint8_t nativeGetPin(uint8_t pin)
+{
+  if(pin >= NUM_DIGITAL_PINS) { return LOW; }
+  return BIT_CHECK(nativePortOutput[digitalPinToPort(pin)], (pin & 0x07U)) ? HIGH : LOW;
+}
+
+void nativeSetAnalog(uint8_t pin, uint16_t value)
+{
+  if(pin < NUM_DIGITAL_PINS) { nativeAnalogValues[pin] = value; }
+}
+
+/*
+***********************************************************************************************************
+* Stand alone entry point. Unit tests provide their own.
+*/
+#if !defined(UNIT_TEST)
+int main(void)
+{
+  nativeReset();
+  setup();
+  while(true)
+  {
+    loop();
+    nativeAdvanceMicros(NATIVE_LOOP_PERIOD_US);
+  }
+  return 0;
+}
+#endif
+
+#endif //CORE_NATIVE
@@ -0,0 +1,232 @@
+#ifndef NATIVE_H
+#define NATIVE_H
+#if defined(CORE_NATIVE)
+
+/*
+***********************************************************************************************************
+* Native (host) board
+*
+* Allows the firmware core to be built and run on the development machine. There is no hardware behind
+* any of the registers below: timers are driven by a virtual clock that only moves when
+* nativeAdvanceMicros() is called (Directly by a test/tool, or by delay()), pins are plain memory and
+* configuration storage is an emulated FRAM on Spi2.
+*/
+#include <SPI.h>
+#include <EEPROM.h>
+
+/*
+***********************************************************************************************************
+* General
+*/
+  #define PORT_TYPE uint8_t //Size of the port variables (Eg inj1_pin_port).
+  #define PINMASK_TYPE uint8_t
+  //#define USE_SCHEDULE_TIMER_32BIT //Run the schedules from a 32-bit counter rather than a 16-bit one. Can also be set in build_flags (See env:native_timer_32bit)
+  #if defined(USE_SCHEDULE_TIMER_32BIT)
+    #define COMPARE_TYPE uint32_t
+    #define COUNTER_TYPE uint32_t
+  #else
+    #define COMPARE_TYPE uint16_t
+    #define COUNTER_TYPE uint16_t
+  #endif
+  #define SERIAL_BUFFER_SIZE 517 //Size of the serial buffer used by new comms protocol. For SD transfers this must be at least 512 + 1 (flag) + 4 (sector)
+  #define TSCOMM_RX_SERIAL_BUFFER_SIZE SERIAL_BUFFER_SIZE
+  #define TSCOMM_TX_SERIAL_BUFFER_SIZE SERIAL_BUFFER_SIZE
+  #define FPU_MAX_SIZE 0 //Size of the FPU buffer. 0 means no FPU.
+  #define BOARD_MAX_DIGITAL_PINS 54
+  #define BOARD_MAX_IO_PINS 70 //digital pins + analog channels + 1
+  #define BOARD_MAX_ADC_PINS  15 //Number of analog pins
+  #define EEPROM_LIB_H <EEPROM.h> //The name of the file that provides the EEPROM class
+  #define RTC_LIB_H <Arduino.h> //There is no RTC on the native board (RTC_ENABLED is not defined), this only satisfies the include in rtc_common.cpp
+  typedef int eeprom_address_t;
+  #define micros_safe() micros() //The virtual clock cannot be interrupted part way through a read
+  #define pinIsReserved(pin)  ( ((pin) == 0) ) //Forbidden pins like USB
+  void initBoard(void);
+  uint16_t freeRam(void);
+  void doSystemReset(void);
+  void jumpToBootloader(void);
+  void setupBoardSystemPinNum(void);
+  void setupBoardFixedPinNum(byte boardID);
+  void setupRemappablePinNum(byte boardID);
+
+  //Configuration storage is an emulated 8kB SPI FRAM (MB85RS64) on Spi2, the same as the M451 target
+  #define USE_FRAM_FOR_STORAGE
+  #define FRAM_SPI_FOR_STORAGE    Spi2
+  #define FRAM_PIN_CS_FOR_STORAGE 53
+  #define FRAM_PIN_WE_FOR_STORAGE 52
+  #define NATIVE_FRAM_SIZE        8192U
+  #define FRAM_LAST_ADDR          (NATIVE_FRAM_SIZE - 1U)
+
+  //M451 core and board support package functions used by the firmware
+  extern SPIClass Spi;  //SPI0 -> flash
+  extern SPIClass Spi1; //SPI1 -> L9779
+  extern SPIClass Spi2; //SPI2 -> Baro & FRAM
+  static inline void SYS_UnlockReg(void) { }
+  static inline void SYS_LockReg(void) { }
+  static inline void WDT_RESET_COUNTER(void) { }
+  static inline void digitalUpdateL9979WD(void) { }
+
+/*
+***********************************************************************************************************
+* Virtual clock and host side interface
+*/
+  #define NATIVE_LOOP_PERIOD_US 250U //Virtual time that elapses for each call to loop() when the native firmware is run stand alone
+
+  void nativeReset(void); ///< Reset the virtual clock, timers, pins and interrupt handlers to power on state
+  void nativeAdvanceMicros(uint32_t uS); ///< Move the virtual clock forward, raising any timer interrupts that fall due
+  void nativeSetPin(uint8_t pin, uint8_t level); ///< Drive an input pin, raising its external interrupt if the edge matches
+  void nativeSetInterruptLatency(uint32_t uS); ///< Virtual time between an edge on an input pin and its interrupt handler being called (0 at reset)
+  uint8_t nativeGetPin(uint8_t pin); ///< Read back the level of an output pin
+  void nativeSetAnalog(uint8_t pin, uint16_t value); ///< Set the value returned by analogRead()
+
+  extern uint8_t nativeFram[NATIVE_FRAM_SIZE];
+
+/*
+***********************************************************************************************************
+* Schedules
+* All schedules share a single free running 16-bit (Or 32-bit with USE_SCHEDULE_TIMER_32BIT) counter ticking
+* at 1uS. Each channel has its own compare register and interrupt enable.
+*/
+  extern volatile COUNTER_TYPE nativeTimerCounter;
+  extern volatile COMPARE_TYPE nativeFuelCompare[8];
+  extern volatile COMPARE_TYPE nativeIgnCompare[8];
+  extern volatile bool nativeFuelTimerEnabled[8];
+  extern volatile bool nativeIgnTimerEnabled[8];
+
+  #define FUEL1_COUNTER nativeTimerCounter
+  #define FUEL2_COUNTER nativeTimerCounter
+  #define FUEL3_COUNTER nativeTimerCounter
+  #define FUEL4_COUNTER nativeTimerCounter
+  #define FUEL5_COUNTER nativeTimerCounter
+  #define FUEL6_COUNTER nativeTimerCounter
+  #define FUEL7_COUNTER nativeTimerCounter
+  #define FUEL8_COUNTER nativeTimerCounter
+
+  #define IGN1_COUNTER  nativeTimerCounter
+  #define IGN2_COUNTER  nativeTimerCounter
+  #define IGN3_COUNTER  nativeTimerCounter
+  #define IGN4_COUNTER  nativeTimerCounter
+  #define IGN5_COUNTER  nativeTimerCounter
+  #define IGN6_COUNTER  nativeTimerCounter
+  #define IGN7_COUNTER  nativeTimerCounter
+  #define IGN8_COUNTER  nativeTimerCounter
+
+  #define FUEL1_COMPARE nativeFuelCompare[0]
+  #define FUEL2_COMPARE nativeFuelCompare[1]
+  #define FUEL3_COMPARE nativeFuelCompare[2]
+  #define FUEL4_COMPARE nativeFuelCompare[3]
+  #define FUEL5_COMPARE nativeFuelCompare[4]
+  #define FUEL6_COMPARE nativeFuelCompare[5]
+  #define FUEL7_COMPARE nativeFuelCompare[6]
+  #define FUEL8_COMPARE nativeFuelCompare[7]
+
+  #define IGN1_COMPARE  nativeIgnCompare[0]
+  #define IGN2_COMPARE  nativeIgnCompare[1]
+  #define IGN3_COMPARE  nativeIgnCompare[2]
+  #define IGN4_COMPARE  nativeIgnCompare[3]
+  #define IGN5_COMPARE  nativeIgnCompare[4]
+  #define IGN6_COMPARE  nativeIgnCompare[5]
+  #define IGN7_COMPARE  nativeIgnCompare[6]
+  #define IGN8_COMPARE  nativeIgnCompare[7]
+
+  static inline void FUEL1_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[0] = true; }
+  static inline void FUEL2_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[1] = true; }
+  static inline void FUEL3_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[2] = true; }
+  static inline void FUEL4_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[3] = true; }
+  static inline void FUEL5_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[4] = true; }
+  static inline void FUEL6_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[5] = true; }
+  static inline void FUEL7_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[6] = true; }
+  static inline void FUEL8_TIMER_ENABLE(void)  { nativeFuelTimerEnabled[7] = true; }
+
+  static inline void FUEL1_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[0] = false; }
+  static inline void FUEL2_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[1] = false; }
+  static inline void FUEL3_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[2] = false; }
+  static inline void FUEL4_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[3] = false; }
+  static inline void FUEL5_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[4] = false; }
+  static inline void FUEL6_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[5] = false; }
+  static inline void FUEL7_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[6] = false; }
+  static inline void FUEL8_TIMER_DISABLE(void)  { nativeFuelTimerEnabled[7] = false; }
+
+  static inline void IGN1_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[0] = true; }
+  static inline void IGN2_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[1] = true; }
+  static inline void IGN3_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[2] = true; }
+  static inline void IGN4_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[3] = true; }
+  static inline void IGN5_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[4] = true; }
+  static inline void IGN6_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[5] = true; }
+  static inline void IGN7_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[6] = true; }
+  static inline void IGN8_TIMER_ENABLE(void)  { nativeIgnTimerEnabled[7] = true; }
+
+  static inline void IGN1_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[0] = false; }
+  static inline void IGN2_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[1] = false; }
+  static inline void IGN3_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[2] = false; }
+  static inline void IGN4_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[3] = false; }
+  static inline void IGN5_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[4] = false; }
+  static inline void IGN6_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[5] = false; }
+  static inline void IGN7_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[6] = false; }
+  static inline void IGN8_TIMER_DISABLE(void)  { nativeIgnTimerEnabled[7] = false; }
+
+  //Used instead of the compares above when USE_SCHEDULE_QUEUE is defined. See schedule_queue.h
+  extern volatile COMPARE_TYPE nativeQueueCompare;
+  extern volatile bool nativeQueueTimerEnabled;
+  #define SCHEDULE_QUEUE_COUNTER  nativeTimerCounter
+  #define SCHEDULE_QUEUE_COMPARE  nativeQueueCompare
+  #define SCHEDULE_QUEUE_TIMER_ENABLE()   (nativeQueueTimerEnabled = true)
+  #define SCHEDULE_QUEUE_TIMER_DISABLE()  (nativeQueueTimerEnabled = false)
+
+  #if defined(USE_SCHEDULE_TIMER_32BIT)
+    #define MAX_TIMER_PERIOD 4294967295UL //This is the maximum time, in uS, that the compare channels can run before overflowing. (2^32 - 1) * 1uS, over 71 minutes
+  #else
+    #define MAX_TIMER_PERIOD 65535UL //This is the maximum time, in uS, that the compare channels can run before overflowing. 65535 * 1uS
+  #endif
+  #define uS_TO_TIMER_COMPARE(uS) (uS) //1 tick = 1uS
+
+/*
+***********************************************************************************************************
+* Trigger input capture
+* As on the M451, the trigger inputs are timer capture inputs: the edge that raises the interrupt also latches the
+* schedule counter, so the decoders see the time of the edge rather than the time the ISR started (TRIGGER_TIMESTAMP())
+*/
+  extern volatile COUNTER_TYPE nativeInputCapture[NUM_DIGITAL_PINS];
+
+  #define TRIGGER_PRI_CAPTURE_AGE()   ((COUNTER_TYPE)(nativeTimerCounter - nativeInputCapture[pinTrigger]))
+  #define TRIGGER_SEC_CAPTURE_AGE()   ((COUNTER_TYPE)(nativeTimerCounter - nativeInputCapture[pinTrigger2]))
+  #define TRIGGER_THIRD_CAPTURE_AGE() ((COUNTER_TYPE)(nativeTimerCounter - nativeInputCapture[pinTrigger3]))
+
+/*
+***********************************************************************************************************
+* Auxiliaries
+*/
+  #define NATIVE_AUX_BOOST  0
+  #define NATIVE_AUX_VVT    1
+  #define NATIVE_AUX_IDLE   2
+  extern volatile COMPARE_TYPE nativeAuxCompare[3]; //The auxiliaries share the schedule counter, so are the same width
+  extern volatile bool nativeAuxTimerEnabled[3];
+
+  #define ENABLE_BOOST_TIMER()  (nativeAuxTimerEnabled[NATIVE_AUX_BOOST] = true)
+  #define DISABLE_BOOST_TIMER() (nativeAuxTimerEnabled[NATIVE_AUX_BOOST] = false)
+
+  #define ENABLE_VVT_TIMER()    (nativeAuxTimerEnabled[NATIVE_AUX_VVT] = true)
+  #define DISABLE_VVT_TIMER()   (nativeAuxTimerEnabled[NATIVE_AUX_VVT] = false)
+
+  #define BOOST_TIMER_COMPARE   nativeAuxCompare[NATIVE_AUX_BOOST]
+  #define BOOST_TIMER_COUNTER   nativeTimerCounter
+  #define VVT_TIMER_COMPARE     nativeAuxCompare[NATIVE_AUX_VVT]
+  #define VVT_TIMER_COUNTER     nativeTimerCounter
+
+/*
+***********************************************************************************************************
+* Idle
+*/
+  #define IDLE_COUNTER          nativeTimerCounter
+  #define IDLE_COMPARE          nativeAuxCompare[NATIVE_AUX_IDLE]
+
+  #define IDLE_TIMER_ENABLE()   (nativeAuxTimerEnabled[NATIVE_AUX_IDLE] = true)
+  #define IDLE_TIMER_DISABLE()  (nativeAuxTimerEnabled[NATIVE_AUX_IDLE] = false)
+
+/*
+***********************************************************************************************************
+* CAN / Second serial
+*/
+  #define SECONDARY_SERIAL_T HardwareSerial
+
+#endif //CORE_NATIVE
+#endif //NATIVE_H
@@ -5,6 +5,7 @@
 #include "auxiliaries.h"
 #include "idle.h"
 #include "scheduler.h"
+#include "schedule_queue.h"
 #include "HardwareTimer.h"
 #include "timers.h"
 #include "comms_secondary.h"
@@ -179,10 +180,21 @@ STM32RTC& rtc = STM32RTC::getInstance();
     * Schedules
     */
     Timer1.setOverflow(0xFFFF, TICK_FORMAT);
+    Timer1.setPrescaleFactor(((Timer1.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
+
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+    Timer5.setOverflow(0xFFFFFFFF, TICK_FORMAT);
+    Timer5.setPrescaleFactor((Timer5.getTimerClkFreq()/1000000)-1);   //1us resolution
+    #if ( STM32_CORE_VERSION_MAJOR < 2 )
+    Timer5.setMode(1, TIMER_OUTPUT_COMPARE);
+    #else //2.0 forward
+    Timer5.setMode(1, TIMER_OUTPUT_COMPARE_TOGGLE);
+    #endif
+    Timer5.attachInterrupt(1, scheduleQueueInterrupt);
+#else
     Timer2.setOverflow(0xFFFF, TICK_FORMAT);
     Timer3.setOverflow(0xFFFF, TICK_FORMAT);
 
-    Timer1.setPrescaleFactor(((Timer1.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
     Timer2.setPrescaleFactor(((Timer2.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
     Timer3.setPrescaleFactor(((Timer3.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
 
@@ -209,10 +221,10 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #endif
     //Attach interrupt functions
     //Injection
-    Timer3.attachInterrupt(1, fuelSchedule1Interrupt);
-    Timer3.attachInterrupt(2, fuelSchedule2Interrupt);
-    Timer3.attachInterrupt(3, fuelSchedule3Interrupt);
-    Timer3.attachInterrupt(4, fuelSchedule4Interrupt);
+    Timer3.attachInterrupt(1, fuelScheduleInterrupt<1>);
+    Timer3.attachInterrupt(2, fuelScheduleInterrupt<2>);
+    Timer3.attachInterrupt(3, fuelScheduleInterrupt<3>);
+    Timer3.attachInterrupt(4, fuelScheduleInterrupt<4>);
     #if (INJ_CHANNELS >= 5)
     Timer5.setOverflow(0xFFFF, TICK_FORMAT);
     Timer5.setPrescaleFactor(((Timer5.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
@@ -221,7 +233,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer5.setMode(1, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer5.attachInterrupt(1, fuelSchedule5Interrupt);
+    Timer5.attachInterrupt(1, fuelScheduleInterrupt<5>);
     #endif
     #if (INJ_CHANNELS >= 6)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -229,7 +241,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer5.setMode(1, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer5.attachInterrupt(2, fuelSchedule6Interrupt);
+    Timer5.attachInterrupt(2, fuelScheduleInterrupt<6>);
     #endif
     #if (INJ_CHANNELS >= 7)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -237,7 +249,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer5.setMode(3, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer5.attachInterrupt(3, fuelSchedule7Interrupt);
+    Timer5.attachInterrupt(3, fuelScheduleInterrupt<7>);
     #endif
     #if (INJ_CHANNELS >= 8)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -245,14 +257,14 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer5.setMode(4, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer5.attachInterrupt(4, fuelSchedule8Interrupt);
+    Timer5.attachInterrupt(4, fuelScheduleInterrupt<8>);
     #endif
 
     //Ignition
-    Timer2.attachInterrupt(1, ignitionSchedule1Interrupt); 
-    Timer2.attachInterrupt(2, ignitionSchedule2Interrupt);
-    Timer2.attachInterrupt(3, ignitionSchedule3Interrupt);
-    Timer2.attachInterrupt(4, ignitionSchedule4Interrupt);
+    Timer2.attachInterrupt(1, ignitionScheduleInterrupt<1>); 
+    Timer2.attachInterrupt(2, ignitionScheduleInterrupt<2>);
+    Timer2.attachInterrupt(3, ignitionScheduleInterrupt<3>);
+    Timer2.attachInterrupt(4, ignitionScheduleInterrupt<4>);
     #if (IGN_CHANNELS >= 5)
     Timer4.setOverflow(0xFFFF, TICK_FORMAT);
     Timer4.setPrescaleFactor(((Timer4.getTimerClkFreq()/1000000) * TIMER_RESOLUTION)-1);   //4us resolution
@@ -261,7 +273,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer4.setMode(1, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer4.attachInterrupt(1, ignitionSchedule5Interrupt);
+    Timer4.attachInterrupt(1, ignitionScheduleInterrupt<5>);
     #endif
     #if (IGN_CHANNELS >= 6)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -269,7 +281,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer4.setMode(2, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer4.attachInterrupt(2, ignitionSchedule6Interrupt);
+    Timer4.attachInterrupt(2, ignitionScheduleInterrupt<6>);
     #endif
     #if (IGN_CHANNELS >= 7)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -277,7 +289,7 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer4.setMode(3, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer4.attachInterrupt(3, ignitionSchedule7Interrupt);
+    Timer4.attachInterrupt(3, ignitionScheduleInterrupt<7>);
     #endif
     #if (IGN_CHANNELS >= 8)
     #if ( STM32_CORE_VERSION_MAJOR < 2 )
@@ -285,8 +297,9 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #else //2.0 forward
     Timer4.setMode(4, TIMER_OUTPUT_COMPARE_TOGGLE);
     #endif
-    Timer4.attachInterrupt(4, ignitionSchedule8Interrupt);
+    Timer4.attachInterrupt(4, ignitionScheduleInterrupt<8>);
     #endif
+#endif //USE_SCHEDULE_TIMER_32BIT
 
 
   }
@@ -346,6 +359,80 @@ STM32RTC& rtc = STM32RTC::getInstance();
     #endif
   }
 
+  /*
+  ***********************************************************************************************************
+  * Trigger input capture
+  */
+  #if defined(USE_TRIGGER_CAPTURE)
+  triggerCapture_t triggerCapturePri;
+  triggerCapture_t triggerCaptureSec;
+  triggerCapture_t triggerCaptureThird;
+
+  //Each timer can only have one HardwareTimer, which the trigger inputs share if they are channels of the same timer
+  static TIM_TypeDef *triggerCaptureInstances[3];
+  static HardwareTimer *triggerCaptureTimers[3];
+
+  /** Whether the timer is already used by the schedules, auxiliaries or the 1ms interval (See the timers table in the header) */
+  static bool triggerCaptureTimerInUse(const TIM_TypeDef *instance)
+  {
+    if( (instance == TIM1) || (instance == TIM2) || (instance == TIM3) || (instance == TIM4) ) { return true; }
+    #if defined(TIM5)
+    if(instance == TIM5) { return true; }
+    #endif
+    #if defined(TIM11)
+    if(instance == TIM11) { return true; }
+    #endif
+    return false;
+  }
+
+  static HardwareTimer* triggerCaptureTimer(TIM_TypeDef *instance)
+  {
+    uint8_t x = 0;
+    for(; (x < 3U) && (triggerCaptureInstances[x] != NULL); x++)
+    {
+      if(triggerCaptureInstances[x] == instance) { return triggerCaptureTimers[x]; }
+    }
+    if(x == 3U) { return NULL; }
+
+    triggerCaptureInstances[x] = instance;
+    triggerCaptureTimers[x] = new HardwareTimer(instance);
+    triggerCaptureTimers[x]->setOverflow(0xFFFF, TICK_FORMAT);
+    triggerCaptureTimers[x]->setPrescaleFactor((triggerCaptureTimers[x]->getTimerClkFreq()/1000000)-1);   //1us resolution
+    return triggerCaptureTimers[x];
+  }
+
+  static void initTriggerCaptureInput(triggerCapture_t &capture, byte pin, byte edge)
+  {
+    capture.counter = NULL;
+    capture.capture = NULL;
+
+    PinName pinName = digitalPinToPinName(pin);
+    TIM_TypeDef *instance = (TIM_TypeDef *)pinmap_peripheral(pinName, PinMap_TIM);
+    if( (instance == NP) || triggerCaptureTimerInUse(instance) ) { return; }
+    HardwareTimer *timer = triggerCaptureTimer(instance);
+    if(timer == NULL) { return; }
+
+    //Capture the same edge that the interrupt is attached to, so that an ignored edge cannot overwrite it before the ISR runs
+    uint32_t channel = STM_PIN_CHANNEL(pinmap_function(pinName, PinMap_TIM));
+    TimerModes_t mode = TIMER_INPUT_CAPTURE_BOTHEDGE;
+    if(edge == RISING) { mode = TIMER_INPUT_CAPTURE_RISING; }
+    else if(edge == FALLING) { mode = TIMER_INPUT_CAPTURE_FALLING; }
+    timer->setMode(channel, mode, pin);
+    timer->resume();
+
+    capture.counter = &instance->CNT;
+    capture.capture = (&instance->CCR1) + (channel - 1U);
+  }
+
+  /** Routes the trigger pins to their timers. Must be called after the trigger interrupts are attached, as attaching sets the pins back to plain inputs */
+  void initTriggerCapture(void)
+  {
+    initTriggerCaptureInput(triggerCapturePri, pinTrigger, primaryTriggerEdge);
+    initTriggerCaptureInput(triggerCaptureSec, pinTrigger2, secondaryTriggerEdge);
+    initTriggerCaptureInput(triggerCaptureThird, pinTrigger3, tertiaryTriggerEdge);
+  }
+  #endif
+
   /*
   ***********************************************************************************************************
   * Interrupt callback functions
@@ -353,40 +440,8 @@ STM32RTC& rtc = STM32RTC::getInstance();
   #if ((STM32_CORE_VERSION_MINOR<=8) & (STM32_CORE_VERSION_MAJOR==1)) 
   void oneMSInterval(HardwareTimer*){oneMSInterval();}
   void boostInterrupt(HardwareTimer*){boostInterrupt();}
-  void fuelSchedule1Interrupt(HardwareTimer*){fuelSchedule1Interrupt();}
-  void fuelSchedule2Interrupt(HardwareTimer*){fuelSchedule2Interrupt();}
-  void fuelSchedule3Interrupt(HardwareTimer*){fuelSchedule3Interrupt();}
-  void fuelSchedule4Interrupt(HardwareTimer*){fuelSchedule4Interrupt();}
-  #if (INJ_CHANNELS >= 5)
-  void fuelSchedule5Interrupt(HardwareTimer*){fuelSchedule5Interrupt();}
-  #endif
-  #if (INJ_CHANNELS >= 6)
-  void fuelSchedule6Interrupt(HardwareTimer*){fuelSchedule6Interrupt();}
-  #endif
-  #if (INJ_CHANNELS >= 7)
-  void fuelSchedule7Interrupt(HardwareTimer*){fuelSchedule7Interrupt();}
-  #endif
-  #if (INJ_CHANNELS >= 8)
-  void fuelSchedule8Interrupt(HardwareTimer*){fuelSchedule8Interrupt();}
-  #endif
   void idleInterrupt(HardwareTimer*){idleInterrupt();}
   void vvtInterrupt(HardwareTimer*){vvtInterrupt();}
   void fanInterrupt(HardwareTimer*){fanInterrupt();}
-  void ignitionSchedule1Interrupt(HardwareTimer*){ignitionSchedule1Interrupt();}
-  void ignitionSchedule2Interrupt(HardwareTimer*){ignitionSchedule2Interrupt();}
-  void ignitionSchedule3Interrupt(HardwareTimer*){ignitionSchedule3Interrupt();}
-  void ignitionSchedule4Interrupt(HardwareTimer*){ignitionSchedule4Interrupt();}
-  #if (IGN_CHANNELS >= 5)
-  void ignitionSchedule5Interrupt(HardwareTimer*){ignitionSchedule5Interrupt();}
-  #endif
-  #if (IGN_CHANNELS >= 6)
-  void ignitionSchedule6Interrupt(HardwareTimer*){ignitionSchedule6Interrupt();}
-  #endif
-  #if (IGN_CHANNELS >= 7)
-  void ignitionSchedule7Interrupt(HardwareTimer*){ignitionSchedule7Interrupt();}
-  #endif
-  #if (IGN_CHANNELS >= 8)
-  void ignitionSchedule8Interrupt(HardwareTimer*){ignitionSchedule8Interrupt();}
-  #endif
   #endif //End core<=1.8
 #endif
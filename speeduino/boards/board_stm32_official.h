@@ -34,8 +34,21 @@
 */
 #define PORT_TYPE uint32_t
 #define PINMASK_TYPE uint32_t
-#define COMPARE_TYPE uint16_t
-#define COUNTER_TYPE uint16_t
+//#define USE_SCHEDULE_TIMER_32BIT //Run the schedules from the 32-bit TIM5 at 1uS instead of the 16-bit timers (STM32F4 only). Can also be set in build_flags
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+  #if !defined(TIM5)
+    #error "USE_SCHEDULE_TIMER_32BIT needs the 32-bit TIM5, which this board does not have"
+  #endif
+  #if !defined(USE_SCHEDULE_QUEUE)
+    #define USE_SCHEDULE_QUEUE //Every schedule shares TIM5 channel 1 (See schedule_queue.h)
+  #endif
+  #define COMPARE_TYPE uint32_t
+  #define COUNTER_TYPE uint32_t
+  #define AUX_COMPARE_TYPE uint16_t //TIM1 is still 16-bit
+#else
+  #define COMPARE_TYPE uint16_t
+  #define COUNTER_TYPE uint16_t
+#endif
 #define SERIAL_BUFFER_SIZE 517 //Size of the serial buffer used by new comms protocol. For SD transfers this must be at least 512 + 1 (flag) + 4 (sector)
 #define FPU_MAX_SIZE 32 //Size of the FPU buffer. 0 means no FPU.
 #define micros_safe() micros() //timer5 method is not used on anything but AVR, the micros_safe() macro is simply an alias for the normal micros()
@@ -201,8 +214,22 @@ void jumpToBootloader();
 * 3 - VVT   |3 - INJ3  |3 - IGN3  |3 - IGN7  |3 - INJ7  |
 * 4 - IDLE  |4 - INJ4  |4 - IGN4  |4 - IGN8  |4 - INJ8  | 
 */
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+/*
+* TIM5 free runs at 1MHz, so there is no rounding between uS and ticks. Channel 1 is loaded with the next schedule
+* that is due by the schedule queue. TIM2, TIM3 and TIM4 are not used by the schedules
+*/
+#define SCHEDULE_QUEUE_COUNTER  (TIM5)->CNT
+#define SCHEDULE_QUEUE_COMPARE  (TIM5)->CCR1
+static inline void SCHEDULE_QUEUE_TIMER_ENABLE(void)  {(TIM5)->CR1 |= TIM_CR1_CEN; (TIM5)->DIER |= TIM_DIER_CC1IE;}
+static inline void SCHEDULE_QUEUE_TIMER_DISABLE(void) {(TIM5)->DIER &= ~TIM_DIER_CC1IE;}
+
+#define MAX_TIMER_PERIOD 4294967295UL //(2^32 - 1) * 1uS, over 71 minutes
+#define uS_TO_TIMER_COMPARE(uS) (uS) //1 tick = 1uS
+#else
 #define MAX_TIMER_PERIOD 65535*4 //The longest period of time (in uS) that the timer can permit (IN this case it is 65535 * 4, as each timer tick is 4uS)
 #define uS_TO_TIMER_COMPARE(uS) (uS>>2) //Converts a given number of uS into the required number of timer ticks until that time has passed.
+#endif
 
 #define FUEL1_COUNTER (TIM3)->CNT
 #define FUEL2_COUNTER (TIM3)->CNT
@@ -340,43 +367,50 @@ extern HardwareTimer Timer11;
 #if ((STM32_CORE_VERSION_MINOR<=8) & (STM32_CORE_VERSION_MAJOR==1)) 
 void oneMSInterval(HardwareTimer*);
 void boostInterrupt(HardwareTimer*);
-void fuelSchedule1Interrupt(HardwareTimer*);
-void fuelSchedule2Interrupt(HardwareTimer*);
-void fuelSchedule3Interrupt(HardwareTimer*);
-void fuelSchedule4Interrupt(HardwareTimer*);
-#if (INJ_CHANNELS >= 5)
-void fuelSchedule5Interrupt(HardwareTimer*);
-#endif
-#if (INJ_CHANNELS >= 6)
-void fuelSchedule6Interrupt(HardwareTimer*);
-#endif
-#if (INJ_CHANNELS >= 7)
-void fuelSchedule7Interrupt(HardwareTimer*);
-#endif
-#if (INJ_CHANNELS >= 8)
-void fuelSchedule8Interrupt(HardwareTimer*);
-#endif
 void idleInterrupt(HardwareTimer*);
 void vvtInterrupt(HardwareTimer*);
 void fanInterrupt(HardwareTimer*);
-void ignitionSchedule1Interrupt(HardwareTimer*);
-void ignitionSchedule2Interrupt(HardwareTimer*);
-void ignitionSchedule3Interrupt(HardwareTimer*);
-void ignitionSchedule4Interrupt(HardwareTimer*);
-#if (IGN_CHANNELS >= 5)
-void ignitionSchedule5Interrupt(HardwareTimer*);
-#endif
-#if (IGN_CHANNELS >= 6)
-void ignitionSchedule6Interrupt(HardwareTimer*);
-#endif
-#if (IGN_CHANNELS >= 7)
-void ignitionSchedule7Interrupt(HardwareTimer*);
-#endif
-#if (IGN_CHANNELS >= 8)
-void ignitionSchedule8Interrupt(HardwareTimer*);
-#endif
+//Older cores pass the timer to its interrupt
+template <uint8_t channel> void fuelScheduleInterrupt(void); //See scheduler.h
+template <uint8_t channel> void ignitionScheduleInterrupt(void);
+template <uint8_t channel> void fuelScheduleInterrupt(HardwareTimer*) { fuelScheduleInterrupt<channel>(); }
+template <uint8_t channel> void ignitionScheduleInterrupt(HardwareTimer*) { ignitionScheduleInterrupt<channel>(); }
+void scheduleQueueInterrupt(void); //See schedule_queue.h
+static inline void scheduleQueueInterrupt(HardwareTimer*) { scheduleQueueInterrupt(); }
 #endif //End core<=1.8
 
+/*
+***********************************************************************************************************
+* Trigger input capture
+* A trigger pin that is a channel of a timer not used above (Eg TIM8, TIM9 or TIM12 on the F407) has that timer free
+* run at 1MHz and capture its edges. The pin keeps its EXTI interrupt, the decoder then takes the tooth time from the
+* capture register (See TRIGGER_TIMESTAMP()). Pins without a free timer channel carry on using micros().
+*/
+#if ( STM32_CORE_VERSION_MAJOR >= 2 )
+  #define USE_TRIGGER_CAPTURE
+
+  typedef struct {
+    volatile uint32_t *counter; ///< CNT of the capturing timer, NULL when the pin is not captured
+    volatile uint32_t *capture; ///< CCRx of the pin's channel on that timer
+  } triggerCapture_t;
+
+  extern triggerCapture_t triggerCapturePri;
+  extern triggerCapture_t triggerCaptureSec;
+  extern triggerCapture_t triggerCaptureThird;
+
+  /** uS since the last captured edge. The timers overflow at 0xFFFF, including the 32-bit ones */
+  static inline uint16_t triggerCaptureAge(const triggerCapture_t &capture)
+  {
+    return (capture.counter == NULL) ? 0U : (uint16_t)(*capture.counter - *capture.capture);
+  }
+
+  #define TRIGGER_PRI_CAPTURE_AGE()   triggerCaptureAge(triggerCapturePri)
+  #define TRIGGER_SEC_CAPTURE_AGE()   triggerCaptureAge(triggerCaptureSec)
+  #define TRIGGER_THIRD_CAPTURE_AGE() triggerCaptureAge(triggerCaptureThird)
+
+  void initTriggerCapture(void);
+#endif
+
 /*
 ***********************************************************************************************************
 * CAN / Second serial
@@ -316,14 +316,14 @@ void ftm0_isr(void)
   bool interrupt7 = (FTM0_C6SC & FTM_CSC_CHF);
   bool interrupt8 = (FTM0_C7SC & FTM_CSC_CHF);
 
-  if(interrupt1) { FTM0_C0SC &= ~FTM_CSC_CHF; fuelSchedule1Interrupt(); }
-  else if(interrupt2) { FTM0_C1SC &= ~FTM_CSC_CHF; fuelSchedule2Interrupt(); }
-  else if(interrupt3) { FTM0_C2SC &= ~FTM_CSC_CHF; fuelSchedule3Interrupt(); }
-  else if(interrupt4) { FTM0_C3SC &= ~FTM_CSC_CHF; fuelSchedule4Interrupt(); }
-  else if(interrupt5) { FTM0_C4SC &= ~FTM_CSC_CHF; ignitionSchedule1Interrupt(); }
-  else if(interrupt6) { FTM0_C5SC &= ~FTM_CSC_CHF; ignitionSchedule2Interrupt(); }
-  else if(interrupt7) { FTM0_C6SC &= ~FTM_CSC_CHF; ignitionSchedule3Interrupt(); }
-  else if(interrupt8) { FTM0_C7SC &= ~FTM_CSC_CHF; ignitionSchedule4Interrupt(); }
+  if(interrupt1) { FTM0_C0SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<1>(); }
+  else if(interrupt2) { FTM0_C1SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<2>(); }
+  else if(interrupt3) { FTM0_C2SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<3>(); }
+  else if(interrupt4) { FTM0_C3SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<4>(); }
+  else if(interrupt5) { FTM0_C4SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<1>(); }
+  else if(interrupt6) { FTM0_C5SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<2>(); }
+  else if(interrupt7) { FTM0_C6SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<3>(); }
+  else if(interrupt8) { FTM0_C7SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<4>(); }
 
 }
 void ftm3_isr(void)
@@ -331,35 +331,35 @@ void ftm3_isr(void)
 
 #if (INJ_CHANNELS >= 5)
   bool interrupt1 = (FTM3_C0SC & FTM_CSC_CHF);
-  if(interrupt1) { FTM3_C0SC &= ~FTM_CSC_CHF; fuelSchedule5Interrupt(); }
+  if(interrupt1) { FTM3_C0SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<5>(); }
 #endif
 #if (INJ_CHANNELS >= 6)
   bool interrupt2 = (FTM3_C1SC & FTM_CSC_CHF);
-  if(interrupt2) { FTM3_C1SC &= ~FTM_CSC_CHF; fuelSchedule6Interrupt(); }
+  if(interrupt2) { FTM3_C1SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<6>(); }
 #endif
 #if (INJ_CHANNELS >= 7)
   bool interrupt3 = (FTM3_C2SC & FTM_CSC_CHF);
-  if(interrupt3) { FTM3_C2SC &= ~FTM_CSC_CHF; fuelSchedule7Interrupt(); }
+  if(interrupt3) { FTM3_C2SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<7>(); }
 #endif
 #if (INJ_CHANNELS >= 8)
   bool interrupt4 = (FTM3_C3SC & FTM_CSC_CHF);
-  if(interrupt4) { FTM3_C3SC &= ~FTM_CSC_CHF; fuelSchedule8Interrupt(); }
+  if(interrupt4) { FTM3_C3SC &= ~FTM_CSC_CHF; fuelScheduleInterrupt<8>(); }
 #endif
 #if (IGN_CHANNELS >= 5)
   bool interrupt5 = (FTM3_C4SC & FTM_CSC_CHF);
-  if(interrupt5) { FTM3_C4SC &= ~FTM_CSC_CHF; ignitionSchedule5Interrupt(); }
+  if(interrupt5) { FTM3_C4SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<5>(); }
 #endif
 #if (IGN_CHANNELS >= 6)
   bool interrupt6 = (FTM3_C5SC & FTM_CSC_CHF);
-  if(interrupt6) { FTM3_C5SC &= ~FTM_CSC_CHF; ignitionSchedule6Interrupt(); }
+  if(interrupt6) { FTM3_C5SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<6>(); }
 #endif
 #if (IGN_CHANNELS >= 7)
   bool interrupt7 = (FTM3_C6SC & FTM_CSC_CHF);
-  if(interrupt7) { FTM3_C6SC &= ~FTM_CSC_CHF; ignitionSchedule7Interrupt(); }
+  if(interrupt7) { FTM3_C6SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<7>(); }
 #endif
 #if (IGN_CHANNELS >= 8)
   bool interrupt8 = (FTM3_C7SC & FTM_CSC_CHF);
-  if(interrupt8) { FTM3_C7SC &= ~FTM_CSC_CHF; ignitionSchedule8Interrupt(); }
+  if(interrupt8) { FTM3_C7SC &= ~FTM_CSC_CHF; ignitionScheduleInterrupt<8>(); }
 #endif
 
 }
@@ -4,6 +4,7 @@
 #include "auxiliaries.h"
 #include "idle.h"
 #include "scheduler.h"
+#include "schedule_queue.h"
 #include "timers.h"
 #include "comms_secondary.h"
 
@@ -15,10 +16,14 @@ FlexCAN_T4<CAN3, RX_SIZE_256, TX_SIZE_16> Can2;
 */
 
 static void PIT_isr();
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+static void GPT1_isr(void);
+#else
 static void TMR1_isr(void);
 static void TMR2_isr(void);
 static void TMR3_isr(void);
 static void TMR4_isr(void);
+#endif
 
 void initBoard()
 {
@@ -100,6 +105,19 @@ void initBoard()
     ***********************************************************************************************************
     * Schedules
     */
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+    //Use GPT1, clocked from the 24MHz oscillator. 24MHz / 12 (PRESCALER24M) / 2 (PRESCALER) = 1MHz, a 1uS tick
+    CCM_CCGR1 |= CCM_CCGR1_GPT1_BUS(CCM_CCGR_ON) | CCM_CCGR1_GPT1_SERIAL(CCM_CCGR_ON);
+    GPT1_CR = 0;
+    GPT1_IR = 0;
+    GPT1_SR = 0x3F; //Clear all status flags
+    GPT1_PR = GPT_PR_PRESCALER24M(11) | GPT_PR_PRESCALER(1);
+    GPT1_CR = GPT_CR_EN_24M | GPT_CR_CLKSRC(5) | GPT_CR_FRR; //Free run mode, so a compare match (Or writing the compare) does not reset the counter
+    GPT1_CR |= GPT_CR_EN; //Start the timer
+
+    attachInterruptVector(IRQ_GPT1, GPT1_isr);
+    NVIC_ENABLE_IRQ(IRQ_GPT1);
+#else
     //Use the Quad timer
     //Uses the BUS clock speed, which is 1/4 of the CPU clock. Maximum prescaler of 128 is used to give a 0.853333uS tick time @ 600Mhz
     //TMR1 - Fuel 1-4
@@ -211,6 +229,7 @@ void initBoard()
     NVIC_ENABLE_IRQ(IRQ_QTIMER3);
     attachInterruptVector(IRQ_QTIMER4, TMR4_isr);
     NVIC_ENABLE_IRQ(IRQ_QTIMER4);
+#endif
 }
 
 void PIT_isr()
@@ -227,6 +246,15 @@ void PIT_isr()
   asm volatile ("dsb") ;
 }
 
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+void GPT1_isr(void)
+{
+  //Only output compare 1 is used, by the schedule queue
+  GPT1_SR = GPT_SR_OF1;
+  scheduleQueueInterrupt();
+  asm volatile ("dsb");
+}
+#else
 void TMR1_isr(void)
 {
   //TMR1 is fuel channels 1-4
@@ -235,10 +263,10 @@ void TMR1_isr(void)
   bool interrupt3 = (TMR1_CSCTRL2 & TMR_CSCTRL_TCF1);
   bool interrupt4 = (TMR1_CSCTRL3 & TMR_CSCTRL_TCF1);
 
-  if(interrupt1)      { TMR1_CSCTRL0 &= ~TMR_CSCTRL_TCF1; fuelSchedule1Interrupt(); }
-  else if(interrupt2) { TMR1_CSCTRL1 &= ~TMR_CSCTRL_TCF1; fuelSchedule2Interrupt(); }
-  else if(interrupt3) { TMR1_CSCTRL2 &= ~TMR_CSCTRL_TCF1; fuelSchedule3Interrupt(); }
-  else if(interrupt4) { TMR1_CSCTRL3 &= ~TMR_CSCTRL_TCF1; fuelSchedule4Interrupt(); }
+  if(interrupt1)      { TMR1_CSCTRL0 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<1>(); }
+  else if(interrupt2) { TMR1_CSCTRL1 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<2>(); }
+  else if(interrupt3) { TMR1_CSCTRL2 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<3>(); }
+  else if(interrupt4) { TMR1_CSCTRL3 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<4>(); }
 }
 void TMR2_isr(void)
 {
@@ -248,10 +276,10 @@ void TMR2_isr(void)
   bool interrupt3 = (TMR2_CSCTRL2 & TMR_CSCTRL_TCF1);
   bool interrupt4 = (TMR2_CSCTRL3 & TMR_CSCTRL_TCF1);
 
-  if(interrupt1)      { TMR2_CSCTRL0 &= ~TMR_CSCTRL_TCF1; ignitionSchedule1Interrupt(); }
-  else if(interrupt2) { TMR2_CSCTRL1 &= ~TMR_CSCTRL_TCF1; ignitionSchedule2Interrupt(); }
-  else if(interrupt3) { TMR2_CSCTRL2 &= ~TMR_CSCTRL_TCF1; ignitionSchedule3Interrupt(); }
-  else if(interrupt4) { TMR2_CSCTRL3 &= ~TMR_CSCTRL_TCF1; ignitionSchedule4Interrupt(); }
+  if(interrupt1)      { TMR2_CSCTRL0 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<1>(); }
+  else if(interrupt2) { TMR2_CSCTRL1 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<2>(); }
+  else if(interrupt3) { TMR2_CSCTRL2 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<3>(); }
+  else if(interrupt4) { TMR2_CSCTRL3 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<4>(); }
 }
 void TMR3_isr(void)
 {
@@ -261,10 +289,10 @@ void TMR3_isr(void)
   bool interrupt3 = (TMR3_CSCTRL2 & TMR_CSCTRL_TCF1);
   bool interrupt4 = (TMR3_CSCTRL3 & TMR_CSCTRL_TCF1);
 
-  if(interrupt1)      { TMR3_CSCTRL0 &= ~TMR_CSCTRL_TCF1; fuelSchedule5Interrupt(); }
-  else if(interrupt2) { TMR3_CSCTRL1 &= ~TMR_CSCTRL_TCF1; fuelSchedule6Interrupt(); }
-  else if(interrupt3) { TMR3_CSCTRL2 &= ~TMR_CSCTRL_TCF1; fuelSchedule7Interrupt(); }
-  else if(interrupt4) { TMR3_CSCTRL3 &= ~TMR_CSCTRL_TCF1; fuelSchedule8Interrupt(); }
+  if(interrupt1)      { TMR3_CSCTRL0 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<5>(); }
+  else if(interrupt2) { TMR3_CSCTRL1 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<6>(); }
+  else if(interrupt3) { TMR3_CSCTRL2 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<7>(); }
+  else if(interrupt4) { TMR3_CSCTRL3 &= ~TMR_CSCTRL_TCF1; fuelScheduleInterrupt<8>(); }
 }
 void TMR4_isr(void)
 {
@@ -274,11 +302,12 @@ void TMR4_isr(void)
   bool interrupt3 = (TMR4_CSCTRL2 & TMR_CSCTRL_TCF1);
   bool interrupt4 = (TMR4_CSCTRL3 & TMR_CSCTRL_TCF1);
 
-  if(interrupt1)      { TMR4_CSCTRL0 &= ~TMR_CSCTRL_TCF1; ignitionSchedule5Interrupt(); }
-  else if(interrupt2) { TMR4_CSCTRL1 &= ~TMR_CSCTRL_TCF1; ignitionSchedule6Interrupt(); }
-  else if(interrupt3) { TMR4_CSCTRL2 &= ~TMR_CSCTRL_TCF1; ignitionSchedule7Interrupt(); }
-  else if(interrupt4) { TMR4_CSCTRL3 &= ~TMR_CSCTRL_TCF1; ignitionSchedule8Interrupt(); }
+  if(interrupt1)      { TMR4_CSCTRL0 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<5>(); }
+  else if(interrupt2) { TMR4_CSCTRL1 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<6>(); }
+  else if(interrupt3) { TMR4_CSCTRL2 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<7>(); }
+  else if(interrupt4) { TMR4_CSCTRL3 &= ~TMR_CSCTRL_TCF1; ignitionScheduleInterrupt<8>(); }
 }
+#endif
 
 uint16_t freeRam()
 {
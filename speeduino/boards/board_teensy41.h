@@ -15,8 +15,18 @@
   time_t getTeensy3Time();
   #define PORT_TYPE uint32_t //Size of the port variables
   #define PINMASK_TYPE uint32_t
-  #define COMPARE_TYPE uint16_t
-  #define COUNTER_TYPE uint16_t
+  //#define USE_SCHEDULE_TIMER_32BIT //Run the schedules from the 32-bit GPT1 at 1uS instead of the 16-bit quad timers. Can also be set in build_flags
+  #if defined(USE_SCHEDULE_TIMER_32BIT)
+    #if !defined(USE_SCHEDULE_QUEUE)
+      #define USE_SCHEDULE_QUEUE //GPT1 only has 3 compares, so every schedule shares the first one (See schedule_queue.h)
+    #endif
+    #define COMPARE_TYPE uint32_t
+    #define COUNTER_TYPE uint32_t
+    #define AUX_COMPARE_TYPE uint16_t
+  #else
+    #define COMPARE_TYPE uint16_t
+    #define COUNTER_TYPE uint16_t
+  #endif
   #define SERIAL_BUFFER_SIZE 517 //Size of the serial buffer used by new comms protocol. For SD transfers this must be at least 512 + 1 (flag) + 4 (sector)
   #define FPU_MAX_SIZE 32 //Size of the FPU buffer. 0 means no FPU.
   #define BOARD_MAX_DIGITAL_PINS 54
@@ -119,6 +129,19 @@
   static inline void IGN7_TIMER_DISABLE(void)  {TMR4_CSCTRL2 &= ~TMR_CSCTRL_TCF1EN;}
   static inline void IGN8_TIMER_DISABLE(void)  {TMR4_CSCTRL3 &= ~TMR_CSCTRL_TCF1EN;}
 
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+  /*
+  GPT1 free runs from the 24MHz oscillator divided down to 1MHz, so there is no rounding between uS and ticks.
+  Output compare 1 is loaded with the next schedule that is due by the schedule queue
+  */
+  #define SCHEDULE_QUEUE_COUNTER  GPT1_CNT
+  #define SCHEDULE_QUEUE_COMPARE  GPT1_OCR1
+  static inline void SCHEDULE_QUEUE_TIMER_ENABLE(void)  { GPT1_IR |= GPT_IR_OF1IE; }
+  static inline void SCHEDULE_QUEUE_TIMER_DISABLE(void) { GPT1_IR &= ~GPT_IR_OF1IE; }
+
+  #define MAX_TIMER_PERIOD 4294967295UL //(2^32 - 1) * 1uS, over 71 minutes
+  #define uS_TO_TIMER_COMPARE(uS) (uS) //1 tick = 1uS
+#else
   //Bus Clock is 150Mhz @ 600 Mhz CPU. Need to handle this dynamically in the future for other frequencies
   //#define TMR_PRESCALE  128
   //#define MAX_TIMER_PERIOD ((65535 * 1000000ULL) / (F_BUS_ACTUAL / TMR_PRESCALE)) //55923 @ 600Mhz. 
@@ -130,6 +153,7 @@
   Divide 2^6 by the time per tick (0.853333) = 75
   Multiply and bitshift back by the precision: (uS * 75) >> 6
   */
+#endif
 
 /*
 ***********************************************************************************************************
@@ -18,6 +18,7 @@ A full copy of the license may be found in the projects root directory
 #include "pages.h"
 #include "page_crc.h"
 #include "logger.h"
+#include "toothLogRing.h"
 #include "comms_legacy.h"
 #include "src/FastCRC/FastCRC.h"
 #include <avr/pgmspace.h>
@@ -609,7 +610,7 @@ void processSerialCommand(void)
 
     case 'd': // Send a CRC32 hash of a given page
     {
-      uint32_t CRC32_val = reverse_bytes(calculatePageCRC32( serialPayload[2] ));
+      uint32_t CRC32_val = reverse_bytes(getPageCRC32( serialPayload[2] ));
 
       serialPayload[0] = SERIAL_RC_OK;
       (void)memcpy(&serialPayload[1], (byte*)&CRC32_val, sizeof(CRC32_val));
@@ -908,6 +909,7 @@ void processSerialCommand(void)
       {
         sendReturnCodeMsg(SERIAL_RC_RANGE_ERR);
       }
+      table2D_invalidateAll(); //The calibrations are used through 2D tables
       break;
     }
 
@@ -1073,15 +1075,14 @@ void processSerialCommand(void)
 */
 void sendToothLog(void)
 {
-  //We need TOOTH_LOG_SIZE number of records to send to TunerStudio. If there aren't that many in the buffer then we just return and wait for the next call
-  if (BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY) == false) 
+  //We need TOOTH_LOG_SIZE number of records to send to TunerStudio. Take them from the ring, which keeps logging while this block is sent
+  toothLogRingFill();
+
+  //If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
+  while(toothHistoryIndex < TOOTH_LOG_SIZE)
   {
-    //If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
-    while(toothHistoryIndex < TOOTH_LOG_SIZE)
-    {
-      toothHistory[toothHistoryIndex] = 0;
-      toothHistoryIndex++;
-    }
+    toothHistory[toothHistoryIndex] = 0;
+    toothHistoryIndex++;
   }
 
   uint32_t CRC32_val = 0U;
@@ -1111,9 +1112,8 @@ void sendToothLog(void)
     uint32_t transmitted = serialWrite(toothHistory[logItemsTransmitted]);
     CRC32_val = CRC32_serial.crc32_upd((const byte*)&transmitted, sizeof(transmitted), false);
   }
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
+  toothLogRingBlockSent();
   serialStatusFlag = SERIAL_INACTIVE;
-  toothHistoryIndex = 0;
   logItemsTransmitted = 0;
 
   //Apply the CRC reflection
@@ -1125,15 +1125,14 @@ void sendToothLog(void)
 
 void sendCompositeLog(void)
 {
-  if ( BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY) == false )
+  toothLogRingFill();
+
+  //If the buffer is not yet full but TS has timed out, pad the rest of the buffer
+  while(toothHistoryIndex < TOOTH_LOG_SIZE)
   {
-    //If the buffer is not yet full but TS has timed out, pad the rest of the buffer with 0s
-    while(toothHistoryIndex < TOOTH_LOG_SIZE)
-    {
-      toothHistory[toothHistoryIndex] = toothHistory[toothHistoryIndex-1U]; //Composite logger needs a realistic time value to display correctly. Copy the last value
-      compositeLogHistory[toothHistoryIndex] = 0U;
-      toothHistoryIndex++;
-    }
+    toothHistory[toothHistoryIndex] = (toothHistoryIndex > 0U) ? toothHistory[toothHistoryIndex-1U] : micros(); //Composite logger needs a realistic time value to display correctly. Copy the last value
+    compositeLogHistory[toothHistoryIndex] = 0U;
+    toothHistoryIndex++;
   }
 
   uint32_t CRC32_val = 0;
@@ -1167,8 +1166,7 @@ void sendCompositeLog(void)
     writeByteReliableBlocking(compositeLogHistory[logItemsTransmitted]);
     CRC32_val = CRC32_serial.crc32_upd((const byte*)&compositeLogHistory[logItemsTransmitted], sizeof(compositeLogHistory[logItemsTransmitted]), false);
   }
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-  toothHistoryIndex = 0;
+  toothLogRingBlockSent();
   serialStatusFlag = SERIAL_INACTIVE;
   logItemsTransmitted = 0;
 
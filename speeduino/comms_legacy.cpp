@@ -19,6 +19,7 @@ A full copy of the license may be found in the projects root directory
 #include "pages.h"
 #include "page_crc.h"
 #include "logger.h"
+#include "toothLogRing.h"
 #include "tables/table3d_axis_io.h"
 #include BOARD_H
 #ifdef RTC_ENABLED
@@ -103,7 +104,7 @@ void legacySerialCommand(void)
       if (primarySerial.available() >= 2)
       {
         primarySerial.read(); //Ignore the first byte value, it's always 0
-        uint32_t CRC32_val = calculatePageCRC32( primarySerial.read() );
+        uint32_t CRC32_val = getPageCRC32( primarySerial.read() );
         
         //Split the 4 bytes of the CRC32 value into individual bytes and send
         primarySerial.write( ((CRC32_val >> 24) & 255) );
@@ -558,7 +559,7 @@ void legacySerialHandler(byte cmd, Stream &targetPort, SerialStatus &targetStatu
       if (targetPort.available() >= 2)
       {
         targetPort.read(); //Ignore the first byte value, it's always 0
-        uint32_t CRC32_val = calculatePageCRC32( targetPort.read() );
+        uint32_t CRC32_val = getPageCRC32( targetPort.read() );
         
         //Split the 4 bytes of the CRC32 value into individual bytes and send
         targetPort.write( ((CRC32_val >> 24) & 255) );
@@ -1027,11 +1028,12 @@ namespace {
     primarySerial.println();
   }
 
-  void print_x_axis(void *pTable, table_type_t key)
+  template <typename table_t>
+  void print_x_axis(table_t *pTable)
   {
     primarySerial.print(F("    "));
 
-    auto x_it = x_begin(pTable, key);
+    auto x_it = pTable->axisX.begin();
     const table3d_axis_io_converter converter = get_table3d_axis_converter(x_it.get_domain());
 
     while(!x_it.at_end())
@@ -1041,10 +1043,11 @@ namespace {
     }
   }
 
-  void serial_print_3dtable(void *pTable, table_type_t key)
+  template <typename table_t>
+  void serial_print_3dtable(table_t *pTable)
   {
-    auto y_it = y_begin(pTable, key);
-    auto row_it = rows_begin(pTable, key);
+    auto y_it = pTable->axisY.begin();
+    auto row_it = pTable->values.begin();
 
     while (!row_it.at_end())
     {
@@ -1053,7 +1056,7 @@ namespace {
       ++row_it;
     }
 
-    print_x_axis(pTable, key);
+    print_x_axis(pTable);
     primarySerial.println();
   }
 }
@@ -1069,7 +1072,7 @@ void sendPageASCII(void)
   {
     case veMapPage:
       primarySerial.println(F("\nVE Map"));
-      serial_print_3dtable(&fuelTable, fuelTable.type_key);
+      serial_print_3dtable(&fuelTable);
       break;
 
     case veSetPage:
@@ -1090,7 +1093,7 @@ void sendPageASCII(void)
 
     case ignMapPage:
       primarySerial.println(F("\nIgnition Map"));
-      serial_print_3dtable(&ignitionTable, ignitionTable.type_key);
+      serial_print_3dtable(&ignitionTable);
       break;
 
     case ignSetPage:
@@ -1108,7 +1111,7 @@ void sendPageASCII(void)
 
     case afrMapPage:
       primarySerial.println(F("\nAFR Map"));
-      serial_print_3dtable(&afrTable, afrTable.type_key);
+      serial_print_3dtable(&afrTable);
       break;
 
     case afrSetPage:
@@ -1132,14 +1135,14 @@ void sendPageASCII(void)
 
     case boostvvtPage:
       primarySerial.println(F("\nBoost Map"));
-      serial_print_3dtable(&boostTable, boostTable.type_key);
+      serial_print_3dtable(&boostTable);
       primarySerial.println(F("\nVVT Map"));
-      serial_print_3dtable(&vvtTable, vvtTable.type_key);
+      serial_print_3dtable(&vvtTable);
       break;
 
     case seqFuelPage:
       primarySerial.println(F("\nTrim 1 Table"));
-      serial_print_3dtable(&trim1Table, trim1Table.type_key);
+      serial_print_3dtable(&trim1Table);
       break;
 
     case canbusPage:
@@ -1149,17 +1152,17 @@ void sendPageASCII(void)
 
     case fuelMap2Page:
       primarySerial.println(F("\n2nd Fuel Map"));
-      serial_print_3dtable(&fuelTable2, fuelTable2.type_key);
+      serial_print_3dtable(&fuelTable2);
       break;
    
     case ignMap2Page:
       primarySerial.println(F("\n2nd Ignition Map"));
-      serial_print_3dtable(&ignitionTable2, ignitionTable2.type_key);
+      serial_print_3dtable(&ignitionTable2);
       break;
 
     case boostvvtPage2:
       primarySerial.println(F("\nBoost lookup table"));
-      serial_print_3dtable(&boostTableLookupDuty, boostTableLookupDuty.type_key);
+      serial_print_3dtable(&boostTableLookupDuty);
       break;
 
     case warmupPage:
@@ -1272,6 +1275,7 @@ void sendToothLog_legacy(byte startOffset) /* Blocking */
   //We need TOOTH_LOG_SIZE number of records to send to TunerStudio. If there aren't that many in the buffer then we just return and wait for the next call
   if (BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY)) //Sanity check. Flagging system means this should always be true
   {
+      toothLogRingFill();
       serialStatusFlag = SERIAL_TRANSMIT_TOOTH_INPROGRESS_LEGACY; 
       for (uint8_t x = startOffset; x < TOOTH_LOG_SIZE; ++x)
       {
@@ -1280,9 +1284,8 @@ void sendToothLog_legacy(byte startOffset) /* Blocking */
         primarySerial.write(toothHistory[x] >> 8);
         primarySerial.write(toothHistory[x]);
       }
-      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
+      toothLogRingBlockSent();
       serialStatusFlag = SERIAL_INACTIVE; 
-      toothHistoryIndex = 0;
   }
   else 
   { 
@@ -1299,6 +1302,7 @@ void sendCompositeLog_legacy(byte startOffset) /* Non-blocking */
 {
   if (BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY)) //Sanity check. Flagging system means this should always be true
   {
+      toothLogRingFill();
       serialStatusFlag = SERIAL_TRANSMIT_COMPOSITE_INPROGRESS_LEGACY;
 
       for (uint8_t x = startOffset; x < TOOTH_LOG_SIZE; ++x)
@@ -1320,8 +1324,7 @@ void sendCompositeLog_legacy(byte startOffset) /* Non-blocking */
 
         primarySerial.write(compositeLogHistory[x]); //The status byte (Indicates the trigger edge, whether it was a pri/sec pulse, the sync status)
       }
-      BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-      toothHistoryIndex = 0;
+      toothLogRingBlockSent();
       serialStatusFlag = SERIAL_INACTIVE; 
   }
   else 
@@ -6,24 +6,25 @@
 #include "config.h"
 #include "storage.h"
 #include "pages.h"
+#include "page_crc.h"
 
 
 
 const byte data_structure_version = 2; //This identifies the data structure when reading / writing. (outdated ?)
 
-struct table3d16RpmLoad fuelTable; 				///< 16x16 fuel map
-struct table3d16RpmLoad fuelTable2; 			///< 16x16 fuel map
-struct table3d16RpmLoad ignitionTable; 			///< 16x16 ignition map
-struct table3d16RpmLoad ignitionTable2; 		///< 16x16 ignition map
-struct table3d16RpmLoad afrTable; 				///< 16x16 afr target map
-struct table3d8RpmLoad stagingTable; 			///< 8x8 fuel staging table
+table3d16RpmLoad fuelTable; 				///< 16x16 fuel map
+table3d16RpmLoad fuelTable2; 			///< 16x16 fuel map
+table3d16RpmLoad ignitionTable; 			///< 16x16 ignition map
+table3d16RpmLoad ignitionTable2; 		///< 16x16 ignition map
+table3d16RpmLoad afrTable; 				///< 16x16 afr target map
+table3d8RpmLoad stagingTable; 			///< 8x8 fuel staging table
 
-struct table3d8RpmLoad boostTable; 			 	///< 8x8 boost map
-struct table3d8RpmLoad boostTableLookupDuty; 	///< 8x8 boost map lookup table
+table3d8RpmLoad boostTable; 			 	///< 8x8 boost map
+table3d8RpmLoad boostTableLookupDuty; 	///< 8x8 boost map lookup table
 
-struct table3d8RpmLoad vvtTable; 				///< 8x8 vvt map
-struct table3d8RpmLoad vvt2Table; 				///< 8x8 vvt2 map
-struct table3d8RpmLoad wmiTable; 				///< 8x8 wmi map
+table3d8RpmLoad vvtTable; 				///< 8x8 vvt map
+table3d8RpmLoad vvt2Table; 				///< 8x8 vvt2 map
+table3d8RpmLoad wmiTable; 				///< 8x8 wmi map
 
 trimTable3d trim1Table; 						///< 6x6 Fuel trim 1 map
 trimTable3d trim2Table; 						///< 6x6 Fuel trim 2 map
@@ -34,7 +35,12 @@ trimTable3d trim6Table; 						///< 6x6 Fuel trim 6 map
 trimTable3d trim7Table; 						///< 6x6 Fuel trim 7 map
 trimTable3d trim8Table; 						///< 6x6 Fuel trim 8 map
 
-struct table3d4RpmLoad dwellTable; 				///< 4x4 Dwell map
+static trimTable3d * const trimTables[] = { &trim1Table, &trim2Table, &trim3Table, &trim4Table, &trim5Table, &trim6Table, &trim7Table, &trim8Table };
+table3d_shared_axes<trimTable3d, 8> trimTableAxes(trimTables);			///< Axis search shared by the trim tables
+static table3d16RpmLoad * const fuelAfrTables[] = { &fuelTable, &afrTable };
+table3d_shared_axes<table3d16RpmLoad, 2> fuelAfrTableAxes(fuelAfrTables);	///< Axis search shared by the fuel & AFR tables
+
+table3d4RpmLoad dwellTable; 				///< 4x4 Dwell map
 
 struct table2D taeTable; 						///< 4 bin TPS Acceleration Enrichment map (2D)
 
@@ -66,6 +72,8 @@ struct table2D wmiAdvTable; 					//6 bin wmi correction table for timing advance
 struct table2D coolantProtectTable;
 struct table2D fanPWMTable;
 struct table2D rollingCutTable;
+struct table2D splitInjPercentTable[2]; 		///< 4 bin split injection fuel share for pulses 2 and 3 (2D)
+struct table2D splitInjAngleTable[2]; 			///< 4 bin split injection angle before pulses 2 and 3 (2D)
 
 struct config2 configPage2;
 struct config4 configPage4;
@@ -103,72 +111,75 @@ void storeEEPROMVersion(byte newVersion) { EEPROM.update(EEPROM_DATA_VERSION, ne
  */
 void loadConfig(void)
 {
-  loadTable(&fuelTable, decltype(fuelTable)::type_key, EEPROM_CONFIG1_MAP);
-  load_range(EEPROM_CONFIG2_START, (byte *)&configPage2, (byte *)&configPage2+sizeof(configPage2));
+  Storage.loadTable(&fuelTable, EEPROM_CONFIG1_MAP);
+  Storage.load_range(EEPROM_CONFIG2_START, (byte *)&configPage2, (byte *)&configPage2+sizeof(configPage2));
 
   //*********************************************************************************************************************************************************************************
   //IGNITION CONFIG PAGE (2)
 
-  loadTable(&ignitionTable, decltype(ignitionTable)::type_key, EEPROM_CONFIG3_MAP);
-  load_range(EEPROM_CONFIG4_START, (byte *)&configPage4, (byte *)&configPage4+sizeof(configPage4));
+  Storage.loadTable(&ignitionTable, EEPROM_CONFIG3_MAP);
+  Storage.load_range(EEPROM_CONFIG4_START, (byte *)&configPage4, (byte *)&configPage4+sizeof(configPage4));
 
   //*********************************************************************************************************************************************************************************
   //AFR TARGET CONFIG PAGE (3)
 
-  loadTable(&afrTable, decltype(afrTable)::type_key, EEPROM_CONFIG5_MAP);
-  load_range(EEPROM_CONFIG6_START, (byte *)&configPage6, (byte *)&configPage6+sizeof(configPage6));
+  Storage.loadTable(&afrTable, EEPROM_CONFIG5_MAP);
+  Storage.load_range(EEPROM_CONFIG6_START, (byte *)&configPage6, (byte *)&configPage6+sizeof(configPage6));
 
   //*********************************************************************************************************************************************************************************
   // Boost and vvt tables load
-  loadTable(&boostTable, decltype(boostTable)::type_key, EEPROM_CONFIG7_MAP1);
-  loadTable(&vvtTable, decltype(vvtTable)::type_key,  EEPROM_CONFIG7_MAP2);
-  loadTable(&stagingTable, decltype(stagingTable)::type_key, EEPROM_CONFIG7_MAP3);
+  Storage.loadTable(&boostTable, EEPROM_CONFIG7_MAP1);
+  Storage.loadTable(&vvtTable,  EEPROM_CONFIG7_MAP2);
+  Storage.loadTable(&stagingTable, EEPROM_CONFIG7_MAP3);
 
   //*********************************************************************************************************************************************************************************
   // Fuel trim tables load
-  loadTable(&trim1Table, decltype(trim1Table)::type_key, EEPROM_CONFIG8_MAP1);
-  loadTable(&trim2Table, decltype(trim2Table)::type_key, EEPROM_CONFIG8_MAP2);
-  loadTable(&trim3Table, decltype(trim3Table)::type_key, EEPROM_CONFIG8_MAP3);
-  loadTable(&trim4Table, decltype(trim4Table)::type_key, EEPROM_CONFIG8_MAP4);
-  loadTable(&trim5Table, decltype(trim5Table)::type_key, EEPROM_CONFIG8_MAP5);
-  loadTable(&trim6Table, decltype(trim6Table)::type_key, EEPROM_CONFIG8_MAP6);
-  loadTable(&trim7Table, decltype(trim7Table)::type_key, EEPROM_CONFIG8_MAP7);
-  loadTable(&trim8Table, decltype(trim8Table)::type_key, EEPROM_CONFIG8_MAP8);
+  Storage.loadTable(&trim1Table, EEPROM_CONFIG8_MAP1);
+  Storage.loadTable(&trim2Table, EEPROM_CONFIG8_MAP2);
+  Storage.loadTable(&trim3Table, EEPROM_CONFIG8_MAP3);
+  Storage.loadTable(&trim4Table, EEPROM_CONFIG8_MAP4);
+  Storage.loadTable(&trim5Table, EEPROM_CONFIG8_MAP5);
+  Storage.loadTable(&trim6Table, EEPROM_CONFIG8_MAP6);
+  Storage.loadTable(&trim7Table, EEPROM_CONFIG8_MAP7);
+  Storage.loadTable(&trim8Table, EEPROM_CONFIG8_MAP8);
 
   //*********************************************************************************************************************************************************************************
   //canbus control page load
-  load_range(EEPROM_CONFIG9_START, (byte *)&configPage9, (byte *)&configPage9+sizeof(configPage9));
+  Storage.load_range(EEPROM_CONFIG9_START, (byte *)&configPage9, (byte *)&configPage9+sizeof(configPage9));
 
   //*********************************************************************************************************************************************************************************
 
   //CONFIG PAGE (10)
-  load_range(EEPROM_CONFIG10_START, (byte *)&configPage10, (byte *)&configPage10+sizeof(configPage10));
+  Storage.load_range(EEPROM_CONFIG10_START, (byte *)&configPage10, (byte *)&configPage10+sizeof(configPage10));
 
   //*********************************************************************************************************************************************************************************
   //Fuel table 2 (See storage.h for data layout)
-  loadTable(&fuelTable2, decltype(fuelTable2)::type_key, EEPROM_CONFIG11_MAP);
+  Storage.loadTable(&fuelTable2, EEPROM_CONFIG11_MAP);
 
   //*********************************************************************************************************************************************************************************
   // WMI, VVT2 and Dwell table load
-  loadTable(&wmiTable, decltype(wmiTable)::type_key, EEPROM_CONFIG12_MAP);
-  loadTable(&vvt2Table, decltype(vvt2Table)::type_key, EEPROM_CONFIG12_MAP2);
-  loadTable(&dwellTable, decltype(dwellTable)::type_key, EEPROM_CONFIG12_MAP3);
+  Storage.loadTable(&wmiTable, EEPROM_CONFIG12_MAP);
+  Storage.loadTable(&vvt2Table, EEPROM_CONFIG12_MAP2);
+  Storage.loadTable(&dwellTable, EEPROM_CONFIG12_MAP3);
 
   //*********************************************************************************************************************************************************************************
   //CONFIG PAGE (13)
-  load_range(EEPROM_CONFIG13_START, (byte *)&configPage13, (byte *)&configPage13+sizeof(configPage13));
+  Storage.load_range(EEPROM_CONFIG13_START, (byte *)&configPage13, (byte *)&configPage13+sizeof(configPage13));
 
   //*********************************************************************************************************************************************************************************
   //SECOND IGNITION CONFIG PAGE (14)
 
-  loadTable(&ignitionTable2, decltype(ignitionTable2)::type_key, EEPROM_CONFIG14_MAP);
+  Storage.loadTable(&ignitionTable2, EEPROM_CONFIG14_MAP);
 
   //*********************************************************************************************************************************************************************************
   //CONFIG PAGE (15) + boost duty lookup table (LUT)
-  loadTable(&boostTableLookupDuty, decltype(boostTableLookupDuty)::type_key, EEPROM_CONFIG15_MAP);
-  load_range(EEPROM_CONFIG15_START, (byte *)&configPage15, (byte *)&configPage15+sizeof(configPage15));
+  Storage.loadTable(&boostTableLookupDuty, EEPROM_CONFIG15_MAP);
+  Storage.load_range(EEPROM_CONFIG15_START, (byte *)&configPage15, (byte *)&configPage15+sizeof(configPage15));
 
   //*********************************************************************************************************************************************************************************
+  //The 2D tables are built over the config pages that have just been loaded
+  table2D_invalidateAll();
+  invalidateAllPageCRC32();
 }
 
 /** Write a table or map to EEPROM storage.
@@ -213,7 +224,7 @@ void writeConfig(uint8_t pageNum)
       | Fuel table (See storage.h for data layout) - Page 1
       | 16x16 table itself + the 16 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&fuelTable, decltype(fuelTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG1_MAP));
+      result = Storage.writeTable(&fuelTable, result.changeWriteAddress(EEPROM_CONFIG1_MAP));
       break;
 
     case veSetPage:
@@ -221,7 +232,7 @@ void writeConfig(uint8_t pageNum)
       | Config page 2 (See storage.h for data layout)
       | 64 byte long config table
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage2, (byte *)&configPage2+sizeof(configPage2), result.changeWriteAddress(EEPROM_CONFIG2_START));
+      result = Storage.write_range((byte *)&configPage2, (byte *)&configPage2+sizeof(configPage2), result.changeWriteAddress(EEPROM_CONFIG2_START));
       break;
 
     case ignMapPage:
@@ -229,7 +240,7 @@ void writeConfig(uint8_t pageNum)
       | Ignition table (See storage.h for data layout) - Page 1
       | 16x16 table itself + the 16 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&ignitionTable, decltype(ignitionTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG3_MAP));
+      result = Storage.writeTable(&ignitionTable, result.changeWriteAddress(EEPROM_CONFIG3_MAP));
       break;
 
     case ignSetPage:
@@ -237,7 +248,7 @@ void writeConfig(uint8_t pageNum)
       | Config page 2 (See storage.h for data layout)
       | 64 byte long config table
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage4, (byte *)&configPage4+sizeof(configPage4), result.changeWriteAddress(EEPROM_CONFIG4_START));
+      result = Storage.write_range((byte *)&configPage4, (byte *)&configPage4+sizeof(configPage4), result.changeWriteAddress(EEPROM_CONFIG4_START));
       break;
 
     case afrMapPage:
@@ -245,7 +256,7 @@ void writeConfig(uint8_t pageNum)
       | AFR table (See storage.h for data layout) - Page 5
       | 16x16 table itself + the 16 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&afrTable, decltype(afrTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG5_MAP));
+      result = Storage.writeTable(&afrTable, result.changeWriteAddress(EEPROM_CONFIG5_MAP));
       break;
 
     case afrSetPage:
@@ -253,7 +264,7 @@ void writeConfig(uint8_t pageNum)
       | Config page 3 (See storage.h for data layout)
       | 64 byte long config table
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage6, (byte *)&configPage6+sizeof(configPage6), result.changeWriteAddress(EEPROM_CONFIG6_START));
+      result = Storage.write_range((byte *)&configPage6, (byte *)&configPage6+sizeof(configPage6), result.changeWriteAddress(EEPROM_CONFIG6_START));
       break;
 
     case boostvvtPage:
@@ -261,9 +272,9 @@ void writeConfig(uint8_t pageNum)
       | Boost and vvt tables (See storage.h for data layout) - Page 8
       | 8x8 table itself + the 8 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&boostTable, decltype(boostTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG7_MAP1));
-      result = writeTable(&vvtTable, decltype(vvtTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG7_MAP2));
-      result = writeTable(&stagingTable, decltype(stagingTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG7_MAP3));
+      result = Storage.writeTable(&boostTable, result.changeWriteAddress(EEPROM_CONFIG7_MAP1));
+      result = Storage.writeTable(&vvtTable, result.changeWriteAddress(EEPROM_CONFIG7_MAP2));
+      result = Storage.writeTable(&stagingTable, result.changeWriteAddress(EEPROM_CONFIG7_MAP3));
       break;
 
     case seqFuelPage:
@@ -271,14 +282,14 @@ void writeConfig(uint8_t pageNum)
       | Fuel trim tables (See storage.h for data layout) - Page 9
       | 6x6 tables itself + the 6 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&trim1Table, decltype(trim1Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP1));
-      result = writeTable(&trim2Table, decltype(trim2Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP2));
-      result = writeTable(&trim3Table, decltype(trim3Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP3));
-      result = writeTable(&trim4Table, decltype(trim4Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP4));
-      result = writeTable(&trim5Table, decltype(trim5Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP5));
-      result = writeTable(&trim6Table, decltype(trim6Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP6));
-      result = writeTable(&trim7Table, decltype(trim7Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP7));
-      result = writeTable(&trim8Table, decltype(trim8Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG8_MAP8));
+      result = Storage.writeTable(&trim1Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP1));
+      result = Storage.writeTable(&trim2Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP2));
+      result = Storage.writeTable(&trim3Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP3));
+      result = Storage.writeTable(&trim4Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP4));
+      result = Storage.writeTable(&trim5Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP5));
+      result = Storage.writeTable(&trim6Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP6));
+      result = Storage.writeTable(&trim7Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP7));
+      result = Storage.writeTable(&trim8Table, result.changeWriteAddress(EEPROM_CONFIG8_MAP8));
       break;
 
     case canbusPage:
@@ -286,7 +297,7 @@ void writeConfig(uint8_t pageNum)
       | Config page 10 (See storage.h for data layout)
       | 192 byte long config table
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage9, (byte *)&configPage9+sizeof(configPage9), result.changeWriteAddress(EEPROM_CONFIG9_START));
+      result = Storage.write_range((byte *)&configPage9, (byte *)&configPage9+sizeof(configPage9), result.changeWriteAddress(EEPROM_CONFIG9_START));
       break;
 
     case warmupPage:
@@ -294,7 +305,7 @@ void writeConfig(uint8_t pageNum)
       | Config page 11 (See storage.h for data layout)
       | 192 byte long config table
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage10, (byte *)&configPage10+sizeof(configPage10), result.changeWriteAddress(EEPROM_CONFIG10_START));
+      result = Storage.write_range((byte *)&configPage10, (byte *)&configPage10+sizeof(configPage10), result.changeWriteAddress(EEPROM_CONFIG10_START));
       break;
 
     case fuelMap2Page:
@@ -302,7 +313,7 @@ void writeConfig(uint8_t pageNum)
       | Fuel table 2 (See storage.h for data layout)
       | 16x16 table itself + the 16 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&fuelTable2, decltype(fuelTable2)::type_key, result.changeWriteAddress(EEPROM_CONFIG11_MAP));
+      result = Storage.writeTable(&fuelTable2, result.changeWriteAddress(EEPROM_CONFIG11_MAP));
       break;
 
     case wmiMapPage:
@@ -312,16 +323,16 @@ void writeConfig(uint8_t pageNum)
       | 8x8 VVT2 table + the 8 values along each of the axis
       | 4x4 Dwell table itself + the 4 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&wmiTable, decltype(wmiTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG12_MAP));
-      result = writeTable(&vvt2Table, decltype(vvt2Table)::type_key, result.changeWriteAddress(EEPROM_CONFIG12_MAP2));
-      result = writeTable(&dwellTable, decltype(dwellTable)::type_key, result.changeWriteAddress(EEPROM_CONFIG12_MAP3));
+      result = Storage.writeTable(&wmiTable, result.changeWriteAddress(EEPROM_CONFIG12_MAP));
+      result = Storage.writeTable(&vvt2Table, result.changeWriteAddress(EEPROM_CONFIG12_MAP2));
+      result = Storage.writeTable(&dwellTable, result.changeWriteAddress(EEPROM_CONFIG12_MAP3));
       break;
 
     case progOutsPage:
       /*---------------------------------------------------
       | Config page 13 (See storage.h for data layout)
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage13, (byte *)&configPage13+sizeof(configPage13), result.changeWriteAddress(EEPROM_CONFIG13_START));
+      result = Storage.write_range((byte *)&configPage13, (byte *)&configPage13+sizeof(configPage13), result.changeWriteAddress(EEPROM_CONFIG13_START));
       break;
 
     case ignMap2Page:
@@ -329,7 +340,7 @@ void writeConfig(uint8_t pageNum)
       | Ignition table (See storage.h for data layout) - Page 1
       | 16x16 table itself + the 16 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&ignitionTable2, decltype(ignitionTable2)::type_key, result.changeWriteAddress(EEPROM_CONFIG14_MAP));
+      result = Storage.writeTable(&ignitionTable2, result.changeWriteAddress(EEPROM_CONFIG14_MAP));
       break;
 
     case boostvvtPage2:
@@ -337,12 +348,12 @@ void writeConfig(uint8_t pageNum)
       | Boost duty cycle lookuptable (See storage.h for data layout) - Page 15
       | 8x8 table itself + the 8 values along each of the axis
       -----------------------------------------------------*/
-      result = writeTable(&boostTableLookupDuty, decltype(boostTableLookupDuty)::type_key, result.changeWriteAddress(EEPROM_CONFIG15_MAP));
+      result = Storage.writeTable(&boostTableLookupDuty, result.changeWriteAddress(EEPROM_CONFIG15_MAP));
 
       /*---------------------------------------------------
       | Config page 15 (See storage.h for data layout)
       -----------------------------------------------------*/
-      result = write_range((byte *)&configPage15, (byte *)&configPage15+sizeof(configPage15), result.changeWriteAddress(EEPROM_CONFIG15_START));
+      result = Storage.write_range((byte *)&configPage15, (byte *)&configPage15+sizeof(configPage15), result.changeWriteAddress(EEPROM_CONFIG15_START));
       break;
 
     default:
@@ -368,6 +379,7 @@ void resetConfigPages(void)
       entity = advance(entity);
     }
   }
+  invalidateAllPageCRC32();
 }
 
 /** Write all config pages to EEPROM.
@@ -378,7 +390,7 @@ void writeAllConfig(void)
   uint8_t page = 1U;
   writeConfig(page);
   page = page + 1;
-  while (page<pageCount && !isEepromWritePending())
+  while (page<pageCount && !Storage.isEepromWritePending())
   {
     writeConfig(page);
     page = page + 1;
@@ -402,6 +414,8 @@ void loadCalibration(void)
 
   EEPROM.get(EEPROM_CALIBRATION_CLT_BINS, cltCalibration_bins);
   EEPROM.get(EEPROM_CALIBRATION_CLT_VALUES, cltCalibration_values);
+
+  table2D_invalidateAll();
 }
 
 /** Write calibration tables to EEPROM.
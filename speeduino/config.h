@@ -10,23 +10,27 @@
 
 #include "tables/table2d.h"
 #include "tables/table3d.h"
+#include "tables/table3d_shared.h"
 
 //This can only be included after the above section
 #include BOARD_H //Note that this is not a real file, it is defined in globals.h. 
 
+//Build options set by the board file or build_flags:
+//USE_SCHEDULE_QUEUE: All schedules share one timer compare (See schedule_queue.h). Native board, or Teensy 4.1 / STM32F4 with USE_SCHEDULE_TIMER_32BIT only
+
 extern const byte data_structure_version; //This identifies the data structure when reading / writing. Now in use: CURRENT_DATA_VERSION (migration on-the fly) ?
 
-extern struct table3d16RpmLoad fuelTable; //16x16 fuel map
-extern struct table3d16RpmLoad fuelTable2; //16x16 fuel map
-extern struct table3d16RpmLoad ignitionTable; //16x16 ignition map
-extern struct table3d16RpmLoad ignitionTable2; //16x16 ignition map
-extern struct table3d16RpmLoad afrTable; //16x16 afr target map
-extern struct table3d8RpmLoad stagingTable; //8x8 fuel staging table
-extern struct table3d8RpmLoad boostTable; //8x8 boost map
-extern struct table3d8RpmLoad boostTableLookupDuty; //8x8 boost map
-extern struct table3d8RpmLoad vvtTable; //8x8 vvt map
-extern struct table3d8RpmLoad vvt2Table; //8x8 vvt map
-extern struct table3d8RpmLoad wmiTable; //8x8 wmi map
+extern table3d16RpmLoad fuelTable; //16x16 fuel map
+extern table3d16RpmLoad fuelTable2; //16x16 fuel map
+extern table3d16RpmLoad ignitionTable; //16x16 ignition map
+extern table3d16RpmLoad ignitionTable2; //16x16 ignition map
+extern table3d16RpmLoad afrTable; //16x16 afr target map
+extern table3d8RpmLoad stagingTable; //8x8 fuel staging table
+extern table3d8RpmLoad boostTable; //8x8 boost map
+extern table3d8RpmLoad boostTableLookupDuty; //8x8 boost map
+extern table3d8RpmLoad vvtTable; //8x8 vvt map
+extern table3d8RpmLoad vvt2Table; //8x8 vvt map
+extern table3d8RpmLoad wmiTable; //8x8 wmi map
 
 typedef table3d6RpmLoad trimTable3d; 
 
@@ -39,7 +43,10 @@ extern trimTable3d trim6Table; //6x6 Fuel trim 6 map
 extern trimTable3d trim7Table; //6x6 Fuel trim 7 map
 extern trimTable3d trim8Table; //6x6 Fuel trim 8 map
 
-extern struct table3d4RpmLoad dwellTable; //4x4 Dwell map
+extern table3d_shared_axes<trimTable3d, 8> trimTableAxes; //Shares the axis search between the trim tables (All looked up with fuelLoad & RPM)
+extern table3d_shared_axes<table3d16RpmLoad, 2> fuelAfrTableAxes; //Shares the axis search between fuelTable & afrTable (Both looked up with fuelLoad & RPM)
+
+extern table3d4RpmLoad dwellTable; //4x4 Dwell map
 extern struct table2D taeTable; //4 bin TPS Acceleration Enrichment map (2D)
 extern struct table2D maeTable;
 extern struct table2D WUETable; //10 bin Warm Up Enrichment map (2D)
@@ -68,6 +75,8 @@ extern struct table2D wmiAdvTable; //6 bin wmi correction table for timing advan
 extern struct table2D coolantProtectTable; //6 bin coolant temperature protection table for engine protection (2D)
 extern struct table2D fanPWMTable;
 extern struct table2D rollingCutTable;
+extern struct table2D splitInjPercentTable[2]; //4 bin split injection fuel share for pulses 2 and 3 vs coolant temperature (2D)
+extern struct table2D splitInjAngleTable[2]; //4 bin split injection angle before pulses 2 and 3 vs coolant temperature (2D)
 
 
 
@@ -826,9 +835,32 @@ struct config15 {
 
   int8_t rollingProtRPMDelta[4]; // Signed RPM value representing how much below the RPM limit. Divided by 10
   byte rollingProtCutPercent[4];
-  
-  //Bytes 106-255
-  byte Unused15_106_255[150];
+
+  //Bytes 106-127 - Split injection
+  byte splitInjEnable : 1;
+  byte splitInjPulses : 1; //0 = 2 pulses, 1 = 3 pulses
+  byte splitInjUnused : 6;
+  byte splitInjMaxRPM; //Split injection is only used below this RPM. Divided by 100
+  byte splitInjBins[4]; //Coolant temperature, offset by CALIBRATION_TEMPERATURE_OFFSET
+  byte splitInjPercent2[4]; //Share of the fuel in the 2nd pulse
+  byte splitInjPercent3[4]; //Share of the fuel in the 3rd pulse
+  byte splitInjAngle2[4]; //Crank degrees from the end of the 1st pulse to the start of the 2nd
+  byte splitInjAngle3[4]; //Crank degrees from the end of the 2nd pulse to the start of the 3rd
+
+  //Bytes 128-131 - Multi-spark
+  byte multiSparkEnable : 1;
+  byte multiSparkCount : 3; //Number of repeat sparks after the primary spark
+  byte multiSparkUnused : 4;
+  byte multiSparkMaxRPMdiv10; //Multi-spark is only used below this RPM
+  byte multiSparkAngle; //Crank degrees after the primary spark that the repeat sparks must fit within
+  byte multiSparkDwell; //Dwell of each repeat spark. ms * 10
+
+  //Byte 132 - Fast sync
+  byte fastSyncEnable : 1; //Start at half sync from the position the engine last stopped at (Missing tooth decoder only)
+  byte fastSyncUnused : 7;
+
+  //Bytes 133-255
+  byte Unused15_133_255[123];
 
 #if defined(CORE_AVR)
   };
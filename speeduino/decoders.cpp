@@ -40,6 +40,7 @@ A full copy of the license may be found in the projects root directory
 #include "config.h"
 
 #include "decoders.h"
+#include "toothLogRing.h"
 #include "scheduledIO.h"
 #include "scheduler.h"
 #include "crankMaths.h"
@@ -47,6 +48,7 @@ A full copy of the license may be found in the projects root directory
 #include "schedule_calcs.h"
 #include "schedule_calcs.hpp"
 #include "unit_testing.h"
+#include "storage.h"
 
 //#include "decoders/decoder_missingTooth.h"
 
@@ -74,9 +76,21 @@ triggerInfo_t	triggerInfo;
 
 #ifdef USE_LIBDIVIDE
 #include "src/libdivide/libdivide.h"
-static libdivide::libdivide_s16_t divtriggerInfo.triggerToothAngle;
+static libdivide::libdivide_s16_t divTriggerToothAngle;
 #endif
 
+#if !defined(CORE_AVR) //The lookup costs more RAM than AVR can spare for what its hardware multiply saves, so toothAngle() always calculates there
+  #define TOOTH_ANGLE_LOOKUP
+  #define TOOTH_ANGLE_LOOKUP_TEETH 60U //The most teeth an evenly spaced wheel can have and still use the tooth angle lookup
+static int16_t toothAngleLookup[2U * (TOOTH_ANGLE_LOOKUP_TEETH + 1U)]; //See initialiseToothAngles()
+static uint8_t toothAngleLookupTeeth = 0U; //0 if the wheel has too many teeth for the lookup
+#endif
+
+static uint8_t fastSyncTooth = 0U; //Fast sync: The tooth the engine last stopped on, until a start uses it. 0 if not known
+static bool fastSyncUnconfirmed = false; //Fast sync: Half sync came from fastSyncTooth and the missing tooth hasn't been seen since
+
+static uint16_t ignitionEndTeethCalc[8]; //The decoder's triggerSetEndTeeth writes the end teeth here. setIgnitionEndTeeth() copies them to triggerInfo.ignitionEndTeeth[]. Always 8 so the decoders can set channels 1-4 without checking IGN_CHANNELS
+
 /** Universal (shared between decoders) decoder routines.
 *
 * @defgroup dec_uni Universal Decoder Routines
@@ -85,77 +99,69 @@ static libdivide::libdivide_s16_t divtriggerInfo.triggerToothAngle;
 */
 // whichTooth - 0 for Primary (Crank), 1 for Secondary (Cam)
 
-/** Add tooth log entry to toothHistory (array).
+/** Add tooth log entry to the tooth log ring (See toothLogRing.h).
  * Enabled by (either) currentStatus.toothLogEnabled and currentStatus.compositeTriggerUsed.
  * @param toothTime - Tooth Time
  * @param whichTooth - 0 for Primary (Crank), 2 for Secondary (Cam) 3 for Tertiary (Cam)
  */
 static inline void addToothLogEntry(unsigned long toothTime, byte whichTooth)
 {
-  if(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY)) { return; }
   //High speed tooth logging history
-  if( (currentStatus.toothLogEnabled == true) || (currentStatus.compositeTriggerUsed > 0) ) 
+  if(currentStatus.toothLogEnabled == true)
   {
-    bool valueLogged = false;
-    if(currentStatus.toothLogEnabled == true)
+    //Tooth log only works on the Crank tooth
+    if(whichTooth == TOOTH_CRANK) { toothLogRingWrite(toothTime, 0U); }
+  }
+  else if(currentStatus.compositeTriggerUsed > 0)
+  {
+    uint8_t compositeStatus = 0;
+    if(currentStatus.compositeTriggerUsed == 4)
     {
-      //Tooth log only works on the Crank tooth
-      if(whichTooth == TOOTH_CRANK)
-      { 
-        toothHistory[toothHistoryIndex] = toothTime; //Set the value in the log. 
-        valueLogged = true;
-      } 
+      // we want to display both cams so swap the values round to display primary as cam1 and secondary as cam2, include the crank in the data as the third output
+      if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_PRI); }
+      if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SEC); }
+      if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_THIRD); }
+      if(whichTooth > TOOTH_CAM_SECONDARY) { BIT_SET(compositeStatus, COMPOSITE_LOG_TRIG); }
     }
-    else if(currentStatus.compositeTriggerUsed > 0)
+    else
     {
-      compositeLogHistory[toothHistoryIndex] = 0;
-      if(currentStatus.compositeTriggerUsed == 4)
-      {
-        // we want to display both cams so swap the values round to display primary as cam1 and secondary as cam2, include the crank in the data as the third output
-        if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_PRI); }
-        if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SEC); }
-        if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_THIRD); }
-        if(whichTooth > TOOTH_CAM_SECONDARY) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_TRIG); }
-      }
-      else
-      {
-        // we want to display crank and one of the cams
-        if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_PRI); }
-        if(currentStatus.compositeTriggerUsed == 3)
-        { 
-          // display cam2 and also log data for cam 1
-          if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SEC); } // only the COMPOSITE_LOG_SEC value is visualised hence the swapping of the data
-          if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_THIRD); } 
-        } 
-        else
-        { 
-          // display cam1 and also log data for cam 2 - this is the historic composite view
-          if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SEC); } 
-          if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_THIRD); }
-        }
-        if(whichTooth > TOOTH_CRANK) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_TRIG); }
-      }  
-      if(currentStatus.hasSync == true) { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_LOG_SYNC); }
-
-      if(triggerInfo.revolutionOne == 1)
-      { BIT_SET(compositeLogHistory[toothHistoryIndex], COMPOSITE_ENGINE_CYCLE);}
+      // we want to display crank and one of the cams
+      if(READ_PRI_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_PRI); }
+      if(currentStatus.compositeTriggerUsed == 3)
+      { 
+        // display cam2 and also log data for cam 1
+        if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SEC); } // only the COMPOSITE_LOG_SEC value is visualised hence the swapping of the data
+        if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_THIRD); } 
+      } 
       else
-      { BIT_CLEAR(compositeLogHistory[toothHistoryIndex], COMPOSITE_ENGINE_CYCLE);}
-
-      toothHistory[toothHistoryIndex] = micros();
-      valueLogged = true;
-    }
-
-    //If there has been a value logged above, update the indexes
-    if(valueLogged == true)
-    {
-     if(toothHistoryIndex < (TOOTH_LOG_SIZE-1)) { toothHistoryIndex++; BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
-     else { BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
-    }
+      { 
+        // display cam1 and also log data for cam 2 - this is the historic composite view
+        if(READ_SEC_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SEC); } 
+        if(READ_THIRD_TRIGGER() == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_THIRD); }
+      }
+      if(whichTooth > TOOTH_CRANK) { BIT_SET(compositeStatus, COMPOSITE_LOG_TRIG); }
+    }  
+    if(currentStatus.hasSync == true) { BIT_SET(compositeStatus, COMPOSITE_LOG_SYNC); }
+    if(triggerInfo.revolutionOne == 1) { BIT_SET(compositeStatus, COMPOSITE_ENGINE_CYCLE); }
 
+    toothLogRingWrite(micros(), compositeStatus);
+  }
+}
 
-  } //Tooth/Composite log enabled
+#if defined(ISR_PROFILING)
+/** Interrupt handler for primary trigger when neither logger is running.
+* Calls the decoder's handler, recording how long it took for the ISR profiler.
+*/
+void primaryTriggerISR(void)
+{
+  ISR_PROFILE_START();
+#if defined(TRIGGER_PRI_CAPTURE_AGE)
+  ISR_PROFILE_LATENCY_US(ISR_PROFILE_TRIGGER, TRIGGER_PRI_CAPTURE_AGE());
+#endif
+  triggerHandler();
+  ISR_PROFILE_END(ISR_PROFILE_TRIGGER);
 }
+#endif
 
 /** Interrupt handler for primary trigger.
 * This function is called on both the rising and falling edges of the primary trigger, when either the 
@@ -163,6 +169,7 @@ static inline void addToothLogEntry(unsigned long toothTime, byte whichTooth)
 */
 void loggerPrimaryISR(void)
 {
+  ISR_PROFILE_START();
   BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_VALID_TRIGGER); //This value will be set to the return value of the decoder function, indicating whether or not this pulse passed the filters
   bool validEdge = false; //This is set true below if the edge 
   /* 
@@ -190,6 +197,7 @@ void loggerPrimaryISR(void)
     //Composite logger adds an entry regardless of which edge it was
     addToothLogEntry(triggerInfo.curGap, TOOTH_CRANK);
   }
+  ISR_PROFILE_END(ISR_PROFILE_TRIGGER);
 }
 
 /** Interrupt handler for secondary trigger.
@@ -359,6 +367,58 @@ static inline uint16_t clampToActualTeeth(uint16_t toothNum, uint8_t toothAdder)
   return min(toothNum, (uint16_t)(triggerInfo.triggerActualTeeth + toothAdder));
 }
 
+/** Builds the tooth angle lookup and divider for an evenly spaced wheel, so that finding the angle of a tooth is a table
+* read and finding the tooth at an angle is a multiply (With libdivide). Called from the decoder setup once
+* triggerInfo.triggerToothAngle and configPage4.triggerTeeth are set.
+* The lookup holds the angle of teeth 0 to triggerTeeth from tooth 1 (Tooth 0 being the one before tooth 1), followed by
+* the same teeth on the second revolution, which are 360 degrees on for a crank speed wheel. There is no lookup on AVR.
+*/
+static void initialiseToothAngles(void)
+{
+#ifdef USE_LIBDIVIDE
+  divTriggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
+#endif
+#if defined(TOOTH_ANGLE_LOOKUP)
+  toothAngleLookupTeeth = 0U;
+  if( (configPage4.triggerTeeth == 0U) || (configPage4.triggerTeeth > TOOTH_ANGLE_LOOKUP_TEETH) ) { return; }
+
+  int16_t revolutionAngle = (configPage4.TrigSpeed == CRANK_SPEED) ? 360 : 0;
+  for(uint8_t tooth = 0U; tooth <= configPage4.triggerTeeth; tooth++)
+  {
+    toothAngleLookup[tooth] = ((int16_t)tooth - 1) * (int16_t)triggerInfo.triggerToothAngle;
+    toothAngleLookup[tooth + configPage4.triggerTeeth + 1U] = toothAngleLookup[tooth] + revolutionAngle;
+  }
+  toothAngleLookupTeeth = configPage4.triggerTeeth;
+#endif
+}
+
+/** The angle of a tooth from tooth 1 on an evenly spaced wheel, plus 360 degrees if it is on the second revolution of a
+* crank speed wheel. See initialiseToothAngles()
+*/
+static inline int16_t toothAngle(uint16_t tooth, bool revolutionOne)
+{
+#if defined(TOOTH_ANGLE_LOOKUP)
+  if( (tooth <= toothAngleLookupTeeth) && (toothAngleLookupTeeth > 0U) )
+  {
+    return toothAngleLookup[revolutionOne ? (tooth + toothAngleLookupTeeth + 1U) : tooth];
+  }
+#endif
+  //No lookup, too many teeth for it, or a tooth count from before sync
+  int16_t angle = ((int16_t)tooth - 1) * (int16_t)triggerInfo.triggerToothAngle;
+  if( (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { angle += 360; }
+  return angle;
+}
+
+/** The number of whole teeth in an angle on an evenly spaced wheel. See initialiseToothAngles() */
+static inline int16_t toothAngleDivide(int16_t angle)
+{
+#ifdef USE_LIBDIVIDE
+  return libdivide::libdivide_s16_do(angle, &divTriggerToothAngle);
+#else
+  return angle / (int16_t)triggerInfo.triggerToothAngle;
+#endif
+}
+
 
 /** Compute RPM.
 * As nearly all the decoders use a common method of determining RPM (The time the last full revolution took) A common function is simpler.
@@ -439,51 +499,113 @@ For each ignition channel, a check is made whether we're at the relevant tooth a
 Only if both these conditions are met will the schedule be updated with the latest timing information.
 If it's the correct tooth, but the schedule is not yet started, calculate and an end compare value (This situation occurs when both the start and end of the ignition pulse happen after the end tooth, but before the next tooth)
 */
+static IgnitionSchedule * const perToothSchedules[IGN_CHANNELS] = {
+  &ignitionSchedule1,
+#if IGN_CHANNELS >= 2
+  &ignitionSchedule2,
+#endif
+#if IGN_CHANNELS >= 3
+  &ignitionSchedule3,
+#endif
+#if IGN_CHANNELS >= 4
+  &ignitionSchedule4,
+#endif
+#if IGN_CHANNELS >= 5
+  &ignitionSchedule5,
+#endif
+#if IGN_CHANNELS >= 6
+  &ignitionSchedule6,
+#endif
+#if IGN_CHANNELS >= 7
+  &ignitionSchedule7,
+#endif
+#if IGN_CHANNELS >= 8
+  &ignitionSchedule8,
+#endif
+};
+
 static inline void checkPerToothTiming(int16_t crankAngle, uint16_t currentTooth)
 {
   if ( (fixedCrankingOverride == 0) && (currentStatus.RPM > 0) )
   {
-    if ( (currentTooth == triggerInfo.ignition1EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule1, ignition1EndAngle, crankAngle);
-    }
-    else if ( (currentTooth == triggerInfo.ignition2EndTooth) )
+    //Several channels can share an end tooth (E.g. when the spark angles are within a tooth of each other), so every channel is checked
+    uint8_t channels = min(maxIgnOutputs, (uint8_t)IGN_CHANNELS);
+    for (uint8_t channel = 0U; channel < channels; ++channel)
     {
-      adjustCrankAngle(ignitionSchedule2, ignition2EndAngle, crankAngle);
-    }
-    else if ( (currentTooth == triggerInfo.ignition3EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule3, ignition3EndAngle, crankAngle);
-    }
-    else if ( (currentTooth == triggerInfo.ignition4EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule4, ignition4EndAngle, crankAngle);
+      if (currentTooth == triggerInfo.ignitionEndTeeth[channel].tooth)
+      {
+        //crankAngle is the angle at the tooth edge (triggerInfo.curTime), not now. Only timed on the few teeth that end a spark
+        adjustCrankAngle(*perToothSchedules[channel], triggerInfo.ignitionEndTeeth[channel].endAngle, crankAngle, micros() - triggerInfo.curTime);
+      }
     }
+  }
+}
+
+void setIgnitionEndTeeth(void)
+{
+  //The teeth are calculated outside of the critical section and copied in with their angles, so the trigger interrupt never sees a tooth with the angle it replaces
+  triggerSetEndTeeth();
+
+  const int endAngles[IGN_CHANNELS] = {
+    ignition1EndAngle,
+#if IGN_CHANNELS >= 2
+    ignition2EndAngle,
+#endif
+#if IGN_CHANNELS >= 3
+    ignition3EndAngle,
+#endif
+#if IGN_CHANNELS >= 4
+    ignition4EndAngle,
+#endif
 #if IGN_CHANNELS >= 5
-    else if ( (currentTooth == triggerInfo.ignition5EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule5, ignition5EndAngle, crankAngle);
-    }
+    ignition5EndAngle,
 #endif
 #if IGN_CHANNELS >= 6
-    else if ( (currentTooth == triggerInfo.ignition6EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule6, ignition6EndAngle, crankAngle);
-    }
+    ignition6EndAngle,
 #endif
 #if IGN_CHANNELS >= 7
-    else if ( (currentTooth == triggerInfo.ignition7EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule7, ignition7EndAngle, crankAngle);
-    }
+    ignition7EndAngle,
 #endif
 #if IGN_CHANNELS >= 8
-    else if ( (currentTooth == triggerInfo.ignition8EndTooth) )
-    {
-      adjustCrankAngle(ignitionSchedule8, ignition8EndAngle, crankAngle);
-    }
+    ignition8EndAngle,
 #endif
+  };
+
+  noInterrupts();
+  for (uint8_t channel = 0U; channel < IGN_CHANNELS; ++channel)
+  {
+    triggerInfo.ignitionEndTeeth[channel].tooth = ignitionEndTeethCalc[channel];
+    triggerInfo.ignitionEndTeeth[channel].endAngle = endAngles[channel];
   }
+  interrupts();
+}
+
+/** Fast sync (Missing tooth decoder only). Only a position the decoder had synced on is saved, anything else (Including a
+ * fast sync position that was never confirmed) clears it. The wheel's tooth count is saved alongside the tooth so that a
+ * position is never used with a different wheel.
+ * The position is only known if the ECU is still powered when the engine stops.
+ */
+void triggerStoreStopPosition(void)
+{
+  uint8_t tooth = 0U;
+  if( (configPage15.fastSyncEnable == true) && (configPage4.TrigPattern == DECODER_MISSING_TOOTH) && (fastSyncUnconfirmed == false) && ((currentStatus.hasSync == true) || BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC)) )
+  {
+    tooth = (uint8_t)triggerInfo.toothCurrentCount;
+  }
+  fastSyncTooth = tooth;
+  fastSyncUnconfirmed = false;
+  if(configPage15.fastSyncEnable == false) { return; } //Storage is only written while fast sync is in use
+
+  Storage.storeTriggerStopPosition(((uint16_t)configPage4.triggerTeeth << 8U) | tooth);
+}
+
+void triggerLoadStopPosition(void)
+{
+  uint16_t position = Storage.readTriggerStopPosition();
+  uint8_t tooth = (uint8_t)(position & 0xFFU);
+
+  fastSyncTooth = 0U;
+  if( ((position >> 8U) == configPage4.triggerTeeth) && (tooth <= configPage4.triggerTeeth) ) { fastSyncTooth = tooth; }
 }
 /** @} */
   
@@ -510,6 +632,7 @@ static inline void checkPerToothTiming(int16_t crankAngle, uint16_t currentTooth
 #include "decoders/decoder_NGC.cxx"
 #include "decoders/decoder_Nissan360.cxx"
 #include "decoders/decoder_non360.cxx"
+#include "decoders/decoder_pattern.cxx"
 #include "decoders/decoder_Renix.cxx"
 #include "decoders/decoder_RoverMEMS.cxx"
 #include "decoders/decoder_Subaru67.cxx"
@@ -2,6 +2,7 @@
 #define DECODERS_H
 
 #include "globals.h"
+#include "isrProfiler.h"
 
 #include "decoders/decoder_24X.h"
 #include "decoders/decoder_missingTooth.h"
@@ -24,6 +25,7 @@
 #include "decoders/decoder_NGC.h"
 #include "decoders/decoder_Nissan360.h"
 #include "decoders/decoder_non360.h"
+#include "decoders/decoder_pattern.h"
 #include "decoders/decoder_Renix.h"
 #include "decoders/decoder_RoverMEMS.h"
 #include "decoders/decoder_Subaru67.h"
@@ -42,7 +44,29 @@
 #else
   #define READ_PRI_TRIGGER() digitalRead(pinTrigger)
   #define READ_SEC_TRIGGER() digitalRead(pinTrigger2)
-  #define READ_THIRD_TRIGGER() digitalRead(pinTrigger3)  
+  #define READ_THIRD_TRIGGER() digitalRead(pinTrigger3)
+#endif
+
+/*
+ * The time (In the micros() timebase) of the edge that raised the trigger interrupt.
+ * Boards that route the trigger inputs to timer input capture channels define TRIGGER_PRI_CAPTURE_AGE() etc, which give
+ * the number of uS since the edge was captured. The edge time is then unaffected by how long the interrupt took to be
+ * serviced (Another ISR running, a noInterrupts() section). Other boards fall back to reading micros() on ISR entry.
+ */
+#if defined(TRIGGER_PRI_CAPTURE_AGE)
+  #define TRIGGER_TIMESTAMP() (micros() - (uint32_t)TRIGGER_PRI_CAPTURE_AGE())
+#else
+  #define TRIGGER_TIMESTAMP() micros()
+#endif
+#if defined(TRIGGER_SEC_CAPTURE_AGE)
+  #define TRIGGER_SEC_TIMESTAMP() (micros() - (uint32_t)TRIGGER_SEC_CAPTURE_AGE())
+#else
+  #define TRIGGER_SEC_TIMESTAMP() micros()
+#endif
+#if defined(TRIGGER_THIRD_CAPTURE_AGE)
+  #define TRIGGER_THIRD_TIMESTAMP() (micros() - (uint32_t)TRIGGER_THIRD_CAPTURE_AGE())
+#else
+  #define TRIGGER_THIRD_TIMESTAMP() micros()
 #endif
 
 #define DECODER_MISSING_TOOTH     0
@@ -73,6 +97,7 @@
 #define DECODER_ROVERMEMS		  25
 #define DECODER_SUZUKI_K6A        26
 #define DECODER_HONDA_J32         27
+#define DECODER_PATTERN           28
 
 #define BIT_DECODER_2ND_DERIV           0 //The use of the 2nd derivative calculation is limited to certain decoders. This is set to either true or false in each decoders setup routine
 #define BIT_DECODER_IS_SEQUENTIAL       1 //Whether or not the decoder supports sequential operation
@@ -127,6 +152,13 @@ void loggerPrimaryISR(void);
 void loggerSecondaryISR(void);
 void loggerTertiaryISR(void);
 
+#if defined(ISR_PROFILING)
+  void primaryTriggerISR(void);
+  #define PRIMARY_TRIGGER_ISR primaryTriggerISR //The handler attached to the primary trigger when the loggers are off
+#else
+  #define PRIMARY_TRIGGER_ISR triggerHandler
+#endif
+
 
 /**
  * @brief This function is called when the engine is stopped, or when the engine is started. It resets the decoder state and the tooth tracking variables
@@ -135,6 +167,16 @@ void loggerTertiaryISR(void);
  */
 void resetDecoder(void);
 
+/**
+ * @brief Fast sync: Saves the tooth the engine stopped on, so the next start can fire from the following tooth. Called once when the engine stops, before resetDecoder()
+ */
+void triggerStoreStopPosition(void);
+
+/**
+ * @brief Fast sync: Reads back the position saved by triggerStoreStopPosition(). Called once at power on, after the config is loaded
+ */
+void triggerLoadStopPosition(void);
+
 extern void (*triggerHandler)(void); //Pointer for the trigger function (Gets pointed to the relevant decoder)
 extern void (*triggerSecondaryHandler)(void); //Pointer for the secondary trigger function (Gets pointed to the relevant decoder)
 extern void (*triggerTertiaryHandler)(void); //Pointer for the tertiary trigger function (Gets pointed to the relevant decoder)
@@ -142,10 +184,17 @@ extern void (*triggerTertiaryHandler)(void); //Pointer for the tertiary trigger
 extern uint16_t (*getRPM)(void); //Pointer to the getRPM function (Gets pointed to the relevant decoder)
 extern int (*getCrankAngle)(void); //Pointer to the getCrank Angle function (Gets pointed to the relevant decoder)
 extern void (*triggerSetEndTeeth)(void); //Pointer to the triggerSetEndTeeth function of each decoder
+void setIgnitionEndTeeth(void); //Runs triggerSetEndTeeth and records the end angle each tooth was calculated for
 
 extern uint32_t MAX_STALL_TIME; 			//The maximum time (in uS) that the system will continue to function before the engine is considered stalled/stopped. This is unique to each decoder, depending on the number of teeth etc. 500000 (half a second) is used as the default value, most decoders will be much less.
 
 
+/** Per tooth ignition timing for one channel. When the decoder reaches the tooth, the channel's spark is retimed from that tooth */
+struct ignitionEndTooth_t {
+    volatile uint16_t tooth;    ///< The decoder's tooth number (Calculated by triggerSetEndTeeth)
+    volatile int16_t endAngle;  ///< The spark angle that the tooth was calculated for
+};
+
 struct triggerInfo_t{
 	volatile uint8_t decoderState;
 
@@ -198,14 +247,7 @@ struct triggerInfo_t{
     uint32_t lastVVTtime; //The time between the vvt reference pulse and the last crank pulse
     byte checkSyncToothCount; //How many teeth must've been seen on this revolution before we try to confirm sync (Useful for missing tooth type decoders)
 
-    uint16_t ignition1EndTooth;
-    uint16_t ignition2EndTooth;
-    uint16_t ignition3EndTooth;
-    uint16_t ignition4EndTooth;
-    uint16_t ignition5EndTooth;
-    uint16_t ignition6EndTooth;
-    uint16_t ignition7EndTooth;
-    uint16_t ignition8EndTooth;
+    ignitionEndTooth_t ignitionEndTeeth[8]; //One per ignition channel. Set together with their angles by setIgnitionEndTeeth()
 
     int16_t toothAngles[24]; //An array for storing fixed tooth angles. Currently sized at 24 for the GM 24X decoder, but may grow later if there are other decoders that use this style
 
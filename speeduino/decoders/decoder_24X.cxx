@@ -50,7 +50,7 @@ void triggerPri_24X(void)
   if(triggerInfo.toothCurrentCount == 25) { currentStatus.hasSync = false; } //Indicates sync has not been achieved (Still waiting for 1 revolution of the crank to take place)
   else
   {
-    triggerInfo.curTime = micros();
+    triggerInfo.curTime = TRIGGER_TIMESTAMP();
     triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
 
     if(triggerInfo.toothCurrentCount == 0)
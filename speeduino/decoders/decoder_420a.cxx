@@ -40,7 +40,7 @@ void triggerSetup_420a(void)
 
 void triggerPri_420a(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime ) //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
   {
@@ -166,17 +166,17 @@ void triggerSetEndTeeth_420a(void)
 {
   if(currentStatus.advance < 9)
   {
-    triggerInfo.ignition1EndTooth = 1;
-    triggerInfo.ignition2EndTooth = 5;
-    triggerInfo.ignition3EndTooth = 9;
-    triggerInfo.ignition4EndTooth = 13;
+    ignitionEndTeethCalc[0] = 1;
+    ignitionEndTeethCalc[1] = 5;
+    ignitionEndTeethCalc[2] = 9;
+    ignitionEndTeethCalc[3] = 13;
   }
   else
   {
-    triggerInfo.ignition1EndTooth = 16;
-    triggerInfo.ignition2EndTooth = 4;
-    triggerInfo.ignition3EndTooth = 8;
-    triggerInfo.ignition4EndTooth = 12;
+    ignitionEndTeethCalc[0] = 16;
+    ignitionEndTeethCalc[1] = 4;
+    ignitionEndTeethCalc[2] = 8;
+    ignitionEndTeethCalc[3] = 12;
   }
 }
 /** @} */
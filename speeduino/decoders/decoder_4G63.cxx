@@ -63,7 +63,7 @@ void triggerSetup_4G63(void)
 
 void triggerPri_4G63(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( (triggerInfo.curGap >= triggerInfo.triggerFilterTime) || (currentStatus.startRevolutions == 0) )
   {
@@ -262,7 +262,7 @@ void triggerSec_4G63(void)
   }
 
 
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   if ( (triggerInfo.curGap2 >= triggerInfo.triggerSecFilterTime) )//|| (currentStatus.startRevolutions == 0) )
   {
@@ -398,17 +398,17 @@ void triggerSetEndTeeth_4G63(void)
   {
     if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
     {
-      triggerInfo.ignition1EndTooth = 8;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4;
-      triggerInfo.ignition4EndTooth = 6;
+      ignitionEndTeethCalc[0] = 8;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4;
+      ignitionEndTeethCalc[3] = 6;
     }
     else
     {
-      triggerInfo.ignition1EndTooth = 4;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4; //Not used
-      triggerInfo.ignition4EndTooth = 2;
+      ignitionEndTeethCalc[0] = 4;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4; //Not used
+      ignitionEndTeethCalc[3] = 2;
     }
   }
   if(configPage2.nCylinders == 6)
@@ -416,17 +416,17 @@ void triggerSetEndTeeth_4G63(void)
     if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
     {
       //This should never happen as 6 cylinder sequential not supported
-      triggerInfo.ignition1EndTooth = 8;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4;
-      triggerInfo.ignition4EndTooth = 6;
+      ignitionEndTeethCalc[0] = 8;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4;
+      ignitionEndTeethCalc[3] = 6;
     }
     else
     {
-      triggerInfo.ignition1EndTooth = 6;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4;
-      triggerInfo.ignition4EndTooth = 2; //Not used
+      ignitionEndTeethCalc[0] = 6;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4;
+      ignitionEndTeethCalc[3] = 2; //Not used
     }
   }
 }
@@ -22,7 +22,7 @@ void triggerSetup_Audi135(void)
 
 void triggerPri_Audi135(void)
 {
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothSystemLastToothTime;
    if ( (triggerInfo.curGap > triggerInfo.triggerFilterTime) || (currentStatus.startRevolutions == 0) )
    {
@@ -61,7 +61,7 @@ void triggerPri_Audi135(void)
 void triggerSec_Audi135(void)
 {
   /*
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   if ( triggerInfo.curGap2 < triggerInfo.triggerSecFilterTime ) { return; }
   triggerInfo.toothLastSecToothTime = triggerInfo.curTime2;
@@ -32,7 +32,7 @@ void triggerSetup_BasicDistributor(void)
 
 void triggerPri_BasicDistributor(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( (triggerInfo.curGap >= triggerInfo.triggerFilterTime) )
   {
@@ -146,64 +146,64 @@ void triggerSetEndTeeth_BasicDistributor(void)
     case 4:
       if( (tempEndAngle > 180) || (tempEndAngle <= 0) )
       {
-        triggerInfo.ignition1EndTooth = 2;
-        triggerInfo.ignition2EndTooth = 1;
+        ignitionEndTeethCalc[0] = 2;
+        ignitionEndTeethCalc[1] = 1;
       }
       else
       {
-        triggerInfo.ignition1EndTooth = 1;
-        triggerInfo.ignition2EndTooth = 2;
+        ignitionEndTeethCalc[0] = 1;
+        ignitionEndTeethCalc[1] = 2;
       }
       break;
     case 3: //Shared with 6 cylinder
     case 6:
       if( (tempEndAngle > 120) && (tempEndAngle <= 240) )
       {
-        triggerInfo.ignition1EndTooth = 2;
-        triggerInfo.ignition2EndTooth = 3;
-        triggerInfo.ignition3EndTooth = 1;
+        ignitionEndTeethCalc[0] = 2;
+        ignitionEndTeethCalc[1] = 3;
+        ignitionEndTeethCalc[2] = 1;
       }
       else if( (tempEndAngle > 240) || (tempEndAngle <= 0) )
       {
-        triggerInfo.ignition1EndTooth = 3;
-        triggerInfo.ignition2EndTooth = 1;
-        triggerInfo.ignition3EndTooth = 2;
+        ignitionEndTeethCalc[0] = 3;
+        ignitionEndTeethCalc[1] = 1;
+        ignitionEndTeethCalc[2] = 2;
       }
       else
       {
-        triggerInfo.ignition1EndTooth = 1;
-        triggerInfo.ignition2EndTooth = 2;
-        triggerInfo.ignition3EndTooth = 3;
+        ignitionEndTeethCalc[0] = 1;
+        ignitionEndTeethCalc[1] = 2;
+        ignitionEndTeethCalc[2] = 3;
       }
       break;
     case 8:
       if( (tempEndAngle > 90) && (tempEndAngle <= 180) )
       {
-        triggerInfo.ignition1EndTooth = 2;
-        triggerInfo.ignition2EndTooth = 3;
-        triggerInfo.ignition3EndTooth = 4;
-        triggerInfo.ignition4EndTooth = 1;
+        ignitionEndTeethCalc[0] = 2;
+        ignitionEndTeethCalc[1] = 3;
+        ignitionEndTeethCalc[2] = 4;
+        ignitionEndTeethCalc[3] = 1;
       }
       else if( (tempEndAngle > 180) && (tempEndAngle <= 270) )
       {
-        triggerInfo.ignition1EndTooth = 3;
-        triggerInfo.ignition2EndTooth = 4;
-        triggerInfo.ignition3EndTooth = 1;
-        triggerInfo.ignition4EndTooth = 2;
+        ignitionEndTeethCalc[0] = 3;
+        ignitionEndTeethCalc[1] = 4;
+        ignitionEndTeethCalc[2] = 1;
+        ignitionEndTeethCalc[3] = 2;
       }
       else if( (tempEndAngle > 270) || (tempEndAngle <= 0) )
       {
-        triggerInfo.ignition1EndTooth = 4;
-        triggerInfo.ignition2EndTooth = 1;
-        triggerInfo.ignition3EndTooth = 2;
-        triggerInfo.ignition4EndTooth = 3;
+        ignitionEndTeethCalc[0] = 4;
+        ignitionEndTeethCalc[1] = 1;
+        ignitionEndTeethCalc[2] = 2;
+        ignitionEndTeethCalc[3] = 3;
       }
       else
       {
-        triggerInfo.ignition1EndTooth = 1;
-        triggerInfo.ignition2EndTooth = 2;
-        triggerInfo.ignition3EndTooth = 3;
-        triggerInfo.ignition4EndTooth = 4;
+        ignitionEndTeethCalc[0] = 1;
+        ignitionEndTeethCalc[1] = 2;
+        ignitionEndTeethCalc[2] = 3;
+        ignitionEndTeethCalc[3] = 4;
       }
       break;
   }
@@ -13,11 +13,12 @@ void triggerSetup_DRZ400(void)
   BIT_SET(triggerInfo.decoderState, BIT_DECODER_TOOTH_ANG_CORRECT); //This is always true for this pattern
   BIT_SET(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY);
   MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerInfo.triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  initialiseToothAngles(); //Uses the dual wheel crank angle and end teeth
 }
 
 void triggerSec_DRZ400(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   if ( triggerInfo.curGap2 >= triggerInfo.triggerSecFilterTime )
   {
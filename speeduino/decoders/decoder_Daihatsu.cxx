@@ -39,7 +39,7 @@ void triggerSetup_Daihatsu(void)
 
 void triggerPri_Daihatsu(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
 
   //if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime || (currentStatus.startRevolutions == 0 )
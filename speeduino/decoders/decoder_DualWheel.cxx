@@ -22,9 +22,7 @@ void triggerSetup_DualWheel(void)
   BIT_SET(triggerInfo.decoderState, BIT_DECODER_TOOTH_ANG_CORRECT); //This is always true for this pattern
   BIT_SET(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY);
   MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerInfo.triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
-#ifdef USE_LIBDIVIDE
-  divtriggerInfo.triggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
-#endif
+  initialiseToothAngles();
 }
 
 /** Dual Wheel Primary.
@@ -32,7 +30,7 @@ void triggerSetup_DualWheel(void)
  * */
 void triggerPri_DualWheel(void)
 {
-    triggerInfo.curTime = micros();
+    triggerInfo.curTime = TRIGGER_TIMESTAMP();
     triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
     if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime )
     {
@@ -60,7 +58,7 @@ void triggerPri_DualWheel(void)
       //NEW IGNITION MODE
       if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) )
       {
-        int16_t crankAngle = ( (triggerInfo.toothCurrentCount-1) * triggerInfo.triggerToothAngle ) + configPage4.triggerAngle;
+        int16_t crankAngle = toothAngle(triggerInfo.toothCurrentCount, false) + configPage4.triggerAngle;
         uint16_t currentTooth;
         if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (triggerInfo.revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
         {
@@ -77,7 +75,7 @@ void triggerPri_DualWheel(void)
  * */
 void triggerSec_DualWheel(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   if ( triggerInfo.curGap2 >= triggerInfo.triggerSecFilterTime )
   {
@@ -146,14 +144,11 @@ int getCrankAngle_DualWheel(void)
     //Handle case where the secondary tooth was the last one seen
     if(temptoothCurrentCount == 0) { temptoothCurrentCount = configPage4.triggerTeeth; }
 
-    int crankAngle = ((temptoothCurrentCount - 1) * triggerInfo.triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    int crankAngle = toothAngle(temptoothCurrentCount, temprevolutionOne) + configPage4.triggerAngle; //The angle of the last tooth seen (Including which revolution of the cycle it is on), plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
 
     triggerInfo.elapsedTime = (triggerInfo.lastCrankAngleCalc - temptoothLastToothTime);
     crankAngle += timeToAngleDegPerMicroSec(triggerInfo.elapsedTime);
 
-    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
-    if ( (temprevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
-
     if (crankAngle >= 720) { crankAngle -= 720; }
     if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
 
@@ -161,12 +156,7 @@ int getCrankAngle_DualWheel(void)
 }
 
 static uint16_t __attribute__((noinline)) calcEndTeeth_DualWheel(int ignitionAngle, uint8_t toothAdder) {
-  int16_t tempEndTooth =
-#ifdef USE_LIBDIVIDE
-      libdivide::libdivide_s16_do(ignitionAngle - configPage4.triggerAngle, &divtriggerInfo.triggerToothAngle);
-#else
-      (ignitionAngle - (int16_t)configPage4.triggerAngle) / (int16_t)triggerInfo.triggerToothAngle;
-#endif
+  int16_t tempEndTooth = toothAngleDivide(ignitionAngle - (int16_t)configPage4.triggerAngle);
   return clampToToothCount(tempEndTooth, toothAdder);
 }
 
@@ -179,21 +169,21 @@ void triggerSetEndTeeth_DualWheel(void)
   byte toothAdder = 0;
   if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = configPage4.triggerTeeth; }
 
-  triggerInfo.ignition1EndTooth = calcEndTeeth_DualWheel(ignition1EndAngle, toothAdder);
-  triggerInfo.ignition2EndTooth = calcEndTeeth_DualWheel(ignition2EndAngle, toothAdder);
-  triggerInfo.ignition3EndTooth = calcEndTeeth_DualWheel(ignition3EndAngle, toothAdder);
-  triggerInfo.ignition4EndTooth = calcEndTeeth_DualWheel(ignition4EndAngle, toothAdder);
+  ignitionEndTeethCalc[0] = calcEndTeeth_DualWheel(ignition1EndAngle, toothAdder);
+  ignitionEndTeethCalc[1] = calcEndTeeth_DualWheel(ignition2EndAngle, toothAdder);
+  ignitionEndTeethCalc[2] = calcEndTeeth_DualWheel(ignition3EndAngle, toothAdder);
+  ignitionEndTeethCalc[3] = calcEndTeeth_DualWheel(ignition4EndAngle, toothAdder);
 #if IGN_CHANNELS >= 5
-  triggerInfo.ignition5EndTooth = calcEndTeeth_DualWheel(ignition5EndAngle, toothAdder);
+  ignitionEndTeethCalc[4] = calcEndTeeth_DualWheel(ignition5EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 6
-  triggerInfo.ignition6EndTooth = calcEndTeeth_DualWheel(ignition6EndAngle, toothAdder);
+  ignitionEndTeethCalc[5] = calcEndTeeth_DualWheel(ignition6EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 7
-  triggerInfo.ignition7EndTooth = calcEndTeeth_DualWheel(ignition7EndAngle, toothAdder);
+  ignitionEndTeethCalc[6] = calcEndTeeth_DualWheel(ignition7EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 8
-  triggerInfo.ignition8EndTooth = calcEndTeeth_DualWheel(ignition8EndAngle, toothAdder);
+  ignitionEndTeethCalc[7] = calcEndTeeth_DualWheel(ignition8EndAngle, toothAdder);
 #endif
 }
 /** @} */
@@ -28,14 +28,12 @@ void triggerSetup_FordST170(void)
   triggerInfo.toothOneTime = 0;
   triggerInfo.toothOneMinusOneTime = 0;
   MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerInfo.triggerToothAngle * (1U + 1U)); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
-#ifdef USE_LIBDIVIDE
-  divtriggerInfo.triggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
-#endif
+  initialiseToothAngles();
 }
 
 void triggerSec_FordST170(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
   //Safety check for initial startup
@@ -111,10 +109,7 @@ int getCrankAngle_FordST170(void)
     temptoothLastToothTime = triggerInfo.toothLastToothTime;
     interrupts();
 
-    int crankAngle = ((temptoothCurrentCount - 1) * triggerInfo.triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-
-    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
-    if ( (temprevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
+    int crankAngle = toothAngle(temptoothCurrentCount, temprevolutionOne) + configPage4.triggerAngle; //The angle of the last tooth seen (Including which revolution of the cycle it is on), plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
 
     triggerInfo.lastCrankAngleCalc = micros();
     triggerInfo.elapsedTime = (triggerInfo.lastCrankAngleCalc - temptoothLastToothTime);
@@ -128,11 +123,7 @@ int getCrankAngle_FordST170(void)
 
 static uint16_t __attribute__((noinline)) calcSetEndTeeth_FordST170(int ignitionAngle, uint8_t toothAdder) {
   int16_t tempEndTooth = ignitionAngle - configPage4.triggerAngle;
-#ifdef USE_LIBDIVIDE
-  tempEndTooth = libdivide::libdivide_s16_do(tempEndTooth, &divtriggerInfo.triggerToothAngle);
-#else
-  tempEndTooth = tempEndTooth / (int16_t)triggerInfo.triggerToothAngle;
-#endif
+  tempEndTooth = toothAngleDivide(tempEndTooth);
   tempEndTooth = nudge(1, 36U + toothAdder,  tempEndTooth - 1, 36U + toothAdder);
   return clampToActualTeeth((uint16_t)tempEndTooth, toothAdder);
 }
@@ -142,10 +133,10 @@ void triggerSetEndTeeth_FordST170(void)
   byte toothAdder = 0;
    if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = 36; }
 
-  triggerInfo.ignition1EndTooth = calcSetEndTeeth_FordST170(ignition1EndAngle, toothAdder);
-  triggerInfo.ignition2EndTooth = calcSetEndTeeth_FordST170(ignition2EndAngle, toothAdder);
-  triggerInfo.ignition3EndTooth = calcSetEndTeeth_FordST170(ignition3EndAngle, toothAdder);
-  triggerInfo.ignition4EndTooth = calcSetEndTeeth_FordST170(ignition4EndAngle, toothAdder);
+  ignitionEndTeethCalc[0] = calcSetEndTeeth_FordST170(ignition1EndAngle, toothAdder);
+  ignitionEndTeethCalc[1] = calcSetEndTeeth_FordST170(ignition2EndAngle, toothAdder);
+  ignitionEndTeethCalc[2] = calcSetEndTeeth_FordST170(ignition3EndAngle, toothAdder);
+  ignitionEndTeethCalc[3] = calcSetEndTeeth_FordST170(ignition4EndAngle, toothAdder);
 
   // Removed ign channels >4 as an ST170 engine is a 4 cylinder
 }
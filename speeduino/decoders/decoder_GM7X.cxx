@@ -18,7 +18,7 @@ void triggerSetup_GM7X(void)
 void triggerPri_GM7X(void)
 {
     triggerInfo.lastGap = triggerInfo.curGap;
-    triggerInfo.curTime = micros();
+    triggerInfo.curTime = TRIGGER_TIMESTAMP();
     triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
     triggerInfo.toothCurrentCount++; //Increment the tooth counter
     BIT_SET(triggerInfo.decoderState, BIT_DECODER_VALID_TRIGGER); //Flag this pulse as being a valid trigger (ie that it passed filters)
@@ -120,15 +120,15 @@ void triggerSetEndTeeth_GM7X(void)
 {
   if(currentStatus.advance < 18 )
   {
-    triggerInfo.ignition1EndTooth = 7;
-    triggerInfo.ignition2EndTooth = 2;
-    triggerInfo.ignition3EndTooth = 5;
+    ignitionEndTeethCalc[0] = 7;
+    ignitionEndTeethCalc[1] = 2;
+    ignitionEndTeethCalc[2] = 5;
   }
   else
   {
-    triggerInfo.ignition1EndTooth = 6;
-    triggerInfo.ignition2EndTooth = 1;
-    triggerInfo.ignition3EndTooth = 4;
+    ignitionEndTeethCalc[0] = 6;
+    ignitionEndTeethCalc[1] = 1;
+    ignitionEndTeethCalc[2] = 4;
   }
 }
 /** @} */
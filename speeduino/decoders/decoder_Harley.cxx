@@ -19,7 +19,7 @@ void triggerSetup_Harley(void)
 void triggerPri_Harley(void)
 {
   triggerInfo.lastGap = triggerInfo.curGap;
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   setFilter(triggerInfo.curGap); // Filtering adjusted according to setting
   if (triggerInfo.curGap > triggerInfo.triggerFilterTime)
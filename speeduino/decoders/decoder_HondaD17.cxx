@@ -16,7 +16,7 @@ void triggerSetup_HondaD17(void)
 void triggerPri_HondaD17(void)
 {
    triggerInfo.lastGap = triggerInfo.curGap;
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
    triggerInfo.toothCurrentCount++; //Increment the tooth counter
 
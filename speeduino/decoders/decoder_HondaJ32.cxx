@@ -41,7 +41,7 @@ void triggerPri_HondaJ32(void)
   // This function is called only on rising edges, which occur as we lose sight of a tooth.
   // This function sets the following state variables for use in other functions:
   // triggerInfo.toothLastToothTime, triggerInfo.toothOneTime, triggerInfo.revolutionOne (just toggles - not correct)
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   triggerInfo.toothLastToothTime = triggerInfo.curTime;
 
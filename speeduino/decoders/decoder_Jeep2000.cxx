@@ -36,7 +36,7 @@ void triggerPri_Jeep2000(void)
   if(triggerInfo.toothCurrentCount == 13) { currentStatus.hasSync = false; } //Indicates sync has not been achieved (Still waiting for 1 revolution of the crank to take place)
   else
   {
-    triggerInfo.curTime = micros();
+    triggerInfo.curTime = TRIGGER_TIMESTAMP();
     triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
     if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime )
     {
@@ -28,7 +28,7 @@ void triggerSetup_MazdaAU(void)
 
 void triggerPri_MazdaAU(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime )
   {
@@ -56,16 +56,17 @@ void triggerPri_MazdaAU(void)
       //Whilst this is an uneven tooth pattern, if the specific angle between the last 2 teeth is specified, 1st deriv prediction can be used
       if( (triggerInfo.toothCurrentCount == 1) || (triggerInfo.toothCurrentCount == 3) ) { triggerInfo.triggerToothAngle = 72; triggerInfo.triggerFilterTime = triggerInfo.curGap; } //Trigger filter is set to whatever time it took to do 72 degrees (Next trigger is 108 degrees away)
       else { triggerInfo.triggerToothAngle = 108; triggerInfo.triggerFilterTime = rshift<3>(triggerInfo.curGap * 3UL); } //Trigger filter is set to (108*3)/8=40 degrees (Next trigger is 70 degrees away).
-
-      triggerInfo.toothLastMinusOneToothTime = triggerInfo.toothLastToothTime;
-      triggerInfo.toothLastToothTime = triggerInfo.curTime;
     } //Has sync
+
+    //Tooth times are recorded before sync as well, otherwise the stall check resets the decoder whenever cranking takes longer than MAX_STALL_TIME to reach the cam teeth
+    triggerInfo.toothLastMinusOneToothTime = triggerInfo.toothLastToothTime;
+    triggerInfo.toothLastToothTime = triggerInfo.curTime;
   } //Filter time
 }
 
 void triggerSec_MazdaAU(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.lastGap = triggerInfo.curGap2;
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   //if ( triggerInfo.curGap2 < triggerInfo.triggerSecFilterTime ) { return; }
@@ -105,6 +106,9 @@ uint16_t getRPM_MazdaAU(void)
     //Because these signals aren't even (Alternating 108 and 72 degrees), this needs a special function
     if(currentStatus.RPM < currentStatus.crankRPM)
     {
+      //Sync is found on the cam, so there may not have been a crank tooth timed yet
+      if(triggerInfo.toothLastToothTime == triggerInfo.toothLastMinusOneToothTime) { return 0; }
+
       int tempToothAngle;
       noInterrupts();
       tempToothAngle = triggerInfo.triggerToothAngle;
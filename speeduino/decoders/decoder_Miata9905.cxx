@@ -48,7 +48,7 @@ void triggerSetup_Miata9905(void)
 
 void triggerPri_Miata9905(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( (triggerInfo.curGap >= triggerInfo.triggerFilterTime) || (currentStatus.startRevolutions == 0) )
   {
@@ -135,7 +135,7 @@ void triggerPri_Miata9905(void)
 
 void triggerSec_Miata9905(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
   if(BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK) || (currentStatus.hasSync == false) )
@@ -237,17 +237,17 @@ void triggerSetEndTeeth_Miata9905(void)
   {
     if(currentStatus.advance >= 10)
     {
-      triggerInfo.ignition1EndTooth = 8;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4;
-      triggerInfo.ignition4EndTooth = 6;
+      ignitionEndTeethCalc[0] = 8;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4;
+      ignitionEndTeethCalc[3] = 6;
     }
     else if (currentStatus.advance > 0)
     {
-      triggerInfo.ignition1EndTooth = 1;
-      triggerInfo.ignition2EndTooth = 3;
-      triggerInfo.ignition3EndTooth = 5;
-      triggerInfo.ignition4EndTooth = 7;
+      ignitionEndTeethCalc[0] = 1;
+      ignitionEndTeethCalc[1] = 3;
+      ignitionEndTeethCalc[2] = 5;
+      ignitionEndTeethCalc[3] = 7;
     }
 
   }
@@ -255,17 +255,17 @@ void triggerSetEndTeeth_Miata9905(void)
   {
     if(currentStatus.advance >= 10)
     {
-      triggerInfo.ignition1EndTooth = 4;
-      triggerInfo.ignition2EndTooth = 2;
-      triggerInfo.ignition3EndTooth = 4; //Not used
-      triggerInfo.ignition4EndTooth = 2; //Not used
+      ignitionEndTeethCalc[0] = 4;
+      ignitionEndTeethCalc[1] = 2;
+      ignitionEndTeethCalc[2] = 4; //Not used
+      ignitionEndTeethCalc[3] = 2; //Not used
     }
     else if(currentStatus.advance > 0)
     {
-      triggerInfo.ignition1EndTooth = 1;
-      triggerInfo.ignition2EndTooth = 3;
-      triggerInfo.ignition3EndTooth = 1; //Not used
-      triggerInfo.ignition4EndTooth = 3; //Not used
+      ignitionEndTeethCalc[0] = 1;
+      ignitionEndTeethCalc[1] = 3;
+      ignitionEndTeethCalc[2] = 1; //Not used
+      ignitionEndTeethCalc[3] = 3; //Not used
     }
   }
 }
@@ -63,14 +63,12 @@ void triggerSetup_NGC(void)
     triggerInfo.toothAngles[8] = 3;
     triggerInfo.toothAngles[9] = 1; // Pos 9 is required to be the same as group 1 for easier math
   }
-#ifdef USE_LIBDIVIDE
-  divtriggerInfo.triggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
-#endif
+  initialiseToothAngles();
 }
 
 void triggerPri_NGC(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   // We need to know the polarity of the missing tooth to determine position
   if (READ_PRI_TRIGGER() == HIGH) {
     triggerInfo.toothLastToothRisingTime = triggerInfo.curTime;
@@ -170,7 +168,7 @@ void triggerPri_NGC(void)
     //NEW IGNITION MODE
     if( (configPage2.perToothIgn == true) && (BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK) == false) )
     {
-      int16_t crankAngle = ( (triggerInfo.toothCurrentCount-1) * triggerInfo.triggerToothAngle ) + configPage4.triggerAngle;
+      int16_t crankAngle = toothAngle(triggerInfo.toothCurrentCount, false) + configPage4.triggerAngle;
       crankAngle = ignitionLimits(crankAngle);
       if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (triggerInfo.revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
       {
@@ -189,7 +187,7 @@ void triggerSec_NGC4(void)
     return;
   }
 
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
 
   // We need to know the polarity of the missing tooth to determine position
   if (READ_SEC_TRIGGER() == HIGH) {
@@ -241,7 +239,7 @@ void triggerSec_NGC68(void)
     return;
   }
 
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
 
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
@@ -315,11 +313,7 @@ static inline uint16_t calcSetEndTeeth_NGC_SkipMissing(uint16_t toothNum) {
 
 static uint16_t __attribute__((noinline)) calcSetEndTeeth_NGC(int ignitionAngle, uint8_t toothAdder) {
   int16_t tempEndTooth = ignitionAngle - configPage4.triggerAngle;
-#ifdef USE_LIBDIVIDE
-  tempEndTooth = libdivide::libdivide_s16_do(tempEndTooth, &divtriggerInfo.triggerToothAngle);
-#else
-  tempEndTooth = tempEndTooth / (int16_t)triggerInfo.triggerToothAngle;
-#endif
+  tempEndTooth = toothAngleDivide(tempEndTooth);
   return calcSetEndTeeth_NGC_SkipMissing(clampToToothCount(tempEndTooth - 1, toothAdder));
 }
 
@@ -328,18 +322,18 @@ void triggerSetEndTeeth_NGC(void)
   byte toothAdder = 0;
   if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = configPage4.triggerTeeth; }
 
-  triggerInfo.ignition1EndTooth = calcSetEndTeeth_NGC(ignition1EndAngle, toothAdder);
-  triggerInfo.ignition2EndTooth = calcSetEndTeeth_NGC(ignition2EndAngle, toothAdder);
-  triggerInfo.ignition3EndTooth = calcSetEndTeeth_NGC(ignition3EndAngle, toothAdder);
-  triggerInfo.ignition4EndTooth = calcSetEndTeeth_NGC(ignition4EndAngle, toothAdder);
+  ignitionEndTeethCalc[0] = calcSetEndTeeth_NGC(ignition1EndAngle, toothAdder);
+  ignitionEndTeethCalc[1] = calcSetEndTeeth_NGC(ignition2EndAngle, toothAdder);
+  ignitionEndTeethCalc[2] = calcSetEndTeeth_NGC(ignition3EndAngle, toothAdder);
+  ignitionEndTeethCalc[3] = calcSetEndTeeth_NGC(ignition4EndAngle, toothAdder);
   #if IGN_CHANNELS >= 6
-  triggerInfo.ignition5EndTooth = calcSetEndTeeth_NGC(ignition5EndAngle, toothAdder);
-  triggerInfo.ignition6EndTooth = calcSetEndTeeth_NGC(ignition6EndAngle, toothAdder);
+  ignitionEndTeethCalc[4] = calcSetEndTeeth_NGC(ignition5EndAngle, toothAdder);
+  ignitionEndTeethCalc[5] = calcSetEndTeeth_NGC(ignition6EndAngle, toothAdder);
   #endif
 
   #if IGN_CHANNELS >= 8
-  triggerInfo.ignition7EndTooth = calcSetEndTeeth_NGC(ignition7EndAngle, toothAdder);
-  triggerInfo.ignition8EndTooth = calcSetEndTeeth_NGC(ignition8EndAngle, toothAdder);
+  ignitionEndTeethCalc[6] = calcSetEndTeeth_NGC(ignition7EndAngle, toothAdder);
+  ignitionEndTeethCalc[7] = calcSetEndTeeth_NGC(ignition8EndAngle, toothAdder);
   #endif
 }
 
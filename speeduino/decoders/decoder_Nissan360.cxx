@@ -20,7 +20,7 @@ void triggerSetup_Nissan360(void)
 
 void triggerPri_Nissan360(void)
 {
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
    //if ( triggerInfo.curGap < triggerInfo.triggerFilterTime ) { return; }
    triggerInfo.toothCurrentCount++; //Increment the tooth counter
@@ -61,7 +61,7 @@ void triggerPri_Nissan360(void)
 
 void triggerSec_Nissan360(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
   //if ( triggerInfo.curGap2 < triggerInfo.triggerSecFilterTime ) { return; }
   triggerInfo.toothLastSecToothTime = triggerInfo.curTime2;
@@ -214,14 +214,14 @@ void triggerSetEndTeeth_Nissan360(void)
 {
   //This uses 4 prior teeth, just to ensure there is sufficient time to set the schedule etc
   byte offset_teeth = 4;
-  if((ignition1EndAngle - offset_teeth) > configPage4.triggerAngle) { triggerInfo.ignition1EndTooth = ( (ignition1EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  else { triggerInfo.ignition1EndTooth = ( (ignition1EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  if((ignition2EndAngle - offset_teeth) > configPage4.triggerAngle) { triggerInfo.ignition2EndTooth = ( (ignition2EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  else { triggerInfo.ignition2EndTooth = ( (ignition2EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  if((ignition3EndAngle - offset_teeth) > configPage4.triggerAngle) { triggerInfo.ignition3EndTooth = ( (ignition3EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  else { triggerInfo.ignition3EndTooth = ( (ignition3EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  if((ignition4EndAngle - offset_teeth) > configPage4.triggerAngle) { triggerInfo.ignition4EndTooth = ( (ignition4EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
-  else { triggerInfo.ignition4EndTooth = ( (ignition4EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  if((ignition1EndAngle - offset_teeth) > configPage4.triggerAngle) { ignitionEndTeethCalc[0] = ( (ignition1EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  else { ignitionEndTeethCalc[0] = ( (ignition1EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  if((ignition2EndAngle - offset_teeth) > configPage4.triggerAngle) { ignitionEndTeethCalc[1] = ( (ignition2EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  else { ignitionEndTeethCalc[1] = ( (ignition2EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  if((ignition3EndAngle - offset_teeth) > configPage4.triggerAngle) { ignitionEndTeethCalc[2] = ( (ignition3EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  else { ignitionEndTeethCalc[2] = ( (ignition3EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  if((ignition4EndAngle - offset_teeth) > configPage4.triggerAngle) { ignitionEndTeethCalc[3] = ( (ignition4EndAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; }
+  else { ignitionEndTeethCalc[3] = ( (ignition4EndAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; }
 }
 /** @} */
 
@@ -35,9 +35,7 @@ void triggerSetup_Renix(void)
   triggerInfo.toothSystemCount = 1;
   triggerInfo.toothCurrentCount = 1;
   triggerInfo.toothLastToothTime = 0;
-#ifdef USE_LIBDIVIDE
-  divtriggerInfo.triggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
-#endif
+  initialiseToothAngles();
 }
 
 
@@ -48,7 +46,7 @@ void triggerSetup_Renix(void)
 
 void triggerPri_Renix(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - renixSystemLastToothTime;
 
   if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime )
@@ -107,7 +105,7 @@ void triggerPri_Renix(void)
       //NEW IGNITION MODE
       if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) )
       {
-        int16_t crankAngle = ( (triggerInfo.toothCurrentCount - 1) * triggerInfo.triggerToothAngle ) + configPage4.triggerAngle;
+        int16_t crankAngle = toothAngle(triggerInfo.toothCurrentCount, false) + configPage4.triggerAngle;
         crankAngle = ignitionLimits(crankAngle);
         if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (triggerInfo.revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
         {
@@ -122,11 +120,7 @@ void triggerPri_Renix(void)
 
 static uint16_t __attribute__((noinline)) calcEndTeeth_Renix(int ignitionAngle, uint8_t toothAdder) {
   int16_t tempEndTooth = ignitionAngle - configPage4.triggerAngle;
-#ifdef USE_LIBDIVIDE
-  tempEndTooth = libdivide::libdivide_s16_do(tempEndTooth, &divtriggerInfo.triggerToothAngle);
-#else
-  tempEndTooth = tempEndTooth / (int16_t)triggerInfo.triggerToothAngle;
-#endif
+  tempEndTooth = toothAngleDivide(tempEndTooth);
   tempEndTooth = tempEndTooth - 1;
   // Clamp to tooth count
   return clampToActualTeeth(clampToToothCount(tempEndTooth, toothAdder), toothAdder);
@@ -139,22 +133,22 @@ void triggerSetEndTeeth_Renix(void)
 
   //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
 
-  triggerInfo.ignition1EndTooth = calcEndTeeth_Renix(ignition1EndAngle, toothAdder);
-  triggerInfo.ignition2EndTooth = calcEndTeeth_Renix(ignition2EndAngle, toothAdder);
-  currentStatus.canin[1] = triggerInfo.ignition2EndTooth;
-  triggerInfo.ignition3EndTooth = calcEndTeeth_Renix(ignition3EndAngle, toothAdder);
-  triggerInfo.ignition4EndTooth = calcEndTeeth_Renix(ignition4EndAngle, toothAdder);
+  ignitionEndTeethCalc[0] = calcEndTeeth_Renix(ignition1EndAngle, toothAdder);
+  ignitionEndTeethCalc[1] = calcEndTeeth_Renix(ignition2EndAngle, toothAdder);
+  currentStatus.canin[1] = ignitionEndTeethCalc[1];
+  ignitionEndTeethCalc[2] = calcEndTeeth_Renix(ignition3EndAngle, toothAdder);
+  ignitionEndTeethCalc[3] = calcEndTeeth_Renix(ignition4EndAngle, toothAdder);
 #if IGN_CHANNELS >= 5
-  triggerInfo.ignition5EndTooth = calcEndTeeth_Renix(ignition5EndAngle, toothAdder);
+  ignitionEndTeethCalc[4] = calcEndTeeth_Renix(ignition5EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 6
-  triggerInfo.ignition6EndTooth = calcEndTeeth_Renix(ignition6EndAngle, toothAdder);
+  ignitionEndTeethCalc[5] = calcEndTeeth_Renix(ignition6EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 7
-  triggerInfo.ignition7EndTooth = calcEndTeeth_Renix(ignition7EndAngle, toothAdder);
+  ignitionEndTeethCalc[6] = calcEndTeeth_Renix(ignition7EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 8
-  triggerInfo.ignition8EndTooth = calcEndTeeth_Renix(ignition8EndAngle, toothAdder);
+  ignitionEndTeethCalc[7] = calcEndTeeth_Renix(ignition8EndAngle, toothAdder);
 #endif
 }
 
@@ -14,7 +14,7 @@
  * @defgroup dec_rover_mems Rover MEMS all versions including T Series, O Series, Mini and K Series
  * @{
  */
-volatile unsigned long roverMEMSTeethSeen = 0; // used for flywheel gap pattern matching
+volatile uint32_t roverMEMSTeethSeen = 0; // used for flywheel gap pattern matching. The window is 32 teeth wide so this must be 32 bits on every platform
 
 void triggerSetup_RoverMEMS()
 {
@@ -42,7 +42,7 @@ void triggerSetup_RoverMEMS()
 
 void triggerPri_RoverMEMS()
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
 
   if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime ) //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
@@ -234,7 +234,7 @@ int getCrankAngle_RoverMEMS()
 
 void triggerSec_RoverMEMS()
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
   //Safety check for initial startup
@@ -389,10 +389,10 @@ void triggerSetEndTeeth_RoverMEMS()
   }
 
 
-  triggerInfo.ignition1EndTooth = tempIgnitionEndTooth[1];
-  triggerInfo.ignition2EndTooth = tempIgnitionEndTooth[2];
-  triggerInfo.ignition3EndTooth = tempIgnitionEndTooth[3];
-  triggerInfo.ignition4EndTooth = tempIgnitionEndTooth[4];
+  ignitionEndTeethCalc[0] = tempIgnitionEndTooth[1];
+  ignitionEndTeethCalc[1] = tempIgnitionEndTooth[2];
+  ignitionEndTeethCalc[2] = tempIgnitionEndTooth[3];
+  ignitionEndTeethCalc[3] = tempIgnitionEndTooth[4];
 }
 /** @} */
 
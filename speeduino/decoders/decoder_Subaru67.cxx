@@ -36,7 +36,7 @@ void triggerSetup_Subaru67(void)
 
 void triggerPri_Subaru67(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( triggerInfo.curGap < triggerInfo.triggerFilterTime )
   { return; }
@@ -157,7 +157,7 @@ void triggerSec_Subaru67(void)
 {
   if( ((triggerInfo.toothSystemCount == 0) || (triggerInfo.toothSystemCount == 3)) )
   {
-    triggerInfo.curTime2 = micros();
+    triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
     triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
     if ( triggerInfo.curGap2 > triggerInfo.triggerSecFilterTime )
@@ -236,37 +236,37 @@ void triggerSetEndTeeth_Subaru67(void)
 {
   if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
   {
-    //if(ignition1EndAngle < 710) { triggerInfo.ignition1EndTooth = 12; }
+    //if(ignition1EndAngle < 710) { ignitionEndTeethCalc[0] = 12; }
     if(currentStatus.advance >= 10 )
     {
-      triggerInfo.ignition1EndTooth = 12;
-      triggerInfo.ignition2EndTooth = 3;
-      triggerInfo.ignition3EndTooth = 6;
-      triggerInfo.ignition4EndTooth = 9;
+      ignitionEndTeethCalc[0] = 12;
+      ignitionEndTeethCalc[1] = 3;
+      ignitionEndTeethCalc[2] = 6;
+      ignitionEndTeethCalc[3] = 9;
     }
     else
     {
-      triggerInfo.ignition1EndTooth = 1;
-      triggerInfo.ignition2EndTooth = 4;
-      triggerInfo.ignition3EndTooth = 7;
-      triggerInfo.ignition4EndTooth = 10;
+      ignitionEndTeethCalc[0] = 1;
+      ignitionEndTeethCalc[1] = 4;
+      ignitionEndTeethCalc[2] = 7;
+      ignitionEndTeethCalc[3] = 10;
     }
   }
   else
   {
     if(currentStatus.advance >= 10 )
     {
-      triggerInfo.ignition1EndTooth = 6;
-      triggerInfo.ignition2EndTooth = 3;
-      //triggerInfo.ignition3EndTooth = 6;
-      //triggerInfo.ignition4EndTooth = 9;
+      ignitionEndTeethCalc[0] = 6;
+      ignitionEndTeethCalc[1] = 3;
+      //ignitionEndTeethCalc[2] = 6;
+      //ignitionEndTeethCalc[3] = 9;
     }
     else
     {
-      triggerInfo.ignition1EndTooth = 1;
-      triggerInfo.ignition2EndTooth = 4;
-      //triggerInfo.ignition3EndTooth = 7;
-      //triggerInfo.ignition4EndTooth = 10;
+      ignitionEndTeethCalc[0] = 1;
+      ignitionEndTeethCalc[1] = 4;
+      //ignitionEndTeethCalc[2] = 7;
+      //ignitionEndTeethCalc[3] = 10;
     }
   }
 }
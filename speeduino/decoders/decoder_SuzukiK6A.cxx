@@ -54,7 +54,7 @@ void triggerSetup_SuzukiK6A(void)
 
 void triggerPri_SuzukiK6A(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( (triggerInfo.curGap >= triggerInfo.triggerFilterTime) || (currentStatus.startRevolutions == 0U) )
   {
@@ -322,9 +322,9 @@ static uint16_t __attribute__((noinline)) calcEndTeeth_SuzukiK6A(int ignitionAng
 
 void triggerSetEndTeeth_SuzukiK6A(void)
 {
-  triggerInfo.ignition1EndTooth = calcEndTeeth_SuzukiK6A(ignition1EndAngle);
-  triggerInfo.ignition2EndTooth = calcEndTeeth_SuzukiK6A(ignition2EndAngle);
-  triggerInfo.ignition3EndTooth = calcEndTeeth_SuzukiK6A(ignition3EndAngle);
+  ignitionEndTeethCalc[0] = calcEndTeeth_SuzukiK6A(ignition1EndAngle);
+  ignitionEndTeethCalc[1] = calcEndTeeth_SuzukiK6A(ignition2EndAngle);
+  ignitionEndTeethCalc[2] = calcEndTeeth_SuzukiK6A(ignition3EndAngle);
 }
 
 /** @} */
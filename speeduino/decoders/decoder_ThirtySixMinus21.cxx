@@ -23,7 +23,7 @@ void triggerSetup_ThirtySixMinus21(void)
 
 void triggerPri_ThirtySixMinus21(void)
 {
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
    if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime ) //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
    {
@@ -122,8 +122,8 @@ int getCrankAngle_ThirtySixMinus21(void)
 
 void triggerSetEndTeeth_ThirtySixMinus21(void)
 {
-  triggerInfo.ignition1EndTooth = 10;
-  triggerInfo.ignition2EndTooth = 28; // Arbitrarily picked  at 180°.
+  ignitionEndTeethCalc[0] = 10;
+  ignitionEndTeethCalc[1] = 28; // Arbitrarily picked  at 180°.
 }
 /** @} */
 
@@ -29,7 +29,7 @@ void triggerSetup_ThirtySixMinus222(void)
 
 void triggerPri_ThirtySixMinus222(void)
 {
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
    if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime ) //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
    {
@@ -156,31 +156,31 @@ void triggerSetEndTeeth_ThirtySixMinus222(void)
 {
   if(configPage2.nCylinders == 4 )
   {
-    if(currentStatus.advance < 10) { triggerInfo.ignition1EndTooth = 36; }
-    else if(currentStatus.advance < 20) { triggerInfo.ignition1EndTooth = 35; }
-    else if(currentStatus.advance < 30) { triggerInfo.ignition1EndTooth = 34; }
-    else { triggerInfo.ignition1EndTooth = 31; }
+    if(currentStatus.advance < 10) { ignitionEndTeethCalc[0] = 36; }
+    else if(currentStatus.advance < 20) { ignitionEndTeethCalc[0] = 35; }
+    else if(currentStatus.advance < 30) { ignitionEndTeethCalc[0] = 34; }
+    else { ignitionEndTeethCalc[0] = 31; }
 
-    if(currentStatus.advance < 30) { triggerInfo.ignition2EndTooth = 16; }
-    else { triggerInfo.ignition2EndTooth = 13; }
+    if(currentStatus.advance < 30) { ignitionEndTeethCalc[1] = 16; }
+    else { ignitionEndTeethCalc[1] = 13; }
   }
   else if(configPage2.nCylinders == 6)
   {
     //H6
-    if(currentStatus.advance < 10) { triggerInfo.ignition1EndTooth = 36; }
-    else if(currentStatus.advance < 20) { triggerInfo.ignition1EndTooth = 35; }
-    else if(currentStatus.advance < 30) { triggerInfo.ignition1EndTooth = 34; }
-    else if(currentStatus.advance < 40) { triggerInfo.ignition1EndTooth = 33; }
-    else { triggerInfo.ignition1EndTooth = 31; }
-
-    if(currentStatus.advance < 20) { triggerInfo.ignition2EndTooth = 9; }
-    else { triggerInfo.ignition2EndTooth = 6; }
-
-    if(currentStatus.advance < 10) { triggerInfo.ignition3EndTooth = 23; }
-    else if(currentStatus.advance < 20) { triggerInfo.ignition3EndTooth = 22; }
-    else if(currentStatus.advance < 30) { triggerInfo.ignition3EndTooth = 21; }
-    else if(currentStatus.advance < 40) { triggerInfo.ignition3EndTooth = 20; }
-    else { triggerInfo.ignition3EndTooth = 19; }
+    if(currentStatus.advance < 10) { ignitionEndTeethCalc[0] = 36; }
+    else if(currentStatus.advance < 20) { ignitionEndTeethCalc[0] = 35; }
+    else if(currentStatus.advance < 30) { ignitionEndTeethCalc[0] = 34; }
+    else if(currentStatus.advance < 40) { ignitionEndTeethCalc[0] = 33; }
+    else { ignitionEndTeethCalc[0] = 31; }
+
+    if(currentStatus.advance < 20) { ignitionEndTeethCalc[1] = 9; }
+    else { ignitionEndTeethCalc[1] = 6; }
+
+    if(currentStatus.advance < 10) { ignitionEndTeethCalc[2] = 23; }
+    else if(currentStatus.advance < 20) { ignitionEndTeethCalc[2] = 22; }
+    else if(currentStatus.advance < 30) { ignitionEndTeethCalc[2] = 21; }
+    else if(currentStatus.advance < 40) { ignitionEndTeethCalc[2] = 20; }
+    else { ignitionEndTeethCalc[2] = 19; }
   }
 }
 /** @} */
@@ -30,7 +30,7 @@ void triggerSetup_Vmax(void)
 
 void triggerPri_Vmax(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   if(READ_PRI_TRIGGER() == primaryTriggerEdge){// Forwarded from the config page to setup the primary trigger edge (rising or falling). Inverting VR-conditioners require FALLING, non-inverting VR-conditioners require RISING in the Trigger edge setup.
     triggerInfo.curGap2 = triggerInfo.curTime;
     triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
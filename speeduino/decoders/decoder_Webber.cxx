@@ -6,7 +6,7 @@ Uses DualWheel decoders, There can be no missing teeth on the primary wheel.
 */
 void triggerPri_Webber(void)
 {
-  triggerInfo.curTime = micros();
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
   triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
   if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime )
   {
@@ -57,7 +57,7 @@ void triggerPri_Webber(void)
 
 void triggerSec_Webber(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
   if ( triggerInfo.curGap2 >= triggerInfo.triggerSecFilterTime )
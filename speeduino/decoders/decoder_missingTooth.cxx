@@ -35,18 +35,33 @@ void triggerSetup_missingTooth(void)
   triggerInfo.thirdToothCount = 0;
   triggerInfo.toothOneTime = 0;
   triggerInfo.toothOneMinusOneTime = 0;
+  fastSyncUnconfirmed = false;
   MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerInfo.triggerToothAngle * (configPage4.triggerMissingTeeth + 1U)); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
 
   if( (configPage4.TrigSpeed == CRANK_SPEED) && ( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage2.injLayout == INJ_SEQUENTIAL) || (configPage6.vvtEnabled > 0)) ) { BIT_SET(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY); }
   else { BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY); }
-#ifdef USE_LIBDIVIDE
-  divtriggerInfo.triggerToothAngle = libdivide::libdivide_s16_gen(triggerInfo.triggerToothAngle);
-#endif
+  initialiseToothAngles();
+}
+
+/** Fast sync: Called on the first tooth of a start. Carries the tooth count on from the tooth the engine stopped at and
+ * runs at half sync (Wasted spark and batch injection) until the missing tooth confirms it. See triggerStoreStopPosition()
+ */
+static void fastSyncStart_missingTooth(void)
+{
+  uint8_t stopTooth = fastSyncTooth;
+  fastSyncTooth = 0U; //Only used for one start
+
+  //The first 2 teeth of a start are only timed, so the gap can't be checked if it falls between them. Sync normally instead
+  if(stopTooth == (triggerInfo.triggerActualTeeth - 1U)) { return; }
+
+  triggerInfo.toothCurrentCount = (stopTooth >= triggerInfo.triggerActualTeeth) ? 1U : (stopTooth + 1U);
+  fastSyncUnconfirmed = true;
+  BIT_SET(currentStatus.status3, BIT_STATUS3_HALFSYNC);
 }
 
 void triggerPri_missingTooth(void)
 {
-   triggerInfo.curTime = micros();
+   triggerInfo.curTime = TRIGGER_TIMESTAMP();
    triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
    if ( triggerInfo.curGap >= triggerInfo.triggerFilterTime ) //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
    {
@@ -74,6 +89,17 @@ void triggerPri_missingTooth(void)
 
           if( (triggerInfo.toothLastToothTime == 0) || (triggerInfo.toothLastMinusOneToothTime == 0) ) { triggerInfo.curGap = 0; }
 
+          if( (fastSyncUnconfirmed == true) && ((triggerInfo.curGap > triggerInfo.targetGap) || (triggerInfo.toothCurrentCount > triggerInfo.triggerActualTeeth)) )
+          {
+            //The first gap since a fast sync start, either seen or expected. If it isn't exactly where the stop position put it (Eg the engine was turned while stopped), drop the half sync and sync normally
+            fastSyncUnconfirmed = false;
+            if( (triggerInfo.curGap <= triggerInfo.targetGap) || (triggerInfo.toothCurrentCount != (triggerInfo.triggerActualTeeth + 1U)) )
+            {
+              BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+              if(triggerInfo.curGap <= triggerInfo.targetGap) { triggerInfo.toothCurrentCount = 1; } //Not the gap. Count on from here as on startup
+            }
+          }
+
           if ( (triggerInfo.curGap > triggerInfo.targetGap) || (triggerInfo.toothCurrentCount > triggerInfo.triggerActualTeeth) )
           {
             //Missing tooth detected
@@ -143,6 +169,7 @@ void triggerPri_missingTooth(void)
       else
       {
         //We fall here on initial startup when enough teeth have not yet been seen
+        if( (triggerInfo.toothLastToothTime == 0UL) && (fastSyncTooth > 0U) && (configPage15.fastSyncEnable == true) ) { fastSyncStart_missingTooth(); }
         triggerInfo.toothLastMinusOneToothTime = triggerInfo.toothLastToothTime;
         triggerInfo.toothLastToothTime = triggerInfo.curTime;
       }
@@ -151,7 +178,7 @@ void triggerPri_missingTooth(void)
       //NEW IGNITION MODE
       if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) )
       {
-        int16_t crankAngle = ( (triggerInfo.toothCurrentCount-1) * triggerInfo.triggerToothAngle ) + configPage4.triggerAngle;
+        int16_t crankAngle = toothAngle(triggerInfo.toothCurrentCount, false) + configPage4.triggerAngle;
         if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (triggerInfo.revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) && (configPage2.strokes == FOUR_STROKE) )
         {
           crankAngle += 360;
@@ -165,7 +192,7 @@ void triggerPri_missingTooth(void)
 
 void triggerSec_missingTooth(void)
 {
-  triggerInfo.curTime2 = micros();
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
   triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
 
   //Safety check for initial startup
@@ -250,7 +277,7 @@ void triggerThird_missingTooth(void)
 //NB no filtering of this signal with current implementation unlike Cam (VVT1)
 
   int16_t curAngle;
-  triggerInfo.curTime3 = micros();
+  triggerInfo.curTime3 = TRIGGER_THIRD_TIMESTAMP();
   triggerInfo.curGap3 = triggerInfo.curTime3 - triggerInfo.toothLastThirdToothTime;
 
   //Safety check for initial startup
@@ -307,10 +334,7 @@ int getCrankAngle_missingTooth(void)
     temptoothLastToothTime = triggerInfo.toothLastToothTime;
     interrupts();
 
-    int crankAngle = ((temptoothCurrentCount - 1) * triggerInfo.triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
-
-    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
-    if ( (temprevolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
+    int crankAngle = toothAngle(temptoothCurrentCount, temprevolutionOne) + configPage4.triggerAngle; //The angle of the last tooth seen (Including which revolution of the cycle it is on), plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
 
     triggerInfo.lastCrankAngleCalc = micros();
     triggerInfo.elapsedTime = (triggerInfo.lastCrankAngleCalc - temptoothLastToothTime);
@@ -326,11 +350,7 @@ int getCrankAngle_missingTooth(void)
 static uint16_t __attribute__((noinline)) calcEndTeeth_missingTooth(int endAngle, uint8_t toothAdder) {
   //Temp variable used here to avoid potential issues if a trigger interrupt occurs part way through this function
   int16_t tempEndTooth;
-#ifdef USE_LIBDIVIDE
-  tempEndTooth = libdivide::libdivide_s16_do(endAngle - configPage4.triggerAngle, &divtriggerInfo.triggerToothAngle);
-#else
-  tempEndTooth = (endAngle - (int16_t)configPage4.triggerAngle) / (int16_t)triggerInfo.triggerToothAngle;
-#endif
+  tempEndTooth = toothAngleDivide(endAngle - (int16_t)configPage4.triggerAngle);
   //For higher tooth count triggers, add a 1 tooth margin to allow for calculation time.
   if(configPage4.triggerTeeth > 12U) { tempEndTooth = tempEndTooth - 1; }
 
@@ -343,21 +363,21 @@ void triggerSetEndTeeth_missingTooth(void)
   uint8_t toothAdder = 0;
   if( ((configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage4.sparkMode == IGN_MODE_SINGLE)) && (configPage4.TrigSpeed == CRANK_SPEED) && (configPage2.strokes == FOUR_STROKE) ) { toothAdder = configPage4.triggerTeeth; }
 
-  triggerInfo.ignition1EndTooth = calcEndTeeth_missingTooth(ignition1EndAngle, toothAdder);
-  triggerInfo.ignition2EndTooth = calcEndTeeth_missingTooth(ignition2EndAngle, toothAdder);
-  triggerInfo.ignition3EndTooth = calcEndTeeth_missingTooth(ignition3EndAngle, toothAdder);
-  triggerInfo.ignition4EndTooth = calcEndTeeth_missingTooth(ignition4EndAngle, toothAdder);
+  ignitionEndTeethCalc[0] = calcEndTeeth_missingTooth(ignition1EndAngle, toothAdder);
+  ignitionEndTeethCalc[1] = calcEndTeeth_missingTooth(ignition2EndAngle, toothAdder);
+  ignitionEndTeethCalc[2] = calcEndTeeth_missingTooth(ignition3EndAngle, toothAdder);
+  ignitionEndTeethCalc[3] = calcEndTeeth_missingTooth(ignition4EndAngle, toothAdder);
 #if IGN_CHANNELS >= 5
-  triggerInfo.ignition5EndTooth = calcEndTeeth_missingTooth(ignition5EndAngle, toothAdder);
+  ignitionEndTeethCalc[4] = calcEndTeeth_missingTooth(ignition5EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 6
-  triggerInfo.ignition6EndTooth = calcEndTeeth_missingTooth(ignition6EndAngle, toothAdder);
+  ignitionEndTeethCalc[5] = calcEndTeeth_missingTooth(ignition6EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 7
-  triggerInfo.ignition7EndTooth = calcEndTeeth_missingTooth(ignition7EndAngle, toothAdder);
+  ignitionEndTeethCalc[6] = calcEndTeeth_missingTooth(ignition7EndAngle, toothAdder);
 #endif
 #if IGN_CHANNELS >= 8
-  triggerInfo.ignition8EndTooth = calcEndTeeth_missingTooth(ignition8EndAngle, toothAdder);
+  ignitionEndTeethCalc[7] = calcEndTeeth_missingTooth(ignition8EndAngle, toothAdder);
 #endif
 }
 /** @} */
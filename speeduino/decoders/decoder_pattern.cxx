@@ -0,0 +1,434 @@
+
+
+/** Pattern table decoder.
+* The wheel is described as data (See triggerPatterns below) rather than code: the angle of every tooth over either one crank revolution or the full cycle.
+* New wheels only need a table entry. configPage4.triggerMissingTeeth selects the entry, as the missing teeth setting is not otherwise used by this decoder.
+*
+* At setup the gap between each tooth and the one before it is turned into a ratio to the previous gap, and each tooth is given a window of accepted ratios
+* that reaches halfway to the nearest different ratio in the pattern. Ratios within 25% of each other cannot be reliably told apart while the engine is
+* accelerating, so are treated as the same. The shortest run of consecutive gaps that only occurs once in the pattern (Its signature)
+* identifies the sync tooth.
+* Once synced the next tooth is always known, so each edge is a single check of the gap against that tooth's window (2 multiplies, no divides).
+* A gap outside of its window is a sync loss, after which the signature is searched for again.
+* Patterns with no signature (Eg Evenly spaced teeth) require the cam: the cam edge then marks the end of the pattern, so the next tooth is tooth 1.
+* For crank speed patterns the cam edge otherwise only marks which revolution of the cycle is next, as with the missing tooth decoder.
+* @defgroup dec_pattern Pattern table
+* @{
+*/
+
+static const int16_t patternGM24X[] PROGMEM = {
+  12, 18, 33, 48, 63, 78, 102, 108, 123, 138, 162, 177,
+  183, 198, 222, 237, 252, 258, 282, 288, 312, 327, 342, 357
+};
+static const int16_t pattern36_2_2_2[] PROGMEM = {
+  0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110,
+  120, 150, 160, 170, 180, 190, 200, 210, 220, 230, 240, 250,
+  260, 270, 280, 290, 300, 330
+};
+static const int16_t pattern36_2_1[] PROGMEM = {
+  0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110,
+  120, 130, 140, 150, 160, 170, 190, 200, 210, 220, 230, 240,
+  250, 260, 270, 280, 290, 300, 310, 320, 330
+};
+//Nominal spacing. The real teeth before each gap are ~3 degrees longer, which is well within the tooth windows
+static const int16_t patternHondaJ32[] PROGMEM = {
+  15, 30, 45, 60, 75, 90, 105, 135, 150, 165, 180, 195,
+  210, 225, 240, 255, 270, 285, 300, 315, 330, 345
+};
+static const int16_t patternSuzukiK6A[] PROGMEM = { 0, 170, 240, 410, 480, 515, 650 };
+
+#define PATTERN_ENTRY(angles, cycle) { (uint8_t)(sizeof(angles) / sizeof(angles[0])), (cycle), (angles) }
+
+/** The wheels, in the order of the pattern list in the ini file */
+constexpr triggerPattern_t triggerPatterns[] = {
+  PATTERN_ENTRY(patternGM24X, 360),
+  PATTERN_ENTRY(pattern36_2_2_2, 360),
+  PATTERN_ENTRY(pattern36_2_1, 360),
+  PATTERN_ENTRY(patternHondaJ32, 360),
+  PATTERN_ENTRY(patternSuzukiK6A, 720),
+};
+const uint8_t triggerPatternCount = sizeof(triggerPatterns) / sizeof(triggerPatterns[0]);
+
+/** The most teeth of any entry from index onwards. The per tooth values are sized from this, rather than for PATTERN_MAX_TEETH */
+static constexpr uint8_t patternLongest(uint8_t index)
+{
+  return (index >= triggerPatternCount) ? 0U
+       : ((triggerPatterns[index].teeth > patternLongest(index + 1U)) ? triggerPatterns[index].teeth : patternLongest(index + 1U));
+}
+static_assert(patternLongest(0U) <= PATTERN_MAX_TEETH, "A trigger pattern has more than PATTERN_MAX_TEETH teeth");
+
+#define PATTERN_GAP_HISTORY 16U //Must be a power of 2 greater than PATTERN_MAX_SIGNATURE
+
+/** Per tooth values derived from the pattern by triggerSetup_pattern() */
+struct patternTooth_t {
+  uint16_t gapAngle; ///< Crank degrees from the previous tooth
+  uint16_t ratio;    ///< This tooth's gap divided by the previous tooth's gap (x256)
+  uint16_t ratioMin; ///< The smallest gap ratio (x256) accepted for this tooth
+  uint16_t ratioMax; ///< The largest gap ratio (x256) accepted for this tooth
+};
+
+static const triggerPattern_t *pattern = &triggerPatterns[0];
+static patternTooth_t patternTeeth[patternLongest(0U)];
+static uint8_t patternSyncTooth; //The tooth the signature ends at. 0 if the pattern has no signature and the cam must be used
+static uint8_t patternSignatureLength; //The number of consecutive gaps in the signature
+static uint16_t patternMinRatio; //The smallest gap ratio in the pattern (x256). Used for the filter before sync
+static uint32_t patternGaps[PATTERN_GAP_HISTORY]; //The most recent tooth gaps
+static uint8_t patternGapHead; //Where the next gap will be written in patternGaps
+static uint8_t patternGapCount; //How many of patternGaps are valid
+
+/** The angle of a tooth of the selected pattern. The angles are in flash */
+static inline int16_t patternToothAngle(uint8_t toothIndex) { return (int16_t)pgm_read_word(&pattern->toothAngles[toothIndex]); }
+
+static inline uint8_t patternPreviousTooth(uint8_t toothIndex) { return (toothIndex == 0U) ? (pattern->teeth - 1U) : (toothIndex - 1U); }
+
+/** The gap n teeth ago. 0 is the gap just measured */
+static inline uint32_t patternGap(uint8_t n) { return patternGaps[(patternGapHead - 1U - n) & (PATTERN_GAP_HISTORY - 1U)]; }
+
+/** Whether 2 gap ratios are far enough apart to tell the teeth apart */
+static inline bool patternRatiosDiffer(uint32_t ratio1, uint32_t ratio2)
+{
+  return ((ratio1 * 4U) > (ratio2 * 5U)) || ((ratio2 * 4U) > (ratio1 * 5U));
+}
+
+static inline bool patternGapInWindow(uint32_t gap, uint32_t lastGap, uint8_t toothIndex)
+{
+  uint32_t scaledGap = gap << 8;
+  return (scaledGap >= (lastGap * patternTeeth[toothIndex].ratioMin)) && (scaledGap <= (lastGap * patternTeeth[toothIndex].ratioMax));
+}
+
+/** Whether the tune needs the 2 crank revolutions of a crank speed pattern to be told apart */
+static inline bool patternIsSequential(void)
+{
+  return (pattern->cycleDegrees == 360U) && (configPage2.strokes == FOUR_STROKE) && ( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage2.injLayout == INJ_SEQUENTIAL) );
+}
+
+/** Finds the shortest run of gap ratios that only occurs once in the pattern. This only runs at setup, so is not concerned with speed */
+static void patternFindSignature(void)
+{
+  uint8_t teeth = pattern->teeth;
+  patternSyncTooth = 0;
+  patternSignatureLength = 0;
+
+  for(uint8_t length = 1; length <= PATTERN_MAX_SIGNATURE; length++)
+  {
+    for(uint8_t candidate = 0; candidate < teeth; candidate++)
+    {
+      bool unique = true;
+      for(uint8_t other = 0; (other < teeth) && unique; other++)
+      {
+        if(other == candidate) { continue; }
+        bool differs = false;
+        uint8_t x = candidate;
+        uint8_t y = other;
+        for(uint8_t step = 0; (step < length) && !differs; step++)
+        {
+          differs = patternRatiosDiffer(patternTeeth[x].ratio, patternTeeth[y].ratio);
+          x = patternPreviousTooth(x);
+          y = patternPreviousTooth(y);
+        }
+        unique = differs;
+      }
+      if(unique)
+      {
+        patternSyncTooth = candidate + 1U;
+        patternSignatureLength = length;
+        return;
+      }
+    }
+  }
+}
+
+void triggerSetup_pattern(void)
+{
+  pattern = &triggerPatterns[(configPage4.triggerMissingTeeth < triggerPatternCount) ? configPage4.triggerMissingTeeth : 0U];
+  uint8_t teeth = pattern->teeth;
+
+  uint16_t minGap = UINT16_MAX;
+  uint16_t maxGap = 0;
+  for(uint8_t x = 0; x < teeth; x++)
+  {
+    int16_t gap = patternToothAngle(x) - patternToothAngle(patternPreviousTooth(x));
+    if(gap <= 0) { gap += pattern->cycleDegrees; }
+    patternTeeth[x].gapAngle = gap;
+    if(patternTeeth[x].gapAngle < minGap) { minGap = patternTeeth[x].gapAngle; }
+    if(patternTeeth[x].gapAngle > maxGap) { maxGap = patternTeeth[x].gapAngle; }
+  }
+
+  patternMinRatio = UINT16_MAX;
+  for(uint8_t x = 0; x < teeth; x++)
+  {
+    uint32_t ratio = ((uint32_t)patternTeeth[x].gapAngle << 8) / patternTeeth[patternPreviousTooth(x)].gapAngle;
+    patternTeeth[x].ratio = (uint16_t)min(ratio, (uint32_t)UINT16_MAX);
+    if(patternTeeth[x].ratio < patternMinRatio) { patternMinRatio = patternTeeth[x].ratio; }
+  }
+
+  //Each window reaches halfway to the nearest different ratio either side. When there is none, the window is open by a factor of 2
+  for(uint8_t x = 0; x < teeth; x++)
+  {
+    uint32_t ratio = patternTeeth[x].ratio;
+    uint32_t below = 0;
+    uint32_t above = UINT32_MAX;
+    for(uint8_t y = 0; y < teeth; y++)
+    {
+      uint32_t other = patternTeeth[y].ratio;
+      if(patternRatiosDiffer(ratio, other) == false) { continue; }
+      if( (other < ratio) && (other > below) ) { below = other; }
+      if( (other > ratio) && (other < above) ) { above = other; }
+    }
+    patternTeeth[x].ratioMin = (below == 0U) ? (ratio >> 1) : ((ratio + below) >> 1);
+    patternTeeth[x].ratioMax = (uint16_t)min( (above == UINT32_MAX) ? (ratio << 1) : ((ratio + above) >> 1), (uint32_t)UINT16_MAX );
+  }
+
+  patternFindSignature();
+
+  triggerInfo.triggerToothAngle = patternTeeth[0].gapAngle;
+  triggerInfo.triggerFilterTime = (minGap * MICROS_PER_DEG_1_RPM) / MAX_RPM; //The shortest gap in the pattern at max RPM
+  triggerInfo.triggerSecFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U));
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * maxGap); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  triggerInfo.toothCurrentCount = 0;
+  triggerInfo.secondaryToothCount = 0;
+  triggerInfo.toothOneTime = 0;
+  triggerInfo.toothOneMinusOneTime = 0;
+  triggerInfo.toothLastMinusOneToothTime = 0;
+  patternGapHead = 0;
+  patternGapCount = 0;
+
+  BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_2ND_DERIV);
+  if( (pattern->cycleDegrees == 720U) || (patternSyncTooth == 0U) ) { BIT_SET(triggerInfo.decoderState, BIT_DECODER_IS_SEQUENTIAL); }
+  else { BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_IS_SEQUENTIAL); }
+  if( (patternSyncTooth == 0U) || patternIsSequential() || ((pattern->cycleDegrees == 360U) && (configPage6.vvtEnabled > 0)) ) { BIT_SET(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY); }
+  else { BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY); }
+}
+
+/** Sets the sync state once the position in the pattern is known. revolutionKnown is whether the cam has been seen in time to mark this revolution */
+static void patternSetSync(bool revolutionKnown)
+{
+  if( (patternIsSequential() == false) || revolutionKnown )
+  {
+    currentStatus.hasSync = true;
+    BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+  }
+  else if(currentStatus.hasSync == false) { BIT_SET(currentStatus.status3, BIT_STATUS3_HALFSYNC); }
+}
+
+static void patternToothOne(void)
+{
+  if( (currentStatus.hasSync == true) || BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) )
+  {
+    currentStatus.startRevolutions++; //Counter
+    if(pattern->cycleDegrees == 720U) { currentStatus.startRevolutions++; }
+  }
+  else { currentStatus.startRevolutions = 0; }
+
+  triggerInfo.toothOneMinusOneTime = triggerInfo.toothOneTime;
+  triggerInfo.toothOneTime = triggerInfo.curTime;
+  triggerInfo.revolutionOne = !triggerInfo.revolutionOne; //Flip sequential revolution tracker
+
+  patternSetSync(triggerInfo.secondaryToothCount > 0U);
+  triggerInfo.secondaryToothCount = 0;
+}
+
+/** Looks for the position in the pattern when there is no sync. Returns true if the current tooth is now known */
+static bool patternFindPosition(void)
+{
+  if(patternSyncTooth > 0U)
+  {
+    if(patternGapCount <= patternSignatureLength) { return false; }
+
+    uint8_t toothIndex = patternSyncTooth - 1U;
+    for(uint8_t n = 0; n < patternSignatureLength; n++)
+    {
+      if(patternGapInWindow(patternGap(n), patternGap(n + 1U), toothIndex) == false) { return false; }
+      toothIndex = patternPreviousTooth(toothIndex);
+    }
+
+    triggerInfo.toothCurrentCount = patternSyncTooth;
+    //Which revolution this is cannot be known until tooth 1 comes around
+    if(patternSyncTooth == 1U) { patternToothOne(); }
+    else { patternSetSync(false); }
+    return true;
+  }
+
+  if( (triggerInfo.secondaryToothCount > 0U) && (triggerInfo.toothCurrentCount == pattern->teeth) )
+  {
+    //The cam has marked the end of the pattern
+    triggerInfo.toothCurrentCount = 1;
+    patternToothOne();
+    return true;
+  }
+  return false;
+}
+
+void triggerPri_pattern(void)
+{
+  triggerInfo.curTime = TRIGGER_TIMESTAMP();
+  triggerInfo.curGap = triggerInfo.curTime - triggerInfo.toothLastToothTime;
+  if ( triggerInfo.curGap < triggerInfo.triggerFilterTime ) { return; } //Pulses should never be less than triggerInfo.triggerFilterTime, so if they are it means a false trigger.
+
+  BIT_SET(triggerInfo.decoderState, BIT_DECODER_VALID_TRIGGER); //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+  if(triggerInfo.toothLastToothTime == 0U) { patternGapCount = 0; } //First tooth since startup or a stall, there is no gap yet
+  else
+  {
+    patternGaps[patternGapHead] = triggerInfo.curGap;
+    patternGapHead = (patternGapHead + 1U) & (PATTERN_GAP_HISTORY - 1U);
+    if(patternGapCount < PATTERN_GAP_HISTORY) { patternGapCount++; }
+  }
+
+  bool positionKnown = false;
+  if( (currentStatus.hasSync == true) || BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) )
+  {
+    uint8_t tooth = (triggerInfo.toothCurrentCount >= pattern->teeth) ? 1U : (triggerInfo.toothCurrentCount + 1U);
+    if( (patternGapCount > 1U) && (patternGapInWindow(triggerInfo.curGap, patternGap(1), tooth - 1U) == false) )
+    {
+      //This gap does not belong to the tooth that was expected
+      currentStatus.hasSync = false;
+      BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC); //No sync at all, so also clear HalfSync bit.
+      currentStatus.syncLossCounter++;
+      triggerInfo.toothCurrentCount = 0;
+      triggerInfo.secondaryToothCount = 0;
+      positionKnown = patternFindPosition();
+    }
+    else
+    {
+      triggerInfo.toothCurrentCount = tooth;
+      if(tooth == 1U) { patternToothOne(); }
+      positionKnown = true;
+    }
+  }
+  else { positionKnown = patternFindPosition(); }
+
+  if(positionKnown)
+  {
+    uint8_t toothIndex = triggerInfo.toothCurrentCount - 1U;
+    uint8_t nextIndex = (triggerInfo.toothCurrentCount >= pattern->teeth) ? 0U : triggerInfo.toothCurrentCount;
+    triggerInfo.triggerToothAngle = patternTeeth[toothIndex].gapAngle;
+    BIT_SET(triggerInfo.decoderState, BIT_DECODER_TOOTH_ANG_CORRECT);
+    if(patternGapCount > 0U) { setFilter((triggerInfo.curGap * patternTeeth[nextIndex].ratio) >> 8); } //Filter on the expected length of the next gap
+    else { triggerInfo.triggerFilterTime = 0; }
+
+    //NEW IGNITION MODE
+    if( (configPage2.perToothIgn == true) && (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) )
+    {
+      int16_t crankAngle = patternToothAngle(toothIndex) + configPage4.triggerAngle;
+      uint16_t tooth = triggerInfo.toothCurrentCount;
+      if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (triggerInfo.revolutionOne == true) && patternIsSequential() )
+      {
+        crankAngle += 360;
+        tooth += pattern->teeth;
+      }
+      crankAngle = ignitionLimits(crankAngle);
+      checkPerToothTiming(crankAngle, tooth);
+    }
+  }
+  else
+  {
+    BIT_CLEAR(triggerInfo.decoderState, BIT_DECODER_TOOTH_ANG_CORRECT);
+    if(patternGapCount > 0U) { setFilter((triggerInfo.curGap * patternMinRatio) >> 8); }
+    else { triggerInfo.triggerFilterTime = 0; }
+  }
+
+  triggerInfo.toothLastMinusOneToothTime = triggerInfo.toothLastToothTime;
+  triggerInfo.toothLastToothTime = triggerInfo.curTime;
+}
+
+void triggerSec_pattern(void)
+{
+  triggerInfo.curTime2 = TRIGGER_SEC_TIMESTAMP();
+  triggerInfo.curGap2 = triggerInfo.curTime2 - triggerInfo.toothLastSecToothTime;
+
+  if ( triggerInfo.curGap2 >= triggerInfo.triggerSecFilterTime )
+  {
+    if(patternSyncTooth == 0U)
+    {
+      //Without a signature the cam edge marks the end of the pattern. If the count does not agree, teeth have been missed or added
+      if( (currentStatus.hasSync == true) && (triggerInfo.toothCurrentCount != pattern->teeth) ) { currentStatus.syncLossCounter++; }
+      triggerInfo.toothCurrentCount = pattern->teeth;
+    }
+    triggerInfo.revolutionOne = 1; //Sequential revolution reset
+    triggerInfo.secondaryToothCount++;
+    if(triggerInfo.toothLastSecToothTime > 0U) { triggerInfo.triggerSecFilterTime = triggerInfo.curGap2 >> 1; } //Next secondary filter is half the current gap
+    triggerInfo.toothLastSecToothTime = triggerInfo.curTime2;
+    triggerRecordVVT1Angle();
+  }
+}
+
+uint16_t getRPM_pattern(void)
+{
+  return stdGetRPM(pattern->cycleDegrees == 720U);
+}
+
+int getCrankAngle_pattern(void)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel
+    unsigned long temptoothLastToothTime;
+    int temptoothCurrentCount;
+    bool temprevolutionOne;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    temptoothCurrentCount = triggerInfo.toothCurrentCount;
+    temprevolutionOne = triggerInfo.revolutionOne;
+    temptoothLastToothTime = triggerInfo.toothLastToothTime;
+    interrupts();
+
+    int crankAngle = configPage4.triggerAngle;
+    if(temptoothCurrentCount > 0) { crankAngle += patternToothAngle(temptoothCurrentCount - 1); } //Perform a lookup of the pattern to find what the angle of the last tooth passed was
+
+    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
+    if ( (temprevolutionOne == true) && (pattern->cycleDegrees == 360U) ) { crankAngle += 360; }
+
+    triggerInfo.lastCrankAngleCalc = micros();
+    triggerInfo.elapsedTime = (triggerInfo.lastCrankAngleCalc - temptoothLastToothTime);
+    crankAngle += timeToAngleDegPerMicroSec(triggerInfo.elapsedTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+/** The last tooth before the given end angle. Runs from the main loop, so a simple search of the pattern is used */
+static uint16_t calcEndTeeth_pattern(int endAngle, bool bothRevolutions)
+{
+  int16_t span = bothRevolutions ? 720 : (int16_t)pattern->cycleDegrees;
+  int16_t angle = endAngle - configPage4.triggerAngle;
+  while(angle < 0) { angle += span; }
+  while(angle >= span) { angle -= span; }
+
+  uint16_t toothCount = bothRevolutions ? (pattern->teeth * 2U) : pattern->teeth;
+  uint16_t tempEndTooth = toothCount; //Before tooth 1, the last tooth seen is the final one of the cycle
+  for(uint16_t tooth = 0; tooth < toothCount; tooth++)
+  {
+    int16_t toothAngle = (tooth < pattern->teeth) ? patternToothAngle(tooth) : (patternToothAngle(tooth - pattern->teeth) + 360);
+    if(toothAngle > angle) { break; }
+    tempEndTooth = tooth + 1U;
+  }
+
+  //For higher tooth count triggers, add a 1 tooth margin to allow for calculation time.
+  if(pattern->teeth > 12U) { tempEndTooth = (tempEndTooth > 1U) ? (tempEndTooth - 1U) : toothCount; }
+  return tempEndTooth;
+}
+
+void triggerSetEndTeeth_pattern(void)
+{
+  bool bothRevolutions = (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && patternIsSequential();
+
+  ignitionEndTeethCalc[0] = calcEndTeeth_pattern(ignition1EndAngle, bothRevolutions);
+  ignitionEndTeethCalc[1] = calcEndTeeth_pattern(ignition2EndAngle, bothRevolutions);
+  ignitionEndTeethCalc[2] = calcEndTeeth_pattern(ignition3EndAngle, bothRevolutions);
+  ignitionEndTeethCalc[3] = calcEndTeeth_pattern(ignition4EndAngle, bothRevolutions);
+#if IGN_CHANNELS >= 5
+  ignitionEndTeethCalc[4] = calcEndTeeth_pattern(ignition5EndAngle, bothRevolutions);
+#endif
+#if IGN_CHANNELS >= 6
+  ignitionEndTeethCalc[5] = calcEndTeeth_pattern(ignition6EndAngle, bothRevolutions);
+#endif
+#if IGN_CHANNELS >= 7
+  ignitionEndTeethCalc[6] = calcEndTeeth_pattern(ignition7EndAngle, bothRevolutions);
+#endif
+#if IGN_CHANNELS >= 8
+  ignitionEndTeethCalc[7] = calcEndTeeth_pattern(ignition8EndAngle, bothRevolutions);
+#endif
+}
+/** @} */
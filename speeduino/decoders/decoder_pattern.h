@@ -0,0 +1,25 @@
+#ifndef DECODER_PATTERN_H
+#define DECODER_PATTERN_H
+
+#define PATTERN_MAX_TEETH     60 //The most teeth a pattern table entry can have
+#define PATTERN_MAX_SIGNATURE 8  //The most consecutive gaps that are compared when looking for the sync tooth
+
+/** A trigger wheel described as data. Tooth 1 is the first entry in toothAngles */
+struct triggerPattern_t {
+  uint8_t teeth;              ///< The number of teeth actually present
+  uint16_t cycleDegrees;      ///< 360 for a wheel turning at crank speed, 720 for one turning at cam speed (Or a crank wheel described over the full cycle)
+  const int16_t *toothAngles; ///< The angle of each tooth (In crank degrees from tooth 1, ascending). Stored in PROGMEM
+};
+
+extern const triggerPattern_t triggerPatterns[];
+extern const uint8_t triggerPatternCount;
+
+void triggerSetup_pattern(void);
+void triggerPri_pattern(void);
+void triggerSec_pattern(void);
+uint16_t getRPM_pattern(void);
+int getCrankAngle_pattern(void);
+void triggerSetEndTeeth_pattern(void);
+
+
+#endif
@@ -23,6 +23,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 //************************************************
 #include "globals.h"
 #include "config.h"
+#include "engine.h"
+#include "speeduino.h"
 #include "scheduler.h"
 #include "comms.h"
 #include "comms_legacy.h"
@@ -46,6 +48,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "schedule_calcs.h"
 #include "schedule_calcs.hpp"
 #include "auxiliaries.h"
+#include "unit_testing.h"
 //#include BOARD_H //Note that this is not a real file, it is defined in globals.h.
 //#include RTC_LIB_H //Defined in each boards .h file
 
@@ -65,32 +68,86 @@ uint32_t rollingCutLastRev = 0; /**< Tracks whether we're on the same or a diffe
 uint16_t staged_req_fuel_mult_pri = 0;
 uint16_t staged_req_fuel_mult_sec = 0;   
 
-
-
-static int16_t injector1StartAngle = 0;
-static int16_t injector2StartAngle = 0;
-static int16_t injector3StartAngle = 0;
-static int16_t injector4StartAngle = 0;
-
+uint8_t engineInputsChanged = 0xFF;
+static uint32_t lastToothTime = 0; /**< The decoder's last tooth time as of the previous engineControl(), used to detect new teeth */
+static unsigned int untrimmedPW[8]; /**< PW1...PW8 as left by the load stage, before calculateInjTiming() applies the fuel trims */
+
+
+
+/** @brief An injector channel, as worked through by calculateInjTiming() and scheduleFuel() */
+typedef struct {
+  FuelSchedule *schedule;
+  unsigned int *pw; ///< The channel's pulse width in currentStatus (PW1...PW8)
+  int *degrees; ///< The channel's offset from TDC of cylinder 1 (channel1InjDegrees...channel8InjDegrees)
+  trimTable3d *trimTable; ///< The channel's fuel trim. Only applied to primary channels, a staged channel keeps the shared secondary pulse width
+  int16_t startAngle; ///< The angle the injector opens at, set by calculateInjTiming()
+  bool staged; ///< Whether this is a secondary channel, only used while staging is active
+} injectorChannel_t;
+
+/** @brief An ignition channel, as worked through by scheduleIgnition() */
+typedef struct {
+  IgnitionSchedule *schedule;
+  int *startAngle; ///< The angle the coil starts charging at (ignition1StartAngle...ignition8StartAngle)
+  int *degrees; ///< The channel's offset from TDC of cylinder 1 (channel1IgnDegrees...channel8IgnDegrees)
+} ignitionChannel_t;
+
+/** The injector channels. The staging role and trim tables are set by initialiseInjectorChannels() */
+static injectorChannel_t injectorChannels[INJ_CHANNELS] = {
+  { &fuelSchedule1, &currentStatus.PW1, &channel1InjDegrees, &trim1Table, 0, false },
+  { &fuelSchedule2, &currentStatus.PW2, &channel2InjDegrees, &trim2Table, 0, false },
+  { &fuelSchedule3, &currentStatus.PW3, &channel3InjDegrees, &trim3Table, 0, false },
+  { &fuelSchedule4, &currentStatus.PW4, &channel4InjDegrees, &trim4Table, 0, false },
 #if INJ_CHANNELS >= 5
-static int16_t injector5StartAngle = 0;
+  { &fuelSchedule5, &currentStatus.PW5, &channel5InjDegrees, &trim5Table, 0, false },
 #endif
 #if INJ_CHANNELS >= 6
-static int16_t injector6StartAngle = 0;
+  { &fuelSchedule6, &currentStatus.PW6, &channel6InjDegrees, &trim6Table, 0, false },
 #endif
 #if INJ_CHANNELS >= 7
-static int16_t injector7StartAngle = 0;
+  { &fuelSchedule7, &currentStatus.PW7, &channel7InjDegrees, &trim7Table, 0, false },
 #endif
 #if INJ_CHANNELS >= 8
-static int16_t injector8StartAngle = 0;
+  { &fuelSchedule8, &currentStatus.PW8, &channel8InjDegrees, &trim8Table, 0, false },
 #endif
+};
+
+#if defined(UNIT_TEST)
+int16_t getInjectorStartAngle(uint8_t channel)
+{
+  return injectorChannels[channel].startAngle;
+}
+#endif
+
+static const ignitionChannel_t ignitionChannels[IGN_CHANNELS] = {
+  { &ignitionSchedule1, &ignition1StartAngle, &channel1IgnDegrees },
+  { &ignitionSchedule2, &ignition2StartAngle, &channel2IgnDegrees },
+  { &ignitionSchedule3, &ignition3StartAngle, &channel3IgnDegrees },
+  { &ignitionSchedule4, &ignition4StartAngle, &channel4IgnDegrees },
+#if IGN_CHANNELS >= 5
+  { &ignitionSchedule5, &ignition5StartAngle, &channel5IgnDegrees },
+#endif
+#if IGN_CHANNELS >= 6
+  { &ignitionSchedule6, &ignition6StartAngle, &channel6IgnDegrees },
+#endif
+#if IGN_CHANNELS >= 7
+  { &ignitionSchedule7, &ignition7StartAngle, &channel7IgnDegrees },
+#endif
+#if IGN_CHANNELS >= 8
+  { &ignitionSchedule8, &ignition8StartAngle, &channel8IgnDegrees },
+#endif
+};
+
+static uint8_t primaryInjOutputs = 1; /**< The number of injector channels that are not staged. Channels from here up to maxInjOutputs are secondaries */
 
 
 static void checkEngineSync(void);
-static void calculateInjTiming(void);
+static void initialiseInjectorChannels(void);
+TESTABLE_STATIC void calculateInjTiming(void);
+static void calculateSplitInjection(uint16_t pwDegrees);
 static void calculateDwell(void);
-static void scheduleFuel(void);
-static void scheduleIgnition(void);
+static void calculateMultiSpark(void);
+TESTABLE_STATIC void scheduleFuel(void);
+TESTABLE_STATIC void scheduleIgnition(void);
 static void calculateStaging(uint32_t);
 static void calculateIgnitionAngles(uint16_t dwellAngle);
 static void engineCheckRun(void);
@@ -99,19 +156,800 @@ static uint16_t PW(int REQ_FUEL, byte VE, long MAP, uint16_t corrections, uint16
 
 static byte getVE1(void);
 static byte getAdvance1(void);
+static void calculateFuelAndSpark(void);
+static void saveFuelPW(void);
+static void restoreFuelPW(void);
 
 
 inline uint16_t applyFuelTrimToPW(trimTable3d *pTrimTable, int16_t fuelLoad, int16_t RPM, uint16_t currentPW)
 {
-    uint8_t pw1percent = 100U + get3DTableValue(pTrimTable, fuelLoad, RPM) - OFFSET_FUELTRIM;
+    uint8_t pw1percent = 100U + trimTableAxes.getValue(pTrimTable, fuelLoad, RPM) - OFFSET_FUELTRIM;
     return percentage(pw1percent, currentPW);
 }
 
 
-void engineControl(void)
+/** Work out the per cylinder channel angles and attach the fuel / ignition output functions to the schedules.
+ * Must be run once the configuration has been loaded and req_fuel_uS has been set (see initialiseAll()).
+ * The number of squirts, CRANK_ANGLE_MAX_INJ / CRANK_ANGLE_MAX_IGN and the number of active outputs are all set here.
+ */
+void engineInit(void)
 {
+  //Calculate the number of degrees between cylinders
+  //Set some default values. These will be updated below if required.
+  CRANK_ANGLE_MAX_IGN = 360;
+  CRANK_ANGLE_MAX_INJ = 360;
+
+  if(configPage2.divider == 0) { configPage2.divider = 1; } //Avoid a divide by 0 on a blank/corrupt tune
+  currentStatus.nSquirts = configPage2.nCylinders / configPage2.divider; //The number of squirts being requested. This is manually overridden below for sequential setups (Due to TS req_fuel calc limitations)
+  if(currentStatus.nSquirts == 0) { currentStatus.nSquirts = 1; } //Safety check. Should never happen as TS will give an error, but leave in case tune is manually altered etc.
+
+  if(configPage2.strokes == FOUR_STROKE) { CRANK_ANGLE_MAX_INJ = 720 / currentStatus.nSquirts; }
+  else { CRANK_ANGLE_MAX_INJ = 360 / currentStatus.nSquirts; }
+
+  switch (configPage2.nCylinders)
+  {
+    case 1:
+      channel1IgnDegrees = 0;
+      channel1InjDegrees = 0;
+      maxIgnOutputs = 1;
+      maxInjOutputs = 1;
+
+      //Sequential ignition works identically on a 1 cylinder whether it's odd or even fire.
+      if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage2.strokes == FOUR_STROKE) ) { CRANK_ANGLE_MAX_IGN = 720; }
+
+      if( (configPage2.injLayout == INJ_SEQUENTIAL) && (configPage2.strokes == FOUR_STROKE) )
+      {
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+
+      //Check if injector staging is enabled
+      if(configPage10.stagingEnabled == true)
+      {
+        maxInjOutputs = 2;
+        channel2InjDegrees = channel1InjDegrees;
+      }
+      break;
+
+    case 2:
+      channel1IgnDegrees = 0;
+      channel1InjDegrees = 0;
+      maxIgnOutputs = 2;
+      maxInjOutputs = 2;
+      if (configPage2.engineType == EVEN_FIRE ) { channel2IgnDegrees = 180; }
+      else { channel2IgnDegrees = configPage2.oddfire2; }
+
+      //Sequential ignition works identically on a 2 cylinder whether it's odd or even fire (With the default being a 180 degree second cylinder).
+      if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage2.strokes == FOUR_STROKE) ) { CRANK_ANGLE_MAX_IGN = 720; }
+
+      if( (configPage2.injLayout == INJ_SEQUENTIAL) && (configPage2.strokes == FOUR_STROKE) )
+      {
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+      //The below are true regardless of whether this is running sequential or not
+      if (configPage2.engineType == EVEN_FIRE ) { channel2InjDegrees = 180; }
+      else { channel2InjDegrees = configPage2.oddfire2; }
+      if (!configPage2.injTiming)
+      {
+        //For simultaneous, all squirts happen at the same time
+        channel1InjDegrees = 0;
+        channel2InjDegrees = 0;
+      }
+
+      //Check if injector staging is enabled
+      if(configPage10.stagingEnabled == true)
+      {
+        maxInjOutputs = 4;
+        channel3InjDegrees = channel1InjDegrees;
+        channel4InjDegrees = channel2InjDegrees;
+      }
+      break;
+
+    case 3:
+      channel1IgnDegrees = 0;
+      maxIgnOutputs = 3;
+      maxInjOutputs = 3;
+      if (configPage2.engineType == EVEN_FIRE )
+      {
+        //Sequential and Single channel modes both run over 720 crank degrees, but only on 4 stroke engines.
+        if( ( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage4.sparkMode == IGN_MODE_SINGLE) ) && (configPage2.strokes == FOUR_STROKE) )
+        {
+          channel2IgnDegrees = 240;
+          channel3IgnDegrees = 480;
+          CRANK_ANGLE_MAX_IGN = 720;
+        }
+        else
+        {
+          channel2IgnDegrees = 120;
+          channel3IgnDegrees = 240;
+        }
+      }
+      else
+      {
+        channel2IgnDegrees = configPage2.oddfire2;
+        channel3IgnDegrees = configPage2.oddfire3;
+      }
+
+      //For alternating injection, the squirt occurs at different times for each channel
+      if( (configPage2.injLayout == INJ_SEMISEQUENTIAL) || (configPage2.injLayout == INJ_PAIRED) || (configPage2.strokes == TWO_STROKE) )
+      {
+        channel1InjDegrees = 0;
+        channel2InjDegrees = 120;
+        channel3InjDegrees = 240;
+
+        if(configPage2.injType == INJ_TYPE_PORT)
+        {
+          //Force nSquirts to 2 for individual port injection. This prevents TunerStudio forcing the value to 3 even when this isn't wanted.
+          currentStatus.nSquirts = 2;
+          if(configPage2.strokes == FOUR_STROKE) { CRANK_ANGLE_MAX_INJ = 360; }
+          else { CRANK_ANGLE_MAX_INJ = 180; }
+        }
+
+        //Adjust the injection angles based on the number of squirts
+        if (currentStatus.nSquirts > 2)
+        {
+          channel2InjDegrees = (channel2InjDegrees * 2) / currentStatus.nSquirts;
+          channel3InjDegrees = (channel3InjDegrees * 2) / currentStatus.nSquirts;
+        }
+
+        if (!configPage2.injTiming)
+        {
+          //For simultaneous, all squirts happen at the same time
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 0;
+          channel3InjDegrees = 0;
+        }
+      }
+      else if (configPage2.injLayout == INJ_SEQUENTIAL)
+      {
+        currentStatus.nSquirts = 1;
+
+        if(configPage2.strokes == TWO_STROKE)
+        {
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 120;
+          channel3InjDegrees = 240;
+          CRANK_ANGLE_MAX_INJ = 360;
+        }
+        else
+        {
+          req_fuel_uS = req_fuel_uS * 2;
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 240;
+          channel3InjDegrees = 480;
+          CRANK_ANGLE_MAX_INJ = 720;
+        }
+      }
+
+#if INJ_CHANNELS >= 6
+      //Check if injector staging is enabled
+      if(configPage10.stagingEnabled == true)
+      {
+        maxInjOutputs = 6;
+        channel4InjDegrees = channel1InjDegrees;
+        channel5InjDegrees = channel2InjDegrees;
+        channel6InjDegrees = channel3InjDegrees;
+      }
+#endif
+      break;
+
+    case 4:
+      channel1IgnDegrees = 0;
+      channel1InjDegrees = 0;
+      maxIgnOutputs = 2; //Default value for 4 cylinder, may be changed below
+      maxInjOutputs = 2;
+      if (configPage2.engineType == EVEN_FIRE )
+      {
+        channel2IgnDegrees = 180;
 
-	//VE and advance calculation were moved outside the sync/RPM check so that the fuel and ignition load value will be accurately shown when RPM=0
+        if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage2.strokes == FOUR_STROKE) )
+        {
+          channel3IgnDegrees = 360;
+          channel4IgnDegrees = 540;
+          CRANK_ANGLE_MAX_IGN = 720;
+          maxIgnOutputs = 4;
+        }
+        if(configPage4.sparkMode == IGN_MODE_ROTARY)
+        {
+          //Rotary uses the ign 3 and 4 schedules for the trailing spark. They are offset from the ign 1 and 2 channels respectively and so use the same degrees as them
+          channel3IgnDegrees = 0;
+          channel4IgnDegrees = 180;
+          maxIgnOutputs = 4;
+
+          configPage4.IgInv = GOING_LOW; //Force Going Low ignition mode (Going high is never used for rotary)
+        }
+      }
+      else
+      {
+        channel2IgnDegrees = configPage2.oddfire2;
+        channel3IgnDegrees = configPage2.oddfire3;
+        channel4IgnDegrees = configPage2.oddfire4;
+        maxIgnOutputs = 4;
+      }
+
+      //For alternating injection, the squirt occurs at different times for each channel
+      if( (configPage2.injLayout == INJ_SEMISEQUENTIAL) || (configPage2.injLayout == INJ_PAIRED) || (configPage2.strokes == TWO_STROKE) )
+      {
+        channel2InjDegrees = 180;
+
+        if (!configPage2.injTiming)
+        {
+          //For simultaneous, all squirts happen at the same time
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 0;
+        }
+        else if (currentStatus.nSquirts > 2)
+        {
+          //Adjust the injection angles based on the number of squirts
+          channel2InjDegrees = (channel2InjDegrees * 2) / currentStatus.nSquirts;
+        }
+        else { } //Do nothing, default values are correct
+      }
+      else if (configPage2.injLayout == INJ_SEQUENTIAL)
+      {
+        channel2InjDegrees = 180;
+        channel3InjDegrees = 360;
+        channel4InjDegrees = 540;
+
+        maxInjOutputs = 4;
+
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+
+      //Check if injector staging is enabled
+      if(configPage10.stagingEnabled == true)
+      {
+        maxInjOutputs = 4;
+
+        if( (configPage2.injLayout == INJ_SEQUENTIAL) || (configPage2.injLayout == INJ_SEMISEQUENTIAL) )
+        {
+          //Staging with 4 cylinders semi/sequential requires 8 total channels
+#if INJ_CHANNELS >= 8
+          maxInjOutputs = 8;
+
+          channel5InjDegrees = channel1InjDegrees;
+          channel6InjDegrees = channel2InjDegrees;
+          channel7InjDegrees = channel3InjDegrees;
+          channel8InjDegrees = channel4InjDegrees;
+#elif INJ_CHANNELS >= 5
+          //This is an invalid config as there are not enough outputs to support sequential + staging
+          //Put the staging output to the non-existent channel 5
+          maxInjOutputs = 5;
+          channel5InjDegrees = channel1InjDegrees;
+#endif
+        }
+        else
+        {
+          channel3InjDegrees = channel1InjDegrees;
+          channel4InjDegrees = channel2InjDegrees;
+        }
+      }
+      break;
+
+    case 5:
+      channel1IgnDegrees = 0;
+      channel2IgnDegrees = 72;
+      channel3IgnDegrees = 144;
+      channel4IgnDegrees = 216;
+#if IGN_CHANNELS >= 5
+      channel5IgnDegrees = 288;
+#endif
+      maxIgnOutputs = 5; //Only 4 actual outputs, so that's all that can be cut
+      maxInjOutputs = 4; //Is updated below to 5 if there are enough channels
+
+      if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
+      {
+        channel2IgnDegrees = 144;
+        channel3IgnDegrees = 288;
+        channel4IgnDegrees = 432;
+#if IGN_CHANNELS >= 5
+        channel5IgnDegrees = 576;
+#endif
+        CRANK_ANGLE_MAX_IGN = 720;
+      }
+
+      //For alternating injection, the squirt occurs at different times for each channel
+      if( (configPage2.injLayout == INJ_SEMISEQUENTIAL) || (configPage2.injLayout == INJ_PAIRED) || (configPage2.strokes == TWO_STROKE) )
+      {
+        if (!configPage2.injTiming)
+        {
+          //For simultaneous, all squirts happen at the same time
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 0;
+          channel3InjDegrees = 0;
+          channel4InjDegrees = 0;
+#if INJ_CHANNELS >= 5
+          channel5InjDegrees = 0;
+#endif
+        }
+        else
+        {
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 72;
+          channel3InjDegrees = 144;
+          channel4InjDegrees = 216;
+#if INJ_CHANNELS >= 5
+          channel5InjDegrees = 288;
+#endif
+        }
+      }
+#if INJ_CHANNELS >= 5
+      else if (configPage2.injLayout == INJ_SEQUENTIAL)
+      {
+        channel1InjDegrees = 0;
+        channel2InjDegrees = 144;
+        channel3InjDegrees = 288;
+        channel4InjDegrees = 432;
+        channel5InjDegrees = 576;
+
+        maxInjOutputs = 5;
+
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+#endif
+
+#if INJ_CHANNELS >= 6
+      if(configPage10.stagingEnabled == true) { maxInjOutputs = 6; }
+#endif
+      break;
+
+    case 6:
+      channel1IgnDegrees = 0;
+      channel1InjDegrees = 0;
+      channel2IgnDegrees = 120;
+      channel2InjDegrees = 120;
+      channel3IgnDegrees = 240;
+      channel3InjDegrees = 240;
+      maxIgnOutputs = 3;
+      maxInjOutputs = 3;
+
+#if IGN_CHANNELS >= 6
+      if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
+      {
+        channel4IgnDegrees = 360;
+        channel5IgnDegrees = 480;
+        channel6IgnDegrees = 600;
+        CRANK_ANGLE_MAX_IGN = 720;
+        maxIgnOutputs = 6;
+      }
+#endif
+
+      //For alternating injection, the squirt occurs at different times for each channel
+      if( (configPage2.injLayout == INJ_SEMISEQUENTIAL) || (configPage2.injLayout == INJ_PAIRED) )
+      {
+        if (!configPage2.injTiming)
+        {
+          //For simultaneous, all squirts happen at the same time
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 0;
+          channel3InjDegrees = 0;
+        }
+        else if (currentStatus.nSquirts > 2)
+        {
+          //Adjust the injection angles based on the number of squirts
+          channel2InjDegrees = (channel2InjDegrees * 2) / currentStatus.nSquirts;
+          channel3InjDegrees = (channel3InjDegrees * 2) / currentStatus.nSquirts;
+        }
+      }
+
+#if INJ_CHANNELS >= 6
+      if (configPage2.injLayout == INJ_SEQUENTIAL)
+      {
+        channel1InjDegrees = 0;
+        channel2InjDegrees = 120;
+        channel3InjDegrees = 240;
+        channel4InjDegrees = 360;
+        channel5InjDegrees = 480;
+        channel6InjDegrees = 600;
+
+        maxInjOutputs = 6;
+
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+      else if(configPage10.stagingEnabled == true) //Check if injector staging is enabled
+      {
+        maxInjOutputs = 6;
+        channel4InjDegrees = channel1InjDegrees;
+        channel5InjDegrees = channel2InjDegrees;
+        channel6InjDegrees = channel3InjDegrees;
+
+        if(configPage2.injLayout == INJ_SEMISEQUENTIAL)
+        {
+          //Staging with 6 cylinders semi-sequential requires 7 total channels
+  #if INJ_CHANNELS >= 7
+          maxInjOutputs = 7;
+
+          channel7InjDegrees = channel1InjDegrees;
+  #endif
+        }
+      }
+#endif
+      break;
+
+    case 8:
+      channel1IgnDegrees = 0;
+      channel1InjDegrees = 0;
+      channel2IgnDegrees = 90;
+      channel2InjDegrees = 90;
+      channel3IgnDegrees = 180;
+      channel3InjDegrees = 180;
+      channel4IgnDegrees = 270;
+      channel4InjDegrees = 270;
+      maxIgnOutputs = 4;
+      maxInjOutputs = 4;
+
+      if(configPage4.sparkMode == IGN_MODE_SINGLE)
+      {
+        maxIgnOutputs = 4;
+        CRANK_ANGLE_MAX_IGN = 360;
+      }
+#if IGN_CHANNELS >= 8
+      else if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
+      {
+        channel5IgnDegrees = 360;
+        channel6IgnDegrees = 450;
+        channel7IgnDegrees = 540;
+        channel8IgnDegrees = 630;
+        maxIgnOutputs = 8;
+        CRANK_ANGLE_MAX_IGN = 720;
+      }
+#endif
+
+      //For alternating injection, the squirt occurs at different times for each channel
+      if( (configPage2.injLayout == INJ_SEMISEQUENTIAL) || (configPage2.injLayout == INJ_PAIRED) )
+      {
+        if (!configPage2.injTiming)
+        {
+          //For simultaneous, all squirts happen at the same time
+          channel1InjDegrees = 0;
+          channel2InjDegrees = 0;
+          channel3InjDegrees = 0;
+          channel4InjDegrees = 0;
+        }
+        else if (currentStatus.nSquirts > 2)
+        {
+          //Adjust the injection angles based on the number of squirts
+          channel2InjDegrees = (channel2InjDegrees * 2) / currentStatus.nSquirts;
+          channel3InjDegrees = (channel3InjDegrees * 2) / currentStatus.nSquirts;
+          channel4InjDegrees = (channel4InjDegrees * 2) / currentStatus.nSquirts;
+        }
+      }
+#if INJ_CHANNELS >= 8
+      else if (configPage2.injLayout == INJ_SEQUENTIAL)
+      {
+        channel1InjDegrees = 0;
+        channel2InjDegrees = 90;
+        channel3InjDegrees = 180;
+        channel4InjDegrees = 270;
+        channel5InjDegrees = 360;
+        channel6InjDegrees = 450;
+        channel7InjDegrees = 540;
+        channel8InjDegrees = 630;
+
+        maxInjOutputs = 8;
+
+        CRANK_ANGLE_MAX_INJ = 720;
+        currentStatus.nSquirts = 1;
+        req_fuel_uS = req_fuel_uS * 2;
+      }
+#endif
+      break;
+
+    default: //Handle this better!!!
+      channel1InjDegrees = 0;
+      channel2InjDegrees = 180;
+      break;
+  }
+
+  currentStatus.status3 |= currentStatus.nSquirts << BIT_STATUS3_NSQUIRTS1; //Top 3 bits of the status3 variable are the number of squirts. This must be done after the above section due to nSquirts being forced to 1 for sequential
+
+  //Special case:
+  //3 or 5 squirts per cycle MUST be tracked over 720 degrees. This is because the angles for them (Eg 720/3=240) are not evenly divisible into 360
+  //This is ONLY the case on 4 stroke systems
+  if( (currentStatus.nSquirts == 3) || (currentStatus.nSquirts == 5) )
+  {
+    if(configPage2.strokes == FOUR_STROKE) { CRANK_ANGLE_MAX_INJ = (720U / currentStatus.nSquirts); }
+  }
+
+  switch(configPage2.injLayout)
+  {
+    case INJ_SEMISEQUENTIAL:
+      //Semi-Sequential injection. Currently possible with 4, 6 and 8 cylinders. 5 cylinder is a special case
+      if( configPage2.nCylinders == 4 )
+      {
+        if(configPage4.inj4cylPairing == INJ_PAIR_13_24)
+        {
+          fuelSchedule1.pStartFunction = openInjector1and3;
+          fuelSchedule1.pEndFunction = closeInjector1and3;
+          fuelSchedule2.pStartFunction = openInjector2and4;
+          fuelSchedule2.pEndFunction = closeInjector2and4;
+        }
+        else
+        {
+          fuelSchedule1.pStartFunction = openInjector1and4;
+          fuelSchedule1.pEndFunction = closeInjector1and4;
+          fuelSchedule2.pStartFunction = openInjector2and3;
+          fuelSchedule2.pEndFunction = closeInjector2and3;
+        }
+      }
+      else if( configPage2.nCylinders == 6 )
+      {
+        fuelSchedule1.pStartFunction = openInjector1and4;
+        fuelSchedule1.pEndFunction = closeInjector1and4;
+        fuelSchedule2.pStartFunction = openInjector2and5;
+        fuelSchedule2.pEndFunction = closeInjector2and5;
+        fuelSchedule3.pStartFunction = openInjector3and6;
+        fuelSchedule3.pEndFunction = closeInjector3and6;
+      }
+      else if( configPage2.nCylinders == 8 )
+      {
+        fuelSchedule1.pStartFunction = openInjector1and5;
+        fuelSchedule1.pEndFunction = closeInjector1and5;
+        fuelSchedule2.pStartFunction = openInjector2and6;
+        fuelSchedule2.pEndFunction = closeInjector2and6;
+        fuelSchedule3.pStartFunction = openInjector3and7;
+        fuelSchedule3.pEndFunction = closeInjector3and7;
+        fuelSchedule4.pStartFunction = openInjector4and8;
+        fuelSchedule4.pEndFunction = closeInjector4and8;
+      }
+      else
+      {
+        //Fall back to paired injection
+        fuelSchedule1.pStartFunction = openInjector1;
+        fuelSchedule1.pEndFunction = closeInjector1;
+        fuelSchedule2.pStartFunction = openInjector2;
+        fuelSchedule2.pEndFunction = closeInjector2;
+        fuelSchedule3.pStartFunction = openInjector3;
+        fuelSchedule3.pEndFunction = closeInjector3;
+        fuelSchedule4.pStartFunction = openInjector4;
+        fuelSchedule4.pEndFunction = closeInjector4;
+#if INJ_CHANNELS >= 5
+        fuelSchedule5.pStartFunction = openInjector5;
+        fuelSchedule5.pEndFunction = closeInjector5;
+#endif
+      }
+      break;
+
+    case INJ_PAIRED:
+    case INJ_SEQUENTIAL:
+    default:
+      //Paired and sequential injection both drive one output per schedule. The difference is only in the angles calculated above
+      fuelSchedule1.pStartFunction = openInjector1;
+      fuelSchedule1.pEndFunction = closeInjector1;
+      fuelSchedule2.pStartFunction = openInjector2;
+      fuelSchedule2.pEndFunction = closeInjector2;
+      fuelSchedule3.pStartFunction = openInjector3;
+      fuelSchedule3.pEndFunction = closeInjector3;
+      fuelSchedule4.pStartFunction = openInjector4;
+      fuelSchedule4.pEndFunction = closeInjector4;
+#if INJ_CHANNELS >= 5
+      fuelSchedule5.pStartFunction = openInjector5;
+      fuelSchedule5.pEndFunction = closeInjector5;
+#endif
+#if INJ_CHANNELS >= 6
+      fuelSchedule6.pStartFunction = openInjector6;
+      fuelSchedule6.pEndFunction = closeInjector6;
+#endif
+#if INJ_CHANNELS >= 7
+      fuelSchedule7.pStartFunction = openInjector7;
+      fuelSchedule7.pEndFunction = closeInjector7;
+#endif
+#if INJ_CHANNELS >= 8
+      fuelSchedule8.pStartFunction = openInjector8;
+      fuelSchedule8.pEndFunction = closeInjector8;
+#endif
+      break;
+  }
+
+  switch(configPage4.sparkMode)
+  {
+    case IGN_MODE_SINGLE:
+      //Single channel mode. All ignition pulses are on channel 1
+      ignitionSchedule1.pStartCallback = beginCoil1Charge;
+      ignitionSchedule1.pEndCallback = endCoil1Charge;
+      ignitionSchedule2.pStartCallback = beginCoil1Charge;
+      ignitionSchedule2.pEndCallback = endCoil1Charge;
+      ignitionSchedule3.pStartCallback = beginCoil1Charge;
+      ignitionSchedule3.pEndCallback = endCoil1Charge;
+      ignitionSchedule4.pStartCallback = beginCoil1Charge;
+      ignitionSchedule4.pEndCallback = endCoil1Charge;
+#if IGN_CHANNELS >= 5
+      ignitionSchedule5.pStartCallback = beginCoil1Charge;
+      ignitionSchedule5.pEndCallback = endCoil1Charge;
+#endif
+#if IGN_CHANNELS >= 6
+      ignitionSchedule6.pStartCallback = beginCoil1Charge;
+      ignitionSchedule6.pEndCallback = endCoil1Charge;
+#endif
+#if IGN_CHANNELS >= 7
+      ignitionSchedule7.pStartCallback = beginCoil1Charge;
+      ignitionSchedule7.pEndCallback = endCoil1Charge;
+#endif
+#if IGN_CHANNELS >= 8
+      ignitionSchedule8.pStartCallback = beginCoil1Charge;
+      ignitionSchedule8.pEndCallback = endCoil1Charge;
+#endif
+      break;
+
+    case IGN_MODE_WASTEDCOP:
+      //Wasted COP mode. Note, most of the boards can only run this for 4-cyl only.
+      if( configPage2.nCylinders <= 3)
+      {
+        //1-3 cylinder wasted COP is the same as regular wasted mode
+        ignitionSchedule1.pStartCallback = beginCoil1Charge;
+        ignitionSchedule1.pEndCallback = endCoil1Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2Charge;
+        ignitionSchedule2.pEndCallback = endCoil2Charge;
+        ignitionSchedule3.pStartCallback = beginCoil3Charge;
+        ignitionSchedule3.pEndCallback = endCoil3Charge;
+      }
+      else if( configPage2.nCylinders == 4 )
+      {
+        //Wasted COP mode for 4 cylinders. Ignition channels 1&3 and 2&4 are paired together
+        ignitionSchedule1.pStartCallback = beginCoil1and3Charge;
+        ignitionSchedule1.pEndCallback = endCoil1and3Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2and4Charge;
+        ignitionSchedule2.pEndCallback = endCoil2and4Charge;
+
+        ignitionSchedule3.pStartCallback = nullCallback;
+        ignitionSchedule3.pEndCallback = nullCallback;
+        ignitionSchedule4.pStartCallback = nullCallback;
+        ignitionSchedule4.pEndCallback = nullCallback;
+      }
+      else if( configPage2.nCylinders == 6 )
+      {
+        //Wasted COP mode for 6 cylinders. Ignition channels 1&4, 2&5 and 3&6 are paired together
+        ignitionSchedule1.pStartCallback = beginCoil1and4Charge;
+        ignitionSchedule1.pEndCallback = endCoil1and4Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2and5Charge;
+        ignitionSchedule2.pEndCallback = endCoil2and5Charge;
+        ignitionSchedule3.pStartCallback = beginCoil3and6Charge;
+        ignitionSchedule3.pEndCallback = endCoil3and6Charge;
+
+        ignitionSchedule4.pStartCallback = nullCallback;
+        ignitionSchedule4.pEndCallback = nullCallback;
+#if IGN_CHANNELS >= 6
+        ignitionSchedule5.pStartCallback = nullCallback;
+        ignitionSchedule5.pEndCallback = nullCallback;
+        ignitionSchedule6.pStartCallback = nullCallback;
+        ignitionSchedule6.pEndCallback = nullCallback;
+#endif
+      }
+      else if( configPage2.nCylinders == 8 )
+      {
+        //Wasted COP mode for 8 cylinders. Ignition channels 1&5, 2&6, 3&7 and 4&8 are paired together
+        ignitionSchedule1.pStartCallback = beginCoil1and5Charge;
+        ignitionSchedule1.pEndCallback = endCoil1and5Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2and6Charge;
+        ignitionSchedule2.pEndCallback = endCoil2and6Charge;
+        ignitionSchedule3.pStartCallback = beginCoil3and7Charge;
+        ignitionSchedule3.pEndCallback = endCoil3and7Charge;
+        ignitionSchedule4.pStartCallback = beginCoil4and8Charge;
+        ignitionSchedule4.pEndCallback = endCoil4and8Charge;
+
+#if IGN_CHANNELS >= 8
+        ignitionSchedule5.pStartCallback = nullCallback;
+        ignitionSchedule5.pEndCallback = nullCallback;
+        ignitionSchedule6.pStartCallback = nullCallback;
+        ignitionSchedule6.pEndCallback = nullCallback;
+        ignitionSchedule7.pStartCallback = nullCallback;
+        ignitionSchedule7.pEndCallback = nullCallback;
+        ignitionSchedule8.pStartCallback = nullCallback;
+        ignitionSchedule8.pEndCallback = nullCallback;
+#endif
+      }
+      else
+      {
+        //If the person has inadvertently selected this when running more than 4 cylinders or other than 6 cylinders, just use standard Wasted spark mode
+        ignitionSchedule1.pStartCallback = beginCoil1Charge;
+        ignitionSchedule1.pEndCallback = endCoil1Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2Charge;
+        ignitionSchedule2.pEndCallback = endCoil2Charge;
+        ignitionSchedule3.pStartCallback = beginCoil3Charge;
+        ignitionSchedule3.pEndCallback = endCoil3Charge;
+        ignitionSchedule4.pStartCallback = beginCoil4Charge;
+        ignitionSchedule4.pEndCallback = endCoil4Charge;
+#if IGN_CHANNELS >= 5
+        ignitionSchedule5.pStartCallback = beginCoil5Charge;
+        ignitionSchedule5.pEndCallback = endCoil5Charge;
+#endif
+      }
+      break;
+
+    case IGN_MODE_ROTARY:
+      if(configPage10.rotaryType == ROTARY_IGN_FC)
+      {
+        //Ignition channel 1 is a wasted spark signal for leading signal on both rotors
+        ignitionSchedule1.pStartCallback = beginCoil1Charge;
+        ignitionSchedule1.pEndCallback = endCoil1Charge;
+        ignitionSchedule2.pStartCallback = beginCoil1Charge;
+        ignitionSchedule2.pEndCallback = endCoil1Charge;
+
+        ignitionSchedule3.pStartCallback = beginTrailingCoilCharge;
+        ignitionSchedule3.pEndCallback = endTrailingCoilCharge1;
+        ignitionSchedule4.pStartCallback = beginTrailingCoilCharge;
+        ignitionSchedule4.pEndCallback = endTrailingCoilCharge2;
+      }
+      else if(configPage10.rotaryType == ROTARY_IGN_FD)
+      {
+        //Ignition channel 1 is a wasted spark signal for leading signal on both rotors
+        ignitionSchedule1.pStartCallback = beginCoil1Charge;
+        ignitionSchedule1.pEndCallback = endCoil1Charge;
+        ignitionSchedule2.pStartCallback = beginCoil1Charge;
+        ignitionSchedule2.pEndCallback = endCoil1Charge;
+
+        //Trailing coils have their own channel each
+        //IGN2 = front rotor trailing spark
+        ignitionSchedule3.pStartCallback = beginCoil2Charge;
+        ignitionSchedule3.pEndCallback = endCoil2Charge;
+        //IGN3 = rear rotor trailing spark
+        ignitionSchedule4.pStartCallback = beginCoil3Charge;
+        ignitionSchedule4.pEndCallback = endCoil3Charge;
+      }
+      else if(configPage10.rotaryType == ROTARY_IGN_RX8)
+      {
+        //RX8 outputs are simply 1 coil and 1 output per plug
+        ignitionSchedule1.pStartCallback = beginCoil1Charge; //IGN1 is front rotor, leading spark
+        ignitionSchedule1.pEndCallback = endCoil1Charge;
+        ignitionSchedule2.pStartCallback = beginCoil2Charge; //IGN2 is rear rotor, leading spark
+        ignitionSchedule2.pEndCallback = endCoil2Charge;
+        ignitionSchedule3.pStartCallback = beginCoil3Charge; //IGN3 = front rotor trailing spark
+        ignitionSchedule3.pEndCallback = endCoil3Charge;
+        ignitionSchedule4.pStartCallback = beginCoil4Charge; //IGN4 = rear rotor trailing spark
+        ignitionSchedule4.pEndCallback = endCoil4Charge;
+      }
+      break;
+
+    case IGN_MODE_WASTED:
+    case IGN_MODE_SEQUENTIAL:
+    default:
+      //Wasted spark (Normal mode) and sequential both drive one coil per schedule. The difference is only in the angles calculated above
+      ignitionSchedule1.pStartCallback = beginCoil1Charge;
+      ignitionSchedule1.pEndCallback = endCoil1Charge;
+      ignitionSchedule2.pStartCallback = beginCoil2Charge;
+      ignitionSchedule2.pEndCallback = endCoil2Charge;
+      ignitionSchedule3.pStartCallback = beginCoil3Charge;
+      ignitionSchedule3.pEndCallback = endCoil3Charge;
+      ignitionSchedule4.pStartCallback = beginCoil4Charge;
+      ignitionSchedule4.pEndCallback = endCoil4Charge;
+#if IGN_CHANNELS >= 5
+      ignitionSchedule5.pStartCallback = beginCoil5Charge;
+      ignitionSchedule5.pEndCallback = endCoil5Charge;
+#endif
+#if IGN_CHANNELS >= 6
+      ignitionSchedule6.pStartCallback = beginCoil6Charge;
+      ignitionSchedule6.pEndCallback = endCoil6Charge;
+#endif
+#if IGN_CHANNELS >= 7
+      ignitionSchedule7.pStartCallback = beginCoil7Charge;
+      ignitionSchedule7.pEndCallback = endCoil7Charge;
+#endif
+#if IGN_CHANNELS >= 8
+      ignitionSchedule8.pStartCallback = beginCoil8Charge;
+      ignitionSchedule8.pEndCallback = endCoil8Charge;
+#endif
+      break;
+  }
+
+  initialiseInjectorChannels();
+}
+
+
+/** The fuel and spark load stage of engineControl(). Calculates VE, advance, the fuel corrections and the pulse widths,
+ * up to and including staging
+ */
+static void calculateFuelAndSpark(void)
+{
+	//VE and advance calculation are outside the sync/RPM check so that the fuel and ignition load value will be accurately shown when RPM=0
   currentStatus.VE1 = getVE1();
   currentStatus.VE = currentStatus.VE1; //Set the final VE value to be VE 1 as a default. This may be changed in the section below
 
@@ -121,56 +959,123 @@ void engineControl(void)
   calculateSecondaryFuel();
   calculateSecondarySpark();
 
-	//Always check for running or stop
-  engineCheckRun();
-
-	//Always check for sync
-  checkEngineSync();
-
-  //END SETTING ENGINE STATUSES
-  //-----------------------------------------------------------------------------------------------------
-
   //Begin the fuel calculation
   //Calculate an injector pulsewidth from the VE
   currentStatus.afrTarget = calculateAfrTarget(afrTable, currentStatus, configPage2, configPage6);
   currentStatus.corrections = correctionsFuel();
 
-  currentStatus.PW1 = PW(req_fuel_uS, currentStatus.VE, currentStatus.MAP, currentStatus.corrections, inj_opentime_uS);
+  currentStatus.PW1 = PW(req_fuel_uS, currentStatus.VE, currentStatus.MAP, currentStatus.corrections, inj_opentime_uS);
+
+  //Manual adder for nitrous. These are not in correctionsFuel() because they are direct adders to the ms value, not % based
+  if( (currentStatus.nitrous_status == NITROUS_STAGE1) || (currentStatus.nitrous_status == NITROUS_BOTH) )
+  {
+	int16_t adderRange = (configPage10.n2o_stage1_maxRPM - configPage10.n2o_stage1_minRPM) * 100;
+	int16_t adderPercent = ((currentStatus.RPM - (configPage10.n2o_stage1_minRPM * 100)) * 100) / adderRange; //The percentage of the way through the RPM range
+	adderPercent = 100 - adderPercent; //Flip the percentage as we go from a higher adder to a lower adder as the RPMs rise
+	currentStatus.PW1 = currentStatus.PW1 + (configPage10.n2o_stage1_adderMax + percentage(adderPercent, (configPage10.n2o_stage1_adderMin - configPage10.n2o_stage1_adderMax))) * 100; //Calculate the above percentage of the calculated ms value.
+  }
+
+  if( (currentStatus.nitrous_status == NITROUS_STAGE2) || (currentStatus.nitrous_status == NITROUS_BOTH) )
+  {
+	int16_t adderRange = (configPage10.n2o_stage2_maxRPM - configPage10.n2o_stage2_minRPM) * 100;
+	int16_t adderPercent = ((currentStatus.RPM - (configPage10.n2o_stage2_minRPM * 100)) * 100) / adderRange; //The percentage of the way through the RPM range
+	adderPercent = 100 - adderPercent; //Flip the percentage as we go from a higher adder to a lower adder as the RPMs rise
+	currentStatus.PW1 = currentStatus.PW1 + (configPage10.n2o_stage2_adderMax + percentage(adderPercent, (configPage10.n2o_stage2_adderMin - configPage10.n2o_stage2_adderMax))) * 100; //Calculate the above percentage of the calculated ms value.
+  }
+
+  //Check that the duty cycle of the chosen pulsewidth isn't too high.
+  uint16_t pwLimit = calculatePWLimit();
+
+  //Apply the pwLimit if staging is disabled and engine is not cranking
+  if( (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) && (configPage10.stagingEnabled == false) )
+  {
+	  if (currentStatus.PW1 > pwLimit)
+	  {
+		  currentStatus.PW1 = pwLimit;
+	  }
+  }
+
+  calculateStaging(pwLimit);
+}
+
+static void saveFuelPW(void)
+{
+  untrimmedPW[0] = currentStatus.PW1;
+  untrimmedPW[1] = currentStatus.PW2;
+  untrimmedPW[2] = currentStatus.PW3;
+  untrimmedPW[3] = currentStatus.PW4;
+  untrimmedPW[4] = currentStatus.PW5;
+  untrimmedPW[5] = currentStatus.PW6;
+  untrimmedPW[6] = currentStatus.PW7;
+  untrimmedPW[7] = currentStatus.PW8;
+}
+
+static void restoreFuelPW(void)
+{
+  currentStatus.PW1 = untrimmedPW[0];
+  currentStatus.PW2 = untrimmedPW[1];
+  currentStatus.PW3 = untrimmedPW[2];
+  currentStatus.PW4 = untrimmedPW[3];
+  currentStatus.PW5 = untrimmedPW[4];
+  currentStatus.PW6 = untrimmedPW[5];
+  currentStatus.PW7 = untrimmedPW[6];
+  currentStatus.PW8 = untrimmedPW[7];
+}
+
+/** Runs the fuel and ignition calculations whose inputs have changed (See @ref engineInputsChanged), then schedules
+ * the next fuel and ignition events. Called every loop
+ */
+void engineControl(void)
+{
+  uint16_t lastRPM = currentStatus.RPM;
+  byte lastEngine = currentStatus.engine;
+  bool lastSync = currentStatus.hasSync;
+  bool lastHalfSync = BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+
+	//Always check for running or stop
+  engineCheckRun();
 
-  //Manual adder for nitrous. These are not in correctionsFuel() because they are direct adders to the ms value, not % based
-  if( (currentStatus.nitrous_status == NITROUS_STAGE1) || (currentStatus.nitrous_status == NITROUS_BOTH) )
+	//Always check for sync
+  checkEngineSync();
+
+  if( (currentStatus.RPM != lastRPM) || (currentStatus.engine != lastEngine) || (currentStatus.hasSync != lastSync) || (BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) != lastHalfSync) )
   {
-	int16_t adderRange = (configPage10.n2o_stage1_maxRPM - configPage10.n2o_stage1_minRPM) * 100;
-	int16_t adderPercent = ((currentStatus.RPM - (configPage10.n2o_stage1_minRPM * 100)) * 100) / adderRange; //The percentage of the way through the RPM range
-	adderPercent = 100 - adderPercent; //Flip the percentage as we go from a higher adder to a lower adder as the RPMs rise
-	currentStatus.PW1 = currentStatus.PW1 + (configPage10.n2o_stage1_adderMax + percentage(adderPercent, (configPage10.n2o_stage1_adderMin - configPage10.n2o_stage1_adderMax))) * 100; //Calculate the above percentage of the calculated ms value.
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_RPM);
   }
+  //The corrections only taper on these ticks, the others (The 1kHz tick in particular) don't change the load stage
+  if( BIT_CHECK(loopTimerMask, BIT_TIMER_10HZ) ) { BIT_SET(engineInputsChanged, ENGINE_INPUT_10HZ); }
+  if( BIT_CHECK(loopTimerMask, BIT_TIMER_30HZ) ) { BIT_SET(engineInputsChanged, ENGINE_INPUT_30HZ); }
 
-  if( (currentStatus.nitrous_status == NITROUS_STAGE2) || (currentStatus.nitrous_status == NITROUS_BOTH) )
+  //A torn read of the tooth time can only cause an extra recalculation
+  uint32_t toothTime = triggerInfo.toothLastToothTime;
+  if( toothTime != lastToothTime )
   {
-	int16_t adderRange = (configPage10.n2o_stage2_maxRPM - configPage10.n2o_stage2_minRPM) * 100;
-	int16_t adderPercent = ((currentStatus.RPM - (configPage10.n2o_stage2_minRPM * 100)) * 100) / adderRange; //The percentage of the way through the RPM range
-	adderPercent = 100 - adderPercent; //Flip the percentage as we go from a higher adder to a lower adder as the RPMs rise
-	currentStatus.PW1 = currentStatus.PW1 + (configPage10.n2o_stage2_adderMax + percentage(adderPercent, (configPage10.n2o_stage2_adderMin - configPage10.n2o_stage2_adderMax))) * 100; //Calculate the above percentage of the calculated ms value.
+    lastToothTime = toothTime;
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_TOOTH);
   }
 
-  //Check that the duty cycle of the chosen pulsewidth isn't too high.
-  uint16_t pwLimit = calculatePWLimit();
+  //END SETTING ENGINE STATUSES
+  //-----------------------------------------------------------------------------------------------------
 
-  //Apply the pwLimit if staging is disabled and engine is not cranking
-  if( (!BIT_CHECK(currentStatus.engine, BIT_ENGINE_CRANK)) && (configPage10.stagingEnabled == false) )
+  bool loadChanged = (engineInputsChanged & ENGINE_INPUTS_LOAD) != 0U;
+
+  if( loadChanged )
   {
-	  if (currentStatus.PW1 > pwLimit)
-	  {
-		  currentStatus.PW1 = pwLimit;
-	  }
+    calculateFuelAndSpark();
+    saveFuelPW();
   }
 
-  calculateStaging(pwLimit);
+  if( loadChanged || BIT_CHECK(engineInputsChanged, ENGINE_INPUT_TOOTH) )
+  {
+    //The fuel trims are applied to the pulse widths in place, so they must start from the untrimmed values each time
+    if( !loadChanged ) { restoreFuelPW(); }
 
-  calculateInjTiming();		// calc new injection pulsew
+    calculateInjTiming();		// calc new injection pulsew
+
+    calculateDwell();			// calc new dwell
+  }
 
-  calculateDwell();			// calc new dwell
+  engineInputsChanged = 0;
 
   scheduleFuel();			// begin fuel sequence
 
@@ -203,7 +1108,7 @@ byte getVE1(void)
     currentStatus.fuelLoad = ((int16_t)currentStatus.MAP * 100U) / currentStatus.EMAP;
   }
   else { currentStatus.fuelLoad = currentStatus.MAP; } //Fallback position
-  tempVE = get3DTableValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
+  tempVE = fuelAfrTableAxes.getValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
 
   return tempVE;
 }
@@ -262,6 +1167,7 @@ void engineCheckRun(void)
       currentStatus.PW1 = 0;
       currentStatus.VE = 0;
       currentStatus.VE2 = 0;
+      if(triggerInfo.toothLastToothTime != 0UL) { triggerStoreStopPosition(); } //Only on the first pass after the engine stops, resetDecoder() clears this
       resetDecoder();
       currentStatus.hasSync = false;
       BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
@@ -310,22 +1216,7 @@ void scheduleIgnition(void)
 	  //This is a safety step to prevent the ignition start time occurring AFTER the target tooth pulse has already occurred. It simply moves the start time forward a little, which is compensated for by the increase in the dwell time
 	  if(currentStatus.RPM < 250)
 	  {
-		ignition1StartAngle -= 5;
-		ignition2StartAngle -= 5;
-		ignition3StartAngle -= 5;
-		ignition4StartAngle -= 5;
-	#if IGN_CHANNELS >= 5
-		ignition5StartAngle -= 5;
-	#endif
-	#if IGN_CHANNELS >= 6
-		ignition6StartAngle -= 5;
-	#endif
-	#if IGN_CHANNELS >= 7
-		ignition7StartAngle -= 5;
-	#endif
-	#if IGN_CHANNELS >= 8
-		ignition8StartAngle -= 5;
-	#endif
+		for(uint8_t x = 0; x < IGN_CHANNELS; x++) { *ignitionChannels[x].startAngle -= 5; }
 	  }
 	}
 	else
@@ -339,14 +1230,18 @@ void scheduleIgnition(void)
 	  //ignition1StartAngle = 335;
 	  crankAngle = ignitionLimits(getCrankAngle()); //Refresh the crank angle info
 
-	#if IGN_CHANNELS >= 1
-	  uint32_t timeOut = calculateIgnitionTimeout(ignitionSchedule1, ignition1StartAngle, channel1IgnDegrees, crankAngle);
-	  if ( (timeOut > 0U) && (BIT_CHECK(ignitionChannelsOn, IGN1_CMD_BIT)) )
+	  //Channel 1 is always scheduled, the others only when they are in use
+	  uint8_t outputs = min(max(maxIgnOutputs, (uint8_t)1U), (uint8_t)IGN_CHANNELS);
+	  for(uint8_t x = 0; x < outputs; x++)
 	  {
-		setIgnitionSchedule(ignitionSchedule1, timeOut,
+		const ignitionChannel_t &channel = ignitionChannels[x];
+		uint32_t timeOut = calculateIgnitionTimeout(*channel.schedule, *channel.startAngle, *channel.degrees, crankAngle);
+		if ( (timeOut > 0U) && (BIT_CHECK(ignitionChannelsOn, x)) )
+		{
+		  setIgnitionSchedule(*channel.schedule, timeOut,
 				  currentStatus.dwell + fixedCrankingOverride);
+		}
 	  }
-	#endif
 
 	#if defined(USE_IGN_REFRESH)
 	  if( (ignitionSchedule1.Status == RUNNING) && (ignition1EndAngle > crankAngle) && (configPage4.StgCycles == 0) && (configPage2.perToothIgn != true) )
@@ -367,97 +1262,6 @@ void scheduleIgnition(void)
 	  }
 	#endif
 
-	#if IGN_CHANNELS >= 2
-	  if (maxIgnOutputs >= 2)
-	  {
-		  unsigned long ignition2StartTime = calculateIgnitionTimeout(ignitionSchedule2, ignition2StartAngle, channel2IgnDegrees, crankAngle);
-
-		  if ( (ignition2StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN2_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule2, ignition2StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 3
-	  if (maxIgnOutputs >= 3)
-	  {
-		  unsigned long ignition3StartTime = calculateIgnitionTimeout(ignitionSchedule3, ignition3StartAngle, channel3IgnDegrees, crankAngle);
-
-		  if ( (ignition3StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN3_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule3, ignition3StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 4
-	  if (maxIgnOutputs >= 4)
-	  {
-		  unsigned long ignition4StartTime = calculateIgnitionTimeout(ignitionSchedule4, ignition4StartAngle, channel4IgnDegrees, crankAngle);
-
-		  if ( (ignition4StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN4_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule4, ignition4StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 5
-	  if (maxIgnOutputs >= 5)
-	  {
-		  unsigned long ignition5StartTime = calculateIgnitionTimeout(ignitionSchedule5, ignition5StartAngle, channel5IgnDegrees, crankAngle);
-
-		  if ( (ignition5StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN5_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule5, ignition5StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 6
-	  if (maxIgnOutputs >= 6)
-	  {
-		  unsigned long ignition6StartTime = calculateIgnitionTimeout(ignitionSchedule6, ignition6StartAngle, channel6IgnDegrees, crankAngle);
-
-		  if ( (ignition6StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN6_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule6, ignition6StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 7
-	  if (maxIgnOutputs >= 7)
-	  {
-		  unsigned long ignition7StartTime = calculateIgnitionTimeout(ignitionSchedule7, ignition7StartAngle, channel7IgnDegrees, crankAngle);
-
-		  if ( (ignition7StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN7_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule7, ignition7StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
-	#if IGN_CHANNELS >= 8
-	  if (maxIgnOutputs >= 8)
-	  {
-		  unsigned long ignition8StartTime = calculateIgnitionTimeout(ignitionSchedule8, ignition8StartAngle, channel8IgnDegrees, crankAngle);
-
-		  if ( (ignition8StartTime > 0) && (BIT_CHECK(ignitionChannelsOn, IGN8_CMD_BIT)) )
-		  {
-			setIgnitionSchedule(ignitionSchedule8, ignition8StartTime,
-					  currentStatus.dwell + fixedCrankingOverride);
-		  }
-	  }
-	#endif
-
 	} //Ignition schedules on
 
 }
@@ -613,127 +1417,32 @@ void scheduleFuel(void)
   }
 
 
-#if INJ_CHANNELS >= 1
-  if( (maxInjOutputs >= 1) && (currentStatus.PW1 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ1_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule1, injector1StartAngle, crankAngle);
-    if (timeOut>0U)
-    {
-        setFuelSchedule(fuelSchedule1,
-                  timeOut,
-                  (unsigned long)currentStatus.PW1
-                  );
-    }
-  }
-#endif
-
   /*-----------------------------------------------------------------------------------------
-  | A Note on tempCrankAngle and tempStartAngle:
-  |   The use of tempCrankAngle/tempStartAngle is described below. It is then used in the same way for channels 2, 3 and 4+ on both injectors and ignition
-  |   Essentially, these 2 variables are used to realign the current crank angle and the desired start angle around 0 degrees for the given cylinder/output
-  |   Eg: If cylinder 2 TDC is 180 degrees after cylinder 1 (Eg a standard 4 cylinder engine), then tempCrankAngle is 180* less than the current crank angle and
-  |       tempStartAngle is the desired open time less 180*. Thus the cylinder is being treated relative to its own TDC, regardless of its offset
+  | A Note on the injector start angles:
+  |   calculateInjectorTimeout() realigns the current crank angle and the desired start angle around 0 degrees for the given cylinder/output
+  |   Eg: If cylinder 2 TDC is 180 degrees after cylinder 1 (Eg a standard 4 cylinder engine), then the crank angle is treated as 180* less than the
+  |       current crank angle and the start angle as the desired open time less 180*. Thus the cylinder is being treated relative to its own TDC,
+  |       regardless of its offset
   |
-  |   This is done to avoid problems with very short of very long times until tempStartAngle.
+  |   This is done to avoid problems with very short of very long times until the start angle.
   |------------------------------------------------------------------------------------------
   */
-#if INJ_CHANNELS >= 2
-  if( (maxInjOutputs >= 2) && (currentStatus.PW2 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ2_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule2, injector2StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule2,
-                timeOut,
-                (unsigned long)currentStatus.PW2
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 3
-  if( (maxInjOutputs >= 3) && (currentStatus.PW3 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ3_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule3, injector3StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule3,
-                timeOut,
-                (unsigned long)currentStatus.PW3
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 4
-  if( (maxInjOutputs >= 4) && (currentStatus.PW4 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ4_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule4, injector4StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule4,
-                timeOut,
-                (unsigned long)currentStatus.PW4
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 5
-  if( (maxInjOutputs >= 5) && (currentStatus.PW5 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ5_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule5, injector5StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule5,
-                timeOut,
-                (unsigned long)currentStatus.PW5
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 6
-  if( (maxInjOutputs >= 6) && (currentStatus.PW6 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ6_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule6, injector6StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule6,
-                timeOut,
-                (unsigned long)currentStatus.PW6
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 7
-  if( (maxInjOutputs >= 7) && (currentStatus.PW7 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ7_CMD_BIT)) )
-  {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule7, injector7StartAngle, crankAngle);
-    if ( timeOut>0U )
-    {
-      setFuelSchedule(fuelSchedule7,
-                timeOut,
-                (unsigned long)currentStatus.PW7
-                );
-    }
-  }
-#endif
-
-#if INJ_CHANNELS >= 8
-  if( (maxInjOutputs >= 8) && (currentStatus.PW8 >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, INJ8_CMD_BIT)) )
+  uint8_t outputs = min(maxInjOutputs, (uint8_t)INJ_CHANNELS);
+  for(uint8_t x = 0; x < outputs; x++)
   {
-    uint32_t timeOut = calculateInjectorTimeout(fuelSchedule8, injector8StartAngle, crankAngle);
-    if ( timeOut>0U )
+    const injectorChannel_t &channel = injectorChannels[x];
+    if( (*channel.pw >= inj_opentime_uS) && (BIT_CHECK(fuelChannelsOn, x)) )
     {
-      setFuelSchedule(fuelSchedule8,
-                timeOut,
-                (unsigned long)currentStatus.PW8
-                );
+      uint32_t timeOut = calculateInjectorTimeout(*channel.schedule, channel.startAngle, crankAngle);
+      if ( timeOut>0U )
+      {
+        setFuelSchedule(*channel.schedule,
+                  timeOut,
+                  (unsigned long)*channel.pw
+                  );
+      }
     }
   }
-#endif
 
 }
 
@@ -763,6 +1472,7 @@ void calculateDwell(void)
 	}
 
 	currentStatus.dwell = correctionsDwell(currentStatus.dwell);
+	calculateMultiSpark();
 
 	// Convert the dwell time to dwell angle based on the current engine speed
 	calculateIgnitionAngles(timeToAngleDegPerMicroSec(currentStatus.dwell));
@@ -772,10 +1482,42 @@ void calculateDwell(void)
 	//if( (configPage2.perToothIgn == true) && (lastToothCalcAdvance != currentStatus.advance) ) { triggerSetEndTeeth(); }
 	if( (configPage2.perToothIgn == true) )
 	{
-		triggerSetEndTeeth();
+		setIgnitionEndTeeth();
 	}
 }
 
+/** Sets up @ref ignitionMultiSpark, the repeat sparks that follow each primary spark.
+ * Each repeat spark waits for the previous spark to finish (The spark duration) then charges the coil again. They must all fit within
+ * the multi-spark crank angle window, and within the time left before the coil has to start charging for its next primary spark.
+ * Must be called after currentStatus.dwell has been set.
+ */
+static void calculateMultiSpark(void)
+{
+  uint8_t sparks = 0U;
+
+  //Single channel mode fires every cylinder from the one coil, so there is no time between sparks
+  if( (configPage15.multiSparkEnable == true) && (currentStatus.RPM > 0U) && (currentStatus.RPM < (configPage15.multiSparkMaxRPMdiv10 * 10U)) && (configPage4.sparkMode != IGN_MODE_SINGLE) )
+  {
+    uint16_t rest = configPage4.sparkDur * 100U; //Spark duration is in mS*10
+    uint16_t dwell = min((uint16_t)(configPage15.multiSparkDwell * 100U), currentStatus.dwell);
+    uint16_t sparkTime = rest + dwell;
+
+    //The dwell budget: the time from the primary spark until the next primary dwell starts, less the primary spark itself
+    uint32_t budget = angleToTimeMicroSecPerDegree(CRANK_ANGLE_MAX_IGN);
+    uint32_t primaryTime = (uint32_t)currentStatus.dwell + rest;
+    budget = (budget > primaryTime) ? (budget - primaryTime) : 0U;
+    budget = min(budget, angleToTimeMicroSecPerDegree(configPage15.multiSparkAngle));
+    budget = min(budget, (uint32_t)sparkTime * configPage15.multiSparkCount);
+
+    if(sparkTime > 0U) { sparks = (uint8_t)udiv_32_16(budget, sparkTime); }
+
+    ignitionMultiSpark.dwell = dwell;
+    ignitionMultiSpark.rest = rest;
+  }
+
+  ignitionMultiSpark.sparks = sparks;
+}
+
 /** Calculate the Ignition angles for all cylinders (based on @ref config2.nCylinders).
  * both start and end angles are calculated for each channel.
  * Also the mode of ignition firing - wasted spark vs. dedicated spark per cyl. - is considered here.
@@ -1196,247 +1938,127 @@ uint16_t calculatePWLimit()
   return tempLimit;
 }
 
-void calculateInjTiming(void)
+/** Sets up @ref fuelSplit for the pulses that follow the first injection of each cycle.
+ * The first pulse starts at the normal injection start angle, and the split pulses follow it at the angles from splitInjAngleTable.
+ * Split injection is not used above the RPM limit, or when the pulses would not all fit into one injection cycle.
+ * @param pwDegrees The crank angle the full pulsewidth takes at the current RPM
+ */
+static void calculateSplitInjection(uint16_t pwDegrees)
 {
+  uint8_t pulses = 0U;
+
+  if( (configPage15.splitInjEnable == true) && (currentStatus.RPM > 0U) && (currentStatus.RPMdiv100 < configPage15.splitInjMaxRPM) )
+  {
+    uint8_t maxPulses = (configPage15.splitInjPulses == 1U) ? (FUEL_SPLIT_MAX_PULSES - 1U) : 1U;
+    int16_t coolant = currentStatus.coolant + CALIBRATION_TEMPERATURE_OFFSET;
+    uint16_t totalPercent = 0U;
+    uint16_t totalDegrees = pwDegrees;
+
+    while(pulses < maxPulses)
+    {
+      uint8_t percent = (uint8_t)table2D_getValue(&splitInjPercentTable[pulses], coolant);
+      uint8_t angle = (uint8_t)table2D_getValue(&splitInjAngleTable[pulses], coolant);
+      totalPercent += percent;
+      totalDegrees += angle;
+      if( (percent == 0U) || (totalPercent >= 100U) || (totalDegrees >= (uint16_t)CRANK_ANGLE_MAX_INJ) ) { break; }
+
+      fuelSplit.percent[pulses] = percent;
+      fuelSplit.gap[pulses] = (uint16_t)min(angleToTimeMicroSecPerDegree(angle), (uint32_t)UINT16_MAX);
+      pulses++;
+    }
+    fuelSplit.openTime = inj_opentime_uS;
+  }
 
+  fuelSplit.pulses = pulses;
+}
+
+/** Sets which injector channels are staged (secondary) channels. Must be called once maxInjOutputs and the channel
+ * angles have been set by engineInit(). The secondaries are the channels that calculateStaging() gives the secondary
+ * pulse width to
+ */
+static void initialiseInjectorChannels(void)
+{
+  primaryInjOutputs = maxInjOutputs;
+  if(configPage10.stagingEnabled == true)
+  {
+    switch (configPage2.nCylinders)
+    {
+      case 1:
+      case 2:
+      case 3:
+        primaryInjOutputs = configPage2.nCylinders;
+        break;
+      case 4:
+        primaryInjOutputs = ( (configPage2.injLayout == INJ_SEQUENTIAL) || (configPage2.injLayout == INJ_SEMISEQUENTIAL) ) ? 4U : 2U;
+        break;
+      case 5:
+        primaryInjOutputs = (configPage2.injLayout == INJ_SEQUENTIAL) ? 5U : 4U;
+        break;
+      case 6:
+        primaryInjOutputs = (configPage2.injLayout == INJ_SEQUENTIAL) ? 6U : 3U;
+        break;
+      case 8:
+        primaryInjOutputs = (configPage2.injLayout == INJ_SEQUENTIAL) ? 8U : 4U;
+        break;
+      default:
+        primaryInjOutputs = 2U; //calculateStaging() treats everything else as 4 cylinder non-sequential
+        break;
+    }
+    if(primaryInjOutputs > maxInjOutputs) { primaryInjOutputs = maxInjOutputs; }
+  }
 
+  for(uint8_t x = 0; x < INJ_CHANNELS; x++)
+  {
+    injectorChannels[x].staged = (x >= primaryInjOutputs);
+    injectorChannels[x].startAngle = 0;
+  }
+}
 
+void calculateInjTiming(void)
+{
   //***********************************************************************************************
   //BEGIN INJECTION TIMING
   currentStatus.injAngle = table2D_getValue(&injectorAngleTable, currentStatus.RPMdiv100);
   if(currentStatus.injAngle > uint16_t(CRANK_ANGLE_MAX_INJ)) { currentStatus.injAngle = uint16_t(CRANK_ANGLE_MAX_INJ); }
 
-  unsigned int PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW1); //How many crank degrees the calculated PW will take at the current speed
-
-  injector1StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-
-  //Repeat the above for each cylinder
-  switch (configPage2.nCylinders)
+  //Sequential 4, 6 and 8 cylinders run paired (over 360 degrees) until full sync is gained
+  if( ( (configPage2.nCylinders == 4) || (configPage2.nCylinders == 6) || (configPage2.nCylinders == 8) ) && (configPage2.nCylinders <= INJ_CHANNELS) )
   {
-	//Single cylinder
-	case 1:
-	  //The only thing that needs to be done for single cylinder is to check for staging.
-	  if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-	  {
-		PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW2); //Need to redo this for PW2 as it will be dramatically different to PW1 when staging
-		//injector3StartAngle = calculateInjector3StartAngle(PWdivTimerPerDegree);
-		injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-	  }
-	  break;
-	//2 cylinders
-	case 2:
-	  //injector2StartAngle = calculateInjector2StartAngle(PWdivTimerPerDegree);
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-
-	  if ( (configPage2.injLayout == INJ_SEQUENTIAL) && (configPage6.fuelTrimEnabled > 0) )
-	  {
-		currentStatus.PW1 = applyFuelTrimToPW(&trim1Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW1);
-		currentStatus.PW2 = applyFuelTrimToPW(&trim2Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW2);
-	  }
-	  else if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-	  {
-		PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW3); //Need to redo this for PW3 as it will be dramatically different to PW1 when staging
-		injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-		injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-
-		injector4StartAngle = injector3StartAngle + (CRANK_ANGLE_MAX_INJ / 2); //Phase this either 180 or 360 degrees out from inj3 (In reality this will always be 180 as you can't have sequential and staged currently)
-		if(injector4StartAngle > (int16_t)CRANK_ANGLE_MAX_INJ) { injector4StartAngle -= CRANK_ANGLE_MAX_INJ; }
-	  }
-	  break;
-	//3 cylinders
-	case 3:
-	  //injector2StartAngle = calculateInjector2StartAngle(PWdivTimerPerDegree);
-	  //injector3StartAngle = calculateInjector3StartAngle(PWdivTimerPerDegree);
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-	  injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-
-	  if ( (configPage2.injLayout == INJ_SEQUENTIAL) && (configPage6.fuelTrimEnabled > 0) )
-	  {
-		currentStatus.PW1 = applyFuelTrimToPW(&trim1Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW1);
-		currentStatus.PW2 = applyFuelTrimToPW(&trim2Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW2);
-		currentStatus.PW3 = applyFuelTrimToPW(&trim3Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW3);
-
-		#if INJ_CHANNELS >= 6
-		  if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-		  {
-			PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW4); //Need to redo this for PW4 as it will be dramatically different to PW1 when staging
-			injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-			injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-			injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-		  }
-		#endif
-	  }
-	  else if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-	  {
-		PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW4); //Need to redo this for PW3 as it will be dramatically different to PW1 when staging
-		injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-		#if INJ_CHANNELS >= 6
-		  injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-		  injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-		#endif
-	  }
-	  break;
-	//4 cylinders
-	case 4:
-	  //injector2StartAngle = calculateInjector2StartAngle(PWdivTimerPerDegree);
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-
-	  if((configPage2.injLayout == INJ_SEQUENTIAL) && currentStatus.hasSync)
-	  {
-		if( CRANK_ANGLE_MAX_INJ != 720 ) { changeHalfToFullSync(); }
-
-		injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-		injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-		#if INJ_CHANNELS >= 8
-		  if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-		  {
-			PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW5); //Need to redo this for PW5 as it will be dramatically different to PW1 when staging
-			injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-			injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-			injector7StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-			injector8StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-		  }
-		#endif
-
-		if(configPage6.fuelTrimEnabled > 0)
-		{
-		  currentStatus.PW1 = applyFuelTrimToPW(&trim1Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW1);
-		  currentStatus.PW2 = applyFuelTrimToPW(&trim2Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW2);
-		  currentStatus.PW3 = applyFuelTrimToPW(&trim3Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW3);
-		  currentStatus.PW4 = applyFuelTrimToPW(&trim4Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW4);
-		}
-	  }
-	  else if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-	  {
-		PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW3); //Need to redo this for PW3 as it will be dramatically different to PW1 when staging
-		injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-		injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-	  }
-	  else
-	  {
-		if( BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) && (CRANK_ANGLE_MAX_INJ != 360) ) { changeFullToHalfSync(); }
-	  }
-	  break;
-	//5 cylinders
-	case 5:
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-	  injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-	  injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-	  #if INJ_CHANNELS >= 5
-		injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel5InjDegrees, currentStatus.injAngle);
-	  #endif
-
-	  //Staging is possible by using the 6th channel if available
-	  #if INJ_CHANNELS >= 6
-		if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-		{
-		  PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW6);
-		  injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel6InjDegrees, currentStatus.injAngle);
-		}
-	  #endif
-
-	  break;
-	//6 cylinders
-	case 6:
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-	  injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-
-	  #if INJ_CHANNELS >= 6
-		if((configPage2.injLayout == INJ_SEQUENTIAL) && currentStatus.hasSync)
-		{
-		  if( CRANK_ANGLE_MAX_INJ != 720 ) { changeHalfToFullSync(); }
-
-		  injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-		  injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel5InjDegrees, currentStatus.injAngle);
-		  injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel6InjDegrees, currentStatus.injAngle);
-
-		  if(configPage6.fuelTrimEnabled > 0)
-		  {
-			currentStatus.PW1 = applyFuelTrimToPW(&trim1Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW1);
-			currentStatus.PW2 = applyFuelTrimToPW(&trim2Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW2);
-			currentStatus.PW3 = applyFuelTrimToPW(&trim3Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW3);
-			currentStatus.PW4 = applyFuelTrimToPW(&trim4Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW4);
-			currentStatus.PW5 = applyFuelTrimToPW(&trim5Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW5);
-			currentStatus.PW6 = applyFuelTrimToPW(&trim6Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW6);
-		  }
-
-		  //Staging is possible with sequential on 8 channel boards by using outputs 7 + 8 for the staged injectors
-		  #if INJ_CHANNELS >= 8
-			if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-			{
-			  PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW4); //Need to redo this for staging PW as it will be dramatically different to PW1 when staging
-			  injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-			  injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-			  injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-			}
-		  #endif
-		}
-		else
-		{
-		  if( BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) && (CRANK_ANGLE_MAX_INJ != 360) ) { changeFullToHalfSync(); }
-
-		  if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-		  {
-			PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW4); //Need to redo this for staging PW as it will be dramatically different to PW1 when staging
-			injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-			injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-			injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-		  }
-		}
-	  #endif
-	  break;
-	//8 cylinders
-	case 8:
-	  injector2StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-	  injector3StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-	  injector4StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-
-	  #if INJ_CHANNELS >= 8
-		if((configPage2.injLayout == INJ_SEQUENTIAL) && currentStatus.hasSync)
-		{
-		  if( CRANK_ANGLE_MAX_INJ != 720 ) { changeHalfToFullSync(); }
+    if( (configPage2.injLayout == INJ_SEQUENTIAL) && currentStatus.hasSync )
+    {
+      if( CRANK_ANGLE_MAX_INJ != 720 ) { changeHalfToFullSync(); }
+    }
+    else if( BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) && (CRANK_ANGLE_MAX_INJ != 360) ) { changeFullToHalfSync(); }
+  }
 
-		  injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel5InjDegrees, currentStatus.injAngle);
-		  injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel6InjDegrees, currentStatus.injAngle);
-		  injector7StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel7InjDegrees, currentStatus.injAngle);
-		  injector8StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel8InjDegrees, currentStatus.injAngle);
+  uint16_t PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW1); //How many crank degrees the calculated PW will take at the current speed
+  calculateSplitInjection(PWdivTimerPerDegree);
 
-		  if(configPage6.fuelTrimEnabled > 0)
-		  {
-			currentStatus.PW1 = applyFuelTrimToPW(&trim1Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW1);
-			currentStatus.PW2 = applyFuelTrimToPW(&trim2Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW2);
-			currentStatus.PW3 = applyFuelTrimToPW(&trim3Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW3);
-			currentStatus.PW4 = applyFuelTrimToPW(&trim4Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW4);
-			currentStatus.PW5 = applyFuelTrimToPW(&trim5Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW5);
-			currentStatus.PW6 = applyFuelTrimToPW(&trim6Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW6);
-			currentStatus.PW7 = applyFuelTrimToPW(&trim7Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW7);
-			currentStatus.PW8 = applyFuelTrimToPW(&trim8Table, currentStatus.fuelLoad, currentStatus.RPM, currentStatus.PW8);
-		  }
-		}
-		else
-		{
-		  if( BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) && (CRANK_ANGLE_MAX_INJ != 360) ) { changeFullToHalfSync(); }
+  uint8_t outputs = min(maxInjOutputs, (uint8_t)INJ_CHANNELS);
 
-		  if( (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true) )
-		  {
-			PWdivTimerPerDegree = timeToAngleDegPerMicroSec(currentStatus.PW5); //Need to redo this for PW3 as it will be dramatically different to PW1 when staging
-			injector5StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel1InjDegrees, currentStatus.injAngle);
-			injector6StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel2InjDegrees, currentStatus.injAngle);
-			injector7StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel3InjDegrees, currentStatus.injAngle);
-			injector8StartAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, channel4InjDegrees, currentStatus.injAngle);
-		  }
-		}
+  //The secondaries all share one pulse width, which will be dramatically different to PW1 when staging
+  bool stagingActive = (configPage10.stagingEnabled == true) && (BIT_CHECK(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE) == true);
+  uint16_t stagedPWdivTimerPerDegree = 0;
+  if( stagingActive && (primaryInjOutputs < outputs) ) { stagedPWdivTimerPerDegree = timeToAngleDegPerMicroSec(*injectorChannels[primaryInjOutputs].pw); }
 
-	  #endif
-	  break;
+  //Per cylinder trims are only possible when each cylinder has its own injector. Paired sequential (half sync) cannot use them
+  bool applyTrims = (configPage2.injLayout == INJ_SEQUENTIAL) && (configPage6.fuelTrimEnabled > 0) && (maxInjOutputs >= primaryInjOutputs);
 
-	//Will hit the default case on 1 cylinder or >8 cylinders. Do nothing in these cases
-	default:
-	  break;
+  for(uint8_t x = 0; x < outputs; x++)
+  {
+    injectorChannel_t &channel = injectorChannels[x];
+    if(channel.staged)
+    {
+      if(stagingActive) { channel.startAngle = calculateInjectorStartAngle(stagedPWdivTimerPerDegree, *channel.degrees, currentStatus.injAngle); }
+    }
+    else
+    {
+      channel.startAngle = calculateInjectorStartAngle(PWdivTimerPerDegree, *channel.degrees, currentStatus.injAngle);
+      if(applyTrims) { *channel.pw = applyFuelTrimToPW(channel.trimTable, currentStatus.fuelLoad, currentStatus.RPM, *channel.pw); }
+    }
   }
 }
 
-
 static void checkEngineSync(void)
 {
 	//Always check for sync
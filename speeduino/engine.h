@@ -10,8 +10,31 @@
 #define ENGINE_H
 //#include "globals.h"
 
+void engineInit(void);
 void engineControl(void);
 
+/** @name Engine inputs
+ * Bits of @ref engineInputsChanged. engineControl() only reruns the fuel and ignition calculations whose inputs have
+ * changed since the last loop:
+ * - The fuel and spark load stage (VE, advance, corrections, pulse widths, staging) reruns on a sensor read, a 10Hz or
+ *   30Hz timer tick (The ticks that the corrections taper on), an RPM or engine status change or a tune write
+ * - The timing stage (Injection angles, dwell and ignition angles) also reruns on every new tooth, as the crank angle
+ *   per uS that it converts the pulse widths and dwell with is updated by each tooth
+ * - Fuel and ignition scheduling always runs
+*/
+///@{
+#define ENGINE_INPUT_SENSORS  0 ///< A sensor has been read
+#define ENGINE_INPUT_10HZ     1 ///< The 10Hz loop timer has ticked
+#define ENGINE_INPUT_RPM      2 ///< RPM, sync or the engine running/cranking status has changed
+#define ENGINE_INPUT_TOOTH    3 ///< A new tooth has been seen by the decoder
+#define ENGINE_INPUT_TUNE     4 ///< A tune value has been written
+#define ENGINE_INPUT_30HZ     5 ///< The 30Hz loop timer has ticked
+
+#define ENGINE_INPUTS_LOAD  ((1U << ENGINE_INPUT_SENSORS) | (1U << ENGINE_INPUT_10HZ) | (1U << ENGINE_INPUT_30HZ) | (1U << ENGINE_INPUT_RPM) | (1U << ENGINE_INPUT_TUNE)) ///< Inputs of the load stage
+///@}
+
+extern uint8_t engineInputsChanged; /**< Inputs changed since the last engineControl(). All bits are set at startup so that everything is calculated on the first loop */
+
 
 extern uint16_t req_fuel_uS; /**< The required fuel variable (As calculated by TunerStudio) in uS */
 extern uint16_t inj_opentime_uS; /**< The injector opening time. This is set within Tuner Studio, but stored here in uS rather than mS */
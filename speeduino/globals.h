@@ -100,6 +100,17 @@
   #define CORE_SAM
   #define INJ_CHANNELS 8
   #define IGN_CHANNELS 8
+#elif defined(NATIVE_BOARD)
+  //Host build (PlatformIO native platform). The M451 target is emulated so that the host build compiles the same code paths as the shipped firmware
+  #define BOARD_H "boards/board_native.h"
+  #define CORE_NATIVE
+  #define CORE_M451
+  #ifndef INJ_CHANNELS
+    #define INJ_CHANNELS 8
+  #endif
+  #ifndef IGN_CHANNELS
+    #define IGN_CHANNELS 8
+  #endif
 #else
   #error Incorrect board selected. Please select the correct board (Usually Mega 2560) and upload again
 #endif
@@ -416,41 +427,7 @@ extern const char TSfirmwareVersion[] PROGMEM;
 extern const byte data_structure_version; //This identifies the data structure when reading / writing. Now in use: CURRENT_DATA_VERSION (migration on-the fly) ?
 
 
-//These are for the direct port manipulation of the injectors, coils and aux outputs
-extern volatile PORT_TYPE *inj1_pin_port;
-extern volatile PINMASK_TYPE inj1_pin_mask;
-extern volatile PORT_TYPE *inj2_pin_port;
-extern volatile PINMASK_TYPE inj2_pin_mask;
-extern volatile PORT_TYPE *inj3_pin_port;
-extern volatile PINMASK_TYPE inj3_pin_mask;
-extern volatile PORT_TYPE *inj4_pin_port;
-extern volatile PINMASK_TYPE inj4_pin_mask;
-extern volatile PORT_TYPE *inj5_pin_port;
-extern volatile PINMASK_TYPE inj5_pin_mask;
-extern volatile PORT_TYPE *inj6_pin_port;
-extern volatile PINMASK_TYPE inj6_pin_mask;
-extern volatile PORT_TYPE *inj7_pin_port;
-extern volatile PINMASK_TYPE inj7_pin_mask;
-extern volatile PORT_TYPE *inj8_pin_port;
-extern volatile PINMASK_TYPE inj8_pin_mask;
-
-extern volatile PORT_TYPE *ign1_pin_port;
-extern volatile PINMASK_TYPE ign1_pin_mask;
-extern volatile PORT_TYPE *ign2_pin_port;
-extern volatile PINMASK_TYPE ign2_pin_mask;
-extern volatile PORT_TYPE *ign3_pin_port;
-extern volatile PINMASK_TYPE ign3_pin_mask;
-extern volatile PORT_TYPE *ign4_pin_port;
-extern volatile PINMASK_TYPE ign4_pin_mask;
-extern volatile PORT_TYPE *ign5_pin_port;
-extern volatile PINMASK_TYPE ign5_pin_mask;
-extern volatile PORT_TYPE *ign6_pin_port;
-extern volatile PINMASK_TYPE ign6_pin_mask;
-extern volatile PORT_TYPE *ign7_pin_port;
-extern volatile PINMASK_TYPE ign7_pin_mask;
-extern volatile PORT_TYPE *ign8_pin_port;
-extern volatile PINMASK_TYPE ign8_pin_mask;
-
+//These are for the direct port manipulation of the aux outputs. The injector and coil pins are in injectorOutputs/coilOutputs (See scheduledIO.h)
 extern volatile PORT_TYPE *tach_pin_port;
 extern volatile PINMASK_TYPE tach_pin_mask;
 extern volatile PORT_TYPE *pump_pin_port;
@@ -481,7 +458,7 @@ extern uint16_t fixedCrankingOverride;
 extern volatile uint32_t toothHistory[TOOTH_LOG_SIZE];
 extern volatile uint8_t compositeLogHistory[TOOTH_LOG_SIZE];
 extern volatile unsigned int toothHistoryIndex;
-extern unsigned long currentLoopTime; /**< The time (in uS) that the current mainloop started */
+extern uint32_t currentLoopTime; /**< The time (in uS) that the current mainloop started */
 extern volatile uint16_t ignitionCount; /**< The count of ignition events that have taken place since the engine started */
 //The below shouldn't be needed and probably should be cleaned up, but the Atmel SAM (ARM) boards use a specific type for the trigger edge values rather than a simple byte/int
 #if defined(CORE_SAMD21)
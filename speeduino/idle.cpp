@@ -880,7 +880,7 @@ void idleInterrupt(void) //Most ARM chips can simply call a function
       if(configPage6.iacChannels == 1) { IDLE2_PIN_LOW(); } //If 2 idle channels are in use, flip idle2 to be the opposite of idle1
       #endif
     }
-    SET_COMPARE(IDLE_COMPARE, IDLE_COUNTER + (idle_pwm_max_count - idle_pwm_cur_value) );
+    SET_AUX_COMPARE(IDLE_COMPARE, IDLE_COUNTER + (idle_pwm_max_count - idle_pwm_cur_value) );
     idle_pwm_state = false;
   }
   else
@@ -907,7 +907,7 @@ void idleInterrupt(void) //Most ARM chips can simply call a function
       if(configPage6.iacChannels == 1) { IDLE2_PIN_HIGH(); } //If 2 idle channels are in use, flip idle2 to be the opposite of idle1
       #endif
     }
-    SET_COMPARE(IDLE_COMPARE, IDLE_COUNTER + idle_pwm_target_value);
+    SET_AUX_COMPARE(IDLE_COMPARE, IDLE_COUNTER + idle_pwm_target_value);
     idle_pwm_cur_value = idle_pwm_target_value;
     idle_pwm_state = true;
   }
@@ -22,7 +22,10 @@
 #include "corrections.h"
 #include "idle.h"
 #include "tables/table2d.h"
+#include "page_crc.h"
 #include "acc_mc33810.h"
+#include "loopProfiler.h"
+#include "isrProfiler.h"
 
 
 #if defined(EEPROM_RESET_PIN)
@@ -68,6 +71,10 @@ void construct2dTables(void) {
   construct2dTable(fanPWMTable,               _countof(configPage9.PWMFanDuty),                 configPage9.PWMFanDuty,                 configPage6.fanPWMBins);
   construct2dTable(wmiAdvTable,               _countof(configPage10.wmiAdvAdj),                 configPage10.wmiAdvAdj,                 configPage10.wmiAdvBins);
   construct2dTable(rollingCutTable,           _countof(configPage15.rollingProtCutPercent),     configPage15.rollingProtCutPercent,     configPage15.rollingProtRPMDelta);
+  construct2dTable(splitInjPercentTable[0],   _countof(configPage15.splitInjPercent2),          configPage15.splitInjPercent2,          configPage15.splitInjBins);
+  construct2dTable(splitInjPercentTable[1],   _countof(configPage15.splitInjPercent3),          configPage15.splitInjPercent3,          configPage15.splitInjBins);
+  construct2dTable(splitInjAngleTable[0],     _countof(configPage15.splitInjAngle2),            configPage15.splitInjAngle2,            configPage15.splitInjBins);
+  construct2dTable(splitInjAngleTable[1],     _countof(configPage15.splitInjAngle3),            configPage15.splitInjAngle3,            configPage15.splitInjBins);
   construct2dTable(injectorAngleTable,        _countof(configPage2.injAng),                     configPage2.injAng,                     configPage2.injAngRPM);
   construct2dTable(flexBoostTable,            _countof(configPage10.flexBoostAdj),              configPage10.flexBoostAdj,              configPage10.flexBoostBins);
   construct2dTable(knockWindowStartTable,      _countof(configPage10.knock_window_angle),        configPage10.knock_window_angle, configPage10.knock_window_rpms);
@@ -338,6 +345,7 @@ void initialiseAll(void)
     toothHistoryIndex = 0;
 
     resetDecoder();
+    triggerLoadStopPosition();
     
     noInterrupts();
     initialiseTriggers();
@@ -363,6 +371,8 @@ void initialiseAll(void)
     //Initial values for loop times
     currentLoopTime = micros_safe();
     mainLoopCount = 0;
+    loopProfileReset();
+    isrProfileReset();
 
     engineInit();
 
@@ -389,12 +399,535 @@ void initialiseAll(void)
        tachoSweepIncr is also the number of tach pulses per second */
     tachoSweepIncr = configPage2.tachoSweepMaxRPM * maxIgnOutputs * 5 / 3;
     
+    //Initialisation may have corrected some config values directly, so none of the page CRCs can be trusted
+    invalidateAllPageCRC32();
+
     currentStatus.initialisationComplete = true;
     digitalWrite(LED_BUILTIN, HIGH);
 
 }
 
 
+/** Initialise the chosen trigger decoder.
+ * - Set Interrupt numbers @ref triggerInterrupt, @ref triggerInterrupt2 and @ref triggerInterrupt3 by their pin numbers
+ * - Call decoder specific setup function triggerSetup_*() (by @ref config4.TrigPattern, set to one of the DECODER_* defines), point the
+ *   decoder function pointers at the matching routines and attach the trigger interrupts on the configured edges.
+ */
+void initialiseTriggers(void)
+{
+  triggerInterrupt = digitalPinToInterrupt(pinTrigger);
+  triggerInterrupt2 = digitalPinToInterrupt(pinTrigger2);
+  triggerInterrupt3 = digitalPinToInterrupt(pinTrigger3);
+
+  pinMode(pinTrigger, INPUT);
+  pinMode(pinTrigger2, INPUT);
+  pinMode(pinTrigger3, INPUT);
+
+  detachInterrupt(triggerInterrupt);
+  detachInterrupt(triggerInterrupt2);
+  detachInterrupt(triggerInterrupt3);
+  //The default values for edges
+  primaryTriggerEdge = 0; //This should ALWAYS be changed below
+  secondaryTriggerEdge = 0; //This is optional and may not be changed below, depending on the decoder in use
+  tertiaryTriggerEdge = 0; //This is even more optional and may not be changed below, depending on the decoder in use
+
+  //Set the trigger function based on the decoder in the config
+  switch (configPage4.TrigPattern)
+  {
+    case DECODER_MISSING_TOOTH:
+      //Missing tooth decoder
+      triggerSetup_missingTooth();
+      triggerHandler = triggerPri_missingTooth;
+      triggerSecondaryHandler = triggerSec_missingTooth;
+      triggerTertiaryHandler = triggerThird_missingTooth;
+
+      getRPM = getRPM_missingTooth;
+      getCrankAngle = getCrankAngle_missingTooth;
+      triggerSetEndTeeth = triggerSetEndTeeth_missingTooth;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+      if(configPage10.TrigEdgeThrd == 0) { tertiaryTriggerEdge = RISING; }
+      else { tertiaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+
+      if(BIT_CHECK(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY)) { attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge); }
+      if(configPage10.vvt2Enabled > 0) { attachInterrupt(triggerInterrupt3, triggerTertiaryHandler, tertiaryTriggerEdge); } // we only need this for vvt2, so not really needed if it's not used
+      break;
+
+    case DECODER_BASIC_DISTRIBUTOR:
+      // Basic distributor
+      triggerSetup_BasicDistributor();
+      triggerHandler = triggerPri_BasicDistributor;
+      getRPM = getRPM_BasicDistributor;
+      getCrankAngle = getCrankAngle_BasicDistributor;
+      triggerSetEndTeeth = triggerSetEndTeeth_BasicDistributor;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    case DECODER_DUAL_WHEEL:
+      triggerSetup_DualWheel();
+      triggerHandler = triggerPri_DualWheel;
+      triggerSecondaryHandler = triggerSec_DualWheel;
+      getRPM = getRPM_DualWheel;
+      getCrankAngle = getCrankAngle_DualWheel;
+      triggerSetEndTeeth = triggerSetEndTeeth_DualWheel;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_GM7X:
+      triggerSetup_GM7X();
+      triggerHandler = triggerPri_GM7X;
+      getRPM = getRPM_GM7X;
+      getCrankAngle = getCrankAngle_GM7X;
+      triggerSetEndTeeth = triggerSetEndTeeth_GM7X;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    case DECODER_4G63:
+      triggerSetup_4G63();
+      triggerHandler = triggerPri_4G63;
+      triggerSecondaryHandler = triggerSec_4G63;
+      getRPM = getRPM_4G63;
+      getCrankAngle = getCrankAngle_4G63;
+      triggerSetEndTeeth = triggerSetEndTeeth_4G63;
+
+      primaryTriggerEdge = CHANGE;
+      secondaryTriggerEdge = FALLING;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_24X:
+      triggerSetup_24X();
+      triggerHandler = triggerPri_24X;
+      triggerSecondaryHandler = triggerSec_24X;
+      getRPM = getRPM_24X;
+      getCrankAngle = getCrankAngle_24X;
+      triggerSetEndTeeth = triggerSetEndTeeth_24X;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = CHANGE; //Secondary is always on every change
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_JEEP2000:
+      triggerSetup_Jeep2000();
+      triggerHandler = triggerPri_Jeep2000;
+      triggerSecondaryHandler = triggerSec_Jeep2000;
+      getRPM = getRPM_Jeep2000;
+      getCrankAngle = getCrankAngle_Jeep2000;
+      triggerSetEndTeeth = triggerSetEndTeeth_Jeep2000;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = CHANGE;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_AUDI135:
+      triggerSetup_Audi135();
+      triggerHandler = triggerPri_Audi135;
+      triggerSecondaryHandler = triggerSec_Audi135;
+      getRPM = getRPM_Audi135;
+      getCrankAngle = getCrankAngle_Audi135;
+      triggerSetEndTeeth = triggerSetEndTeeth_Audi135;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = RISING; //always rising for this trigger
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_HONDA_D17:
+      triggerSetup_HondaD17();
+      triggerHandler = triggerPri_HondaD17;
+      triggerSecondaryHandler = triggerSec_HondaD17;
+      getRPM = getRPM_HondaD17;
+      getCrankAngle = getCrankAngle_HondaD17;
+      triggerSetEndTeeth = triggerSetEndTeeth_HondaD17;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = CHANGE;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_HONDA_J32:
+      triggerSetup_HondaJ32();
+      triggerHandler = triggerPri_HondaJ32;
+      triggerSecondaryHandler = triggerSec_HondaJ32;
+      getRPM = getRPM_HondaJ32;
+      getCrankAngle = getCrankAngle_HondaJ32;
+      triggerSetEndTeeth = triggerSetEndTeeth_HondaJ32;
+
+      primaryTriggerEdge = RISING; // Don't honor the config, always use rising edge
+      secondaryTriggerEdge = RISING; // Unused
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_MIATA_9905:
+      triggerSetup_Miata9905();
+      triggerHandler = triggerPri_Miata9905;
+      triggerSecondaryHandler = triggerSec_Miata9905;
+      getRPM = getRPM_Miata9905;
+      getCrankAngle = getCrankAngle_Miata9905;
+      triggerSetEndTeeth = triggerSetEndTeeth_Miata9905;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_MAZDA_AU:
+      triggerSetup_MazdaAU();
+      triggerHandler = triggerPri_MazdaAU;
+      triggerSecondaryHandler = triggerSec_MazdaAU;
+      getRPM = getRPM_MazdaAU;
+      getCrankAngle = getCrankAngle_MazdaAU;
+      triggerSetEndTeeth = triggerSetEndTeeth_MazdaAU;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = FALLING;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_NON360:
+      triggerSetup_non360();
+      triggerHandler = triggerPri_DualWheel; //Is identical to the dual wheel decoder, so that is used. Same goes for the secondary below
+      triggerSecondaryHandler = triggerSec_DualWheel; //Note the use of the Dual Wheel trigger function here. No point in having the same code in twice.
+      getRPM = getRPM_non360;
+      getCrankAngle = getCrankAngle_non360;
+      triggerSetEndTeeth = triggerSetEndTeeth_non360;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = FALLING;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_NISSAN_360:
+      triggerSetup_Nissan360();
+      triggerHandler = triggerPri_Nissan360;
+      triggerSecondaryHandler = triggerSec_Nissan360;
+      getRPM = getRPM_Nissan360;
+      getCrankAngle = getCrankAngle_Nissan360;
+      triggerSetEndTeeth = triggerSetEndTeeth_Nissan360;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = CHANGE;
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_SUBARU_67:
+      triggerSetup_Subaru67();
+      triggerHandler = triggerPri_Subaru67;
+      triggerSecondaryHandler = triggerSec_Subaru67;
+      getRPM = getRPM_Subaru67;
+      getCrankAngle = getCrankAngle_Subaru67;
+      triggerSetEndTeeth = triggerSetEndTeeth_Subaru67;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_DAIHATSU_PLUS1:
+      triggerSetup_Daihatsu();
+      triggerHandler = triggerPri_Daihatsu;
+      getRPM = getRPM_Daihatsu;
+      getCrankAngle = getCrankAngle_Daihatsu;
+      triggerSetEndTeeth = triggerSetEndTeeth_Daihatsu;
+
+      //No secondary input required for this pattern
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    case DECODER_HARLEY:
+      triggerSetup_Harley();
+      triggerHandler = triggerPri_Harley;
+      getRPM = getRPM_Harley;
+      getCrankAngle = getCrankAngle_Harley;
+      triggerSetEndTeeth = triggerSetEndTeeth_Harley;
+
+      primaryTriggerEdge = RISING; //Always rising
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    case DECODER_36_2_2_2:
+      //36-2-2-2
+      triggerSetup_ThirtySixMinus222();
+      triggerHandler = triggerPri_ThirtySixMinus222;
+      triggerSecondaryHandler = triggerSec_ThirtySixMinus222;
+      getRPM = getRPM_ThirtySixMinus222;
+      getCrankAngle = getCrankAngle_ThirtySixMinus222;
+      triggerSetEndTeeth = triggerSetEndTeeth_ThirtySixMinus222;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_36_2_1:
+      //36-2-1
+      triggerSetup_ThirtySixMinus21();
+      triggerHandler = triggerPri_ThirtySixMinus21;
+      triggerSecondaryHandler = triggerSec_ThirtySixMinus21;
+      getRPM = getRPM_ThirtySixMinus21;
+      getCrankAngle = getCrankAngle_ThirtySixMinus21;
+      triggerSetEndTeeth = triggerSetEndTeeth_ThirtySixMinus21;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_420A:
+      //DSM 420a
+      triggerSetup_420a();
+      triggerHandler = triggerPri_420a;
+      triggerSecondaryHandler = triggerSec_420a;
+      getRPM = getRPM_420a;
+      getCrankAngle = getCrankAngle_420a;
+      triggerSetEndTeeth = triggerSetEndTeeth_420a;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      secondaryTriggerEdge = FALLING; //Always falling edge
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_WEBER:
+      //Weber-Marelli
+      triggerSetup_DualWheel();
+      triggerHandler = triggerPri_Webber;
+      triggerSecondaryHandler = triggerSec_Webber;
+      getRPM = getRPM_DualWheel;
+      getCrankAngle = getCrankAngle_DualWheel;
+      triggerSetEndTeeth = triggerSetEndTeeth_DualWheel;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_ST170:
+      //Ford ST170
+      triggerSetup_FordST170();
+      triggerHandler = triggerPri_missingTooth;
+      triggerSecondaryHandler = triggerSec_FordST170;
+      getRPM = getRPM_FordST170;
+      getCrankAngle = getCrankAngle_FordST170;
+      triggerSetEndTeeth = triggerSetEndTeeth_FordST170;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_DRZ400:
+      triggerSetup_DRZ400();
+      triggerHandler = triggerPri_DualWheel;
+      triggerSecondaryHandler = triggerSec_DRZ400;
+      getRPM = getRPM_DualWheel;
+      getCrankAngle = getCrankAngle_DualWheel;
+      triggerSetEndTeeth = triggerSetEndTeeth_DualWheel;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_NGC:
+      //Chrysler NGC - 4, 6 and 8 cylinder
+      triggerSetup_NGC();
+      triggerHandler = triggerPri_NGC;
+      getRPM = getRPM_NGC;
+      getCrankAngle = getCrankAngle_missingTooth;
+      triggerSetEndTeeth = triggerSetEndTeeth_NGC;
+
+      primaryTriggerEdge = CHANGE;
+      if (configPage2.nCylinders == 4)
+      {
+        triggerSecondaryHandler = triggerSec_NGC4;
+        secondaryTriggerEdge = CHANGE;
+      }
+      else
+      {
+        triggerSecondaryHandler = triggerSec_NGC68;
+        secondaryTriggerEdge = FALLING;
+      }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_VMAX:
+      triggerSetup_Vmax();
+      triggerHandler = triggerPri_Vmax;
+      getRPM = getRPM_Vmax;
+      getCrankAngle = getCrankAngle_Vmax;
+      triggerSetEndTeeth = triggerSetEndTeeth_Vmax;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = true; } // set as boolean so we can directly use it in decoder.
+      else { primaryTriggerEdge = false; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, CHANGE); //Hardcoded change, the primaryTriggerEdge will be used in the decoder to select if it's an inverted or non-inverted signal.
+      break;
+
+    case DECODER_RENIX:
+      //Renault 44 tooth decoder
+      triggerSetup_Renix();
+      triggerHandler = triggerPri_Renix;
+      getRPM = getRPM_missingTooth;
+      getCrankAngle = getCrankAngle_missingTooth;
+      triggerSetEndTeeth = triggerSetEndTeeth_Renix;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    case DECODER_ROVERMEMS:
+      //Rover MEMs - covers multiple flywheel trigger combinations.
+      triggerSetup_RoverMEMS();
+      triggerHandler = triggerPri_RoverMEMS;
+      triggerSecondaryHandler = triggerSec_RoverMEMS;
+      getRPM = getRPM_RoverMEMS;
+      getCrankAngle = getCrankAngle_RoverMEMS;
+      triggerSetEndTeeth = triggerSetEndTeeth_RoverMEMS;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge);
+      break;
+
+    case DECODER_PATTERN:
+      triggerSetup_pattern();
+      triggerHandler = triggerPri_pattern;
+      triggerSecondaryHandler = triggerSec_pattern;
+      getRPM = getRPM_pattern;
+      getCrankAngle = getCrankAngle_pattern;
+      triggerSetEndTeeth = triggerSetEndTeeth_pattern;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+      if(configPage4.TrigEdgeSec == 0) { secondaryTriggerEdge = RISING; }
+      else { secondaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      if(BIT_CHECK(triggerInfo.decoderState, BIT_DECODER_HAS_SECONDARY)) { attachInterrupt(triggerInterrupt2, triggerSecondaryHandler, secondaryTriggerEdge); }
+      break;
+
+    case DECODER_SUZUKI_K6A:
+      triggerSetup_SuzukiK6A();
+      triggerHandler = triggerPri_SuzukiK6A; // only primary, no secondary, trigger pattern is over 720 degrees
+      getRPM = getRPM_SuzukiK6A;
+      getCrankAngle = getCrankAngle_SuzukiK6A;
+      triggerSetEndTeeth = triggerSetEndTeeth_SuzukiK6A;
+
+      if(configPage4.TrigEdge == 0) { primaryTriggerEdge = RISING; } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { primaryTriggerEdge = FALLING; }
+
+      attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, primaryTriggerEdge);
+      break;
+
+    default:
+      triggerHandler = triggerPri_missingTooth;
+      getRPM = getRPM_missingTooth;
+      getCrankAngle = getCrankAngle_missingTooth;
+
+      if(configPage4.TrigEdge == 0) { attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, RISING); } // Attach the crank trigger wheel interrupt (Hall sensor drags to ground when triggering)
+      else { attachInterrupt(triggerInterrupt, PRIMARY_TRIGGER_ISR, FALLING); }
+      break;
+  }
+
+  #if defined(CORE_TEENSY41)
+    //Teensy 4 requires a HYSTERESIS flag to be set on the trigger pins to prevent false interrupts
+    setTriggerHysteresis();
+  #endif
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture(); //Must follow the attachInterrupt() calls above
+  #endif
+}
+
+
 /** Set board / microcontroller specific pin mappings / assignments.
  * The boardID is switch-case compared against raw boardID integers (not enum or defined label, and probably no need for that either)
  * which are originated from tuning SW (e.g. TS) set values and are available in reference/speeduino.ini (See pinLayout, note also that
@@ -466,6 +999,25 @@ void setPinMapping(byte boardID)
     pinMode(pinCoil8, OUTPUT);
     #endif
 
+#if defined(PORT_TYPE)
+    coilOutputs[0].port = portOutputRegister(digitalPinToPort(pinCoil1));
+    coilOutputs[0].mask = digitalPinToBitMask(pinCoil1);
+    coilOutputs[1].port = portOutputRegister(digitalPinToPort(pinCoil2));
+    coilOutputs[1].mask = digitalPinToBitMask(pinCoil2);
+    coilOutputs[2].port = portOutputRegister(digitalPinToPort(pinCoil3));
+    coilOutputs[2].mask = digitalPinToBitMask(pinCoil3);
+    coilOutputs[3].port = portOutputRegister(digitalPinToPort(pinCoil4));
+    coilOutputs[3].mask = digitalPinToBitMask(pinCoil4);
+    coilOutputs[4].port = portOutputRegister(digitalPinToPort(pinCoil5));
+    coilOutputs[4].mask = digitalPinToBitMask(pinCoil5);
+    coilOutputs[5].port = portOutputRegister(digitalPinToPort(pinCoil6));
+    coilOutputs[5].mask = digitalPinToBitMask(pinCoil6);
+    coilOutputs[6].port = portOutputRegister(digitalPinToPort(pinCoil7));
+    coilOutputs[6].mask = digitalPinToBitMask(pinCoil7);
+    coilOutputs[7].port = portOutputRegister(digitalPinToPort(pinCoil8));
+    coilOutputs[7].mask = digitalPinToBitMask(pinCoil8);
+#endif
+
 #if !defined(CORE_M451)
 
   } 
@@ -491,22 +1043,22 @@ void setPinMapping(byte boardID)
     #endif
 
 #if defined(PORT_TYPE)
-    inj1_pin_port = portOutputRegister(digitalPinToPort(pinInjector1));
-    inj1_pin_mask = digitalPinToBitMask(pinInjector1);
-    inj2_pin_port = portOutputRegister(digitalPinToPort(pinInjector2));
-    inj2_pin_mask = digitalPinToBitMask(pinInjector2);
-    inj3_pin_port = portOutputRegister(digitalPinToPort(pinInjector3));
-    inj3_pin_mask = digitalPinToBitMask(pinInjector3);
-    inj4_pin_port = portOutputRegister(digitalPinToPort(pinInjector4));
-    inj4_pin_mask = digitalPinToBitMask(pinInjector4);
-    inj5_pin_port = portOutputRegister(digitalPinToPort(pinInjector5));
-    inj5_pin_mask = digitalPinToBitMask(pinInjector5);
-    inj6_pin_port = portOutputRegister(digitalPinToPort(pinInjector6));
-    inj6_pin_mask = digitalPinToBitMask(pinInjector6);
-    inj7_pin_port = portOutputRegister(digitalPinToPort(pinInjector7));
-    inj7_pin_mask = digitalPinToBitMask(pinInjector7);
-    inj8_pin_port = portOutputRegister(digitalPinToPort(pinInjector8));
-    inj8_pin_mask = digitalPinToBitMask(pinInjector8);
+    injectorOutputs[0].port = portOutputRegister(digitalPinToPort(pinInjector1));
+    injectorOutputs[0].mask = digitalPinToBitMask(pinInjector1);
+    injectorOutputs[1].port = portOutputRegister(digitalPinToPort(pinInjector2));
+    injectorOutputs[1].mask = digitalPinToBitMask(pinInjector2);
+    injectorOutputs[2].port = portOutputRegister(digitalPinToPort(pinInjector3));
+    injectorOutputs[2].mask = digitalPinToBitMask(pinInjector3);
+    injectorOutputs[3].port = portOutputRegister(digitalPinToPort(pinInjector4));
+    injectorOutputs[3].mask = digitalPinToBitMask(pinInjector4);
+    injectorOutputs[4].port = portOutputRegister(digitalPinToPort(pinInjector5));
+    injectorOutputs[4].mask = digitalPinToBitMask(pinInjector5);
+    injectorOutputs[5].port = portOutputRegister(digitalPinToPort(pinInjector6));
+    injectorOutputs[5].mask = digitalPinToBitMask(pinInjector6);
+    injectorOutputs[6].port = portOutputRegister(digitalPinToPort(pinInjector7));
+    injectorOutputs[6].mask = digitalPinToBitMask(pinInjector7);
+    injectorOutputs[7].port = portOutputRegister(digitalPinToPort(pinInjector8));
+    injectorOutputs[7].mask = digitalPinToBitMask(pinInjector8);
 #endif
 
 #if !defined(CORE_M451)
@@ -521,6 +1073,9 @@ void setPinMapping(byte boardID)
   }
 #endif
 
+  //The schedules are given the output functions after this, so the drivers must be selected first
+  initialiseOutputDrivers();
+
 //CS pin number is now set in a compile flag. 
 // #ifdef USE_SPI_EEPROM
 //   //We need to send the flash CS (SS) pin if we're using SPI flash. It cannot read from globals.
@@ -0,0 +1,26 @@
+/** \file isrProfiler.cpp
+ * @brief Interrupt latency and duration histograms. See isrProfiler.h
+ */
+#include "globals.h"
+#include "isrProfiler.h"
+#include <SimplyAtomic.h>
+
+isrProfile_t isrProfile[ISR_PROFILE_COUNT];
+
+static void clearHistogram(isrHistogram_t &histogram)
+{
+  for(uint8_t bucket = 0; bucket < ISR_HISTOGRAM_BUCKETS; bucket++) { histogram.buckets[bucket] = 0; }
+  histogram.maxTime = 0;
+}
+
+void isrProfileReset(void)
+{
+  ATOMIC()
+  {
+    for(uint8_t source = 0; source < ISR_PROFILE_COUNT; source++)
+    {
+      clearHistogram(isrProfile[source].latency);
+      clearHistogram(isrProfile[source].duration);
+    }
+  }
+}
@@ -0,0 +1,82 @@
+/** \file isrProfiler.h
+ * @brief Interrupt latency and duration histograms
+ *
+ * Each profiled interrupt source keeps two histograms: entry latency (how late the handler started compared to when the
+ * interrupt was due) and handler duration. Buckets are powers of 2 in uS: bucket 0 holds 0-1uS, bucket 1 2-3uS, bucket 2
+ * 4-7uS and so on, with the last bucket holding everything from ISR_HISTOGRAM_TOP_US up. Counts saturate at UINT16_MAX
+ * and, along with the largest value seen, are kept until isrProfileReset() is called.
+ *
+ * Latency is only measured for the timer interrupts:
+ * - Fuel and ignition schedules: timer counter at handler entry minus the compare value that fired it
+ * - 1ms timer: time since the previous run, minus 1ms
+ * - Trigger: time since the edge was captured, on boards that capture the trigger edges (See TRIGGER_TIMESTAMP() in
+ *   decoders.h). Elsewhere there is no record of when the edge happened, so only the duration is recorded.
+ *
+ * Profiling uses 2 calls to micros() per interrupt. This is cheap on the 32 bit boards, but on AVR it noticeably
+ * lengthens every ISR, so it is off there unless ISR_PROFILING is defined in the build flags.
+ */
+#ifndef ISR_PROFILER_H
+#define ISR_PROFILER_H
+
+#include "globals.h" // Needed for CORE_AVR, micros() and uS_TO_TIMER_COMPARE()
+
+#if !defined(CORE_AVR) && !defined(ISR_PROFILING)
+  #define ISR_PROFILING
+#endif
+
+//Interrupt sources. These are also the order the sources are sent in by the ISR profile comms command
+#define ISR_PROFILE_TRIGGER   0 //Primary trigger (The decoder's triggerPri_* function, or loggerPrimaryISR when a logger is running)
+#define ISR_PROFILE_FUEL      1 //All fuel schedule channels
+#define ISR_PROFILE_IGNITION  2 //All ignition schedule channels
+#define ISR_PROFILE_1MS       3 //oneMSInterval()
+#define ISR_PROFILE_COUNT     4
+
+#define ISR_HISTOGRAM_BUCKETS 8
+#define ISR_HISTOGRAM_TOP_US  (1UL << (ISR_HISTOGRAM_BUCKETS - 1U)) //Values from here up all go in the last bucket
+
+struct isrHistogram_t {
+  volatile uint16_t buckets[ISR_HISTOGRAM_BUCKETS];
+  volatile uint16_t maxTime; ///< Largest value seen (uS)
+};
+
+struct isrProfile_t {
+  isrHistogram_t latency;
+  isrHistogram_t duration;
+};
+
+extern isrProfile_t isrProfile[ISR_PROFILE_COUNT];
+
+/** @brief Clears all of the histograms. Runs with interrupts disabled */
+void isrProfileReset(void);
+
+/** @brief Adds a value (uS) to a histogram. Inlined as this is called from within the ISRs */
+static inline __attribute__((always_inline)) void isrHistogramAdd(isrHistogram_t &histogram, uint32_t value)
+{
+  uint8_t bucket = 0;
+  for(uint32_t top = 2; (bucket < (ISR_HISTOGRAM_BUCKETS - 1U)) && (value >= top); top <<= 1) { bucket++; }
+
+  if(histogram.buckets[bucket] < UINT16_MAX) { histogram.buckets[bucket]++; }
+  uint16_t value16 = (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+  if(value16 > histogram.maxTime) { histogram.maxTime = value16; }
+}
+
+//Converts a number of schedule timer ticks to uS. The inverse of the board's uS_TO_TIMER_COMPARE()
+#define ISR_TIMER_TICKS_TO_uS(ticks) ( ((uint32_t)(ticks) * 1024UL) / uS_TO_TIMER_COMPARE(1024UL) )
+
+#if defined(ISR_PROFILING)
+  /** @brief Records the handler entry time. Must be the first statement of the ISR */
+  #define ISR_PROFILE_START()                 uint32_t isrEntryTime = micros()
+  /** @brief Records the handler duration. Must be the last statement of the ISR */
+  #define ISR_PROFILE_END(source)             isrHistogramAdd(isrProfile[(source)].duration, micros() - isrEntryTime)
+  /** @brief Records how many timer ticks late the handler started */
+  #define ISR_PROFILE_LATENCY_TICKS(source, ticks) isrHistogramAdd(isrProfile[(source)].latency, ISR_TIMER_TICKS_TO_uS(ticks))
+  /** @brief Records how many uS late the handler started */
+  #define ISR_PROFILE_LATENCY_US(source, uS)  isrHistogramAdd(isrProfile[(source)].latency, (uS))
+#else
+  #define ISR_PROFILE_START()
+  #define ISR_PROFILE_END(source)
+  #define ISR_PROFILE_LATENCY_TICKS(source, ticks)
+  #define ISR_PROFILE_LATENCY_US(source, uS)
+#endif
+
+#endif // ISR_PROFILER_H
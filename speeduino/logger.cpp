@@ -6,6 +6,9 @@
 #include "init.h"
 #include "maths.h"
 #include "utilities.h"
+#include "loopProfiler.h"
+#include "isrProfiler.h"
+#include "toothLogRing.h"
 #include BOARD_H 
 
 /** 
@@ -176,6 +179,21 @@ byte getTSLogEntry(uint16_t byteNum)
     case 127: statusValue = currentStatus.status5; break;
     case 128: statusValue = currentStatus.knockCount; break;
     case 129: statusValue = currentStatus.knockRetard; break;
+    case 130: statusValue = lowByte(loopProfile[LOOP_TASK_LOOP].maxTime); break; //Longest loop in the last second (uS)
+    case 131: statusValue = highByte(loopProfile[LOOP_TASK_LOOP].maxTime); break;
+    case 132: statusValue = lowByte(loopProfile[LOOP_TASK_LOOP].avgTime); break; //Mean loop time in the last second (uS)
+    case 133: statusValue = highByte(loopProfile[LOOP_TASK_LOOP].avgTime); break;
+    case 134: statusValue = loopProfileSlowestTask(); break; //Task with the longest run in the last second (LOOP_TASK_*)
+    case 135: statusValue = lowByte(loopProfile[loopProfileSlowestTask()].maxTime); break; //Longest run of that task (uS)
+    case 136: statusValue = highByte(loopProfile[loopProfileSlowestTask()].maxTime); break;
+    case 137: statusValue = lowByte(loopProfile[LOOP_TASK_LOOP].overruns); break; //Loops longer than LOOP_PROFILE_OVERRUN_US
+    case 138: statusValue = highByte(loopProfile[LOOP_TASK_LOOP].overruns); break;
+    case 139: statusValue = lowByte(isrProfile[ISR_PROFILE_TRIGGER].duration.maxTime); break; //Longest trigger ISR since reset (uS)
+    case 140: statusValue = highByte(isrProfile[ISR_PROFILE_TRIGGER].duration.maxTime); break;
+    case 141: statusValue = lowByte(isrProfile[ISR_PROFILE_IGNITION].latency.maxTime); break; //Latest ignition ISR start since reset (uS)
+    case 142: statusValue = highByte(isrProfile[ISR_PROFILE_IGNITION].latency.maxTime); break;
+    case 143: statusValue = lowByte(isrProfile[ISR_PROFILE_IGNITION].duration.maxTime); break; //Longest ignition ISR since reset (uS)
+    case 144: statusValue = highByte(isrProfile[ISR_PROFILE_IGNITION].duration.maxTime); break;
     default: statusValue = 0; // MISRA check
   }
 
@@ -511,10 +529,9 @@ bool is2ByteEntry(uint8_t key)
 
 void startToothLogger(void)
 {
+  toothLogRingReset(false); //Before the flags below, so the entries are written in this log's format
   currentStatus.toothLogEnabled = true;
   currentStatus.compositeTriggerUsed = 0U; //Safety first (Should never be required)
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-  toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
@@ -525,7 +542,10 @@ void startToothLogger(void)
     detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
     attachInterrupt( digitalPinToInterrupt(pinTrigger2), loggerSecondaryISR, CHANGE );  
   }
-  
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture(); //Attaching the interrupts takes the pins away from their capture channels
+  #endif
 }
 
 void stopToothLogger(void)
@@ -534,21 +554,24 @@ void stopToothLogger(void)
 
   //Disconnect the logger interrupts and attach the normal ones
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
-  attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerHandler, primaryTriggerEdge );
+  attachInterrupt( digitalPinToInterrupt(pinTrigger), PRIMARY_TRIGGER_ISR, primaryTriggerEdge );
 
   if(VSS_USES_RPM2() != true)
   {
     detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
     attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryHandler, secondaryTriggerEdge );  
   }
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 void startCompositeLogger(void)
 {
+  toothLogRingReset(true);
   currentStatus.compositeTriggerUsed = 2U;
   currentStatus.toothLogEnabled = false; //Safety first (Should never be required)
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-  toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
@@ -559,6 +582,10 @@ void startCompositeLogger(void)
     detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
     attachInterrupt( digitalPinToInterrupt(pinTrigger2), loggerSecondaryISR, CHANGE );
   }
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 void stopCompositeLogger(void)
@@ -567,21 +594,24 @@ void stopCompositeLogger(void)
 
   //Disconnect the logger interrupts and attach the normal ones
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
-  attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerHandler, primaryTriggerEdge );
+  attachInterrupt( digitalPinToInterrupt(pinTrigger), PRIMARY_TRIGGER_ISR, primaryTriggerEdge );
 
   if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
   {
     detachInterrupt( digitalPinToInterrupt(pinTrigger2) );
     attachInterrupt( digitalPinToInterrupt(pinTrigger2), triggerSecondaryHandler, secondaryTriggerEdge );
   }
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 void startCompositeLoggerTertiary(void)
 {
+  toothLogRingReset(true);
   currentStatus.compositeTriggerUsed = 3U;
   currentStatus.toothLogEnabled = false; //Safety first (Should never be required)
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-  toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
@@ -589,6 +619,10 @@ void startCompositeLoggerTertiary(void)
 
   detachInterrupt( digitalPinToInterrupt(pinTrigger3) );
   attachInterrupt( digitalPinToInterrupt(pinTrigger3), loggerTertiaryISR, CHANGE );
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 void stopCompositeLoggerTertiary(void)
@@ -597,19 +631,22 @@ void stopCompositeLoggerTertiary(void)
 
   //Disconnect the logger interrupts and attach the normal ones
   detachInterrupt( digitalPinToInterrupt(pinTrigger) );
-  attachInterrupt( digitalPinToInterrupt(pinTrigger), triggerHandler, primaryTriggerEdge );
+  attachInterrupt( digitalPinToInterrupt(pinTrigger), PRIMARY_TRIGGER_ISR, primaryTriggerEdge );
 
   detachInterrupt( digitalPinToInterrupt(pinTrigger3) );
   attachInterrupt( digitalPinToInterrupt(pinTrigger3), triggerTertiaryHandler, tertiaryTriggerEdge );
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 
 void startCompositeLoggerCams(void)
 {
+  toothLogRingReset(true);
   currentStatus.compositeTriggerUsed = 4;
   currentStatus.toothLogEnabled = false; //Safety first (Should never be required)
-  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-  toothHistoryIndex = 0;
 
   //Disconnect the standard interrupt and add the logger version
   if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
@@ -620,6 +657,10 @@ void startCompositeLoggerCams(void)
 
   detachInterrupt( digitalPinToInterrupt(pinTrigger3) );
   attachInterrupt( digitalPinToInterrupt(pinTrigger3), loggerTertiaryISR, CHANGE );
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
 
 void stopCompositeLoggerCams(void)
@@ -635,4 +676,8 @@ void stopCompositeLoggerCams(void)
 
   detachInterrupt( digitalPinToInterrupt(pinTrigger3) );
   attachInterrupt( digitalPinToInterrupt(pinTrigger3), triggerTertiaryHandler, tertiaryTriggerEdge );
+
+  #if defined(USE_TRIGGER_CAPTURE)
+    initTriggerCapture();
+  #endif
 }
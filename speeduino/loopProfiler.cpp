@@ -0,0 +1,87 @@
+/** \file loopProfiler.cpp
+ * @brief Main loop task profiler. See loopProfiler.h
+ */
+#include "globals.h"
+#include "loopProfiler.h"
+
+loopTaskProfile_t loopProfile[LOOP_TASK_COUNT];
+
+//Results for the second in progress. The loop is the only writer, so no locking is needed
+struct loopTaskAccumulator_t {
+  uint32_t totalTime;
+  uint16_t runs;
+  uint16_t minTime;
+  uint16_t maxTime;
+};
+static loopTaskAccumulator_t accumulators[LOOP_TASK_COUNT];
+
+static void clearAccumulators(void)
+{
+  for(uint8_t task = 0; task < LOOP_TASK_COUNT; task++)
+  {
+    accumulators[task].totalTime = 0;
+    accumulators[task].runs = 0;
+    accumulators[task].minTime = UINT16_MAX;
+    accumulators[task].maxTime = 0;
+  }
+}
+
+void loopProfileEnd(uint8_t task, uint32_t startTime)
+{
+  uint32_t runTime = micros() - startTime;
+  uint16_t runTime16 = (runTime > UINT16_MAX) ? UINT16_MAX : (uint16_t)runTime;
+  loopTaskAccumulator_t &accumulator = accumulators[task];
+
+  if(accumulator.runs < UINT16_MAX)
+  {
+    accumulator.runs++;
+    accumulator.totalTime += runTime16;
+  }
+  if(runTime16 < accumulator.minTime) { accumulator.minTime = runTime16; }
+  if(runTime16 > accumulator.maxTime) { accumulator.maxTime = runTime16; }
+  if( (runTime > LOOP_PROFILE_OVERRUN_US) && (loopProfile[task].overruns < UINT16_MAX) ) { loopProfile[task].overruns++; }
+}
+
+void loopProfileLatch(void)
+{
+  for(uint8_t task = 0; task < LOOP_TASK_COUNT; task++)
+  {
+    const loopTaskAccumulator_t &accumulator = accumulators[task];
+    if(accumulator.runs == 0U)
+    {
+      //Task didn't run in the last second
+      loopProfile[task].minTime = 0;
+      loopProfile[task].avgTime = 0;
+      loopProfile[task].maxTime = 0;
+    }
+    else
+    {
+      loopProfile[task].minTime = accumulator.minTime;
+      loopProfile[task].avgTime = (uint16_t)(accumulator.totalTime / accumulator.runs);
+      loopProfile[task].maxTime = accumulator.maxTime;
+    }
+  }
+  clearAccumulators();
+}
+
+void loopProfileReset(void)
+{
+  clearAccumulators();
+  for(uint8_t task = 0; task < LOOP_TASK_COUNT; task++)
+  {
+    loopProfile[task].minTime = 0;
+    loopProfile[task].avgTime = 0;
+    loopProfile[task].maxTime = 0;
+    loopProfile[task].overruns = 0;
+  }
+}
+
+uint8_t loopProfileSlowestTask(void)
+{
+  uint8_t slowest = LOOP_TASK_SERIAL;
+  for(uint8_t task = LOOP_TASK_SERIAL + 1U; task < LOOP_TASK_COUNT; task++)
+  {
+    if(loopProfile[task].maxTime > loopProfile[slowest].maxTime) { slowest = task; }
+  }
+  return slowest;
+}
@@ -0,0 +1,56 @@
+/** \file loopProfiler.h
+ * @brief Main loop task profiler
+ *
+ * Records the execution time of each timer bucket of loop() and the major calls within it, so that a long loop can be
+ * traced back to the task that caused it. Results are collected over one second and then latched, giving the
+ * min/avg/max time (uS) of each task over the last complete second. Overruns count every run of a task that took longer
+ * than LOOP_PROFILE_OVERRUN_US and accumulate until loopProfileReset() is called.
+ */
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <stdint.h>
+
+#define LOOP_PROFILE_OVERRUN_US 1000U //A task that runs for longer than this delays the 1kHz tasks
+
+//Task IDs. These are also the order the tasks are sent in by the loop profile comms command
+#define LOOP_TASK_LOOP      0 //The whole of loop()
+#define LOOP_TASK_SERIAL    1
+#define LOOP_TASK_STORAGE   2
+#define LOOP_TASK_1KHZ      3
+#define LOOP_TASK_200HZ     4
+#define LOOP_TASK_50HZ      5
+#define LOOP_TASK_30HZ      6
+#define LOOP_TASK_15HZ      7
+#define LOOP_TASK_10HZ      8
+#define LOOP_TASK_4HZ       9
+#define LOOP_TASK_1HZ       10
+#define LOOP_TASK_ENGINE    11 //engineControl()
+#define LOOP_TASK_BOOST     12
+#define LOOP_TASK_VVT       13
+#define LOOP_TASK_IDLE      14
+#define LOOP_TASK_SD_LOG    15 //writeSDLogEntry()
+#define LOOP_TASK_COUNT     16
+
+struct loopTaskProfile_t {
+  uint16_t minTime;   ///< Shortest run in the last second (uS)
+  uint16_t avgTime;   ///< Mean run time in the last second (uS)
+  uint16_t maxTime;   ///< Longest run in the last second (uS)
+  uint16_t overruns;  ///< Runs longer than LOOP_PROFILE_OVERRUN_US since the last reset
+};
+
+extern loopTaskProfile_t loopProfile[LOOP_TASK_COUNT];
+
+/** @brief Adds a run of the given task that started at startTime (micros()) and has just finished */
+void loopProfileEnd(uint8_t task, uint32_t startTime);
+/** @brief Publishes the results collected since the last call to loopProfile[] and starts a new collection period. Called once per second */
+void loopProfileLatch(void);
+/** @brief Clears all results, including the overrun counts */
+void loopProfileReset(void);
+/** @brief The task (other than LOOP_TASK_LOOP) with the longest run in the last second */
+uint8_t loopProfileSlowestTask(void);
+
+/** @brief Times a single call. Eg: LOOP_PROFILE(LOOP_TASK_BOOST, boostControl()); */
+#define LOOP_PROFILE(task, call) do { uint32_t profileStart = micros(); call; loopProfileEnd((task), profileStart); } while(0)
+
+#endif // LOOP_PROFILER_H
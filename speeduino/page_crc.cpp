@@ -99,3 +99,59 @@ uint32_t calculatePageCRC32(byte pageNum)
   }
   return ~pad_crc(getPageSize(pageNum) - entity.size, crc, crcCalc);
 }
+
+// ========================= CRC cache =========================
+
+// TS asks for the CRC of every page on connect, so computing them on demand
+// blocks the loop for a long time (especially on AVR). Instead we keep the last CRC
+// of each page, which stays valid until the page is written.
+static uint32_t pageCRCs[PAGE_COUNT];
+static uint16_t validCRCs = 0U; //Bit n is set if pageCRCs[n] is up to date
+static uint8_t nextVerifyPage = 0U;
+static_assert(PAGE_COUNT <= 16U, "validCRCs has 1 bit per page");
+
+void invalidatePageCRC32(byte pageNum)
+{
+  if (pageNum < PAGE_COUNT) { BIT_CLEAR(validCRCs, pageNum); }
+}
+
+void invalidateAllPageCRC32(void)
+{
+  validCRCs = 0U;
+}
+
+uint32_t getPageCRC32(byte pageNum)
+{
+  if (pageNum >= PAGE_COUNT) { return calculatePageCRC32(pageNum); } //Not cached, let calculatePageCRC32() deal with it
+  if (!BIT_CHECK(validCRCs, pageNum))
+  {
+    pageCRCs[pageNum] = calculatePageCRC32(pageNum);
+    BIT_SET(validCRCs, pageNum);
+  }
+  return pageCRCs[pageNum];
+}
+
+bool updateStalePageCRC32(void)
+{
+  for (uint8_t pageNum = 0U; pageNum < PAGE_COUNT; ++pageNum)
+  {
+    if (!BIT_CHECK(validCRCs, pageNum) && getPageSize(pageNum)!=0U)
+    {
+      (void)getPageCRC32(pageNum);
+      return true;
+    }
+  }
+  return false;
+}
+
+void verifyNextPageCRC32(void)
+{
+  //Page 0 is empty and has no CRC
+  do
+  {
+    nextVerifyPage = (nextVerifyPage + 1U) % PAGE_COUNT;
+  } while (getPageSize(nextVerifyPage)==0U);
+
+  pageCRCs[nextVerifyPage] = calculatePageCRC32(nextVerifyPage);
+  BIT_SET(validCRCs, nextVerifyPage);
+}
@@ -4,4 +4,34 @@
 /*
  * Calculates and returns the CRC32 value of a given page of memory
  */
-uint32_t calculatePageCRC32(byte pageNum /**< [in] The page number to compute CRC for. */);
\ No newline at end of file
+uint32_t calculatePageCRC32(byte pageNum /**< [in] The page number to compute CRC for. */);
+
+/*
+ * Returns the CRC32 value of a given page, from the cache if it is up to date.
+ * Use this rather than calculatePageCRC32() when responding to TS.
+ */
+uint32_t getPageCRC32(byte pageNum /**< [in] The page number to return the CRC for. */);
+
+/*
+ * Marks the cached CRC of a page as stale. Called by setPageValue(), and should be 
+ * called after changing any page data directly.
+ */
+void invalidatePageCRC32(byte pageNum /**< [in] The page number that has changed. */);
+
+/*
+ * Marks all cached CRCs as stale. E.g. after loading the config from storage.
+ */
+void invalidateAllPageCRC32(void);
+
+/*
+ * Recomputes the CRC of the first page (if any) whose cached CRC is stale.
+ * Does at most one page per call, so the cost can be spread over several loops.
+ * Returns true if a page was recomputed.
+ */
+bool updateStalePageCRC32(void);
+
+/*
+ * Recomputes the CRC of the next page in turn, whether stale or not. This catches
+ * page data that was changed directly without invalidating its CRC.
+ */
+void verifyNextPageCRC32(void);
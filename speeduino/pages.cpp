@@ -4,6 +4,8 @@
 #include "config.h"
 
 #include "utilities.h"
+#include "page_crc.h"
+#include "engine.h"
 #include "tables/table3d_axis_io.h"
 
 // Maps from virtual page "addresses" to addresses/bytes of real in memory entities
@@ -28,6 +30,7 @@
 
 // Page sizes as defined in the .ini file
 constexpr const uint16_t PROGMEM ini_page_sizes[] = { 0, 128, 288, 288, 128, 288, 128, 240, 384, 192, 192, 288, 192, 128, 288, 256 };
+static_assert(_countof(ini_page_sizes) == PAGE_COUNT, "PAGE_COUNT must match the number of pages");
 
 // ========================= Table size calculations =========================
 // Note that these should be computed at compile time, assuming the correct
@@ -67,7 +70,7 @@ public:
   //
   // Using a template here is a performance boost - we can call functions that
   // are specialised per table type, which allows the compiler more optimisation
-  // opportunities. See get_table_value().
+  // opportunities. See page_value_getter.
 
   offset_to_table(table_t *pTable, uint16_t table_offset)
   : _pTable(pTable),
@@ -101,11 +104,13 @@ public:
 
       case table_location_xaxis:
         get_xaxis_value() = get_table3d_axis_converter(table_t::xaxis_t::domain).from_byte(new_value);
+        _pTable->axisX.rebuild_reciprocals();
         break;
 
       case table_location_yaxis:
       default:
         get_yaxis_value() = get_table3d_axis_converter(table_t::yaxis_t::domain).from_byte(new_value);
+        _pTable->axisY.rebuild_reciprocals();
     }
     invalidate_cache(&_pTable->get_value_cache);
     return *this;
@@ -149,54 +154,6 @@ private:
   uint16_t _table_offset;
 };
 
-// ========================= Offset to entity byte mapping =========================
-
-inline byte& get_raw_location(page_iterator_t &entity, uint16_t offset)
-{
-  return *((byte*)entity.pData + (offset-entity.start));
-}
-
-inline byte get_table_value(page_iterator_t &entity, uint16_t offset)
-{
-  #define CTA_GET_TABLE_VALUE(size, xDomain, yDomain, pTable, offset) \
-      return *offset_to_table<TABLE3D_TYPENAME_BASE(size, xDomain, yDomain)>((TABLE3D_TYPENAME_BASE(size, xDomain, yDomain)*)pTable, offset);
-  #define CTA_GET_TABLE_VALUE_DEFAULT ({ return 0U; })
-  CONCRETE_TABLE_ACTION(entity.table_key, CTA_GET_TABLE_VALUE, CTA_GET_TABLE_VALUE_DEFAULT, entity.pData, (offset-entity.start));  
-}
-
-inline byte get_value(page_iterator_t &entity, uint16_t offset)
-{
-  if (Raw==entity.type)
-  {
-    return get_raw_location(entity, offset);
-  }
-  if (Table==entity.type)
-  {
-    return get_table_value(entity, offset);
-  }
-  return 0U;
-}
-
-inline void set_table_value(page_iterator_t &entity, uint16_t offset, byte new_value)
-{
-  #define CTA_SET_TABLE_VALUE(size, xDomain, yDomain, pTable, offset, new_value) \
-      offset_to_table<TABLE3D_TYPENAME_BASE(size, xDomain, yDomain)>((TABLE3D_TYPENAME_BASE(size, xDomain, yDomain)*)pTable, offset) = new_value; break;
-  #define CTA_SET_TABLE_VALUE_DEFAULT ({ })
-  CONCRETE_TABLE_ACTION(entity.table_key, CTA_SET_TABLE_VALUE, CTA_SET_TABLE_VALUE_DEFAULT, entity.pData, (offset-entity.start), new_value);  
-}
-
-inline void set_value(page_iterator_t &entity, byte value, uint16_t offset)
-{    
-  if (Raw==entity.type)
-  {
-    get_raw_location(entity, offset) = value;
-  }
-  else if (Table==entity.type)
-  {
-    set_table_value(entity, offset, value);
-  }
-}
-
 // ========================= Static page size computation & checking ===================
 
 // This will fail AND print the page number and required size
@@ -232,7 +189,6 @@ inline const page_iterator_t create_end_iterator(uint8_t pageNum, uint16_t start
 {
   return page_iterator_t {
     .pData = nullptr,
-    .table_key = table_type_None,
     .page = pageNum,
     .start = start,
     .size = start,
@@ -243,15 +199,14 @@ inline const page_iterator_t create_end_iterator(uint8_t pageNum, uint16_t start
 // Signal the end of a page
 #define END_OF_PAGE(pageNum, entityNum) \
   check_size<pageNum, ENTITY_START_VAR(entityNum)>(); \
-  return create_end_iterator(pageNum, ENTITY_START_VAR(entityNum)); \
+  return visitor.visit_end(pageNum, ENTITY_START_VAR(entityNum)); \
 
 // ========================= Table processing  ===================
 
-inline const page_iterator_t create_table_iterator(void *pTable, table_type_t key, uint8_t pageNum, uint16_t start, uint16_t size)
+inline const page_iterator_t create_table_iterator(void *pTable, uint8_t pageNum, uint16_t start, uint16_t size)
 {
   return page_iterator_t {
     .pData = pTable,
-    .table_key = key,
     .page = pageNum,
     .start = start,
     .size = size,
@@ -259,13 +214,11 @@ inline const page_iterator_t create_table_iterator(void *pTable, table_type_t ke
   };
 }
 
-// If the offset is in range, create a Table entity_t
+// If the offset is in range, visit the table
 #define CHECK_TABLE(pageNum, offset, pTable, entityNum) \
   if (offset < ENTITY_START_VAR(entityNum)+get_table_axisy_end(pTable)) \
   { \
-    return create_table_iterator(pTable, (pTable)->type_key, \
-                                  pageNum, \
-                                  ENTITY_START_VAR(entityNum), get_table_axisy_end(pTable)); \
+    return visitor.visit_table(pTable, pageNum, ENTITY_START_VAR(entityNum), get_table_axisy_end(pTable)); \
   } \
   DECLARE_NEXT_ENTITY_START(entityNum, get_table_axisy_end(pTable))
 
@@ -275,7 +228,6 @@ inline const page_iterator_t create_raw_iterator(void *pBuffer, uint8_t pageNum,
 {
   return page_iterator_t {
     .pData = pBuffer,
-    .table_key = table_type_None,
     .page = pageNum,
     .start = start,
     .size = size,
@@ -283,22 +235,30 @@ inline const page_iterator_t create_raw_iterator(void *pBuffer, uint8_t pageNum,
   };
 }
 
-// If the offset is in range, create a Raw entity_t
+// If the offset is in range, visit the raw block
 #define CHECK_RAW(pageNum, offset, pDataBlock, blockSize, entityNum) \
   if (offset < ENTITY_START_VAR(entityNum)+blockSize) \
   { \
-    return create_raw_iterator(pDataBlock, pageNum, ENTITY_START_VAR(entityNum), blockSize);\
+    return visitor.visit_raw(pDataBlock, pageNum, ENTITY_START_VAR(entityNum), blockSize);\
   } \
   DECLARE_NEXT_ENTITY_START(entityNum, blockSize)
 
 // ===============================================================================
 
-// Does the heavy lifting of mapping page+offset to an entity
+// Does the heavy lifting of mapping page+offset to an entity. The entity is
+// passed to the visitor *with its static type*, so e.g. a table value write is
+// compiled for that exact table type - no runtime type dispatch. The visitor
+// must supply:
+//  * result_t
+//  * template <typename table_t> result_t visit_table(table_t *pTable, uint8_t pageNum, uint16_t start, uint16_t size)
+//  * result_t visit_raw(void *pBuffer, uint8_t pageNum, uint16_t start, uint16_t size)
+//  * result_t visit_end(uint8_t pageNum, uint16_t start)
 //
 // Alternative implementation would be to encode the mapping into data structures
 // That uses flash memory, which is scarce. And it was too slow.
+template <typename visitor_t>
 static inline __attribute__((always_inline)) // <-- this is critical for performance
-page_iterator_t map_page_offset_to_entity(uint8_t pageNumber, uint16_t offset)
+typename visitor_t::result_t visit_page_offset(const visitor_t &visitor, uint8_t pageNumber, uint16_t offset)
 {
   // The start address of the 1st entity in any page.
   static constexpr uint16_t ENTITY_START_VAR(0) = 0U;
@@ -417,6 +377,121 @@ page_iterator_t map_page_offset_to_entity(uint8_t pageNumber, uint16_t offset)
 }
 
 
+// ========================= Page visitors  ===================
+
+// Builds a page_iterator_t for the entity
+struct page_iterator_builder {
+  typedef page_iterator_t result_t;
+
+  template <typename table_t>
+  result_t visit_table(table_t *pTable, uint8_t pageNum, uint16_t start, uint16_t size) const
+  {
+    return create_table_iterator(pTable, pageNum, start, size);
+  }
+  result_t visit_raw(void *pBuffer, uint8_t pageNum, uint16_t start, uint16_t size) const
+  {
+    return create_raw_iterator(pBuffer, pageNum, start, size);
+  }
+  result_t visit_end(uint8_t pageNum, uint16_t start) const
+  {
+    return create_end_iterator(pageNum, start);
+  }
+};
+
+static inline page_iterator_t map_page_offset_to_entity(uint8_t pageNumber, uint16_t offset)
+{
+  return visit_page_offset(page_iterator_builder(), pageNumber, offset);
+}
+
+// Reads the byte at a page offset
+struct page_value_getter {
+  typedef byte result_t;
+  uint16_t offset;
+
+  template <typename table_t>
+  result_t visit_table(table_t *pTable, uint8_t, uint16_t start, uint16_t) const
+  {
+    return *offset_to_table<table_t>(pTable, offset-start);
+  }
+  result_t visit_raw(void *pBuffer, uint8_t, uint16_t start, uint16_t) const
+  {
+    return *((byte*)pBuffer + (offset-start));
+  }
+  result_t visit_end(uint8_t, uint16_t) const
+  {
+    return 0U;
+  }
+};
+
+// Writes the byte at a page offset
+struct page_value_setter {
+  typedef void result_t;
+  uint16_t offset;
+  byte value;
+
+  template <typename table_t>
+  result_t visit_table(table_t *pTable, uint8_t, uint16_t start, uint16_t) const
+  {
+    offset_to_table<table_t>(pTable, offset-start) = value;
+  }
+  result_t visit_raw(void *pBuffer, uint8_t, uint16_t start, uint16_t) const
+  {
+    byte &location = *((byte*)pBuffer + (offset-start));
+    if (location != value)
+    {
+      location = value;
+      table2D_invalidateAll(); //The byte may be part of a 2D table
+    }
+  }
+  result_t visit_end(uint8_t, uint16_t) const
+  {
+  }
+};
+
+// Iterators over the parts of a table entity
+struct table_entity_iterators {
+  table_value_iterator rows;
+  table_axis_iterator x;
+  table_axis_iterator xReverse;
+  table_axis_iterator y;
+};
+
+// Gets the iterators for a table entity, from the table's static type
+struct table_iterators_getter {
+  typedef table_entity_iterators result_t;
+
+  template <typename table_t>
+  result_t visit_table(table_t *pTable, uint8_t, uint16_t, uint16_t) const
+  {
+    return table_entity_iterators { pTable->values.begin(), pTable->axisX.begin(), pTable->axisX.rbegin(), pTable->axisY.begin() };
+  }
+  result_t visit_raw(void *, uint8_t, uint16_t, uint16_t) const
+  {
+    return not_a_table();
+  }
+  result_t visit_end(uint8_t, uint16_t) const
+  {
+    return not_a_table();
+  }
+
+private:
+  static result_t not_a_table(void)
+  {
+    return table_entity_iterators { 
+      table_value_iterator(NULL, 0U),
+      table_axis_iterator(NULL, NULL, axis_domain_Tps), 
+      table_axis_iterator(NULL, NULL, axis_domain_Tps), 
+      table_axis_iterator(NULL, NULL, axis_domain_Tps),
+    };
+  }
+};
+
+// Not inlined: the page mapping is only expanded once for all of the table iterators
+static table_entity_iterators __attribute__((noinline)) get_table_iterators(const page_iterator_t &it)
+{
+  return visit_page_offset(table_iterators_getter(), it.page, it.start);
+}
+
 // ====================================== External functions  ====================================
 
 uint8_t getPageCount(void)
@@ -431,16 +506,14 @@ uint16_t getPageSize(byte pageNum)
 
 void setPageValue(byte pageNum, uint16_t offset, byte value)
 {
-  page_iterator_t entity = map_page_offset_to_entity(pageNum, offset);
-
-  set_value(entity, value, offset);
+  visit_page_offset(page_value_setter{ offset, value }, pageNum, offset);
+  invalidatePageCRC32(pageNum);
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_TUNE);
 }
 
 byte getPageValue(byte pageNum, uint16_t offset)
 {
-  page_iterator_t entity = map_page_offset_to_entity(pageNum, offset);
-
-  return get_value(entity, offset);
+  return visit_page_offset(page_value_getter{ offset }, pageNum, offset);
 }
 
 // Support iteration over a pages entities.
@@ -460,7 +533,7 @@ page_iterator_t advance(const page_iterator_t &it)
  */
 table_value_iterator rows_begin(const page_iterator_t &it)
 {
-  return rows_begin(it.pData, it.table_key);
+  return get_table_iterators(it).rows;
 }
 
 /**
@@ -468,7 +541,7 @@ table_value_iterator rows_begin(const page_iterator_t &it)
  */
 table_axis_iterator x_begin(const page_iterator_t &it)
 {
-  return x_begin(it.pData, it.table_key);
+  return get_table_iterators(it).x;
 }
 
 /**
@@ -476,7 +549,7 @@ table_axis_iterator x_begin(const page_iterator_t &it)
  */
 table_axis_iterator x_rbegin(const page_iterator_t &it)
 {
-  return x_rbegin(it.pData, it.table_key);
+  return get_table_iterators(it).xReverse;
 }
 
 /**
@@ -484,5 +557,5 @@ table_axis_iterator x_rbegin(const page_iterator_t &it)
  */
 table_axis_iterator y_begin(const page_iterator_t &it)
 {
-  return y_begin(it.pData, it.table_key);
+  return get_table_iterators(it).y;
 }
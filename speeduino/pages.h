@@ -9,6 +9,7 @@
  * Page count, as defined in the INI file
  */
 uint8_t getPageCount(void); 
+#define PAGE_COUNT 16U //As returned by getPageCount(), for sizing arrays
 
 /**
  * Page size in bytes
@@ -65,7 +66,6 @@ enum entity_type {
 // A entity on a logical page.
 struct page_iterator_t {
     void *pData;
-    table_type_t table_key;
     uint8_t page;   // The page the entity belongs to
     uint16_t start; // The start position of the entity, in bytes, from the start of the page
     uint16_t size;  // Size of the entity in bytes
@@ -90,13 +90,26 @@ static inline uint32_t calculateIgnitionTimeout(const IgnitionSchedule &schedule
 
 #define MIN_CYCLES_FOR_ENDCOMPARE 6
 
-inline void adjustCrankAngle(IgnitionSchedule &schedule, int endAngle, int crankAngle) 
+/** Retimes the end (spark) of an ignition schedule from a known crank angle.
+ * uSSinceCrankAngle is how long ago the engine was at crankAngle (E.g. the time since the tooth that it was read from).
+ * The spark is never set closer than IGNITION_REFRESH_THRESHOLD, so the compare can't be missed.
+ */
+inline void adjustCrankAngle(IgnitionSchedule &schedule, int endAngle, int crankAngle, uint32_t uSSinceCrankAngle = 0U) 
 {
+  if(schedule.multiSparkNext > 0U) { return; } //Repeat sparks are timed from the primary spark, not the crank angle
+
+  uint32_t uSToEnd = angleToTimeMicroSecPerDegree( ignitionLimits( (endAngle - crankAngle) ) );
+  if( uSToEnd > (uSSinceCrankAngle + IGNITION_REFRESH_THRESHOLD) ) { uSToEnd = uSToEnd - uSSinceCrankAngle; }
+  else { uSToEnd = IGNITION_REFRESH_THRESHOLD; }
+
   if( (schedule.Status == RUNNING) ) { 
-    SET_COMPARE(schedule.compare, schedule.counter + uS_TO_TIMER_COMPARE( angleToTimeMicroSecPerDegree( ignitionLimits( (endAngle - crankAngle) ) ) ) ); 
+    //Recorded as an ISR event so that the main loop doesn't put its own compare back over this one
+    schedule.armedCompare = schedule.counter + uS_TO_TIMER_COMPARE( uSToEnd );
+    SET_COMPARE(schedule.compare, schedule.armedCompare); 
+    schedule.isrEvents = schedule.isrEvents + 1U;
   }
   else if(currentStatus.startRevolutions > MIN_CYCLES_FOR_ENDCOMPARE) { 
-    schedule.endCompare = schedule.counter + uS_TO_TIMER_COMPARE( angleToTimeMicroSecPerDegree( ignitionLimits( (endAngle - crankAngle) ) ) ); 
+    schedule.endCompare = schedule.counter + uS_TO_TIMER_COMPARE( uSToEnd ); 
     schedule.endScheduleSetByDecoder = true; 
   }
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+/** \file schedule_queue.cpp
+ * @brief Fuel and ignition schedules multiplexed onto a single timer compare channel. See schedule_queue.h
+ */
+#include "globals.h"
+#include "schedule_queue.h"
+
+#if defined(USE_SCHEDULE_QUEUE)
+#include <SimplyAtomic.h>
+#include "timers.h"
+
+//Due times must hold a full timer period, which does not fit in 32 bits when the timer itself is 32-bit
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+typedef uint64_t queue_ticks_t;
+#else
+typedef uint32_t queue_ticks_t;
+#endif
+
+#define SCHEDULE_QUEUE_FULL_PERIOD  ((queue_ticks_t)((COMPARE_TYPE)~(COMPARE_TYPE)0U) + 1U) //Ticks until a compare that has just fired matches again
+#define SCHEDULE_QUEUE_MAX_WAIT     (SCHEDULE_QUEUE_FULL_PERIOD / 2U) //The longest the compare is left before the queue is serviced
+
+queued_compare_t scheduleQueueCompare[SCHEDULE_QUEUE_SLOTS];
+
+static volatile COMPARE_TYPE slotCompare[SCHEDULE_QUEUE_SLOTS]; //The value written to each slot's compare
+static queue_ticks_t slotDue[SCHEDULE_QUEUE_SLOTS]; //Ticks from queueReference until each queued slot is due
+static volatile uint32_t enabledSlots = 0U; //Bit n is set if slot n is enabled
+
+static uint8_t queue[SCHEDULE_QUEUE_SLOTS]; //The enabled slots, soonest first
+static uint8_t queueLength = 0U;
+static COUNTER_TYPE queueReference; //Counter value that slotDue[] is relative to
+
+static scheduleQueueHandler_t queueHandler = nullptr;
+
+static inline queue_ticks_t ticksSinceReference(void)
+{
+  return (COMPARE_TYPE)(SCHEDULE_QUEUE_COUNTER - queueReference);
+}
+
+static void queueRemove(uint8_t slot)
+{
+  for (uint8_t x = 0U; x < queueLength; ++x)
+  {
+    if (queue[x] == slot)
+    {
+      --queueLength;
+      for (; x < queueLength; ++x) { queue[x] = queue[x + 1U]; }
+      return;
+    }
+  }
+}
+
+static void queueInsert(uint8_t slot)
+{
+  if (queueLength == 0U) { queueReference = SCHEDULE_QUEUE_COUNTER; }
+
+  //As with a hardware compare, a compare equal to the counter matches a full period from now
+  queue_ticks_t ticksToCompare = (COMPARE_TYPE)(slotCompare[slot] - SCHEDULE_QUEUE_COUNTER);
+  if (ticksToCompare == 0U) { ticksToCompare = SCHEDULE_QUEUE_FULL_PERIOD; }
+  slotDue[slot] = ticksSinceReference() + ticksToCompare;
+
+  uint8_t position = queueLength;
+  while ( (position > 0U) && (slotDue[queue[position - 1U]] > slotDue[slot]) )
+  {
+    queue[position] = queue[position - 1U];
+    --position;
+  }
+  queue[position] = slot;
+  ++queueLength;
+}
+
+/** Loads the hardware compare with the head of the queue, or switches the timer off if the queue is empty */
+static void queueArm(void)
+{
+  if (queueLength == 0U)
+  {
+    SCHEDULE_QUEUE_TIMER_DISABLE();
+    return;
+  }
+
+  queue_ticks_t next = min(slotDue[queue[0]], (queue_ticks_t)SCHEDULE_QUEUE_MAX_WAIT);
+  if (next <= ticksSinceReference())
+  {
+    //Already due (E.g. the compare was set to a time that has passed). Fire as soon as possible
+    SET_COMPARE(SCHEDULE_QUEUE_COMPARE, SCHEDULE_QUEUE_COUNTER + 1U);
+  }
+  else
+  {
+    SET_COMPARE(SCHEDULE_QUEUE_COMPARE, queueReference + next);
+  }
+  SCHEDULE_QUEUE_TIMER_ENABLE();
+}
+
+static inline bool isQueued(uint8_t slot)
+{
+  for (uint8_t x = 0U; x < queueLength; ++x)
+  {
+    if (queue[x] == slot) { return true; }
+  }
+  return false;
+}
+
+void initialiseScheduleQueue(scheduleQueueHandler_t handler)
+{
+  ATOMIC()
+  {
+    queueHandler = handler;
+    queueLength = 0U;
+    enabledSlots = 0U;
+    for (uint8_t slot = 0U; slot < SCHEDULE_QUEUE_SLOTS; ++slot)
+    {
+      scheduleQueueCompare[slot].slot = slot;
+      slotCompare[slot] = 0U;
+    }
+    SCHEDULE_QUEUE_TIMER_DISABLE();
+  }
+}
+
+void scheduleQueueSetCompare(uint8_t slot, COMPARE_TYPE compare)
+{
+  ATOMIC()
+  {
+    slotCompare[slot] = compare;
+    if (BIT_CHECK(enabledSlots, slot))
+    {
+      queueRemove(slot);
+      queueInsert(slot);
+      queueArm();
+    }
+  }
+}
+
+COMPARE_TYPE scheduleQueueGetCompare(uint8_t slot)
+{
+  return slotCompare[slot];
+}
+
+void scheduleQueueEnable(uint8_t slot)
+{
+  ATOMIC()
+  {
+    if (!BIT_CHECK(enabledSlots, slot))
+    {
+      BIT_SET(enabledSlots, slot);
+      queueInsert(slot);
+      queueArm();
+    }
+  }
+}
+
+void scheduleQueueDisable(uint8_t slot)
+{
+  ATOMIC()
+  {
+    if (BIT_CHECK(enabledSlots, slot))
+    {
+      BIT_CLEAR(enabledSlots, slot);
+      queueRemove(slot);
+      queueArm();
+    }
+  }
+}
+
+void scheduleQueueInterrupt(void)
+{
+  queue_ticks_t elapsed = ticksSinceReference();
+
+  //Take everything that is due off the front of the queue
+  uint8_t dueSlots[SCHEDULE_QUEUE_SLOTS];
+  uint8_t dueCount = 0U;
+  while ( (queueLength > 0U) && (slotDue[queue[0]] <= elapsed) )
+  {
+    dueSlots[dueCount] = queue[0];
+    ++dueCount;
+    queueRemove(queue[0]);
+  }
+
+  //Move the reference up to now so that the due times stay well away from wrapping
+  for (uint8_t x = 0U; x < queueLength; ++x) { slotDue[queue[x]] = slotDue[queue[x]] - elapsed; }
+  queueReference = queueReference + elapsed;
+
+  //Run the due slots, soonest first. The handlers will usually set a new compare or disable their slot
+  for (uint8_t x = 0U; x < dueCount; ++x)
+  {
+    uint8_t slot = dueSlots[x];
+    queueHandler(slot);
+    if (BIT_CHECK(enabledSlots, slot) && !isQueued(slot)) { queueInsert(slot); }
+  }
+
+  queueArm();
+}
+
+#endif //USE_SCHEDULE_QUEUE
@@ -0,0 +1,77 @@
+/** \file schedule_queue.h
+ * @brief Fuel and ignition schedules multiplexed onto a single timer compare channel
+ *
+ * By default every fuel and ignition schedule owns a hardware compare channel (FUEL1_COMPARE...IGN8_COMPARE), so the
+ * number of channels is limited to what the timers provide. When USE_SCHEDULE_QUEUE is defined, each schedule is
+ * instead given a slot in a queue that is sorted by due time. Only the queue's head is loaded into the hardware
+ * compare (SCHEDULE_QUEUE_COMPARE), and its interrupt runs every schedule that has fallen due before re-arming the
+ * compare for the next one.
+ *
+ * The schedules still see a compare register and an enable/disable pair, so setFuelSchedule(), setIgnitionSchedule()
+ * and the schedule ISRs are unchanged:
+ * - Writing a slot's compare (queued_compare_t) moves the slot within the queue if it is enabled
+ * - Enabling a slot adds it to the queue, disabling it removes it
+ * - A slot whose compare is not changed by its handler fires again a full timer period later, as a hardware
+ *   compare channel would
+ *
+ * Due times are held relative to the last time the queue was serviced. The compare is never left more than half a
+ * timer period in the future so that those relative times cannot wrap, at the cost of an occasional empty interrupt
+ * when nothing is due for a long time.
+ *
+ * The board must provide SCHEDULE_QUEUE_COUNTER, SCHEDULE_QUEUE_COMPARE, SCHEDULE_QUEUE_TIMER_ENABLE() and
+ * SCHEDULE_QUEUE_TIMER_DISABLE(), and call scheduleQueueInterrupt() from the compare interrupt. Only the native board
+ * and the 32-bit schedule timer of Teensy 4.1 and STM32F4 (USE_SCHEDULE_TIMER_32BIT, which turns the queue on) do so.
+ * Other boards, including the M451, keep a compare channel per schedule.
+ */
+#ifndef SCHEDULE_QUEUE_H
+#define SCHEDULE_QUEUE_H
+
+#include "globals.h"
+
+#if defined(USE_SCHEDULE_QUEUE)
+
+#if !defined(SCHEDULE_QUEUE_COMPARE)
+  #error "USE_SCHEDULE_QUEUE is only supported by the native board, and by Teensy 4.1 and STM32F4 with USE_SCHEDULE_TIMER_32BIT"
+#endif
+
+#define SCHEDULE_QUEUE_IGN_SLOTS  ((IGN_CHANNELS < 5) ? 5 : IGN_CHANNELS) //Ignition schedules 1-5 always exist
+#define SCHEDULE_QUEUE_SLOTS  (INJ_CHANNELS + SCHEDULE_QUEUE_IGN_SLOTS) //Fuel schedules use slots 0 to INJ_CHANNELS-1, ignition the rest
+#define FUEL_QUEUE_SLOT(channel)  ((channel) - 1U) ///< Queue slot of fuel schedule 1...INJ_CHANNELS
+#define IGN_QUEUE_SLOT(channel)   (INJ_CHANNELS + (channel) - 1U) ///< Queue slot of ignition schedule 1...IGN_CHANNELS
+
+static_assert(SCHEDULE_QUEUE_SLOTS <= 32U, "The queue tracks enabled slots in a 32 bit mask");
+
+/** @brief Called with the slot number when a slot falls due */
+typedef void (*scheduleQueueHandler_t)(uint8_t slot);
+
+/** @brief Clears the queue and sets the function that runs the slots. Also disables the queue timer */
+void initialiseScheduleQueue(scheduleQueueHandler_t handler);
+
+void scheduleQueueSetCompare(uint8_t slot, COMPARE_TYPE compare);
+COMPARE_TYPE scheduleQueueGetCompare(uint8_t slot);
+void scheduleQueueEnable(uint8_t slot);
+void scheduleQueueDisable(uint8_t slot);
+
+/** @brief Must be called by the board from the SCHEDULE_QUEUE_COMPARE interrupt */
+void scheduleQueueInterrupt(void);
+
+/** @brief A slot's compare register, as seen by a schedule. Used in place of a hardware compare register (See SET_COMPARE()) */
+class queued_compare_t {
+public:
+  queued_compare_t &operator=(COMPARE_TYPE value) { scheduleQueueSetCompare(slot, value); return *this; }
+  operator COMPARE_TYPE() const { return scheduleQueueGetCompare(slot); }
+
+  queued_compare_t &operator=(const queued_compare_t &) = delete; //Would copy the slot number, not the compare value
+
+  uint8_t slot;
+};
+
+extern queued_compare_t scheduleQueueCompare[SCHEDULE_QUEUE_SLOTS];
+
+/** @brief Timer enable/disable functions for a slot, in the form expected by the schedules */
+template <uint8_t slot> void scheduleQueueSlotEnable(void) { scheduleQueueEnable(slot); }
+template <uint8_t slot> void scheduleQueueSlotDisable(void) { scheduleQueueDisable(slot); }
+
+#endif //USE_SCHEDULE_QUEUE
+
+#endif // SCHEDULE_QUEUE_H
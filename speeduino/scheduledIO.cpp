@@ -8,126 +8,201 @@
 /** @file
  * Injector and Coil (toggle/open/close) control (under various situations, eg with particular cylinder count, rotary engine type or wasted spark ign, etc.).
  * Also accounts for presence of MC33810 injector/ignition (dwell, etc.) control circuit.
+ * The driver for each output (See @ref outputChannel_t) is selected once by initialiseOutputDrivers().
  * Functions here are typically assigned (at initialisation) to callback function variables (e.g. inj1StartFunction or inj1EndFunction) 
  * form where they are called (by scheduler.ino).
  */
-void openInjector1(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector1_DIRECT(); }   else { openInjector1_MC33810(); } }
-void closeInjector1(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector1_DIRECT(); }  else { closeInjector1_MC33810(); } }
-void openInjector2(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector2_DIRECT(); }   else { openInjector2_MC33810(); } }
-void closeInjector2(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector2_DIRECT(); }  else { closeInjector2_MC33810(); } }
-void openInjector3(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector3_DIRECT(); }   else { openInjector3_MC33810(); } }
-void closeInjector3(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector3_DIRECT(); }  else { closeInjector3_MC33810(); } }
-void openInjector4(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector4_DIRECT(); }   else { openInjector4_MC33810(); } }
-void closeInjector4(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector4_DIRECT(); }  else { closeInjector4_MC33810(); } }
-void openInjector5(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector5_DIRECT(); }   else { openInjector5_MC33810(); } }
-void closeInjector5(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector5_DIRECT(); }  else { closeInjector5_MC33810(); } }
-void openInjector6(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector6_DIRECT(); }   else { openInjector6_MC33810(); } }
-void closeInjector6(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector6_DIRECT(); }  else { closeInjector6_MC33810(); } }
-void openInjector7(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector7_DIRECT(); }   else { openInjector7_MC33810(); } }
-void closeInjector7(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector7_DIRECT(); }  else { closeInjector7_MC33810(); } }
-void openInjector8(void)   { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { openInjector8_DIRECT(); }   else { openInjector8_MC33810(); } }
-void closeInjector8(void)  { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { closeInjector8_DIRECT(); }  else { closeInjector8_MC33810(); } }
-
-void injector1Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector1Toggle_DIRECT(); } else { injector1Toggle_MC33810(); } }
-void injector2Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector2Toggle_DIRECT(); } else { injector2Toggle_MC33810(); } }
-void injector3Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector3Toggle_DIRECT(); } else { injector3Toggle_MC33810(); } }
-void injector4Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector4Toggle_DIRECT(); } else { injector4Toggle_MC33810(); } }
-void injector5Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector5Toggle_DIRECT(); } else { injector5Toggle_MC33810(); } }
-void injector6Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector6Toggle_DIRECT(); } else { injector6Toggle_MC33810(); } }
-void injector7Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector7Toggle_DIRECT(); } else { injector7Toggle_MC33810(); } }
-void injector8Toggle(void) { if(injectorOutputControl != OUTPUT_CONTROL_MC33810) { injector8Toggle_DIRECT(); } else { injector8Toggle_MC33810(); } }
-
-void coil1Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil1Toggle_DIRECT(); } else { coil1Toggle_MC33810(); } }
-void coil2Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil2Toggle_DIRECT(); } else { coil2Toggle_MC33810(); } }
-void coil3Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil3Toggle_DIRECT(); } else { coil3Toggle_MC33810(); } }
-void coil4Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil4Toggle_DIRECT(); } else { coil4Toggle_MC33810(); } }
-void coil5Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil5Toggle_DIRECT(); } else { coil5Toggle_MC33810(); } }
-void coil6Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil6Toggle_DIRECT(); } else { coil6Toggle_MC33810(); } }
-void coil7Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil7Toggle_DIRECT(); } else { coil7Toggle_MC33810(); } }
-void coil8Toggle(void)     { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil8Toggle_DIRECT(); } else { coil8Toggle_MC33810(); } }
-
-// These are for Semi-Sequential and 5 Cylinder injection
-//Standard 4 cylinder pairings
-void openInjector1and3(void) { openInjector1(); openInjector3(); }
-void closeInjector1and3(void) { closeInjector1(); closeInjector3(); }
-void openInjector2and4(void) { openInjector2(); openInjector4(); }
-void closeInjector2and4(void) { closeInjector2(); closeInjector4(); }
-//Alternative output pairings
-void openInjector1and4(void) { openInjector1(); openInjector4(); }
-void closeInjector1and4(void) { closeInjector1(); closeInjector4(); }
-void openInjector2and3(void) { openInjector2(); openInjector3(); }
-void closeInjector2and3(void) { closeInjector2(); closeInjector3(); }
-
-void openInjector3and5(void) { openInjector3(); openInjector5(); }
-void closeInjector3and5(void) { closeInjector3(); closeInjector5(); }
-
-void openInjector2and5(void) { openInjector2(); openInjector5(); }
-void closeInjector2and5(void) { closeInjector2(); closeInjector5(); }
-void openInjector3and6(void) { openInjector3(); openInjector6(); }
-void closeInjector3and6(void) { closeInjector3(); closeInjector6(); }
-
-void openInjector1and5(void) { openInjector1(); openInjector5(); }
-void closeInjector1and5(void) { closeInjector1(); closeInjector5(); }
-void openInjector2and6(void) { openInjector2(); openInjector6(); }
-void closeInjector2and6(void) { closeInjector2(); closeInjector6(); }
-void openInjector3and7(void) { openInjector3(); openInjector7(); }
-void closeInjector3and7(void) { closeInjector3(); closeInjector7(); }
-void openInjector4and8(void) { openInjector4(); openInjector8(); }
-void closeInjector4and8(void) { closeInjector4(); closeInjector8(); }
-
-void beginCoil1Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil1Charging_DIRECT(); } else { coil1Charging_MC33810(); } tachoOutputOn(); }
-void endCoil1Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil1StopCharging_DIRECT(); } else { coil1StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil2Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil2Charging_DIRECT(); } else { coil2Charging_MC33810(); } tachoOutputOn(); }
-void endCoil2Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil2StopCharging_DIRECT(); } else { coil2StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil3Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil3Charging_DIRECT(); } else { coil3Charging_MC33810(); } tachoOutputOn(); }
-void endCoil3Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil3StopCharging_DIRECT(); } else { coil3StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil4Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil4Charging_DIRECT(); } else { coil4Charging_MC33810(); } tachoOutputOn(); }
-void endCoil4Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil4StopCharging_DIRECT(); } else { coil4StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil5Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil5Charging_DIRECT(); } else { coil5Charging_MC33810(); } tachoOutputOn(); }
-void endCoil5Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil5StopCharging_DIRECT(); } else { coil5StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil6Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil6Charging_DIRECT(); } else { coil6Charging_MC33810(); } tachoOutputOn(); }
-void endCoil6Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil6StopCharging_DIRECT(); } else { coil6StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil7Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil7Charging_DIRECT(); } else { coil7Charging_MC33810(); } tachoOutputOn(); }
-void endCoil7Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil7StopCharging_DIRECT(); } else { coil7StopCharging_MC33810(); } tachoOutputOff(); }
-
-void beginCoil8Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil8Charging_DIRECT(); } else { coil8Charging_MC33810(); } tachoOutputOn(); }
-void endCoil8Charge(void) { if(ignitionOutputControl != OUTPUT_CONTROL_MC33810) { coil8StopCharging_DIRECT(); } else { coil8StopCharging_MC33810(); } tachoOutputOff(); }
+outputChannel_t injectorOutputs[OUTPUT_CHANNELS];
+outputChannel_t coilOutputs[OUTPUT_CHANNELS];
+
+//Drivers for the injector and coil outputs. Each is instantiated for outputs 1-8, so an output's driver only does the write for that output
+template <uint8_t output> static void openInjectorDirect(void)
+{
+  *injectorOutputs[output - 1U].port |= injectorOutputs[output - 1U].mask;
+  if(output <= 4U) { BIT_SET(currentStatus.status1, BIT_STATUS1_INJ1 + (output - 1U)); }
+}
+template <uint8_t output> static void closeInjectorDirect(void)
+{
+  *injectorOutputs[output - 1U].port &= ~(injectorOutputs[output - 1U].mask);
+  if(output <= 4U) { BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ1 + (output - 1U)); }
+}
+template <uint8_t output> static void injectorToggleDirect(void) { *injectorOutputs[output - 1U].port ^= injectorOutputs[output - 1U].mask; }
+
+template <uint8_t output> static inline void coilLowDirect(void)  { *coilOutputs[output - 1U].port &= ~(coilOutputs[output - 1U].mask); }
+template <uint8_t output> static inline void coilHighDirect(void) { *coilOutputs[output - 1U].port |= coilOutputs[output - 1U].mask; }
+template <uint8_t output> static void beginCoilChargeDirect(void)
+{
+  if(configPage4.IgInv == GOING_HIGH) { coilLowDirect<output>(); } else { coilHighDirect<output>(); }
+  tachoOutputOn();
+}
+template <uint8_t output> static void endCoilChargeDirect(void)
+{
+  if(configPage4.IgInv == GOING_HIGH) { coilHighDirect<output>(); } else { coilLowDirect<output>(); }
+  tachoOutputOff();
+}
+template <uint8_t output> static void coilToggleDirect(void) { *coilOutputs[output - 1U].port ^= coilOutputs[output - 1U].mask; }
+
+//The MC33810 output bits can be changed by the board setup, so they are read each time
+static uint8_t * const mc33810InjectorBits[OUTPUT_CHANNELS] = { &MC33810_BIT_INJ1, &MC33810_BIT_INJ2, &MC33810_BIT_INJ3, &MC33810_BIT_INJ4, &MC33810_BIT_INJ5, &MC33810_BIT_INJ6, &MC33810_BIT_INJ7, &MC33810_BIT_INJ8 };
+static uint8_t * const mc33810CoilBits[OUTPUT_CHANNELS] = { &MC33810_BIT_IGN1, &MC33810_BIT_IGN2, &MC33810_BIT_IGN3, &MC33810_BIT_IGN4, &MC33810_BIT_IGN5, &MC33810_BIT_IGN6, &MC33810_BIT_IGN7, &MC33810_BIT_IGN8 };
+
+template <uint8_t output> static void openInjectorMC33810(void)   { writeMC33810(output, *mc33810InjectorBits[output - 1U], MC33810_OUTPUT_ON); }
+template <uint8_t output> static void closeInjectorMC33810(void)  { writeMC33810(output, *mc33810InjectorBits[output - 1U], MC33810_OUTPUT_OFF); }
+template <uint8_t output> static void injectorToggleMC33810(void) { writeMC33810(output, *mc33810InjectorBits[output - 1U], MC33810_OUTPUT_TOGGLE); }
+
+template <uint8_t output> static void beginCoilChargeMC33810(void)
+{
+  writeMC33810(output, *mc33810CoilBits[output - 1U], (configPage4.IgInv == GOING_HIGH) ? MC33810_OUTPUT_OFF : MC33810_OUTPUT_ON);
+  tachoOutputOn();
+}
+template <uint8_t output> static void endCoilChargeMC33810(void)
+{
+  writeMC33810(output, *mc33810CoilBits[output - 1U], (configPage4.IgInv == GOING_HIGH) ? MC33810_OUTPUT_ON : MC33810_OUTPUT_OFF);
+  tachoOutputOff();
+}
+template <uint8_t output> static void coilToggleMC33810(void) { writeMC33810(output, *mc33810CoilBits[output - 1U], MC33810_OUTPUT_TOGGLE); }
+
+#define OUTPUT_DRIVERS(on, off, toggle) { \
+  { on<1>, off<1>, toggle<1> }, { on<2>, off<2>, toggle<2> }, { on<3>, off<3>, toggle<3> }, { on<4>, off<4>, toggle<4> }, \
+  { on<5>, off<5>, toggle<5> }, { on<6>, off<6>, toggle<6> }, { on<7>, off<7>, toggle<7> }, { on<8>, off<8>, toggle<8> } }
+
+//These are only read by initialiseOutputDrivers(), so they are kept in flash and copied out of it
+static const outputDriver_t injectorDirectDrivers[OUTPUT_CHANNELS] PROGMEM = OUTPUT_DRIVERS(openInjectorDirect, closeInjectorDirect, injectorToggleDirect);
+static const outputDriver_t injectorMC33810Drivers[OUTPUT_CHANNELS] PROGMEM = OUTPUT_DRIVERS(openInjectorMC33810, closeInjectorMC33810, injectorToggleMC33810);
+static const outputDriver_t coilDirectDrivers[OUTPUT_CHANNELS] PROGMEM = OUTPUT_DRIVERS(beginCoilChargeDirect, endCoilChargeDirect, coilToggleDirect);
+static const outputDriver_t coilMC33810Drivers[OUTPUT_CHANNELS] PROGMEM = OUTPUT_DRIVERS(beginCoilChargeMC33810, endCoilChargeMC33810, coilToggleMC33810);
+
+outputPairChannel_t injectorPairs[OUTPUT_PAIRS];
+outputPairChannel_t coilPairs[OUTPUT_PAIRS];
+
+//The outputs in each pair, in the order of outputPair_t
+static const uint8_t pairOutputs[OUTPUT_PAIRS][2] = { {1, 3}, {2, 4}, {1, 4}, {2, 3}, {3, 5}, {2, 5}, {3, 6}, {1, 5}, {2, 6}, {3, 7}, {4, 8} };
+
+//Drivers for the output pairs. The pair is a template parameter, so its outputs (And so which status bits and MC33810 ICs are used) are known at compile time
+template <uint8_t pair> static inline uint8_t injectorPairStatusBits(void)
+{
+  uint8_t bits = 0U;
+  if(pairOutputs[pair][0] <= 4U) { BIT_SET(bits, BIT_STATUS1_INJ1 + (pairOutputs[pair][0] - 1U)); }
+  if(pairOutputs[pair][1] <= 4U) { BIT_SET(bits, BIT_STATUS1_INJ1 + (pairOutputs[pair][1] - 1U)); }
+  return bits;
+}
+
+template <uint8_t pair, bool twoPorts> static inline void setPairDirect(outputPairChannel_t &outputs)
+{
+  *outputs.port |= outputs.mask;
+  if(twoPorts) { *outputs.port2 |= outputs.mask2; }
+}
+template <uint8_t pair, bool twoPorts> static inline void clearPairDirect(outputPairChannel_t &outputs)
+{
+  *outputs.port &= ~(outputs.mask);
+  if(twoPorts) { *outputs.port2 &= ~(outputs.mask2); }
+}
+
+template <uint8_t pair> static void openInjectorPairDirect(void)   { setPairDirect<pair, false>(injectorPairs[pair]); currentStatus.status1 |= injectorPairStatusBits<pair>(); }
+template <uint8_t pair> static void closeInjectorPairDirect(void)  { clearPairDirect<pair, false>(injectorPairs[pair]); currentStatus.status1 &= ~injectorPairStatusBits<pair>(); }
+template <uint8_t pair> static void openInjectorPairDirect2(void)  { setPairDirect<pair, true>(injectorPairs[pair]); currentStatus.status1 |= injectorPairStatusBits<pair>(); }
+template <uint8_t pair> static void closeInjectorPairDirect2(void) { clearPairDirect<pair, true>(injectorPairs[pair]); currentStatus.status1 &= ~injectorPairStatusBits<pair>(); }
+
+template <uint8_t pair, bool twoPorts> static inline void beginCoilPairChargeDirect(void)
+{
+  if(configPage4.IgInv == GOING_HIGH) { clearPairDirect<pair, twoPorts>(coilPairs[pair]); } else { setPairDirect<pair, twoPorts>(coilPairs[pair]); }
+  tachoOutputOn();
+}
+template <uint8_t pair, bool twoPorts> static inline void endCoilPairChargeDirect(void)
+{
+  if(configPage4.IgInv == GOING_HIGH) { setPairDirect<pair, twoPorts>(coilPairs[pair]); } else { clearPairDirect<pair, twoPorts>(coilPairs[pair]); }
+  tachoOutputOff();
+}
+template <uint8_t pair> static void beginCoilPairDirect(void)  { beginCoilPairChargeDirect<pair, false>(); }
+template <uint8_t pair> static void endCoilPairDirect(void)    { endCoilPairChargeDirect<pair, false>(); }
+template <uint8_t pair> static void beginCoilPairDirect2(void) { beginCoilPairChargeDirect<pair, true>(); }
+template <uint8_t pair> static void endCoilPairDirect2(void)   { endCoilPairChargeDirect<pair, true>(); }
+
+//One SPI command for each IC that the pair is on. The bits are read from the same MC33810_BIT_* values as the single outputs
+template <uint8_t pair> static inline void writePairMC33810(uint8_t * const *outputBits, uint8_t action)
+{
+  uint8_t icBits[2] = { 0U, 0U };
+  for(uint8_t member = 0U; member < 2U; member++)
+  {
+    uint8_t output = pairOutputs[pair][member];
+    BIT_SET(icBits[(output <= 4U) ? 0U : 1U], *outputBits[output - 1U]);
+  }
+  if( (pairOutputs[pair][0] <= 4U) || (pairOutputs[pair][1] <= 4U) ) { writeMC33810Bits(1U, icBits[0], action); }
+  if( (pairOutputs[pair][0] > 4U) || (pairOutputs[pair][1] > 4U) ) { writeMC33810Bits(2U, icBits[1], action); }
+}
+template <uint8_t pair> static void openInjectorPairMC33810(void)  { writePairMC33810<pair>(mc33810InjectorBits, MC33810_OUTPUT_ON); }
+template <uint8_t pair> static void closeInjectorPairMC33810(void) { writePairMC33810<pair>(mc33810InjectorBits, MC33810_OUTPUT_OFF); }
+template <uint8_t pair> static void beginCoilPairMC33810(void)
+{
+  writePairMC33810<pair>(mc33810CoilBits, (configPage4.IgInv == GOING_HIGH) ? MC33810_OUTPUT_OFF : MC33810_OUTPUT_ON);
+  tachoOutputOn();
+}
+template <uint8_t pair> static void endCoilPairMC33810(void)
+{
+  writePairMC33810<pair>(mc33810CoilBits, (configPage4.IgInv == GOING_HIGH) ? MC33810_OUTPUT_ON : MC33810_OUTPUT_OFF);
+  tachoOutputOff();
+}
+
+#define PAIR_DRIVERS(on, off) { \
+  { on<OUTPUTS_1_3>, off<OUTPUTS_1_3> }, { on<OUTPUTS_2_4>, off<OUTPUTS_2_4> }, { on<OUTPUTS_1_4>, off<OUTPUTS_1_4> }, { on<OUTPUTS_2_3>, off<OUTPUTS_2_3> }, \
+  { on<OUTPUTS_3_5>, off<OUTPUTS_3_5> }, { on<OUTPUTS_2_5>, off<OUTPUTS_2_5> }, { on<OUTPUTS_3_6>, off<OUTPUTS_3_6> }, { on<OUTPUTS_1_5>, off<OUTPUTS_1_5> }, \
+  { on<OUTPUTS_2_6>, off<OUTPUTS_2_6> }, { on<OUTPUTS_3_7>, off<OUTPUTS_3_7> }, { on<OUTPUTS_4_8>, off<OUTPUTS_4_8> } }
+
+//As with the single output drivers, these are only read at initialisation so are kept in flash
+static const outputPairDriver_t injectorPairDirectDrivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(openInjectorPairDirect, closeInjectorPairDirect);
+static const outputPairDriver_t injectorPairDirect2Drivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(openInjectorPairDirect2, closeInjectorPairDirect2);
+static const outputPairDriver_t injectorPairMC33810Drivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(openInjectorPairMC33810, closeInjectorPairMC33810);
+static const outputPairDriver_t coilPairDirectDrivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(beginCoilPairDirect, endCoilPairDirect);
+static const outputPairDriver_t coilPairDirect2Drivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(beginCoilPairDirect2, endCoilPairDirect2);
+static const outputPairDriver_t coilPairMC33810Drivers[OUTPUT_PAIRS] PROGMEM = PAIR_DRIVERS(beginCoilPairMC33810, endCoilPairMC33810);
+
+/** Works out the single writes that switch a pair of outputs, and selects the driver for them */
+static void initialiseOutputPair(outputPairChannel_t &outputs, const outputChannel_t *pins, uint8_t pair, bool mc33810,
+                                 const outputPairDriver_t *directDrivers, const outputPairDriver_t *direct2Drivers, const outputPairDriver_t *mc33810Drivers)
+{
+  const outputChannel_t &first = pins[pairOutputs[pair][0] - 1U];
+  const outputChannel_t &second = pins[pairOutputs[pair][1] - 1U];
+
+  outputs.port = first.port;
+  outputs.mask = first.mask;
+  outputs.port2 = second.port;
+  outputs.mask2 = second.mask;
+
+  const outputPairDriver_t *drivers = direct2Drivers;
+  if(mc33810) { drivers = mc33810Drivers; }
+  else if(first.port == second.port)
+  {
+    //Both pins are on one port, so they can be switched by one write
+    outputs.mask = first.mask | second.mask;
+    drivers = directDrivers;
+  }
+  memcpy_P(&outputs.driver, &drivers[pair], sizeof(outputPairDriver_t));
+}
+
+void initialiseOutputDrivers(void)
+{
+  const outputDriver_t *injectorDrivers = (injectorOutputControl == OUTPUT_CONTROL_MC33810) ? injectorMC33810Drivers : injectorDirectDrivers;
+  const outputDriver_t *coilDrivers = (ignitionOutputControl == OUTPUT_CONTROL_MC33810) ? coilMC33810Drivers : coilDirectDrivers;
+  for(uint8_t output = 0U; output < OUTPUT_CHANNELS; output++)
+  {
+    memcpy_P(&injectorOutputs[output].driver, &injectorDrivers[output], sizeof(outputDriver_t));
+    memcpy_P(&coilOutputs[output].driver, &coilDrivers[output], sizeof(outputDriver_t));
+  }
+
+  for(uint8_t pair = 0U; pair < OUTPUT_PAIRS; pair++)
+  {
+    initialiseOutputPair(injectorPairs[pair], injectorOutputs, pair, (injectorOutputControl == OUTPUT_CONTROL_MC33810),
+                         injectorPairDirectDrivers, injectorPairDirect2Drivers, injectorPairMC33810Drivers);
+    initialiseOutputPair(coilPairs[pair], coilOutputs, pair, (ignitionOutputControl == OUTPUT_CONTROL_MC33810),
+                         coilPairDirectDrivers, coilPairDirect2Drivers, coilPairMC33810Drivers);
+  }
+}
 
 //The below 3 calls are all part of the rotary ignition mode
 void beginTrailingCoilCharge(void) { beginCoil2Charge(); }
 void endTrailingCoilCharge1(void) { endCoil2Charge(); beginCoil3Charge(); } //Sets ign3 (Trailing select) high
 void endTrailingCoilCharge2(void) { endCoil2Charge(); endCoil3Charge(); } //sets ign3 (Trailing select) low
 
-//As above but for ignition (Wasted COP mode)
-void beginCoil1and3Charge(void) { beginCoil1Charge(); beginCoil3Charge(); }
-void endCoil1and3Charge(void)   { endCoil1Charge();  endCoil3Charge(); }
-void beginCoil2and4Charge(void) { beginCoil2Charge(); beginCoil4Charge(); }
-void endCoil2and4Charge(void)   { endCoil2Charge();  endCoil4Charge(); }
-
-//For 6cyl wasted COP mode)
-void beginCoil1and4Charge(void) { beginCoil1Charge(); beginCoil4Charge(); }
-void endCoil1and4Charge(void)   { endCoil1Charge();  endCoil4Charge(); }
-void beginCoil2and5Charge(void) { beginCoil2Charge(); beginCoil5Charge(); }
-void endCoil2and5Charge(void)   { endCoil2Charge();  endCoil5Charge(); }
-void beginCoil3and6Charge(void) { beginCoil3Charge(); beginCoil6Charge(); }
-void endCoil3and6Charge(void)   { endCoil3Charge(); endCoil6Charge(); }
-
-//For 8cyl wasted COP mode)
-void beginCoil1and5Charge(void) { beginCoil1Charge(); beginCoil5Charge(); }
-void endCoil1and5Charge(void)   { endCoil1Charge();  endCoil5Charge(); }
-void beginCoil2and6Charge(void) { beginCoil2Charge(); beginCoil6Charge(); }
-void endCoil2and6Charge(void)   { endCoil2Charge();  endCoil6Charge(); }
-void beginCoil3and7Charge(void) { beginCoil3Charge(); beginCoil7Charge();  }
-void endCoil3and7Charge(void)   { endCoil3Charge(); endCoil7Charge(); }
-void beginCoil4and8Charge(void) { beginCoil4Charge(); beginCoil8Charge(); }
-void endCoil4and8Charge(void)   { endCoil4Charge();  endCoil8Charge(); }
-
 void tachoOutputOn(void) { if(configPage6.tachoMode) { TACHO_PULSE_LOW(); } else { tachoOutputFlag = READY; } }
 void tachoOutputOff(void) { if(configPage6.tachoMode) { TACHO_PULSE_HIGH(); } }
 
@@ -2,273 +2,166 @@
 #define SCHEDULEDIO_H
 
 #include <Arduino.h>
+#include "globals.h"
 
-void openInjector1(void);
-void closeInjector1(void);
-
-void openInjector2(void);
-void closeInjector2(void);
-
-void openInjector3(void);
-void closeInjector3(void);
-
-void openInjector4(void);
-void closeInjector4(void);
-
-void openInjector5(void);
-void closeInjector5(void);
-
-void openInjector6(void);
-void closeInjector6(void);
-
-void openInjector7(void);
-void closeInjector7(void);
-
-void openInjector8(void);
-void closeInjector8(void);
-
-// These are for Semi-Sequential and 5 Cylinder injection
-void openInjector1and3(void);
-void closeInjector1and3(void);
-void openInjector2and4(void);
-void closeInjector2and4(void);
-void openInjector1and4(void);
-void closeInjector1and4(void);
-void openInjector2and3(void);
-void closeInjector2and3(void);
-
-void openInjector3and5(void);
-void closeInjector3and5(void);
-
-void openInjector2and5(void);
-void closeInjector2and5(void);
-void openInjector3and6(void);
-void closeInjector3and6(void);
-
-void openInjector1and5(void);
-void closeInjector1and5(void);
-void openInjector2and6(void);
-void closeInjector2and6(void);
-void openInjector3and7(void);
-void closeInjector3and7(void);
-void openInjector4and8(void);
-void closeInjector4and8(void);
-
-void injector1Toggle(void);
-void injector2Toggle(void);
-void injector3Toggle(void);
-void injector4Toggle(void);
-void injector5Toggle(void);
-void injector6Toggle(void);
-void injector7Toggle(void);
-void injector8Toggle(void);
-
-void beginCoil1Charge(void);
-void endCoil1Charge(void);
-
-void beginCoil2Charge(void);
-void endCoil2Charge(void);
-
-void beginCoil3Charge(void);
-void endCoil3Charge(void);
-
-void beginCoil4Charge(void);
-void endCoil4Charge(void);
-
-void beginCoil5Charge(void);
-void endCoil5Charge(void);
-
-void beginCoil6Charge(void);
-void endCoil6Charge(void);
-
-void beginCoil7Charge(void);
-void endCoil7Charge(void);
+typedef void (*voidVoidCallback)(void);
 
-void beginCoil8Charge(void);
-void endCoil8Charge(void);
+#define OUTPUT_CHANNELS 8 //Number of injector and coil outputs with pins. This can be more than INJ_CHANNELS/IGN_CHANNELS as the test modes drive all of them
+
+/** @brief The functions that switch one injector or coil output */
+struct outputDriver_t {
+  voidVoidCallback on;     ///< Opens the injector, or starts charging the coil
+  voidVoidCallback off;    ///< Closes the injector, or stops charging the coil (Spark)
+  voidVoidCallback toggle;
+};
+
+/** @brief An injector or coil output.
+ * The pin is set by setPinMapping(), which then selects the driver for the output with initialiseOutputDrivers().
+ * The driver is fixed for that output (Direct pin or MC33810), so switching the output doesn't check injectorOutputControl or ignitionOutputControl.
+ */
+struct outputChannel_t {
+  volatile PORT_TYPE *port;
+  volatile PINMASK_TYPE mask;
+  outputDriver_t driver;
+};
+
+extern outputChannel_t injectorOutputs[OUTPUT_CHANNELS]; ///< Injector outputs 1 to 8
+extern outputChannel_t coilOutputs[OUTPUT_CHANNELS];     ///< Coil outputs 1 to 8
+
+/** Selects the driver for every injector and coil output from injectorOutputControl and ignitionOutputControl.
+ * Must be called before the driver functions are given to the schedules, as they are copied from here
+ */
+void initialiseOutputDrivers(void);
+
+//The single output functions are the selected driver. The schedules are given these directly, so their ISRs call straight into the driver
+#define openInjector1   (injectorOutputs[0].driver.on)
+#define closeInjector1  (injectorOutputs[0].driver.off)
+#define injector1Toggle (injectorOutputs[0].driver.toggle)
+#define openInjector2   (injectorOutputs[1].driver.on)
+#define closeInjector2  (injectorOutputs[1].driver.off)
+#define injector2Toggle (injectorOutputs[1].driver.toggle)
+#define openInjector3   (injectorOutputs[2].driver.on)
+#define closeInjector3  (injectorOutputs[2].driver.off)
+#define injector3Toggle (injectorOutputs[2].driver.toggle)
+#define openInjector4   (injectorOutputs[3].driver.on)
+#define closeInjector4  (injectorOutputs[3].driver.off)
+#define injector4Toggle (injectorOutputs[3].driver.toggle)
+#define openInjector5   (injectorOutputs[4].driver.on)
+#define closeInjector5  (injectorOutputs[4].driver.off)
+#define injector5Toggle (injectorOutputs[4].driver.toggle)
+#define openInjector6   (injectorOutputs[5].driver.on)
+#define closeInjector6  (injectorOutputs[5].driver.off)
+#define injector6Toggle (injectorOutputs[5].driver.toggle)
+#define openInjector7   (injectorOutputs[6].driver.on)
+#define closeInjector7  (injectorOutputs[6].driver.off)
+#define injector7Toggle (injectorOutputs[6].driver.toggle)
+#define openInjector8   (injectorOutputs[7].driver.on)
+#define closeInjector8  (injectorOutputs[7].driver.off)
+#define injector8Toggle (injectorOutputs[7].driver.toggle)
+
+//Coil charge functions also run the tacho output
+#define beginCoil1Charge (coilOutputs[0].driver.on)
+#define endCoil1Charge   (coilOutputs[0].driver.off)
+#define coil1Toggle      (coilOutputs[0].driver.toggle)
+#define beginCoil2Charge (coilOutputs[1].driver.on)
+#define endCoil2Charge   (coilOutputs[1].driver.off)
+#define coil2Toggle      (coilOutputs[1].driver.toggle)
+#define beginCoil3Charge (coilOutputs[2].driver.on)
+#define endCoil3Charge   (coilOutputs[2].driver.off)
+#define coil3Toggle      (coilOutputs[2].driver.toggle)
+#define beginCoil4Charge (coilOutputs[3].driver.on)
+#define endCoil4Charge   (coilOutputs[3].driver.off)
+#define coil4Toggle      (coilOutputs[3].driver.toggle)
+#define beginCoil5Charge (coilOutputs[4].driver.on)
+#define endCoil5Charge   (coilOutputs[4].driver.off)
+#define coil5Toggle      (coilOutputs[4].driver.toggle)
+#define beginCoil6Charge (coilOutputs[5].driver.on)
+#define endCoil6Charge   (coilOutputs[5].driver.off)
+#define coil6Toggle      (coilOutputs[5].driver.toggle)
+#define beginCoil7Charge (coilOutputs[6].driver.on)
+#define endCoil7Charge   (coilOutputs[6].driver.off)
+#define coil7Toggle      (coilOutputs[6].driver.toggle)
+#define beginCoil8Charge (coilOutputs[7].driver.on)
+#define endCoil8Charge   (coilOutputs[7].driver.off)
+#define coil8Toggle      (coilOutputs[7].driver.toggle)
+
+/** Pairs of outputs that are switched together for semi-sequential/paired injection, 5 cylinder injection and wasted COP */
+enum outputPair_t : uint8_t { OUTPUTS_1_3, OUTPUTS_2_4, OUTPUTS_1_4, OUTPUTS_2_3, OUTPUTS_3_5, OUTPUTS_2_5, OUTPUTS_3_6, OUTPUTS_1_5, OUTPUTS_2_6, OUTPUTS_3_7, OUTPUTS_4_8, OUTPUT_PAIRS };
+
+/** @brief The functions that switch a pair of outputs. Pairs are never toggled */
+struct outputPairDriver_t {
+  voidVoidCallback on;  ///< Opens the injectors, or starts charging the coils
+  voidVoidCallback off; ///< Closes the injectors, or stops charging the coils (Spark)
+};
+
+/** @brief A pair of outputs, switched by a single write where the hardware allows it.
+ * Set up by initialiseOutputDrivers() from the pins of the two outputs:
+ * - If both pins are on the same port, port/mask switches both of them and port2 isn't used
+ * - Otherwise each pin has its own port (port/mask and port2/mask2)
+ * - With the MC33810, outputs on the same IC are switched by one SPI command
+ */
+struct outputPairChannel_t {
+  volatile PORT_TYPE *port;
+  PINMASK_TYPE mask;
+  volatile PORT_TYPE *port2;
+  PINMASK_TYPE mask2;
+  outputPairDriver_t driver;
+};
+
+extern outputPairChannel_t injectorPairs[OUTPUT_PAIRS];
+extern outputPairChannel_t coilPairs[OUTPUT_PAIRS];
+
+//The paired output functions, as given to the schedules
+#define openInjector1and3  (injectorPairs[OUTPUTS_1_3].driver.on)
+#define closeInjector1and3 (injectorPairs[OUTPUTS_1_3].driver.off)
+#define openInjector2and4  (injectorPairs[OUTPUTS_2_4].driver.on)
+#define closeInjector2and4 (injectorPairs[OUTPUTS_2_4].driver.off)
+#define openInjector1and4  (injectorPairs[OUTPUTS_1_4].driver.on)
+#define closeInjector1and4 (injectorPairs[OUTPUTS_1_4].driver.off)
+#define openInjector2and3  (injectorPairs[OUTPUTS_2_3].driver.on)
+#define closeInjector2and3 (injectorPairs[OUTPUTS_2_3].driver.off)
+#define openInjector3and5  (injectorPairs[OUTPUTS_3_5].driver.on)
+#define closeInjector3and5 (injectorPairs[OUTPUTS_3_5].driver.off)
+#define openInjector2and5  (injectorPairs[OUTPUTS_2_5].driver.on)
+#define closeInjector2and5 (injectorPairs[OUTPUTS_2_5].driver.off)
+#define openInjector3and6  (injectorPairs[OUTPUTS_3_6].driver.on)
+#define closeInjector3and6 (injectorPairs[OUTPUTS_3_6].driver.off)
+#define openInjector1and5  (injectorPairs[OUTPUTS_1_5].driver.on)
+#define closeInjector1and5 (injectorPairs[OUTPUTS_1_5].driver.off)
+#define openInjector2and6  (injectorPairs[OUTPUTS_2_6].driver.on)
+#define closeInjector2and6 (injectorPairs[OUTPUTS_2_6].driver.off)
+#define openInjector3and7  (injectorPairs[OUTPUTS_3_7].driver.on)
+#define closeInjector3and7 (injectorPairs[OUTPUTS_3_7].driver.off)
+#define openInjector4and8  (injectorPairs[OUTPUTS_4_8].driver.on)
+#define closeInjector4and8 (injectorPairs[OUTPUTS_4_8].driver.off)
+
+#define beginCoil1and3Charge (coilPairs[OUTPUTS_1_3].driver.on)
+#define endCoil1and3Charge   (coilPairs[OUTPUTS_1_3].driver.off)
+#define beginCoil2and4Charge (coilPairs[OUTPUTS_2_4].driver.on)
+#define endCoil2and4Charge   (coilPairs[OUTPUTS_2_4].driver.off)
+#define beginCoil1and4Charge (coilPairs[OUTPUTS_1_4].driver.on)
+#define endCoil1and4Charge   (coilPairs[OUTPUTS_1_4].driver.off)
+#define beginCoil2and5Charge (coilPairs[OUTPUTS_2_5].driver.on)
+#define endCoil2and5Charge   (coilPairs[OUTPUTS_2_5].driver.off)
+#define beginCoil3and6Charge (coilPairs[OUTPUTS_3_6].driver.on)
+#define endCoil3and6Charge   (coilPairs[OUTPUTS_3_6].driver.off)
+#define beginCoil1and5Charge (coilPairs[OUTPUTS_1_5].driver.on)
+#define endCoil1and5Charge   (coilPairs[OUTPUTS_1_5].driver.off)
+#define beginCoil2and6Charge (coilPairs[OUTPUTS_2_6].driver.on)
+#define endCoil2and6Charge   (coilPairs[OUTPUTS_2_6].driver.off)
+#define beginCoil3and7Charge (coilPairs[OUTPUTS_3_7].driver.on)
+#define endCoil3and7Charge   (coilPairs[OUTPUTS_3_7].driver.off)
+#define beginCoil4and8Charge (coilPairs[OUTPUTS_4_8].driver.on)
+#define endCoil4and8Charge   (coilPairs[OUTPUTS_4_8].driver.off)
 
 //The following functions are used specifically for the trailing coil on rotary engines. They are separate as they also control the switching of the trailing select pin
 void beginTrailingCoilCharge(void);
 void endTrailingCoilCharge1(void);
 void endTrailingCoilCharge2(void);
 
-//And the combined versions of the above for simplicity
-void beginCoil1and3Charge(void);
-void endCoil1and3Charge(void);
-void beginCoil2and4Charge(void);
-void endCoil2and4Charge(void);
-
-//For 6-cyl cop
-void beginCoil1and4Charge(void);
-void endCoil1and4Charge(void);
-void beginCoil2and5Charge(void);
-void endCoil2and5Charge(void);
-void beginCoil3and6Charge(void);
-void endCoil3and6Charge(void);
-
-//For 8-cyl cop
-void beginCoil1and5Charge(void);
-void endCoil1and5Charge(void);
-void beginCoil2and6Charge(void);
-void endCoil2and6Charge(void);
-void beginCoil3and7Charge(void);
-void endCoil3and7Charge(void);
-void beginCoil4and8Charge(void);
-void endCoil4and8Charge(void);
-
-void coil1Toggle(void);
-void coil2Toggle(void);
-void coil3Toggle(void);
-void coil4Toggle(void);
-void coil5Toggle(void);
-void coil6Toggle(void);
-void coil7Toggle(void);
-void coil8Toggle(void);
-
 void tachoOutputOn(void);
 void tachoOutputOff(void);
 
-/*
-#ifndef USE_MC33810
-#define openInjector1() *inj1_pin_port |= (inj1_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ1)
-#define closeInjector1() *inj1_pin_port &= ~(inj1_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ1)
-#define openInjector2() *inj2_pin_port |= (inj2_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ2)
-#define closeInjector2() *inj2_pin_port &= ~(inj2_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ2)
-#define openInjector3() *inj3_pin_port |= (inj3_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ3)
-#define closeInjector3() *inj3_pin_port &= ~(inj3_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ3)
-#define openInjector4() *inj4_pin_port |= (inj4_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ4)
-#define closeInjector4() *inj4_pin_port &= ~(inj4_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ4)
-#define openInjector5() *inj5_pin_port |= (inj5_pin_mask);
-#define closeInjector5() *inj5_pin_port &= ~(inj5_pin_mask);
-#define openInjector6() *inj6_pin_port |= (inj6_pin_mask);
-#define closeInjector6() *inj6_pin_port &= ~(inj6_pin_mask);
-#define openInjector7() *inj7_pin_port |= (inj7_pin_mask);
-#define closeInjector7() *inj7_pin_port &= ~(inj7_pin_mask);
-#define openInjector8() *inj8_pin_port |= (inj8_pin_mask);
-#define closeInjector8() *inj8_pin_port &= ~(inj8_pin_mask);
-
-#else
-#include "acc_mc33810.h"
-#define openInjector1() openInjector1_MC33810()
-#define closeInjector1() closeInjector1_MC33810()
-#define openInjector2() openInjector2_MC33810()
-#define closeInjector2() closeInjector2_MC33810()
-#define openInjector3() openInjector3_MC33810()
-#define closeInjector3() closeInjector3_MC33810()
-#define openInjector4() openInjector4_MC33810()
-#define closeInjector4() closeInjector4_MC33810()
-#define openInjector5() openInjector5_MC33810()
-#define closeInjector5() closeInjector5_MC33810()
-#define openInjector6() openInjector6_MC33810()
-#define closeInjector6() closeInjector6_MC33810()
-#define openInjector7() openInjector7_MC33810()
-#define closeInjector7() closeInjector7_MC33810()
-#define openInjector8() openInjector8_MC33810()
-#define closeInjector8() closeInjector8_MC33810()
-
-#endif
-
-#define openInjector1and4() openInjector1(); openInjector4()
-#define closeInjector1and4() closeInjector1(); closeInjector4()
-#define openInjector2and3() openInjector2(); openInjector3()
-#define closeInjector2and3() closeInjector2(); closeInjector3()
-
-//5 cylinder support doubles up injector 3 as being closese to inj 5 (Crank angle)
-#define openInjector3and5() openInjector3(); openInjector5()
-#define closeInjector3and5() closeInjector3(); closeInjector5()
-*/
-
-//Macros are used to define how each injector control system functions. These are then called by the master openInjectx() function.
-//The DIRECT macros (ie individual pins) are defined below. Others should be defined in their relevant acc_x.h file
-#define openInjector1_DIRECT()  { *inj1_pin_port |= (inj1_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ1); }
-#define closeInjector1_DIRECT() { *inj1_pin_port &= ~(inj1_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ1); }
-#define openInjector2_DIRECT()  { *inj2_pin_port |= (inj2_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ2); }
-#define closeInjector2_DIRECT() { *inj2_pin_port &= ~(inj2_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ2); }
-#define openInjector3_DIRECT()  { *inj3_pin_port |= (inj3_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ3); }
-#define closeInjector3_DIRECT() { *inj3_pin_port &= ~(inj3_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ3); }
-#define openInjector4_DIRECT()  { *inj4_pin_port |= (inj4_pin_mask); BIT_SET(currentStatus.status1, BIT_STATUS1_INJ4); }
-#define closeInjector4_DIRECT() { *inj4_pin_port &= ~(inj4_pin_mask);  BIT_CLEAR(currentStatus.status1, BIT_STATUS1_INJ4); }
-#define openInjector5_DIRECT()  { *inj5_pin_port |= (inj5_pin_mask); }
-#define closeInjector5_DIRECT() { *inj5_pin_port &= ~(inj5_pin_mask); }
-#define openInjector6_DIRECT()  { *inj6_pin_port |= (inj6_pin_mask); }
-#define closeInjector6_DIRECT() { *inj6_pin_port &= ~(inj6_pin_mask); }
-#define openInjector7_DIRECT()  { *inj7_pin_port |= (inj7_pin_mask); }
-#define closeInjector7_DIRECT() { *inj7_pin_port &= ~(inj7_pin_mask); }
-#define openInjector8_DIRECT()  { *inj8_pin_port |= (inj8_pin_mask); }
-#define closeInjector8_DIRECT() { *inj8_pin_port &= ~(inj8_pin_mask); }
-
-#define coil1Low_DIRECT()       (*ign1_pin_port &= ~(ign1_pin_mask))
-#define coil1High_DIRECT()      (*ign1_pin_port |= (ign1_pin_mask))
-#define coil2Low_DIRECT()       (*ign2_pin_port &= ~(ign2_pin_mask))
-#define coil2High_DIRECT()      (*ign2_pin_port |= (ign2_pin_mask))
-#define coil3Low_DIRECT()       (*ign3_pin_port &= ~(ign3_pin_mask))
-#define coil3High_DIRECT()      (*ign3_pin_port |= (ign3_pin_mask))
-#define coil4Low_DIRECT()       (*ign4_pin_port &= ~(ign4_pin_mask))
-#define coil4High_DIRECT()      (*ign4_pin_port |= (ign4_pin_mask))
-#define coil5Low_DIRECT()       (*ign5_pin_port &= ~(ign5_pin_mask))
-#define coil5High_DIRECT()      (*ign5_pin_port |= (ign5_pin_mask))
-#define coil6Low_DIRECT()       (*ign6_pin_port &= ~(ign6_pin_mask))
-#define coil6High_DIRECT()      (*ign6_pin_port |= (ign6_pin_mask))
-#define coil7Low_DIRECT()       (*ign7_pin_port &= ~(ign7_pin_mask))
-#define coil7High_DIRECT()      (*ign7_pin_port |= (ign7_pin_mask))
-#define coil8Low_DIRECT()       (*ign8_pin_port &= ~(ign8_pin_mask))
-#define coil8High_DIRECT()      (*ign8_pin_port |= (ign8_pin_mask))
-
-//Set the value of the coil pins to the coilHIGH or coilLOW state
-#define coil1Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil1Low_DIRECT() : coil1High_DIRECT())
-#define coil1StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil1High_DIRECT() : coil1Low_DIRECT())
-#define coil2Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil2Low_DIRECT() : coil2High_DIRECT())
-#define coil2StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil2High_DIRECT() : coil2Low_DIRECT())
-#define coil3Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil3Low_DIRECT() : coil3High_DIRECT())
-#define coil3StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil3High_DIRECT() : coil3Low_DIRECT())
-#define coil4Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil4Low_DIRECT() : coil4High_DIRECT())
-#define coil4StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil4High_DIRECT() : coil4Low_DIRECT())
-#define coil5Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil5Low_DIRECT() : coil5High_DIRECT())
-#define coil5StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil5High_DIRECT() : coil5Low_DIRECT())
-#define coil6Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil6Low_DIRECT() : coil6High_DIRECT())
-#define coil6StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil6High_DIRECT() : coil6Low_DIRECT())
-#define coil7Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil7Low_DIRECT() : coil7High_DIRECT())
-#define coil7StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil7High_DIRECT() : coil7Low_DIRECT())
-#define coil8Charging_DIRECT()      (configPage4.IgInv == GOING_HIGH ? coil8Low_DIRECT() : coil8High_DIRECT())
-#define coil8StopCharging_DIRECT()  (configPage4.IgInv == GOING_HIGH ? coil8High_DIRECT() : coil8Low_DIRECT())
-
-#define coil1Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil1Low_MC33810();  } else { coil1High_MC33810(); }
-#define coil1StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil1High_MC33810(); } else { coil1Low_MC33810();  }
-#define coil2Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil2Low_MC33810();  } else { coil2High_MC33810(); }
-#define coil2StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil2High_MC33810(); } else { coil2Low_MC33810();  }
-#define coil3Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil3Low_MC33810();  } else { coil3High_MC33810(); }
-#define coil3StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil3High_MC33810(); } else { coil3Low_MC33810();  }
-#define coil4Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil4Low_MC33810();  } else { coil4High_MC33810(); }
-#define coil4StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil4High_MC33810(); } else { coil4Low_MC33810();  }
-#define coil5Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil5Low_MC33810();  } else { coil5High_MC33810(); }
-#define coil5StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil5High_MC33810(); } else { coil5Low_MC33810();  }
-#define coil6Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil6Low_MC33810();  } else { coil6High_MC33810(); }
-#define coil6StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil6High_MC33810(); } else { coil6Low_MC33810();  }
-#define coil7Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil7Low_MC33810();  } else { coil7High_MC33810(); }
-#define coil7StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil7High_MC33810(); } else { coil7Low_MC33810();  }
-#define coil8Charging_MC33810()      if(configPage4.IgInv == GOING_HIGH) { coil8Low_MC33810();  } else { coil8High_MC33810(); }
-#define coil8StopCharging_MC33810()  if(configPage4.IgInv == GOING_HIGH) { coil8High_MC33810(); } else { coil8Low_MC33810();  }
-
-#define coil1Toggle_DIRECT() (*ign1_pin_port ^= ign1_pin_mask )
-#define coil2Toggle_DIRECT() (*ign2_pin_port ^= ign2_pin_mask )
-#define coil3Toggle_DIRECT() (*ign3_pin_port ^= ign3_pin_mask )
-#define coil4Toggle_DIRECT() (*ign4_pin_port ^= ign4_pin_mask )
-#define coil5Toggle_DIRECT() (*ign5_pin_port ^= ign5_pin_mask )
-#define coil6Toggle_DIRECT() (*ign6_pin_port ^= ign6_pin_mask )
-#define coil7Toggle_DIRECT() (*ign7_pin_port ^= ign7_pin_mask )
-#define coil8Toggle_DIRECT() (*ign8_pin_port ^= ign8_pin_mask )
-
-#define injector1Toggle_DIRECT() (*inj1_pin_port ^= inj1_pin_mask )
-#define injector2Toggle_DIRECT() (*inj2_pin_port ^= inj2_pin_mask )
-#define injector3Toggle_DIRECT() (*inj3_pin_port ^= inj3_pin_mask )
-#define injector4Toggle_DIRECT() (*inj4_pin_port ^= inj4_pin_mask )
-#define injector5Toggle_DIRECT() (*inj5_pin_port ^= inj5_pin_mask )
-#define injector6Toggle_DIRECT() (*inj6_pin_port ^= inj6_pin_mask )
-#define injector7Toggle_DIRECT() (*inj7_pin_port ^= inj7_pin_mask )
-#define injector8Toggle_DIRECT() (*inj8_pin_port ^= inj8_pin_mask )
-
 void nullCallback(void);
 
-typedef void (*voidVoidCallback)(void);
-
 #endif
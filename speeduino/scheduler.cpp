@@ -28,57 +28,85 @@ A full copy of the license may be found in the projects root directory
 #include "config.h"
 #include "scheduler.h"
 #include "scheduledIO.h"
+#include "isrProfiler.h"
 #include "timers.h"
 #include "schedule_calcs.h"
+#include "schedule_queue.h"
+#include "maths.h"
+#include <SimplyAtomic.h>
+
+#if defined(USE_SCHEDULE_QUEUE)
+//Every schedule runs from the queue's timer, with a queue slot in place of its own compare channel
+#define FUEL_SCHEDULE_TIMER(n) SCHEDULE_QUEUE_COUNTER, scheduleQueueCompare[FUEL_QUEUE_SLOT(n)], scheduleQueueSlotDisable<FUEL_QUEUE_SLOT(n)>, scheduleQueueSlotEnable<FUEL_QUEUE_SLOT(n)>
+#define IGN_SCHEDULE_TIMER(n) SCHEDULE_QUEUE_COUNTER, scheduleQueueCompare[IGN_QUEUE_SLOT(n)], scheduleQueueSlotDisable<IGN_QUEUE_SLOT(n)>, scheduleQueueSlotEnable<IGN_QUEUE_SLOT(n)>
+static void scheduleQueueDispatch(uint8_t slot);
+#else
+#define FUEL_SCHEDULE_TIMER(n) FUEL##n##_COUNTER, FUEL##n##_COMPARE, FUEL##n##_TIMER_DISABLE, FUEL##n##_TIMER_ENABLE
+#define IGN_SCHEDULE_TIMER(n) IGN##n##_COUNTER, IGN##n##_COMPARE, IGN##n##_TIMER_DISABLE, IGN##n##_TIMER_ENABLE
+#endif
 
-FuelSchedule fuelSchedule1(FUEL1_COUNTER, FUEL1_COMPARE, FUEL1_TIMER_DISABLE, FUEL1_TIMER_ENABLE);
-FuelSchedule fuelSchedule2(FUEL2_COUNTER, FUEL2_COMPARE, FUEL2_TIMER_DISABLE, FUEL2_TIMER_ENABLE);
-FuelSchedule fuelSchedule3(FUEL3_COUNTER, FUEL3_COMPARE, FUEL3_TIMER_DISABLE, FUEL3_TIMER_ENABLE);
-FuelSchedule fuelSchedule4(FUEL4_COUNTER, FUEL4_COMPARE, FUEL4_TIMER_DISABLE, FUEL4_TIMER_ENABLE);
+FuelSchedule fuelSchedule1(FUEL_SCHEDULE_TIMER(1));
+FuelSchedule fuelSchedule2(FUEL_SCHEDULE_TIMER(2));
+FuelSchedule fuelSchedule3(FUEL_SCHEDULE_TIMER(3));
+FuelSchedule fuelSchedule4(FUEL_SCHEDULE_TIMER(4));
 
 #if (INJ_CHANNELS >= 5)
-FuelSchedule fuelSchedule5(FUEL5_COUNTER, FUEL5_COMPARE, FUEL5_TIMER_DISABLE, FUEL5_TIMER_ENABLE);
+FuelSchedule fuelSchedule5(FUEL_SCHEDULE_TIMER(5));
 #endif
 #if (INJ_CHANNELS >= 6)
-FuelSchedule fuelSchedule6(FUEL6_COUNTER, FUEL6_COMPARE, FUEL6_TIMER_DISABLE, FUEL6_TIMER_ENABLE);
+FuelSchedule fuelSchedule6(FUEL_SCHEDULE_TIMER(6));
 #endif
 #if (INJ_CHANNELS >= 7)
-FuelSchedule fuelSchedule7(FUEL7_COUNTER, FUEL7_COMPARE, FUEL7_TIMER_DISABLE, FUEL7_TIMER_ENABLE);
+FuelSchedule fuelSchedule7(FUEL_SCHEDULE_TIMER(7));
 #endif
 #if (INJ_CHANNELS >= 8)
-FuelSchedule fuelSchedule8(FUEL8_COUNTER, FUEL8_COMPARE, FUEL8_TIMER_DISABLE, FUEL8_TIMER_ENABLE);
+FuelSchedule fuelSchedule8(FUEL_SCHEDULE_TIMER(8));
 #endif
 
-IgnitionSchedule ignitionSchedule1(IGN1_COUNTER, IGN1_COMPARE, IGN1_TIMER_DISABLE, IGN1_TIMER_ENABLE);
-IgnitionSchedule ignitionSchedule2(IGN2_COUNTER, IGN2_COMPARE, IGN2_TIMER_DISABLE, IGN2_TIMER_ENABLE);
-IgnitionSchedule ignitionSchedule3(IGN3_COUNTER, IGN3_COMPARE, IGN3_TIMER_DISABLE, IGN3_TIMER_ENABLE);
-IgnitionSchedule ignitionSchedule4(IGN4_COUNTER, IGN4_COMPARE, IGN4_TIMER_DISABLE, IGN4_TIMER_ENABLE);
-IgnitionSchedule ignitionSchedule5(IGN5_COUNTER, IGN5_COMPARE, IGN5_TIMER_DISABLE, IGN5_TIMER_ENABLE);
+IgnitionSchedule ignitionSchedule1(IGN_SCHEDULE_TIMER(1));
+IgnitionSchedule ignitionSchedule2(IGN_SCHEDULE_TIMER(2));
+IgnitionSchedule ignitionSchedule3(IGN_SCHEDULE_TIMER(3));
+IgnitionSchedule ignitionSchedule4(IGN_SCHEDULE_TIMER(4));
+IgnitionSchedule ignitionSchedule5(IGN_SCHEDULE_TIMER(5));
 
 #if IGN_CHANNELS >= 6
-IgnitionSchedule ignitionSchedule6(IGN6_COUNTER, IGN6_COMPARE, IGN6_TIMER_DISABLE, IGN6_TIMER_ENABLE);
+IgnitionSchedule ignitionSchedule6(IGN_SCHEDULE_TIMER(6));
 #endif
 #if IGN_CHANNELS >= 7
-IgnitionSchedule ignitionSchedule7(IGN7_COUNTER, IGN7_COMPARE, IGN7_TIMER_DISABLE, IGN7_TIMER_ENABLE);
+IgnitionSchedule ignitionSchedule7(IGN_SCHEDULE_TIMER(7));
 #endif
 #if IGN_CHANNELS >= 8
-IgnitionSchedule ignitionSchedule8(IGN8_COUNTER, IGN8_COMPARE, IGN8_TIMER_DISABLE, IGN8_TIMER_ENABLE);
+IgnitionSchedule ignitionSchedule8(IGN_SCHEDULE_TIMER(8));
 #endif
 
+struct FuelSplit fuelSplit;
+struct IgnitionMultiSpark ignitionMultiSpark;
+
 static void reset(FuelSchedule &schedule) 
 {
     schedule.Status = OFF;
+    schedule.splitPulses = 0U;
+    schedule.splitNext = 0U;
+    schedule.cycle = 0U;
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
     schedule.pTimerEnable();
 }
 
 static void reset(IgnitionSchedule &schedule) 
 {
     schedule.Status = OFF;
+    schedule.multiSparks = 0U;
+    schedule.multiSparkNext = 0U;
+    schedule.cycle = 0U;
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
     schedule.pTimerEnable();
 }
 
 void initialiseSchedulers()
 {
+#if defined(USE_SCHEDULE_QUEUE)
+    initialiseScheduleQueue(scheduleQueueDispatch);
+#endif
     reset(fuelSchedule1);
     reset(fuelSchedule2);
     reset(fuelSchedule3);
@@ -211,75 +239,231 @@ void initialiseSchedulers()
 
 }
 
+/*
+Handing schedules from the main loop to the ISRs
+
+The main loop doesn't disable interrupts to set a schedule, so the trigger interrupts are never held up by it. Instead:
+- A schedule that is OFF has nothing for its ISR to do, so it is set up in full before its timer is enabled
+- A pending or running schedule belongs to its ISR. The next cycle is written to the slot in cycles that isn't queued,
+  then queued by writing nextCycle. A queued cycle stays valid until the ISR takes it up or a newer one replaces it. It
+  is tagged with endCount, so the ISR only takes it up at the end of the pulse it was queued behind, never a later one
+- The compare of a pending schedule is only moved when neither the armed nor the new compare is about to fire, and the
+  rest of the schedule is written first (See canMoveScheduleCompare() and moveScheduleCompare())
+*/
+
+//AVR 16 bit timer registers are accessed through a TEMP register that is shared by every compare on the timer, so another
+//schedule's ISR must not run part way through the 2 byte access. This is the only part of a schedule update that needs interrupts off
+#if defined(CORE_AVR)
+  #define SCHEDULE_REGISTER_ACCESS() ATOMIC()
+#else
+  #define SCHEDULE_REGISTER_ACCESS()
+#endif
+
+template <typename TSchedule>
+static inline COMPARE_TYPE readScheduleCounter(TSchedule &schedule)
+{
+  COMPARE_TYPE counter = 0U;
+  SCHEDULE_REGISTER_ACCESS() { counter = schedule.counter; }
+  return counter;
+}
+
+template <typename TSchedule>
+static inline void writeScheduleCompare(TSchedule &schedule, COMPARE_TYPE compare)
+{
+  SCHEDULE_REGISTER_ACCESS() { SET_COMPARE(schedule.compare, compare); }
+}
+
+/** Whether the main loop can move the compare of a pending or running schedule.
+ * Both the armed and the new compare must be more than SCHEDULE_UPDATE_THRESHOLD away, so the ISR can't fire while the
+ * schedule is being updated, nor straight after the new compare is written and before it is recorded.
+ */
+template <typename TSchedule>
+static inline bool canMoveScheduleCompare(TSchedule &schedule, COMPARE_TYPE now, COMPARE_TYPE compare)
+{
+  return ( (COMPARE_TYPE)(schedule.armedCompare - now) > uS_TO_TIMER_COMPARE(SCHEDULE_UPDATE_THRESHOLD) )
+      && ( (COMPARE_TYPE)(compare - now) > uS_TO_TIMER_COMPARE(SCHEDULE_UPDATE_THRESHOLD) );
+}
+
+/** Moves the compare of a pending or running schedule from the main loop, once canMoveScheduleCompare() has allowed it.
+ * The new compare is only recorded once the ISR is known not to have run since events was read. If it did run (E.g. the
+ * main loop was held up by other interrupts), the compare that it set is put back.
+ * @param events The schedule's isrEvents, read before its status was checked
+ * @return true if the compare was moved
+ */
+template <typename TSchedule>
+static bool moveScheduleCompare(TSchedule &schedule, uint8_t events, COMPARE_TYPE compare)
+{
+  writeScheduleCompare(schedule, compare);
+  if(schedule.isrEvents != events)
+  {
+    writeScheduleCompare(schedule, schedule.armedCompare);
+    return false;
+  }
+  schedule.armedCompare = compare;
+  return true;
+}
+
+/** Sets the compare from a schedule ISR, recording it for moveScheduleCompare() */
+template <typename TSchedule>
+static inline __attribute__((always_inline)) void setISRCompare(TSchedule &schedule, COMPARE_TYPE compare)
+{
+  schedule.armedCompare = compare;
+  SET_COMPARE(schedule.compare, compare);
+}
+
+/** Shares the pulsewidth between the first pulse and the split pulses in @ref fuelSplit.
+ * The split pulse durations and gaps are written to the cycle for fuelScheduleISR() to fire.
+ * @param pDuration The full pulsewidth. Set to the duration of the first pulse
+ * @return The number of split pulses that follow the first
+ */
+static uint8_t setFuelSplitPulses(FuelScheduleCycle &cycle, unsigned long *pDuration)
+{
+  uint8_t pulses = 0U;
+
+  if( (fuelSplit.pulses > 0U) && (*pDuration > fuelSplit.openTime) )
+  {
+    uint32_t fuelTime = *pDuration - fuelSplit.openTime; //The time the injector is actually flowing fuel
+    for(; pulses < fuelSplit.pulses; ++pulses)
+    {
+      uint16_t splitFuelTime = percentage(fuelSplit.percent[pulses], fuelTime);
+      cycle.splitDuration[pulses] = splitFuelTime + fuelSplit.openTime;
+      cycle.splitGap[pulses] = uS_TO_TIMER_COMPARE(fuelSplit.gap[pulses]);
+      *pDuration = *pDuration - splitFuelTime;
+    }
+  }
+  return pulses;
+}
+
 void _setFuelScheduleRunning(FuelSchedule &schedule, unsigned long timeout, unsigned long duration)
 {
-  //The following must be enclosed in the noInterupts block to avoid contention caused if the relevant interrupt fires before the state is fully set
-  noInterrupts();
+  uint8_t events = schedule.isrEvents;
+  ScheduleStatus status = schedule.Status;
 
   //The duration of the pulsewidth cannot be longer than the maximum timer period. This is unlikely as pulse widths should never get that long, but it's here for safety
-  if(duration >= MAX_TIMER_PERIOD) { schedule.duration = MAX_TIMER_PERIOD - 1; }
-  else { schedule.duration = duration; }
+  if(duration >= MAX_TIMER_PERIOD) { duration = MAX_TIMER_PERIOD - 1; }
+  COMPARE_TYPE now = readScheduleCounter(schedule);
+  COMPARE_TYPE startCompare = now + uS_TO_TIMER_COMPARE(timeout);
 
-  schedule.startCompare = schedule.counter + uS_TO_TIMER_COMPARE(timeout);
-  SET_COMPARE(schedule.compare, schedule.startCompare);
-  schedule.Status = PENDING; //Turn this schedule on
-  interrupts();
-  schedule.pTimerEnable();
+  if(status == OFF)
+  {
+    //The ISR has nothing to do for this schedule, so it can be set up in full before the timer is enabled
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
+    schedule.splitNext = 0U;
+    schedule.splitPulses = setFuelSplitPulses(schedule.cycles[schedule.cycle], &duration);
+    schedule.duration = duration;
+    schedule.startCompare = startCompare;
+    schedule.armedCompare = startCompare;
+    writeScheduleCompare(schedule, startCompare);
+    schedule.Status = PENDING; //Turn this schedule on
+    schedule.pTimerEnable();
+  }
+  else if( (status == PENDING) && (schedule.splitNext == 0U) && canMoveScheduleCompare(schedule, now, startCompare) )
+  {
+    //The first pulse can't start for SCHEDULE_UPDATE_THRESHOLD, so it is written before its start is moved. If the ISR
+    //starts it anyway, it is this pulse that is started, just at the old compare
+    schedule.splitPulses = setFuelSplitPulses(schedule.cycles[schedule.cycle], &duration);
+    schedule.duration = duration;
+    schedule.startCompare = startCompare;
+    (void)moveScheduleCompare(schedule, events, startCompare);
+  }
 }
 
 void _setFuelScheduleNext(FuelSchedule &schedule, unsigned long timeout, unsigned long duration)
 {
-  noInterrupts();
+  uint8_t endCount = schedule.endCount;
+  //Split pulses from this cycle are still to come, so the next cycle can only be queued once the last one is running
+  if( (schedule.Status != RUNNING) || (schedule.splitNext < schedule.splitPulses) ) { return; }
+
+  //The slot that isn't queued is free. The current cycle's split pulses have all started, so its slot is no longer read
+  uint8_t slot = (schedule.nextCycle == 0U) ? 1U : 0U;
+  FuelScheduleCycle &next = schedule.cycles[slot];
+
   //The duration of the pulsewidth cannot be longer than the maximum timer period. This is unlikely as pulse widths should never get that long, but it's here for safety
-  //Duration can safely be set here as the schedule is already running at the previous duration value already used
-  if(duration >= MAX_TIMER_PERIOD) { schedule.duration = MAX_TIMER_PERIOD - 1; }
-  else { schedule.duration = duration; }
+  if(duration >= MAX_TIMER_PERIOD) { duration = MAX_TIMER_PERIOD - 1; }
+  next.splitPulses = setFuelSplitPulses(next, &duration);
+  next.duration = duration;
+  next.startCompare = readScheduleCounter(schedule) + uS_TO_TIMER_COMPARE(timeout);
+  next.endCount = endCount;
+
+  //If the pulse ended while this was being written, the ISR will not take this cycle up as endCount has moved on
+  schedule.nextCycle = slot;
+}
 
-  schedule.nextStartCompare = schedule.counter + uS_TO_TIMER_COMPARE(timeout);
-  schedule.hasNextSchedule = true;
-  interrupts();
+/** Writes the repeat sparks from @ref ignitionMultiSpark to the cycle for ignitionScheduleISR() to fire after the primary spark.
+ * @return The number of repeat sparks
+ */
+static inline uint8_t setMultiSparks(IgnitionScheduleCycle &cycle)
+{
+  cycle.multiSparkRest = uS_TO_TIMER_COMPARE(ignitionMultiSpark.rest);
+  cycle.multiSparkDwell = ignitionMultiSpark.dwell;
+  return ignitionMultiSpark.sparks;
 }
 
 void _setIgnitionScheduleRunning(IgnitionSchedule &schedule, unsigned long timeout, unsigned long duration)
 {
-  //The duration of the dwell cannot be longer than the maximum timer period. This is unlikely as dwell timess should never get that long, but it's here for safety
-  if(duration >= MAX_TIMER_PERIOD) { schedule.duration = MAX_TIMER_PERIOD - 1; }
-  else { schedule.duration = duration; }
+  uint8_t events = schedule.isrEvents;
+  ScheduleStatus status = schedule.Status;
 
-  COMPARE_TYPE timeout_timer_compare = uS_TO_TIMER_COMPARE(timeout);
+  //The duration of the dwell cannot be longer than the maximum timer period. This is unlikely as dwell timess should never get that long, but it's here for safety
+  if(duration >= MAX_TIMER_PERIOD) { duration = MAX_TIMER_PERIOD - 1; }
+  COMPARE_TYPE now = readScheduleCounter(schedule);
+  COMPARE_TYPE startCompare = now + uS_TO_TIMER_COMPARE(timeout); //As there is a tick every 4uS, there are timeout/4 ticks until the interrupt should be triggered ( >>2 divides by 4)
 
-  noInterrupts();
-  schedule.startCompare = schedule.counter + timeout_timer_compare; //As there is a tick every 4uS, there are timeout/4 ticks until the interrupt should be triggered ( >>2 divides by 4)
-  //if(schedule.endScheduleSetByDecoder == false) { schedule.endCompare = schedule.startCompare + uS_TO_TIMER_COMPARE(schedule.duration); } //The .endCompare value is also set by the per tooth timing in decoders.ino. The check here is so that it's not getting overridden. 
-  SET_COMPARE(schedule.compare, schedule.startCompare);
-  schedule.Status = PENDING; //Turn this schedule on
-  interrupts();
-  schedule.pTimerEnable();
+  if(status == OFF)
+  {
+    //The ISR has nothing to do for this schedule, so it can be set up in full before the timer is enabled
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
+    schedule.duration = duration;
+    schedule.multiSparkNext = 0U;
+    schedule.multiSparks = setMultiSparks(schedule.cycles[schedule.cycle]);
+    schedule.startCompare = startCompare;
+    schedule.armedCompare = startCompare;
+    writeScheduleCompare(schedule, startCompare);
+    schedule.Status = PENDING; //Turn this schedule on
+    schedule.pTimerEnable();
+  }
+  else if( (status == PENDING) && (schedule.multiSparkNext == 0U) && canMoveScheduleCompare(schedule, now, startCompare) )
+  {
+    //The primary dwell can't start for SCHEDULE_UPDATE_THRESHOLD, so it is written before its start is moved. If the ISR
+    //starts it anyway, it is this dwell that is started, just at the old compare
+    schedule.duration = duration;
+    schedule.multiSparks = setMultiSparks(schedule.cycles[schedule.cycle]);
+    schedule.startCompare = startCompare;
+    (void)moveScheduleCompare(schedule, events, startCompare);
+  }
 }
 
 void _setIgnitionScheduleNext(IgnitionSchedule &schedule, unsigned long timeout, unsigned long duration)
 {
   //If the schedule is already running, we can set the next schedule so it is ready to go
   //This is required in cases of high rpm and high DC where there otherwise would not be enough time to set the schedule
-  noInterrupts();
-  schedule.nextStartCompare = schedule.counter + uS_TO_TIMER_COMPARE(timeout);
-  if(duration >= MAX_TIMER_PERIOD) { schedule.duration = MAX_TIMER_PERIOD - 1; }
-  else { schedule.duration = duration; }
-  schedule.hasNextSchedule = true;
-  interrupts();
+  uint8_t endCount = schedule.endCount;
+  //Repeat sparks from this cycle are still to come, so the next cycle can only be queued once the last one is running
+  if( (schedule.Status != RUNNING) || (schedule.multiSparkNext < schedule.multiSparks) ) { return; }
+
+  //The slot that isn't queued is free. The current cycle's repeat sparks have all started, so its slot is no longer read
+  uint8_t slot = (schedule.nextCycle == 0U) ? 1U : 0U;
+  IgnitionScheduleCycle &next = schedule.cycles[slot];
+
+  next.startCompare = readScheduleCounter(schedule) + uS_TO_TIMER_COMPARE(timeout);
+  if(duration >= MAX_TIMER_PERIOD) { next.duration = MAX_TIMER_PERIOD - 1; }
+  else { next.duration = duration; }
+  next.multiSparks = setMultiSparks(next);
+  next.endCount = endCount;
+
+  //If the dwell ended while this was being written, the ISR will not take this cycle up as endCount has moved on
+  schedule.nextCycle = slot;
 }
 
-
 void refreshIgnitionSchedule1(unsigned long timeToEnd)
 {
-  if( (ignitionSchedule1.Status == RUNNING) && (timeToEnd < ignitionSchedule1.duration) )
-  //Must have the threshold check here otherwise it can cause a condition where the compare fires twice, once after the other, both for the end
-  //if( (timeToEnd < ignitionSchedule1.duration) && (timeToEnd > IGNITION_REFRESH_THRESHOLD) )
+  uint8_t events = ignitionSchedule1.isrEvents;
+  if( (ignitionSchedule1.Status == RUNNING) && (ignitionSchedule1.multiSparkNext == 0U) && (timeToEnd < ignitionSchedule1.duration) )
   {
-    noInterrupts();
-    ignitionSchedule1.endCompare = IGN1_COUNTER + uS_TO_TIMER_COMPARE(timeToEnd);
-    SET_COMPARE(IGN1_COMPARE, ignitionSchedule1.endCompare);
-    interrupts();
+    //The compare is left alone if the spark is too close, which stops it from firing twice
+    COMPARE_TYPE now = readScheduleCounter(ignitionSchedule1);
+    COMPARE_TYPE endCompare = now + uS_TO_TIMER_COMPARE(timeToEnd);
+    if( canMoveScheduleCompare(ignitionSchedule1, now, endCompare) && moveScheduleCompare(ignitionSchedule1, events, endCompare) ) { ignitionSchedule1.endCompare = endCompare; }
   }
 }
 
@@ -323,23 +507,45 @@ extern void beginInjectorPriming(void)
 // overhead.
 static inline __attribute__((always_inline)) void fuelScheduleISR(FuelSchedule &schedule)
 {
+  ISR_PROFILE_START();
+  ISR_PROFILE_LATENCY_TICKS(ISR_PROFILE_FUEL, (COMPARE_TYPE)(schedule.counter - schedule.compare));
+
   if (schedule.Status == PENDING) //Check to see if this schedule is turn on
   {
+    schedule.isrEvents = schedule.isrEvents + 1U;
     schedule.pStartFunction();
     schedule.Status = RUNNING; //Set the status to be in progress (ie The start callback has been called, but not the end callback)
-    SET_COMPARE(schedule.compare, schedule.counter + uS_TO_TIMER_COMPARE(schedule.duration) ); //Doing this here prevents a potential overflow on restarts
+    setISRCompare(schedule, schedule.counter + uS_TO_TIMER_COMPARE(schedule.duration) ); //Doing this here prevents a potential overflow on restarts
   }
   else if (schedule.Status == RUNNING)
   {
+    uint8_t endCount = schedule.endCount;
+    schedule.endCount = endCount + 1U;
+    schedule.isrEvents = schedule.isrEvents + 1U;
     schedule.pEndFunction();
     schedule.Status = OFF; //Turn off the schedule
 
-    //If there is a next schedule queued up, activate it
-    if(schedule.hasNextSchedule == true)
+    //If the next cycle was queued up behind this pulse, activate it
+    uint8_t next = schedule.nextCycle;
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
+    if( (next < SCHEDULE_CYCLE_SLOTS) && (schedule.cycles[next].endCount == endCount) )
+    {
+      const FuelScheduleCycle &cycle = schedule.cycles[next];
+      setISRCompare(schedule, cycle.startCompare);
+      schedule.duration = cycle.duration;
+      schedule.splitPulses = cycle.splitPulses;
+      schedule.splitNext = 0U;
+      schedule.cycle = next;
+      schedule.Status = PENDING;
+    }
+    //If this cycle's injection is split, open the injector again after the gap
+    else if(schedule.splitNext < schedule.splitPulses)
     {
-      SET_COMPARE(schedule.compare, schedule.nextStartCompare); //Flip the next start compare time to be the current one. The duration of this next pulse will already have been set in _setFuelScheduleNext()
+      const FuelScheduleCycle &cycle = schedule.cycles[schedule.cycle];
+      setISRCompare(schedule, schedule.counter + cycle.splitGap[schedule.splitNext]);
+      schedule.duration = cycle.splitDuration[schedule.splitNext];
+      schedule.splitNext = schedule.splitNext + 1U;
       schedule.Status = PENDING;
-      schedule.hasNextSchedule = false;
     }
     else
     { 
@@ -350,130 +556,66 @@ static inline __attribute__((always_inline)) void fuelScheduleISR(FuelSchedule &
   { 
     schedule.pTimerDisable(); //Safety check. Turn off this output compare unit and return without performing any action
   } 
-} 
-
-/*******************************************************************************************************************************************************************************************************/
-/** fuelSchedule*Interrupt (All 8 ISR functions below) get called (as timed interrupts) when either the start time or the duration time are reached.
-* This calls the relevant callback function (startCallback or endCallback) depending on the status (PENDING => Needs to run, RUNNING => Needs to stop) of the schedule.
-* The status of schedule is managed here based on startCallback /endCallback function called:
-* - startCallback - change scheduler into RUNNING state
-* - endCallback - change scheduler into OFF state (or PENDING if schedule.hasNextSchedule is set)
-*/
-//Timer3A (fuel schedule 1) Compare Vector
-#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) //AVR chips use the ISR for this
-//fuelSchedules 1 and 5
-ISR(TIMER3_COMPA_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule1Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule1);
-  }
-
-
-#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) //AVR chips use the ISR for this
-ISR(TIMER3_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule2Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule2);
-  }
-
-
-#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) //AVR chips use the ISR for this
-ISR(TIMER3_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule3Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule3);
-  }
-
-
-#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) //AVR chips use the ISR for this
-ISR(TIMER4_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule4Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule4);
-  }
-
-#if INJ_CHANNELS >= 5
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER4_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule5Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule5);
-  }
-#endif
-
-#if INJ_CHANNELS >= 6
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER4_COMPA_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule6Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule6);
-  }
-#endif
-
-#if INJ_CHANNELS >= 7
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER5_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule7Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule7);
-  }
-#endif
 
-#if INJ_CHANNELS >= 8
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER5_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void fuelSchedule8Interrupt() //Most ARM chips can simply call a function
-#endif
-  {
-    fuelScheduleISR(fuelSchedule8);
-  }
-#endif
+  ISR_PROFILE_END(ISR_PROFILE_FUEL);
+} 
 
 // Shared ISR function for all ignition timers.
 // This is completely inlined into the ISR - there is no function call
 // overhead.
 static inline __attribute__((always_inline)) void ignitionScheduleISR(IgnitionSchedule &schedule)
 {
+  ISR_PROFILE_START();
+  ISR_PROFILE_LATENCY_TICKS(ISR_PROFILE_IGNITION, (COMPARE_TYPE)(schedule.counter - schedule.compare));
+
   if (schedule.Status == PENDING) //Check to see if this schedule is turn on
   {
+    schedule.isrEvents = schedule.isrEvents + 1U;
     schedule.pStartCallback();
     schedule.Status = RUNNING; //Set the status to be in progress (ie The start callback has been called, but not the end callback)
     schedule.startTime = micros();
-    if(schedule.endScheduleSetByDecoder == true) { SET_COMPARE(schedule.compare, schedule.endCompare); }
-    else { SET_COMPARE(schedule.compare, schedule.counter + uS_TO_TIMER_COMPARE(schedule.duration) ); } //Doing this here prevents a potential overflow on restarts
+    if( (schedule.endScheduleSetByDecoder == true) && (schedule.multiSparkNext == 0U) ) { setISRCompare(schedule, schedule.endCompare); }
+    else { setISRCompare(schedule, schedule.counter + uS_TO_TIMER_COMPARE(schedule.duration) ); } //Doing this here prevents a potential overflow on restarts
   }
   else if (schedule.Status == RUNNING)
   {
+    uint8_t endCount = schedule.endCount;
+    schedule.endCount = endCount + 1U;
+    schedule.isrEvents = schedule.isrEvents + 1U;
     schedule.pEndCallback();
     schedule.Status = OFF; //Turn off the schedule
     schedule.endScheduleSetByDecoder = false;
-    ignitionCount = ignitionCount + 1; //Increment the ignition counter
-    currentStatus.actualDwell = DWELL_AVERAGE( (micros() - schedule.startTime) );
+    if(schedule.multiSparkNext == 0U) //Repeat sparks are not counted as ignition events
+    {
+      ignitionCount = ignitionCount + 1; //Increment the ignition counter
+      currentStatus.actualDwell = DWELL_AVERAGE( (micros() - schedule.startTime) );
+    }
 
-    //If there is a next schedule queued up, activate it
-    if(schedule.hasNextSchedule == true)
+    //If the next cycle was queued up behind this spark, activate it
+    uint8_t next = schedule.nextCycle;
+    schedule.nextCycle = SCHEDULE_NO_NEXT_CYCLE;
+    if( (next < SCHEDULE_CYCLE_SLOTS) && (schedule.cycles[next].endCount == endCount) )
+    {
+      const IgnitionScheduleCycle &cycle = schedule.cycles[next];
+      setISRCompare(schedule, cycle.startCompare);
+      schedule.duration = cycle.duration;
+      schedule.Status = PENDING;
+      schedule.multiSparks = cycle.multiSparks;
+      schedule.multiSparkNext = 0U;
+      schedule.cycle = next;
+    }
+    //Multi-spark: once this spark has finished, charge the coil again
+    else if(schedule.multiSparkNext < schedule.multiSparks)
     {
-      SET_COMPARE(schedule.compare, schedule.nextStartCompare);
+      const IgnitionScheduleCycle &cycle = schedule.cycles[schedule.cycle];
+      setISRCompare(schedule, schedule.counter + cycle.multiSparkRest);
+      schedule.duration = cycle.multiSparkDwell;
+      schedule.multiSparkNext = schedule.multiSparkNext + 1U;
       schedule.Status = PENDING;
-      schedule.hasNextSchedule = false;
     }
     else
     { 
+      schedule.multiSparkNext = 0U;
       schedule.pTimerDisable(); 
     }
   }
@@ -482,93 +624,131 @@ static inline __attribute__((always_inline)) void ignitionScheduleISR(IgnitionSc
     //Catch any spurious interrupts. This really shouldn't ever be called, but there as a safety
     schedule.pTimerDisable(); 
   }
+
+  ISR_PROFILE_END(ISR_PROFILE_IGNITION);
 }
 
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER5_COMPA_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule1Interrupt(void) //Most ARM chips can simply call a function
+//The schedule on each channel. These are only indexed with constants, so they resolve to the schedule at compile time
+static FuelSchedule * const fuelSchedules[INJ_CHANNELS] = {
+  &fuelSchedule1, &fuelSchedule2, &fuelSchedule3, &fuelSchedule4,
+#if INJ_CHANNELS >= 5
+  &fuelSchedule5,
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule1);
-  }
-
-#if IGN_CHANNELS >= 2
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER5_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule2Interrupt(void) //Most ARM chips can simply call a function
+#if INJ_CHANNELS >= 6
+  &fuelSchedule6,
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule2);
-  }
+#if INJ_CHANNELS >= 7
+  &fuelSchedule7,
+#endif
+#if INJ_CHANNELS >= 8
+  &fuelSchedule8,
 #endif
+};
 
-#if IGN_CHANNELS >= 3
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER5_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule3Interrupt(void) //Most ARM chips can simply call a function
+static IgnitionSchedule * const ignitionSchedules[IGN_SCHEDULES] = {
+  &ignitionSchedule1, &ignitionSchedule2, &ignitionSchedule3, &ignitionSchedule4, &ignitionSchedule5,
+#if IGN_CHANNELS >= 6
+  &ignitionSchedule6,
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule3);
-  }
+#if IGN_CHANNELS >= 7
+  &ignitionSchedule7,
 #endif
+#if IGN_CHANNELS >= 8
+  &ignitionSchedule8,
+#endif
+};
 
-#if IGN_CHANNELS >= 4
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER4_COMPA_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule4Interrupt(void) //Most ARM chips can simply call a function
+#if !defined(USE_SCHEDULE_QUEUE)
+/*******************************************************************************************************************************************************************************************************/
+/** The fuel and ignition schedule interrupts get called (as timed interrupts) when either the start time or the duration time are reached.
+* This calls the relevant callback function (startCallback or endCallback) depending on the status (PENDING => Needs to run, RUNNING => Needs to stop) of the schedule.
+* The status of schedule is managed here based on startCallback /endCallback function called:
+* - startCallback - change scheduler into RUNNING state
+* - endCallback - change scheduler into OFF state (or PENDING if a next cycle was queued behind this pulse, or a split injection pulse or repeat spark is still to come)
+*/
+#if defined(CORE_AVR) //AVR chips use the ISR for this. The vectors are fixed to the compare channels
+ISR(TIMER3_COMPA_vect) { fuelScheduleISR(fuelSchedule1); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER3_COMPB_vect) { fuelScheduleISR(fuelSchedule2); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER3_COMPC_vect) { fuelScheduleISR(fuelSchedule3); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER4_COMPB_vect) { fuelScheduleISR(fuelSchedule4); } //cppcheck-suppress misra-c2012-8.2
+#if INJ_CHANNELS >= 5
+ISR(TIMER4_COMPC_vect) { fuelScheduleISR(fuelSchedule5); } //cppcheck-suppress misra-c2012-8.2
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule4);
-  }
+#if INJ_CHANNELS >= 6
+ISR(TIMER4_COMPA_vect) { fuelScheduleISR(fuelSchedule6); } //cppcheck-suppress misra-c2012-8.2
 #endif
-
-#if IGN_CHANNELS >= 5
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER4_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule5Interrupt(void) //Most ARM chips can simply call a function
+#if INJ_CHANNELS >= 7
+ISR(TIMER5_COMPC_vect) { fuelScheduleISR(fuelSchedule7); } //cppcheck-suppress misra-c2012-8.2
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule5);
-  }
+#if INJ_CHANNELS >= 8
+ISR(TIMER5_COMPB_vect) { fuelScheduleISR(fuelSchedule8); } //cppcheck-suppress misra-c2012-8.2
 #endif
 
-#if IGN_CHANNELS >= 6
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER4_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule6Interrupt(void) //Most ARM chips can simply call a function
+ISR(TIMER5_COMPA_vect) { ignitionScheduleISR(ignitionSchedule1); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER5_COMPB_vect) { ignitionScheduleISR(ignitionSchedule2); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER5_COMPC_vect) { ignitionScheduleISR(ignitionSchedule3); } //cppcheck-suppress misra-c2012-8.2
+ISR(TIMER4_COMPA_vect) { ignitionScheduleISR(ignitionSchedule4); } //cppcheck-suppress misra-c2012-8.2
+#if IGN_CHANNELS >= 5
+ISR(TIMER4_COMPC_vect) { ignitionScheduleISR(ignitionSchedule5); } //cppcheck-suppress misra-c2012-8.2
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule6);
-  }
+#if IGN_CHANNELS >= 6
+ISR(TIMER4_COMPB_vect) { ignitionScheduleISR(ignitionSchedule6); } //cppcheck-suppress misra-c2012-8.2
 #endif
-
 #if IGN_CHANNELS >= 7
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER3_COMPC_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule7Interrupt(void) //Most ARM chips can simply call a function
+ISR(TIMER3_COMPC_vect) { ignitionScheduleISR(ignitionSchedule7); } //cppcheck-suppress misra-c2012-8.2
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule7);
-  }
+#if IGN_CHANNELS >= 8
+ISR(TIMER3_COMPB_vect) { ignitionScheduleISR(ignitionSchedule8); } //cppcheck-suppress misra-c2012-8.2
 #endif
 
-#if IGN_CHANNELS >= 8
-#if defined(CORE_AVR) //AVR chips use the ISR for this
-ISR(TIMER3_COMPB_vect) //cppcheck-suppress misra-c2012-8.2
-#else
-void ignitionSchedule8Interrupt(void) //Most ARM chips can simply call a function
+#else //Most ARM chips can simply call a function
+template <uint8_t channel> void fuelScheduleInterrupt(void) { fuelScheduleISR(*fuelSchedules[channel - 1U]); }
+template <uint8_t channel> void ignitionScheduleInterrupt(void) { ignitionScheduleISR(*ignitionSchedules[channel - 1U]); }
+
+//The board's timer interrupts call these
+template void fuelScheduleInterrupt<1>(void);
+template void fuelScheduleInterrupt<2>(void);
+template void fuelScheduleInterrupt<3>(void);
+template void fuelScheduleInterrupt<4>(void);
+#if INJ_CHANNELS >= 5
+template void fuelScheduleInterrupt<5>(void);
 #endif
-  {
-    ignitionScheduleISR(ignitionSchedule8);
-  }
+#if INJ_CHANNELS >= 6
+template void fuelScheduleInterrupt<6>(void);
+#endif
+#if INJ_CHANNELS >= 7
+template void fuelScheduleInterrupt<7>(void);
+#endif
+#if INJ_CHANNELS >= 8
+template void fuelScheduleInterrupt<8>(void);
 #endif
+template void ignitionScheduleInterrupt<1>(void);
+template void ignitionScheduleInterrupt<2>(void);
+template void ignitionScheduleInterrupt<3>(void);
+template void ignitionScheduleInterrupt<4>(void);
+#if IGN_CHANNELS >= 5
+template void ignitionScheduleInterrupt<5>(void);
+#endif
+#if IGN_CHANNELS >= 6
+template void ignitionScheduleInterrupt<6>(void);
+#endif
+#if IGN_CHANNELS >= 7
+template void ignitionScheduleInterrupt<7>(void);
+#endif
+#if IGN_CHANNELS >= 8
+template void ignitionScheduleInterrupt<8>(void);
+#endif
+#endif //CORE_AVR
+#else
+static_assert(IGN_SCHEDULES == SCHEDULE_QUEUE_IGN_SLOTS, "Every ignition schedule has a queue slot");
+
+/** Runs the schedule that owns a queue slot. This replaces the per channel ISRs above */
+static void scheduleQueueDispatch(uint8_t slot)
+{
+  if (slot < INJ_CHANNELS) { fuelScheduleISR(*fuelSchedules[slot]); }
+  else { ignitionScheduleISR(*ignitionSchedules[slot - IGN_QUEUE_SLOT(1)]); }
+}
+#endif //!USE_SCHEDULE_QUEUE
 
 void disablePendingFuelSchedule(byte channel)
 {
@@ -37,15 +37,24 @@ See page 136 of the processors datasheet: http://www.atmel.com/Images/doc2549.pd
 256 prescale gives tick every 16uS.
 256 prescale gives overflow every 1048576uS (This means maximum wait time is 1.0485 seconds).
 
+## 32-bit timers
+
+Teensy 4.1 and STM32F4 boards (And the native board) can instead run the schedules from a 32-bit timer ticking at 1uS by defining
+USE_SCHEDULE_TIMER_32BIT. COMPARE_TYPE is then 32-bit and MAX_TIMER_PERIOD is over an hour, so setFuelSchedule() and setIgnitionSchedule()
+no longer have to refuse long timeouts at low RPM, and there is no rounding between uS and timer ticks.
+The Teensy 4.1 and STM32 timers only have a few 32-bit compares, so those boards also use the schedule queue (See schedule_queue.h).
+
 */
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
 #include "globals.h"
 #include "crankMaths.h"
+#include "schedule_queue.h"
 
 #define USE_IGN_REFRESH
 #define IGNITION_REFRESH_THRESHOLD  30 //Time in uS that the refresh functions will check to ensure there is enough time before changing the end compare
+#define SCHEDULE_UPDATE_THRESHOLD   100 //Time in uS that both the armed and the new compare must be away from firing for the main loop to move it (See canMoveScheduleCompare())
 
 #define DWELL_AVERAGE_ALPHA 30
 #define DWELL_AVERAGE(input) LOW_PASS_FILTER((input), DWELL_AVERAGE_ALPHA, currentStatus.actualDwell)
@@ -57,50 +66,42 @@ void beginInjectorPriming(void);
 void disablePendingFuelSchedule(byte channel);
 void disablePendingIgnSchedule(byte channel);
 
+#define FUEL_SPLIT_MAX_PULSES 3 ///< The most injection pulses per channel per cycle when split injection is active
+
+#define SCHEDULE_CYCLE_SLOTS    2U    ///< Parameter slots per schedule: the current cycle's and the queued next cycle's
+#define SCHEDULE_NO_NEXT_CYCLE  0xFFU ///< nextCycle value when no next cycle is queued
+
+/** @brief How each injection is currently split into several pulses. Set by calculateInjTiming()
+ * 
+ * The pulsewidth passed to setFuelSchedule() is shared between the first pulse and the trailing pulses listed here. Each
+ * trailing pulse opens the injector again, so gets its own injector opening time on top of its share of the fuel.
+ */
+struct FuelSplit {
+  uint8_t pulses; ///< Number of trailing pulses after the first. 0 = split injection is off
+  uint8_t percent[FUEL_SPLIT_MAX_PULSES - 1U]; ///< Share of the pulsewidth (Less the opening time) given to each trailing pulse
+  uint16_t gap[FUEL_SPLIT_MAX_PULSES - 1U]; ///< Time from the end of the previous pulse to the start of each trailing pulse (uS)
+  uint16_t openTime; ///< Injector opening time (uS)
+};
+extern struct FuelSplit fuelSplit;
+
+/** @brief The repeat sparks that follow each primary spark when multi-spark is active. Set by calculateDwell()
+ * 
+ * After the primary spark, the ignition ISR waits for the spark to finish then charges and fires the coil again, as many
+ * times as is set here.
+ */
+struct IgnitionMultiSpark {
+  uint8_t sparks; ///< Number of repeat sparks after the primary one. 0 = multi-spark is off
+  uint16_t dwell; ///< Dwell of each repeat spark (uS)
+  uint16_t rest; ///< Time from each spark to the start of the next dwell (uS)
+};
+extern struct IgnitionMultiSpark ignitionMultiSpark;
+
 void refreshIgnitionSchedule1(unsigned long timeToEnd);
 
-//The ARM cores use separate functions for their ISRs
-#if defined(ARDUINO_ARCH_STM32) || defined(CORE_TEENSY)
-  void fuelSchedule1Interrupt(void);
-  void fuelSchedule2Interrupt(void);
-  void fuelSchedule3Interrupt(void);
-  void fuelSchedule4Interrupt(void);
-#if (INJ_CHANNELS >= 5)
-  void fuelSchedule5Interrupt(void);
-#endif
-#if (INJ_CHANNELS >= 6)
-  void fuelSchedule6Interrupt(void);
-#endif
-#if (INJ_CHANNELS >= 7)
-  void fuelSchedule7Interrupt(void);
-#endif
-#if (INJ_CHANNELS >= 8)
-  void fuelSchedule8Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 1)
-  void ignitionSchedule1Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 2)
-  void ignitionSchedule2Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 3)
-  void ignitionSchedule3Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 4)
-  void ignitionSchedule4Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 5)
-  void ignitionSchedule5Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 6)
-  void ignitionSchedule6Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 7)
-  void ignitionSchedule7Interrupt(void);
-#endif
-#if (IGN_CHANNELS >= 8)
-  void ignitionSchedule8Interrupt(void);
-#endif
+//The ARM cores use separate functions for their ISRs, one for each schedule (E.g. fuelScheduleInterrupt<1>). With USE_SCHEDULE_QUEUE there is only scheduleQueueInterrupt()
+#if (defined(ARDUINO_ARCH_STM32) || defined(CORE_TEENSY) || defined(CORE_M451)) && !defined(USE_SCHEDULE_QUEUE)
+  template <uint8_t channel> void fuelScheduleInterrupt(void);     ///< Channels 1 to INJ_CHANNELS
+  template <uint8_t channel> void ignitionScheduleInterrupt(void); ///< Channels 1 to IGN_CHANNELS
 #endif
 /** Schedule statuses.
  * - OFF - Schedule turned off and there is no scheduled plan
@@ -110,6 +111,18 @@ void refreshIgnitionSchedule1(unsigned long timeToEnd);
  */
 enum ScheduleStatus {OFF, PENDING, STAGED, RUNNING}; //The statuses that a schedule can have
 
+/** The parameters of one ignition cycle (A primary spark and its repeat sparks).
+ * Each schedule has one slot for the cycle that is running and one that the main loop queues the next cycle in.
+ */
+struct IgnitionScheduleCycle {
+  COMPARE_TYPE startCompare; ///< When the primary dwell starts. Only used by a queued next cycle
+  unsigned long duration; ///< Primary dwell (uS)
+  uint8_t multiSparks; ///< Number of repeat sparks that follow the primary spark
+  uint8_t endCount; ///< The schedule's endCount when a next cycle was queued
+  COMPARE_TYPE multiSparkRest; ///< Timer ticks from each spark to the start of the next repeat dwell
+  uint16_t multiSparkDwell; ///< Dwell of each repeat spark (uS)
+};
+
 /** Ignition schedule.
  */
 struct IgnitionSchedule {
@@ -117,8 +130,13 @@ struct IgnitionSchedule {
   // Deduce the real types of the counter and compare registers.
   // COMPARE_TYPE is NOT the same - it's just an integer type wide enough to
   // store 16-bit counter/compare calculation results.
+#if defined(USE_SCHEDULE_QUEUE)
+  using counter_t = decltype(SCHEDULE_QUEUE_COUNTER);
+  using compare_t = queued_compare_t;
+#else
   using counter_t = decltype(IGN1_COUNTER);
   using compare_t = decltype(IGN1_COMPARE);
+#endif
 
   IgnitionSchedule( counter_t &counter, compare_t &compare,
             void (&_pTimerDisable)(), void (&_pTimerEnable)())
@@ -137,10 +155,15 @@ struct IgnitionSchedule {
   volatile COMPARE_TYPE startCompare; ///< The counter value of the timer when this will start
   volatile COMPARE_TYPE endCompare;   ///< The counter value of the timer when this will end
 
-  COMPARE_TYPE nextStartCompare;      ///< Planned start of next schedule (when current schedule is RUNNING)
-  COMPARE_TYPE nextEndCompare;        ///< Planned end of next schedule (when current schedule is RUNNING)
-  volatile bool hasNextSchedule = false; ///< Enable flag for planned next schedule (when current schedule is RUNNING)
   volatile bool endScheduleSetByDecoder = false;
+  uint8_t multiSparks = 0U; ///< Number of repeat sparks that follow the current cycle's primary spark (See @ref IgnitionMultiSpark)
+  volatile uint8_t multiSparkNext = 0U; ///< Number of repeat sparks started so far. 0 = the primary spark is pending or running
+  IgnitionScheduleCycle cycles[SCHEDULE_CYCLE_SLOTS]; ///< The current cycle and the queued next cycle (See _setIgnitionScheduleNext())
+  volatile uint8_t cycle = 0U; ///< The slot in cycles that the current cycle's repeat sparks come from
+  volatile uint8_t nextCycle = SCHEDULE_NO_NEXT_CYCLE; ///< The slot in cycles holding the queued next cycle. Written in one go, so the ISR never sees a part written cycle
+  volatile uint8_t endCount = 0U; ///< Incremented by the ISR at the end of each dwell, so a queued next cycle is only taken up at the end of the dwell that it was queued behind
+  volatile uint8_t isrEvents = 0U; ///< Incremented by the ISR each time it sets the compare, so the main loop can tell if it ran part way through an update
+  volatile COMPARE_TYPE armedCompare; ///< The last value written to the compare register
 
   counter_t &counter;  // Reference to the counter register. E.g. TCNT3
   compare_t &compare;  // Reference to the compare register. E.g. OCR3A
@@ -155,8 +178,8 @@ inline __attribute__((always_inline)) void setIgnitionSchedule(IgnitionSchedule
 {
   if((timeout) < MAX_TIMER_PERIOD)
   {
-    if(schedule.Status != RUNNING) 
-    { //Check that we're not already part way through a schedule
+    if( (schedule.Status != RUNNING) && (schedule.multiSparkNext == 0U) )
+    { //Check that we're not already part way through a schedule, including its repeat sparks
       _setIgnitionScheduleRunning(schedule, timeout, duration);
     }
     // Check whether timeout exceeds the maximum future time. This can potentially occur on sequential setups when below ~115rpm
@@ -167,6 +190,18 @@ inline __attribute__((always_inline)) void setIgnitionSchedule(IgnitionSchedule
   }
 }
 
+/** The parameters of one injection cycle (A pulse and its split pulses).
+ * Each schedule has one slot for the cycle that is running and one that the main loop queues the next cycle in.
+ */
+struct FuelScheduleCycle {
+  COMPARE_TYPE startCompare; ///< When the first pulse starts. Only used by a queued next cycle
+  unsigned long duration; ///< Duration of the first pulse (uS)
+  uint8_t splitPulses; ///< Number of split injection pulses that follow the first
+  uint8_t endCount; ///< The schedule's endCount when a next cycle was queued
+  COMPARE_TYPE splitGap[FUEL_SPLIT_MAX_PULSES - 1U]; ///< Timer ticks from the end of one pulse to the start of each split pulse
+  uint16_t splitDuration[FUEL_SPLIT_MAX_PULSES - 1U]; ///< Duration of each split pulse (uS)
+};
+
 /** Fuel injection schedule.
 * Fuel schedules don't use the callback pointers, or the startTime/endScheduleSetByDecoder variables.
 * They are removed in this struct to save RAM.
@@ -176,8 +211,13 @@ struct FuelSchedule {
   // Deduce the real types of the counter and compare registers.
   // COMPARE_TYPE is NOT the same - it's just an integer type wide enough to
   // store 16-bit counter/compare calculation results.
+#if defined(USE_SCHEDULE_QUEUE)
+  using counter_t = decltype(SCHEDULE_QUEUE_COUNTER);
+  using compare_t = queued_compare_t;
+#else
   using counter_t = decltype(FUEL1_COUNTER);
   using compare_t = decltype(FUEL1_COMPARE);
+#endif
 
   FuelSchedule( counter_t &counter, compare_t &compare,
             void (&_pTimerDisable)(), void (&_pTimerEnable)())
@@ -193,8 +233,14 @@ struct FuelSchedule {
   volatile COMPARE_TYPE startCompare; ///< The counter value of the timer when this will start
   void (*pStartFunction)(void);
   void (*pEndFunction)(void);  
-  COMPARE_TYPE nextStartCompare;
-  volatile bool hasNextSchedule = false;
+  uint8_t splitPulses = 0U; ///< Number of split injection pulses that follow the current cycle's first pulse (See @ref FuelSplit)
+  volatile uint8_t splitNext = 0U; ///< Index of the next split pulse to fire. When this reaches splitPulses, the cycle is complete
+  FuelScheduleCycle cycles[SCHEDULE_CYCLE_SLOTS]; ///< The current cycle and the queued next cycle (See _setFuelScheduleNext())
+  volatile uint8_t cycle = 0U; ///< The slot in cycles that the current cycle's split pulses come from
+  volatile uint8_t nextCycle = SCHEDULE_NO_NEXT_CYCLE; ///< The slot in cycles holding the queued next cycle. Written in one go, so the ISR never sees a part written cycle
+  volatile uint8_t endCount = 0U; ///< Incremented by the ISR at the end of each pulse, so a queued next cycle is only taken up at the end of the pulse that it was queued behind
+  volatile uint8_t isrEvents = 0U; ///< Incremented by the ISR each time it sets the compare, so the main loop can tell if it ran part way through an update
+  volatile COMPARE_TYPE armedCompare; ///< The last value written to the compare register
 
   counter_t &counter;  // Reference to the counter register. E.g. TCNT3
   compare_t &compare;  // Reference to the compare register. E.g. OCR3A
@@ -238,6 +284,8 @@ extern FuelSchedule fuelSchedule7;
 extern FuelSchedule fuelSchedule8;
 #endif
 
+#define IGN_SCHEDULES ((IGN_CHANNELS < 5) ? 5 : IGN_CHANNELS) //Number of ignition schedules. Schedules 1-5 always exist
+
 extern IgnitionSchedule ignitionSchedule1;
 extern IgnitionSchedule ignitionSchedule2;
 extern IgnitionSchedule ignitionSchedule3;
@@ -17,6 +17,7 @@ A full copy of the license may be found in the projects root directory
 #include "comms.h"
 #include "idle.h"
 #include "corrections.h"
+#include "engine.h"
 #include "pages.h"
 #include "decoders.h"
 #include "auxiliaries.h"
@@ -532,6 +533,7 @@ void readMAP(void)
 
     // Convert from filtered sensor readings to kPa
     setMAPValuesFromReadings(mapAlgorithmState.sensorReadings, configPage2, configPage6.useEMAP, currentStatus);
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
   }
 }
 
@@ -584,6 +586,8 @@ void readTPS(bool useFilter)
     else { currentStatus.CTPSActive = digitalRead(pinCTPS); } //Inverted mode (5v activates closed throttle position sensor)
   }
   else { currentStatus.CTPSActive = 0; }
+
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 void readCLT(bool useFilter)
@@ -594,12 +598,14 @@ void readCLT(bool useFilter)
   else { currentStatus.cltADC = tempReading; }
   
   currentStatus.coolant = table2D_getValue(&cltCalibrationTable, currentStatus.cltADC) - CALIBRATION_TEMPERATURE_OFFSET; //Temperature calibration values are stored as positive bytes. We subtract 40 from them to allow for negative temperatures
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 void readIAT(void)
 {
   currentStatus.iatADC = LOW_PASS_FILTER(readAnalogSensor(pinIAT), configPage4.ADCFILTER_IAT, currentStatus.iatADC);
   currentStatus.IAT = table2D_getValue(&iatCalibrationTable, currentStatus.iatADC) - CALIBRATION_TEMPERATURE_OFFSET;
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 // ========================================== Baro ==========================================
@@ -643,6 +649,7 @@ void readBaro(void)
   } else {
     // Do nothing - baro remains at last read value & MISRA checker is kept happy.
   }
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 static inline void initialiseBaro(void) {
@@ -682,7 +689,7 @@ void readO2(void)
     currentStatus.O2ADC = 0U;
     currentStatus.O2 = 0U;
   }
-  
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 void readO2_2(void)
@@ -691,6 +698,7 @@ void readO2_2(void)
   //Get the current O2 value.
   currentStatus.O2_2ADC = LOW_PASS_FILTER(readAnalogSensor(pinO2_2), configPage4.ADCFILTER_O2, currentStatus.O2_2ADC);
   currentStatus.O2_2 = table2D_getValue(&o2CalibrationTable, currentStatus.O2_2ADC);
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 void readBat(void)
@@ -722,6 +730,7 @@ void readBat(void)
   }
 
   currentStatus.battery10 = LOW_PASS_FILTER(tempReading, configPage4.ADCFILTER_BAT, currentStatus.battery10);
+  BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
 }
 
 /**
@@ -866,7 +875,7 @@ void flexPulse(void)
 {
   if(READ_FLEX() == true)
   {
-    uint16_t tempPW = clamp(micros() - flexStartTime, 0UL, (unsigned long)UINT16_MAX); //Calculate the pulse width
+    uint16_t tempPW = clamp((uint32_t)(micros() - flexStartTime), (uint32_t)0UL, (uint32_t)UINT16_MAX); //Calculate the pulse width
     flexPulseWidth = LOW_PASS_FILTER(tempPW, configPage4.FILTER_FLEX, flexPulseWidth);
     ++flexCounter;
   }
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "comms_legacy.h"
 #include "comms_secondary.h"
 #include "pages.h"
+#include "page_crc.h"
 
 #include "TSComms.h"
 
@@ -54,6 +55,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "SD_logger.h"
 #include "schedule_calcs.h"
 #include "auxiliaries.h"
+#include "loopProfiler.h"
 //#include BOARD_H //Note that this is not a real file, it is defined in globals.h.
 //#include RTC_LIB_H //Defined in each boards .h file
 
@@ -141,15 +143,15 @@ void loop(void)
     currentLoopTime = micros_safe();		// register current loop time
 
     //SERIAL Comms
-	serialControl();
+	LOOP_PROFILE(LOOP_TASK_SERIAL, serialControl());
 
-	Storage.storageControl();			// control machine for mem storage
+	LOOP_PROFILE(LOOP_TASK_STORAGE, Storage.storageControl());			// control machine for mem storage
 
     if( (configPage6.iacAlgorithm == IAC_ALGORITHM_STEP_OL)
     || (configPage6.iacAlgorithm == IAC_ALGORITHM_STEP_CL)
     || (configPage6.iacAlgorithm == IAC_ALGORITHM_STEP_OLCL) )
     {
-      idleControl(); //Run idlecontrol every loop for stepper idle.
+      LOOP_PROFILE(LOOP_TASK_IDLE, idleControl()); //Run idlecontrol every loop for stepper idle.
     }
 
     //***Perform sensor reads***
@@ -157,34 +159,41 @@ void loop(void)
     // Every 1ms. NOTE: This is NOT guaranteed to run at 1kHz on AVR systems. It will run at 1kHz if possible or as fast as loops/s allows if not.
     if (BIT_CHECK(loopTimerMask, BIT_TIMER_1KHZ))
     {
+      uint32_t taskStart = micros();
       readMAP();
+      loopProfileEnd(LOOP_TASK_1KHZ, taskStart);
     }
 
     if(BIT_CHECK(loopTimerMask, BIT_TIMER_200HZ))
     {
+      uint32_t taskStart = micros();
       #if defined(ANALOG_ISR)
         //ADC in free running mode does 1 complete conversion of all 16 channels and then the interrupt is disabled. Every 200Hz we re-enable the interrupt to get another conversion cycle
         BIT_SET(ADCSRA,ADIE); //Enable ADC interrupt
       #endif
+      loopProfileEnd(LOOP_TASK_200HZ, taskStart);
     }
 
     if(	BIT_CHECK(loopTimerMask, BIT_TIMER_50HZ) ) //50 hertz
     {
+      uint32_t taskStart = micros();
       #if defined(NATIVE_CAN_AVAILABLE)
       sendCANBroadcast(50);
       #endif
 
       digitalUpdateL9979WD();
+      loopProfileEnd(LOOP_TASK_50HZ, taskStart);
     }
 
     if(BIT_CHECK(loopTimerMask, BIT_TIMER_30HZ)) //30 hertz
     {
+      uint32_t taskStart = micros();
 
     	//Most boost tends to run at about 30Hz, so placing it here ensures a new target time is fetched frequently enough
-      boostControl();
+      LOOP_PROFILE(LOOP_TASK_BOOST, boostControl());
 
       //VVT may eventually need to be synced with the cam readings (ie run once per cam rev) but for now run at 30Hz
-      vvtControl();
+      LOOP_PROFILE(LOOP_TASK_VVT, vvtControl());
 
       //Water methanol injection
       wmiControl();
@@ -206,14 +215,16 @@ void loop(void)
       #ifdef SD_LOGGING
         if(configPage13.onboard_log_file_rate == LOGGER_RATE_30HZ)
         {
-        	writeSDLogEntry();
+        	LOOP_PROFILE(LOOP_TASK_SD_LOG, writeSDLogEntry());
         }
       #endif
 
+      loopProfileEnd(LOOP_TASK_30HZ, taskStart);
     }
 
     if (BIT_CHECK(loopTimerMask, BIT_TIMER_15HZ)) //Every 32 loops
     {
+      uint32_t taskStart = micros();
       #if TPS_READ_FREQUENCY == 15
         readTPS(); //TPS reading to be performed every 32 loops (any faster and it can upset the TPSdot sampling time)
       #endif
@@ -232,18 +243,17 @@ void loop(void)
       sendCANBroadcast(15);
       #endif
 
-      //And check whether the tooth log buffer is ready
-      if( toothHistoryIndex > TOOTH_LOG_SIZE )
-      {
-    	  BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
-      }
+      //Bring one out of date page CRC up to date, so TS doesn't have to wait for it
+      updateStalePageCRC32();
+      loopProfileEnd(LOOP_TASK_15HZ, taskStart);
     }
 
     if(BIT_CHECK(loopTimerMask, BIT_TIMER_10HZ)) //10 hertz
     {
+      uint32_t taskStart = micros();
       //updateFullStatus();
       checkProgrammableIO();
-      idleControl(); //Perform any idle related actions. This needs to be run at 10Hz to align with the idle taper resolution of 0.1s
+      LOOP_PROFILE(LOOP_TASK_IDLE, idleControl()); //Perform any idle related actions. This needs to be run at 10Hz to align with the idle taper resolution of 0.1s
       
       // Air conditioning control
       airConControl();
@@ -256,13 +266,15 @@ void loop(void)
       #endif
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == LOGGER_RATE_10HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == LOGGER_RATE_10HZ) { LOOP_PROFILE(LOOP_TASK_SD_LOG, writeSDLogEntry()); }
       #endif
 
+      loopProfileEnd(LOOP_TASK_10HZ, taskStart);
     }
 
     if (BIT_CHECK(loopTimerMask, BIT_TIMER_4HZ))
     {
+      uint32_t taskStart = micros();
       //The IAT and CLT readings can be done less frequently (4 times per second)
       readCLT();
       readIAT();
@@ -273,7 +285,7 @@ void loop(void)
       updateIdleTarget();
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == LOGGER_RATE_4HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == LOGGER_RATE_4HZ) { LOOP_PROFILE(LOOP_TASK_SD_LOG, writeSDLogEntry()); }
         syncSDLog(); //Sync the SD log file to the card 4 times per second. 
       #endif  
 
@@ -286,22 +298,27 @@ void loop(void)
           auxControl();
       } //aux channels are enabled
 
+      loopProfileEnd(LOOP_TASK_4HZ, taskStart);
     } //4Hz timer
 
     if (BIT_CHECK(loopTimerMask, BIT_TIMER_1HZ)) //Once per second)
     {
+      uint32_t taskStart = micros();
       readBaro(); 		//Infrequent baro readings are not an issue.
 
       wmiLamp();		// No water indicator bulb
 
+      verifyNextPageCRC32(); //Picks up any page data that was changed without invalidating its CRC
+
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == LOGGER_RATE_1HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == LOGGER_RATE_1HZ) { LOOP_PROFILE(LOOP_TASK_SD_LOG, writeSDLogEntry()); }
       #endif
 
+      loopProfileEnd(LOOP_TASK_1HZ, taskStart);
     } //1Hz timer
 
 
-    engineControl();
+    LOOP_PROFILE(LOOP_TASK_ENGINE, engineControl());
 
 #if !defined(CORE_M451)
 
@@ -321,6 +338,10 @@ void loop(void)
     }
 #endif
 
+    loopProfileEnd(LOOP_TASK_LOOP, currentLoopTime);
+    //Publish the task times once per second, alongside loopsPerSecond
+    if (BIT_CHECK(loopTimerMask, BIT_TIMER_1HZ)) { loopProfileLatch(); }
+
 } //loop()
 //#pragma GCC diagnostic pop
 
@@ -257,14 +257,6 @@ byte val;
 }
 
 
-eeprom_address_t StorageClass::loadTable(void *pTable, table_type_t key, eeprom_address_t address)
-{
-  return load(y_rbegin(pTable, key),
-                load(x_begin(pTable, key),
-                  load(rows_begin(pTable, key), address)));
-}
-
-
 eeprom_address_t StorageClass::write_block(eeprom_address_t address, const void *__p_block, uint16_t _blk_size)
 {
 #if defined(USE_FRAM_FOR_STORAGE)
@@ -379,16 +371,6 @@ write_location StorageClass::write(table_axis_iterator it, write_location locati
  }
 
 
-write_location StorageClass::writeTable(void *pTable, table_type_t key, write_location location)
- {
-   return write(y_rbegin(pTable, key),
-                 write(x_begin(pTable, key),
-                   write(rows_begin(pTable, key), location)));
- }
-
-
-
-
 
 eeprom_address_t StorageClass::compute_crc_address(uint8_t pageNum)
 {
@@ -499,6 +481,37 @@ uint32_t StorageClass::readCalibrationCRC32(uint8_t calibrationPageNum)
   return crc32_val;
 }
 
+/** Saves the position the engine stopped at, for fast sync on the next start. See triggerStoreStopPosition()
+@param position - Encoded position
+*/
+void StorageClass::storeTriggerStopPosition(uint16_t position)
+{
+#if defined(USE_FRAM_FOR_STORAGE)
+	write_block(EEPROM_TRIGGER_STOP_POSITION, &position, sizeof(position));
+#endif
+
+#if defined(USE_EEPROM_FOR_STORAGE)
+  EEPROM.put(EEPROM_TRIGGER_STOP_POSITION, position);
+#endif
+}
+
+/** Retrieves the position saved by storeTriggerStopPosition()
+*/
+uint16_t StorageClass::readTriggerStopPosition(void)
+{
+  uint16_t position = 0;
+
+#if defined(USE_FRAM_FOR_STORAGE)
+	load_block(EEPROM_TRIGGER_STOP_POSITION, &position, sizeof(position));
+#endif
+
+#if defined(USE_EEPROM_FOR_STORAGE)
+  EEPROM.get(EEPROM_TRIGGER_STOP_POSITION, position);
+#endif
+
+  return position;
+}
+
 uint16_t StorageClass::getEEPROMSize(void)
 {
 #if defined(USE_FRAM_FOR_STORAGE)
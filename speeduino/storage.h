@@ -106,7 +106,8 @@
  * | 3283       |1           | boostControlEnableThreshold          |                                    |
  * | 3284       |14          | A/C Control Settings                 |                                    |
  * | 3298       |159         | Page 15 spare                        |                                    |
- * | 3457       |217         | EMPTY                                |                                    |
+ * | 3457       |2           | Trigger stop position                | @ref EEPROM_TRIGGER_STOP_POSITION  |
+ * | 3459       |215         | EMPTY                                |                                    |
  * | 3674       |4           | CLT Calibration CRC32                |                                    |
  * | 3678       |4           | IAT Calibration CRC32                |                                    |
  * | 3682       |4           | O2 Calibration CRC32                 |                                    |
@@ -187,6 +188,7 @@ extern uint32_t deferEEPROMWritesUntil;
 #define EEPROM_CONFIG15_START 3281
 #define EEPROM_CONFIG15_END   3457
 
+#define EEPROM_TRIGGER_STOP_POSITION 3457 //Fast sync. Written each time the engine stops, so FRAM is preferred
 
 #define EEPROM_CALIBRATION_CLT_CRC  3674
 #define EEPROM_CALIBRATION_IAT_CRC  3678
@@ -270,11 +272,29 @@ extern uint32_t deferEEPROMWritesUntil;
 	 void storeCalibrationCRC32(uint8_t calibrationPageNum, uint32_t calibrationCRC);
 	 uint32_t readCalibrationCRC32(uint8_t calibrationPageNum);
 
+	 void storeTriggerStopPosition(uint16_t position);
+	 uint16_t readTriggerStopPosition(void);
+
 	 uint16_t getEEPROMSize(void);
 	 bool isEepromWritePending(void);
 
-	 eeprom_address_t loadTable(void *pTable, table_type_t key, eeprom_address_t address);
-	 write_location writeTable(void *pTable, table_type_t key, write_location location);
+	 // The table layout in storage is: values, X axis, Y axis (reversed)
+	 template <typename table_t>
+	 eeprom_address_t loadTable(table_t *pTable, eeprom_address_t address)
+	 {
+		 address = load(pTable->axisY.rbegin(),
+		 			load(pTable->axisX.begin(),
+		 				load(pTable->values.begin(), address)));
+		 table_axes_changed(pTable);
+		 return address;
+	 }
+	 template <typename table_t>
+	 write_location writeTable(table_t *pTable, write_location location)
+	 {
+		 return write(pTable->axisY.rbegin(),
+		 			write(pTable->axisX.begin(),
+		 				write(pTable->values.begin(), location)));
+	 }
      eeprom_address_t load_range(eeprom_address_t address, byte *pFirst, const byte *pLast);
 	 write_location write_range(const byte *pStart, const byte *pEnd, write_location location);
 
@@ -13,6 +13,8 @@ Note that this may clear some of the existing values of the table
 #include "globals.h"
 #endif
 
+uint16_t table2D_generation = 1U; //0 means never calculated, see table2d.h
+
 static void construct2dTable(table2D &table, uint8_t valueSize, uint8_t axisSize, uint8_t length, void *values, void *bins) {
   table.valueSize = valueSize;
   table.axisSize = axisSize;
@@ -20,6 +22,7 @@ static void construct2dTable(table2D &table, uint8_t valueSize, uint8_t axisSize
   table.values = values;
   table.axisX = bins;
   table.lastInput = INT16_MAX;
+  table.cacheGeneration = 0U; //Not calculated yet
   table.lastXMax = INT16_MAX;
   table.lastXMin = INT16_MAX;
 }
@@ -43,14 +46,6 @@ void construct2dTable(table2D &table, uint8_t length, int16_t *values, uint8_t *
   construct2dTable(table, SIZE_INT, SIZE_BYTE, length, values, bins);
 }
 
-static inline uint8_t getCacheTime(void) {
-#if !defined(UNIT_TEST)
-  return currentStatus.secl;
-#else
-  return 0;
-#endif
-}
-
 /*
 This function pulls a 1D linear interpolated (ie averaged) value from a 2D table
 ie: Given a value on the X axis, it returns a Y value that corresponds to the point on the curve between the nearest two defined X values
@@ -70,7 +65,7 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
   int xMax = fromTable->xSize-1;
 
   //Check whether the X input is the same as last time this ran
-  if( (X_in == fromTable->lastInput) && (fromTable->cacheTime == getCacheTime()) )
+  if( (X_in == fromTable->lastInput) && (fromTable->cacheGeneration == table2D_generation) )
   {
     returnValue = fromTable->lastOutput;
     valueFound = true;
@@ -89,8 +84,6 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
   //Finally if none of that is found
   else
   {
-    fromTable->cacheTime = getCacheTime(); //As we're not using the cache value, set the current secl value to track when this new value was calculated
-
     //1st check is whether we're still in the same X bin as last time
     xMaxValue = table2D_getAxisValue(fromTable, fromTable->lastXMax);
     xMinValue = table2D_getAxisValue(fromTable, fromTable->lastXMin);
@@ -148,6 +141,7 @@ int table2D_getValue(struct table2D *fromTable, int X_in)
 
   fromTable->lastInput = X_in;
   fromTable->lastOutput = returnValue;
+  fromTable->cacheGeneration = table2D_generation;
 
   return returnValue;
 }
@@ -33,9 +33,24 @@ struct table2D {
   //Store the last input and output for caching
   int16_t lastInput;
   int16_t lastOutput;
-  byte cacheTime; //Tracks when the last cache value was set so it can expire after x seconds. A timeout is required to pickup when a tuning value is changed, otherwise the old cached value will continue to be returned as the X value isn't changing. 
+  uint16_t cacheGeneration; //The value of table2D_generation when lastOutput was calculated. The cached value is only used while this matches, so that a tuning change is picked up straight away even though the X value isn't changing
 };
 
+/*
+2D tables are built directly over arrays in the config pages and calibration data, so there is no link from a byte
+written by TS back to the table(s) using it. Instead all 2D tables share one generation counter, which is bumped
+whenever any of that data changes. This is rare (Only while tuning) so recalculating every 2D table then costs nothing.
+Generation 0 is never used, so a table that has never been calculated (cacheGeneration 0, as a zero initialised or
+newly constructed table has) can't be mistaken for a cached one.
+*/
+extern uint16_t table2D_generation;
+/** @brief Marks the cached value of every 2D table as stale. Call whenever config page or calibration data changes */
+static inline void table2D_invalidateAll(void)
+{
+  table2D_generation++;
+  if(table2D_generation == 0U) { table2D_generation = 1U; } //Skip 0 on wrap, see above
+}
+
 void construct2dTable(table2D &table, uint8_t length, uint8_t *values, uint8_t *bins);
 void construct2dTable(table2D &table, uint8_t length, uint8_t *values, int8_t *bins);
 void construct2dTable(table2D &table, uint8_t length, uint16_t *values, uint16_t *bins);
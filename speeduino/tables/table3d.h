@@ -49,81 +49,51 @@
 #include "table3d_axes.h"
 #include "table3d_values.h"
 
-#define TO_TYPE_KEY(size, xDom, yDom) table3d ## size ## xDom ## yDom ## _key
-
-/**
- * @brief Table \b type identifiers. Limited compile time RTTI
- * 
- * With no virtual functions (they have quite a bit of overhead in both space & 
- * time), we have to pass void* around in certain cases. In order to cast that 
- * back to a concrete table type, we need to somehow identify the type.
- * 
- * Once approach is to register each type - but that requires a central registry
- * which will use RAM.
- * 
- * Since we have a compile time fixed set of table types, we can map a unique
- * identifier to the type via a cast - this enum is that unique identifier.
+/** 
+ * @brief A 3D table with size x size dimensions, xDom x-axis and yDom y-axis
  * 
- * Typically used in conjunction with the '#CONCRETE_TABLE_ACTION' macro
+ * The member order is significant: TS pages & storage iterate over the values,
+ * then the X axis, then the Y axis.
  */
-enum table_type_t {
-    table_type_None,
-    #define TABLE3D_GEN_TYPEKEY(size, xDom, yDom) TO_TYPE_KEY(size, xDom, yDom),
-    TABLE3D_GENERATOR(TABLE3D_GEN_TYPEKEY)
-};
+template <table3d_dim_t size, axis_domain xDom, axis_domain yDom>
+struct table3d_t
+{
+    typedef table3d_axis<size, xDom> xaxis_t;
+    typedef table3d_axis<size, yDom> yaxis_t;
+    typedef table3d_values<size> value_t;
 
-// Generate the 3D table types
-#define TABLE3D_GEN_TYPE(size, xDom, yDom) \
-    /** @brief A 3D table with size x size dimensions, xDom x-axis and yDom y-axis */ \
-    struct TABLE3D_TYPENAME_BASE(size, xDom, yDom) \
-    { \
-        typedef TABLE3D_TYPENAME_AXIS(size, xDom) xaxis_t; \
-        typedef TABLE3D_TYPENAME_AXIS(size, yDom) yaxis_t; \
-        typedef TABLE3D_TYPENAME_VALUE(size, xDom, yDom) value_t; \
-        /* This will take up zero space unless we take the address somewhere */ \
-        static constexpr table_type_t type_key = TO_TYPE_KEY(size, xDom, yDom); \
-        \
-        table3DGetValueCache get_value_cache; \
-        value_t values; \
-        xaxis_t axisX; \
-        yaxis_t axisY; \
-    };
-TABLE3D_GENERATOR(TABLE3D_GEN_TYPE)
-
-// Generate get3DTableValue() functions
-#define TABLE3D_GEN_GET_TABLE_VALUE(size, xDom, yDom) \
-    static inline table3d_value_t get3DTableValue(TABLE3D_TYPENAME_BASE(size, xDom, yDom) *pTable, table3d_axis_t y, table3d_axis_t x) \
-    { \
-      return get3DTableValue( &pTable->get_value_cache, \
-                              TABLE3D_TYPENAME_BASE(size, xDom, yDom)::value_t::row_size, \
-                              pTable->values.values, \
-                              pTable->axisX.axis, \
-                              pTable->axisY.axis, \
-                              y, x); \
-    } 
-TABLE3D_GENERATOR(TABLE3D_GEN_GET_TABLE_VALUE)
-
-// =============================== Table function calls =========================
-
-// With no templates or inheritance we need some way to call functions
-// for the various distinct table types. CONCRETE_TABLE_ACTION dispatches
-// to a caller defined function overloaded by the type of the table. 
-#define CONCRETE_TABLE_ACTION_INNER(size, xDomain, yDomain, action, ...) \
-  case TO_TYPE_KEY(size, xDomain, yDomain): action(size, xDomain, yDomain, ##__VA_ARGS__);
-#define CONCRETE_TABLE_ACTION(testKey, action, defaultAction, ...) \
-  switch ((table_type_t)testKey) { \
-  TABLE3D_GENERATOR(CONCRETE_TABLE_ACTION_INNER, action, ##__VA_ARGS__ ) \
-  default: defaultAction; }
-
-// =============================== Table function calls =========================
-
-table_value_iterator rows_begin(void *pTable, table_type_t key);
+    table3DGetValueCache get_value_cache;
+    value_t values;
+    xaxis_t axisX;
+    yaxis_t axisY;
+};
 
-table_axis_iterator x_begin(void *pTable, table_type_t key);
+typedef table3d_t<6U, axis_domain_Rpm, axis_domain_Load> table3d6RpmLoad;
+typedef table3d_t<4U, axis_domain_Rpm, axis_domain_Load> table3d4RpmLoad;
+typedef table3d_t<8U, axis_domain_Rpm, axis_domain_Load> table3d8RpmLoad;
+typedef table3d_t<8U, axis_domain_Rpm, axis_domain_Tps> table3d8RpmTps;
+typedef table3d_t<16U, axis_domain_Rpm, axis_domain_Load> table3d16RpmLoad;
 
-table_axis_iterator x_rbegin(void *pTable, table_type_t key);
+/** @brief Lookup a value from a 3D table. See get3DTableValue(table3DGetValueCache*, ...) */
+template <table3d_dim_t size, axis_domain xDom, axis_domain yDom>
+static inline table3d_value_t get3DTableValue(table3d_t<size, xDom, yDom> *pTable, table3d_axis_t y, table3d_axis_t x)
+{
+    return get3DTableValue<size>( &pTable->get_value_cache, 
+                            pTable->values.values, 
+                            pTable->axisX.axis, 
+                            pTable->axisX.bin_recip, 
+                            pTable->axisY.axis, 
+                            pTable->axisY.bin_recip, 
+                            y, x);
+}
 
-table_axis_iterator y_begin(void *pTable, table_type_t key);
+/** @brief Call after changing a table's axes directly (rather than via TS page writes or storage) */
+template <table3d_dim_t size, axis_domain xDom, axis_domain yDom>
+static inline void table_axes_changed(table3d_t<size, xDom, yDom> *pTable)
+{
+    invalidate_cache(&pTable->get_value_cache);
+    pTable->axisX.rebuild_reciprocals();
+    pTable->axisY.rebuild_reciprocals();
+}
 
-table_axis_iterator y_rbegin(void *pTable, table_type_t key);
 /** @} */
@@ -81,41 +81,62 @@ private:
     const axis_domain _domain;
 };
 
-#define TABLE3D_TYPENAME_AXIS(size, domain) table3d ## size ## domain ## _axis
-
-#define TABLE3D_GEN_AXIS(size, dom) \
-    /** @brief The dxis for a 3D table with size x size dimensions and domain 'domain' */ \
-    struct TABLE3D_TYPENAME_AXIS(size, dom) { \
-        /** @brief The length of the axis in elements */ \
-        static constexpr table3d_dim_t length = (size); \
-        /** @brief The domain the axis represents */ \
-        static constexpr axis_domain domain = axis_domain_ ## dom; \
-        /**
-          @brief The axis elements\
-        */ \
-        table3d_axis_t axis[(size)]; \
-        \
-        /** @brief Iterate over the axis elements */ \
-        table_axis_iterator begin(void) \
-        {  \
-            return table_axis_iterator(axis+(size)-1, axis, domain); \
-        } \
-        /** @brief Iterate over the axis elements, from largest to smallest */ \
-        table_axis_iterator rbegin(void) \
-        {  \
-            return table_axis_iterator(axis, axis+(size)-1, domain); \
-        } \
-    };
-
-// This generates the axis types for the following sizes & domains:
-TABLE3D_GEN_AXIS(6, Rpm)
-TABLE3D_GEN_AXIS(6, Load)
-TABLE3D_GEN_AXIS(4, Rpm)
-TABLE3D_GEN_AXIS(4, Load)
-TABLE3D_GEN_AXIS(8, Rpm)
-TABLE3D_GEN_AXIS(8, Load)
-TABLE3D_GEN_AXIS(8, Tps)
-TABLE3D_GEN_AXIS(16, Rpm)
-TABLE3D_GEN_AXIS(16, Load)
-
-/** @} */
\ No newline at end of file
+/**
+ * @brief Rebuild the bin width reciprocals for an axis
+ * 
+ * Interpolation needs the position of a value within its bin as a fraction of the
+ * bin width. Dividing by the width on every lookup is slow on 8-bit hardware, so
+ * each bin keeps a reciprocal of its width, turning the division into multiplies
+ * & shifts. These must be rebuilt whenever any axis element changes.
+ * 
+ * @param pAxis The axis elements (stored largest first)
+ * @param pRecips One reciprocal per bin - i.e. length-1 elements
+ * @param length The length of the axis in elements
+ */
+void build_bin_reciprocals(const table3d_axis_t *pAxis, table3d_bin_recip_t *pRecips, table3d_dim_t length);
+
+/**
+ * @brief Incremented by build_bin_reciprocals(), i.e. whenever any 3D table axis changes.
+ * 
+ * Lets anything derived from the axes of several tables (see table3d_shared_axes) 
+ * detect that it is stale without each writer needing to know about it.
+ */
+extern uint16_t table3D_axisGeneration;
+
+/** @brief The axis for a 3D table with size elements and domain 'dom' */
+template <table3d_dim_t size, axis_domain dom>
+struct table3d_axis {
+    static_assert(size>1U, "An axis needs at least one bin");
+
+    /** @brief The length of the axis in elements */
+    static constexpr table3d_dim_t length = size;
+    /** @brief The domain the axis represents */
+    static constexpr axis_domain domain = dom;
+    /**
+      @brief The axis elements
+    */
+    table3d_axis_t axis[size];
+    /**
+      @brief Reciprocal of each bin width: bin_recip[n] is for the bin axis[n+1]..axis[n]
+    */
+    table3d_bin_recip_t bin_recip[size-1U];
+
+    /** @brief Rebuild bin_recip[] after changing the axis elements */
+    void rebuild_reciprocals(void)
+    {
+        build_bin_reciprocals(axis, bin_recip, size);
+    }
+
+    /** @brief Iterate over the axis elements */
+    table_axis_iterator begin(void)
+    {
+        return table_axis_iterator(axis+size-1, axis, domain);
+    }
+    /** @brief Iterate over the axis elements, from largest to smallest */
+    table_axis_iterator rbegin(void)
+    {
+        return table_axis_iterator(axis, axis+size-1, domain);
+    }
+};
+
+/** @} */
@@ -1,96 +1,8 @@
 #include "table3d_interpolate.h"
+#include "table3d_axes.h"
 #include "maths.h"
 
 
-// ============================= Axis Bin Searching =========================
-
-static inline bool is_in_bin(const table3d_axis_t &testValue, const table3d_axis_t &min, const table3d_axis_t &max)
-{
-  return testValue > min && testValue <= max;
-}
-
-// Find the axis index for the top of the bin that covers the test value.
-// E.g. 4 in { 1, 3, 5, 7, 9 } would be 2
-// We assume the axis is in order.
-static inline table3d_dim_t find_bin_max(
-  table3d_axis_t &value,        // Value to search for
-  const table3d_axis_t *pAxis,  // The axis to search
-  table3d_dim_t minElement,     // Axis index of the element with the lowest value (at one end of the array)
-  table3d_dim_t maxElement,     // Axis index of the element with the highest value (at the other end of the array)
-  table3d_dim_t lastBinMax)     // The last result from this call - used to speed up searches
-{
-  // It's quicker to increment/adjust this pointer than to repeatedly 
-  // index the array - minimum 2%, often >5%
-  const table3d_axis_t *pMax = nullptr;
-  // minElement is at one end of the array, so the "lowest" bin 
-  // is [minElement, minElement+stride]. Since we're working with the upper
-  // index of the bin pair, we can't go below minElement + stride.
-  table3d_dim_t minBinIndex = minElement - 1U;
-
-  // Check the cached last bin and either side first - it's likely that this will give a hit under
-  // real world conditions
-
-  // Check if we're still in the same bin as last time
-  pMax = pAxis + lastBinMax;
-  if (is_in_bin(value, *(pMax + 1U), *pMax))
-  {
-    return lastBinMax;
-  }
-  // Check the bin above the last one
-  pMax = pMax + 1U;
-  if (lastBinMax!=minBinIndex && is_in_bin(value, *(pMax + 1U), *pMax))
-  {
-    return lastBinMax + 1U;    
-  }
-  // Check the bin below the last one
-  pMax -= 2U;
-  if (lastBinMax!=maxElement && is_in_bin(value, *(pMax + 1U), *pMax))
-  {
-    return lastBinMax - 1U;
-  }
-
-  // Check if outside array limits - won't happen often in the real world
-  // so check after the cache check
-  // At or above maximum - clamp to final value
-  if (value>=pAxis[maxElement])
-  {
-    value = pAxis[maxElement];
-    return maxElement;
-  }
-  // At or below minimum - clamp to lowest value
-  if (value<=pAxis[minElement])
-  {
-    value = pAxis[minElement];
-    return minElement - 1U;
-  }
-
-  // No hits above, so run a linear search.
-  // We start at the maximum & work down, rather than looping from [0] up to [max]
-  // This is because the important tables (fuel and injection) will have the highest
-  // RPM at the top of the X axis, so starting there will mean the best case occurs 
-  // when the RPM is highest (and hence the CPU is needed most)
-  lastBinMax = maxElement;
-  pMax = pAxis + lastBinMax;
-  while (lastBinMax!=minBinIndex && !is_in_bin(value, *(pMax + 1U), *pMax))
-  {
-    ++lastBinMax;
-    ++pMax;
-  }
-  return lastBinMax;
-}
-
-table3d_dim_t find_xbin(table3d_axis_t &value, const table3d_axis_t *pAxis, table3d_dim_t size, table3d_dim_t lastBin)
-{
-  return find_bin_max(value, pAxis, size-1U, 0U, lastBin);
-}
-
-table3d_dim_t find_ybin(table3d_axis_t &value, const table3d_axis_t *pAxis, table3d_dim_t size, table3d_dim_t lastBin)
-{
-  // Y axis is stored in reverse for performance purposes (not sure that's still valid). 
-  // The minimum value is at the end & max at the start. So need to adjust for that. 
-  return find_bin_max(value, pAxis, size-1U, 0U, lastBin);
-}
-
 // ========================= Fixed point math =========================
 
 // An unsigned fixed point number type with 1 integer bit & 8 fractional bits.
@@ -126,7 +38,41 @@ static inline QU1X8_t mulQU1X8(QU1X8_t a, QU1X8_t b)
 
 // ============================= Axis value to bin % =========================
 
-static inline QU1X8_t compute_bin_position(table3d_axis_t value, const table3d_dim_t &bin, const table3d_axis_t *pAxis)
+// Each bin reciprocal is packed into 16 bits:
+//  * Bits 0-11: ceil(2^(RECIP_BITS+shift) / binWidth). Always in the range (2^10, 2^11]
+//  * Bits 12-15: shift, which is floor(log2(binWidth))
+// Normalising the reciprocal this way keeps the multiplication error below 1 for 
+// any bin width (see compute_bin_position()), so 16 bits of storage per bin are enough.
+// A value of zero means there is no reciprocal (zero or negative bin width, or
+// the reciprocals haven't been built) & we fall back to division.
+static constexpr uint8_t RECIP_BITS = 11U;
+static constexpr uint8_t RECIP_SHIFT_POS = 12U;
+static constexpr table3d_bin_recip_t RECIP_MASK = ((table3d_bin_recip_t)1U << RECIP_SHIFT_POS) - 1U;
+
+static inline table3d_bin_recip_t compute_bin_reciprocal(table3d_axis_t binWidth)
+{
+  // A width of 1 can't have a value inside the bin, so needs no reciprocal
+  if (binWidth<2) { return 0U; }
+
+  uint8_t shift = 0U;
+  while (((uint16_t)binWidth >> (shift+1U)) != 0U) { ++shift; }
+  const uint32_t numerator = (uint32_t)1U << (RECIP_BITS+shift);
+  const uint16_t recip = (uint16_t)((numerator + (uint16_t)binWidth - 1U) / (uint16_t)binWidth);
+  return (table3d_bin_recip_t)(((table3d_bin_recip_t)shift << RECIP_SHIFT_POS) | recip);
+}
+
+uint16_t table3D_axisGeneration = 0U;
+
+void build_bin_reciprocals(const table3d_axis_t *pAxis, table3d_bin_recip_t *pRecips, table3d_dim_t length)
+{
+  ++table3D_axisGeneration;
+  for (table3d_dim_t bin=0U; bin<length-1U; ++bin)
+  {
+    pRecips[bin] = compute_bin_reciprocal(pAxis[bin]-pAxis[bin+1U]);
+  }
+}
+
+static inline QU1X8_t compute_bin_position(table3d_axis_t value, const table3d_dim_t &bin, const table3d_axis_t *pAxis, const table3d_bin_recip_t *pRecips)
 {
   table3d_axis_t binMinValue = pAxis[bin+1U];
   if (value==binMinValue) { return 0; }
@@ -138,6 +84,20 @@ static inline QU1X8_t compute_bin_position(table3d_axis_t value, const table3d_d
   // 24.8 fixed point to avoid overflow
   table3d_axis_t binPosition = value - binMinValue;
   uint32_t p = (uint32_t)binPosition << QU1X8_INTEGER_SHIFT;
+
+  const table3d_bin_recip_t packed = pRecips[bin];
+  if (packed!=0U)
+  {
+    // Multiply by the reciprocal instead of dividing. Since the reciprocal is rounded up, 
+    // the result is either exact or one too high: binPosition < 2^(shift+1), so the error
+    // is at most binPosition/2^(RECIP_BITS-8+shift) < 2^(9-RECIP_BITS) < 1.
+    // A single multiply & compare corrects it, giving the same result as the division.
+    const uint8_t shift = (uint8_t)(packed >> RECIP_SHIFT_POS);
+    QU1X8_t q = (QU1X8_t)(((uint32_t)(uint16_t)binPosition * (packed & RECIP_MASK)) >> (RECIP_BITS-QU1X8_INTEGER_SHIFT+shift));
+    if (((uint32_t)q * (uint16_t)binWidth) > p) { --q; }
+    return q;
+  }
+
   // But since we are computing the ratio (0 to 1), p is guaranteed to be
   // less than binWidth and thus the division below will result in a value
   // <=1. So we can reduce the data type from 24.8 (uint32_t) to 1.8 (uint16_t)
@@ -147,32 +107,48 @@ static inline QU1X8_t compute_bin_position(table3d_axis_t value, const table3d_d
 
 // ============================= End internal support functions =========================
 
-//This function pulls a value from a 3D table given a target for X and Y coordinates.
+// Load the 4 values surrounding the bins into the corners
+//  A          B
+//
+//  C          D
+struct table3d_corners {
+  table3d_value_t A, B, C, D;
+};
+
+static inline table3d_corners get_corners(table3d_dim_t axisSize, const table3d_value_t *pValues, table3d_dim_t xBinMax, table3d_dim_t yBinMax)
+{
+    table3d_dim_t rowMax = yBinMax * axisSize;
+    table3d_dim_t rowMin = rowMax + axisSize;
+    table3d_dim_t colMax = axisSize - xBinMax - 1U;
+    table3d_dim_t colMin = colMax - 1U;
+    return { pValues[rowMax + colMin], pValues[rowMax + colMax], pValues[rowMin + colMin], pValues[rowMin + colMax] };
+}
+
+static inline bool is_flat(const table3d_corners &corners)
+{
+  return (corners.A == corners.B) && (corners.A == corners.C) && (corners.A == corners.D);
+}
+
+static inline table3d_value_t blend_corners(const table3d_corners &corners, QU1X8_t p, QU1X8_t q)
+{
+  const QU1X8_t m = mulQU1X8(QU1X8_ONE-p, q);
+  const QU1X8_t n = mulQU1X8(p, q);
+  const QU1X8_t o = mulQU1X8(QU1X8_ONE-p, QU1X8_ONE-q);
+  const QU1X8_t r = mulQU1X8(p, QU1X8_ONE-q);
+  return ( (corners.A * m) + (corners.B * n) + (corners.C * o) + (corners.D * r) ) >> QU1X8_INTEGER_SHIFT;
+}
+
+//Interpolates a value from a 3D table, once get3DTableValue() has found the bins around the X and Y coordinates.
 //It performs a 2D linear interpolation as described in: www.megamanual.com/v22manual/ve_tuner.pdf
-table3d_value_t __attribute__((noclone)) get3DTableValue(struct table3DGetValueCache *pValueCache, 
+table3d_value_t blend3DTableValue(struct table3DGetValueCache *pValueCache, 
                     table3d_dim_t axisSize,
                     const table3d_value_t *pValues,
                     const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
                     const table3d_axis_t *pYAxis,
+                    const table3d_bin_recip_t *pYRecips,
                     table3d_axis_t Y_in, table3d_axis_t X_in)
 {
-    //0th check is whether the same X and Y values are being sent as last time. 
-    // If they are, this not only prevents a lookup of the axis, but prevents the 
-    //interpolation calcs being performed
-    if( X_in == pValueCache->last_lookup.x && 
-        Y_in == pValueCache->last_lookup.y)
-    {
-      return pValueCache->lastOutput;
-    }
-
-    // Assign this here, as we might modify coords below.
-    pValueCache->last_lookup.x = X_in;
-    pValueCache->last_lookup.y = Y_in;
-
-    // Figure out where on the axes the incoming coord are
-    pValueCache->lastXBinMax = find_xbin(X_in, pXAxis, axisSize, pValueCache->lastXBinMax);
-    pValueCache->lastYBinMax = find_ybin(Y_in, pYAxis, axisSize, pValueCache->lastYBinMax);
-
     /*
     At this point we have the 4 corners of the map where the interpolated value will fall in
     Eg: (yMax,xMin)  (yMax,xMax)
@@ -184,30 +160,40 @@ table3d_value_t __attribute__((noclone)) get3DTableValue(struct table3DGetValueC
 
               C          D
     */
-    table3d_dim_t rowMax = pValueCache->lastYBinMax * axisSize;
-    table3d_dim_t rowMin = rowMax + axisSize;
-    table3d_dim_t colMax = axisSize - pValueCache->lastXBinMax - 1U;
-    table3d_dim_t colMin = colMax - 1U;
-    table3d_value_t A = pValues[rowMax + colMin];
-    table3d_value_t B = pValues[rowMax + colMax];
-    table3d_value_t C = pValues[rowMin + colMin];
-    table3d_value_t D = pValues[rowMin + colMax];
+    const table3d_corners corners = get_corners(axisSize, pValues, pValueCache->lastXBinMax, pValueCache->lastYBinMax);
 
     //Check that all values aren't just the same (This regularly happens with things like the fuel trim maps)
-    if( (A == B) && (A == C) && (A == D) ) { pValueCache->lastOutput = A; }
+    if( is_flat(corners) ) { pValueCache->lastOutput = corners.A; }
     else
     {
       //Create some normalised position values
       //These are essentially percentages (between 0 and 1) of where the desired value falls between the nearest bins on each axis
-      const QU1X8_t p = compute_bin_position(X_in, pValueCache->lastXBinMax, pXAxis);
-      const QU1X8_t q = compute_bin_position(Y_in, pValueCache->lastYBinMax, pYAxis);
-
-      const QU1X8_t m = mulQU1X8(QU1X8_ONE-p, q);
-      const QU1X8_t n = mulQU1X8(p, q);
-      const QU1X8_t o = mulQU1X8(QU1X8_ONE-p, QU1X8_ONE-q);
-      const QU1X8_t r = mulQU1X8(p, QU1X8_ONE-q);
-      pValueCache->lastOutput = ( (A * m) + (B * n) + (C * o) + (D * r) ) >> QU1X8_INTEGER_SHIFT;
+      const QU1X8_t p = compute_bin_position(X_in, pValueCache->lastXBinMax, pXAxis, pXRecips);
+      const QU1X8_t q = compute_bin_position(Y_in, pValueCache->lastYBinMax, pYAxis, pYRecips);
+      pValueCache->lastOutput = blend_corners(corners, p, q);
     }
 
     return pValueCache->lastOutput;
 }
+
+void weigh3DTableBins(struct table3DBinLookup *pLookup, 
+                    const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
+                    const table3d_axis_t *pYAxis,
+                    const table3d_bin_recip_t *pYRecips,
+                    table3d_axis_t Y_in, table3d_axis_t X_in)
+{
+    // Unlike get3DTableValue() we always need the weights: at least one
+    // of the tables sharing the lookup probably isn't flat here.
+    pLookup->xWeight = compute_bin_position(X_in, pLookup->lastXBinMax, pXAxis, pXRecips);
+    pLookup->yWeight = compute_bin_position(Y_in, pLookup->lastYBinMax, pYAxis, pYRecips);
+}
+
+table3d_value_t interpolate3DTableValue(const struct table3DBinLookup *pLookup, 
+                    table3d_dim_t axisSize,
+                    const table3d_value_t *pValues)
+{
+    const table3d_corners corners = get_corners(axisSize, pValues, pLookup->lastXBinMax, pLookup->lastYBinMax);
+    if( is_flat(corners) ) { return corners.A; }
+    return blend_corners(corners, pLookup->xWeight, pLookup->yWeight);
+}
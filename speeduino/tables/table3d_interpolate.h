@@ -38,6 +38,162 @@ static inline void invalidate_cache(table3DGetValueCache *pCache)
     pCache->last_lookup.x = INT16_MAX;
 }
 
+// Where a coordinate falls on a pair of axes: the bins it is in & how far
+// across each bin it is. This depends only on the axes, so it can be computed
+// once & shared by any number of tables with identical axes.
+struct table3DBinLookup {
+  // As per table3DGetValueCache
+  table3d_dim_t lastXBinMax = 1;
+  table3d_dim_t lastYBinMax = 1;
+  coord2d last_lookup = { INT16_MAX, INT16_MAX };
+
+  // Position within the X & Y bins, 0 to 1 as 1.8 fixed point
+  uint16_t xWeight;
+  uint16_t yWeight;
+};
+
+static inline void invalidate_bin_lookup(table3DBinLookup *pLookup)
+{
+    pLookup->last_lookup.x = INT16_MAX;
+}
+
+// ============================= Axis Bin Searching =========================
+
+static inline bool is_in_bin(const table3d_axis_t &testValue, const table3d_axis_t &min, const table3d_axis_t &max)
+{
+  return testValue > min && testValue <= max;
+}
+
+// The linear search in find_bin_max(), unrolled at compile time: test bin, then bin+1 and so on.
+// The value is known to be inside the axis, so the last bin needs no test.
+template <table3d_dim_t bin, table3d_dim_t lastBin>
+struct table3d_bin_search
+{
+  static inline __attribute__((always_inline)) table3d_dim_t find(table3d_axis_t value, const table3d_axis_t *pAxis)
+  {
+    if (is_in_bin(value, pAxis[bin+1U], pAxis[bin])) { return bin; }
+    return table3d_bin_search<bin+1U, lastBin>::find(value, pAxis);
+  }
+};
+template <table3d_dim_t lastBin>
+struct table3d_bin_search<lastBin, lastBin>
+{
+  static inline __attribute__((always_inline)) table3d_dim_t find(table3d_axis_t, const table3d_axis_t *)
+  {
+    return lastBin;
+  }
+};
+
+// Find the axis index for the top of the bin that covers the test value.
+// E.g. 4 in { 9, 7, 5, 3, 1 } would be 2
+// The axis is stored largest value first & the size is a compile time constant,
+// so the search is unrolled for each table size.
+template <table3d_dim_t axisSize>
+static inline table3d_dim_t find_bin_max(
+  table3d_axis_t &value,        // Value to search for. Clamped to the axis
+  const table3d_axis_t *pAxis,  // The axis to search
+  table3d_dim_t lastBinMax)     // The last result from this call - used to speed up searches
+{
+  static_assert(axisSize>1U, "An axis needs at least one bin");
+  // Axis index of the element with the lowest value. Since we're working with
+  // the upper index of the bin pair, the "lowest" bin is minElement-1.
+  constexpr table3d_dim_t minElement = axisSize - 1U;
+  constexpr table3d_dim_t minBinIndex = minElement - 1U;
+
+  // Check the cached last bin and either side first - it's likely that this will give a hit under
+  // real world conditions
+
+  // It's quicker to increment/adjust this pointer than to repeatedly 
+  // index the array - minimum 2%, often >5%
+  const table3d_axis_t *pMax = pAxis + lastBinMax;
+  // Check if we're still in the same bin as last time
+  if (is_in_bin(value, *(pMax + 1U), *pMax))
+  {
+    return lastBinMax;
+  }
+  // Check the bin above the last one
+  pMax = pMax + 1U;
+  if (lastBinMax!=minBinIndex && is_in_bin(value, *(pMax + 1U), *pMax))
+  {
+    return lastBinMax + 1U;    
+  }
+  // Check the bin below the last one
+  pMax -= 2U;
+  if (lastBinMax!=0U && is_in_bin(value, *(pMax + 1U), *pMax))
+  {
+    return lastBinMax - 1U;
+  }
+
+  // Check if outside array limits - won't happen often in the real world
+  // so check after the cache check
+  // At or above maximum - clamp to final value
+  if (value>=pAxis[0])
+  {
+    value = pAxis[0];
+    return 0U;
+  }
+  // At or below minimum - clamp to lowest value
+  if (value<=pAxis[minElement])
+  {
+    value = pAxis[minElement];
+    return minBinIndex;
+  }
+
+  // No hits above, so run a linear search.
+  // We start at the maximum & work down, rather than looping from [0] up to [max]
+  // This is because the important tables (fuel and injection) will have the highest
+  // RPM at the top of the X axis, so starting there will mean the best case occurs 
+  // when the RPM is highest (and hence the CPU is needed most)
+  return table3d_bin_search<0U, minBinIndex>::find(value, pAxis);
+}
+
+// ============================= Interpolation =========================
+
+/** @brief Blend a table's values at the bins held in the cache. See get3DTableValue() */
+table3d_value_t blend3DTableValue(struct table3DGetValueCache *pValueCache, 
+                    table3d_dim_t axisSize,
+                    const table3d_value_t *pValues,
+                    const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
+                    const table3d_axis_t *pYAxis,
+                    const table3d_bin_recip_t *pYRecips,
+                    table3d_axis_t y, table3d_axis_t x);
+
+/** @brief Set the X & Y bin weights for the bins held in the lookup. See lookup3DTableBins() */
+void weigh3DTableBins(struct table3DBinLookup *pLookup, 
+                    const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
+                    const table3d_axis_t *pYAxis,
+                    const table3d_bin_recip_t *pYRecips,
+                    table3d_axis_t y, table3d_axis_t x);
+
+/** @brief Locate a coordinate on a pair of axes. Only searches if the coordinate differs from the last one */
+template <table3d_dim_t axisSize>
+static inline void lookup3DTableBins(struct table3DBinLookup *pLookup, 
+                    const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
+                    const table3d_axis_t *pYAxis,
+                    const table3d_bin_recip_t *pYRecips,
+                    table3d_axis_t Y_in, table3d_axis_t X_in)
+{
+    if( X_in == pLookup->last_lookup.x && 
+        Y_in == pLookup->last_lookup.y)
+    {
+      return;
+    }
+    pLookup->last_lookup.x = X_in;
+    pLookup->last_lookup.y = Y_in;
+
+    pLookup->lastXBinMax = find_bin_max<axisSize>(X_in, pXAxis, pLookup->lastXBinMax);
+    pLookup->lastYBinMax = find_bin_max<axisSize>(Y_in, pYAxis, pLookup->lastYBinMax);
+    weigh3DTableBins(pLookup, pXAxis, pXRecips, pYAxis, pYRecips, Y_in, X_in);
+}
+
+/** @brief Interpolate a table's values at the location found by lookup3DTableBins() */
+table3d_value_t interpolate3DTableValue(const struct table3DBinLookup *pLookup, 
+                    table3d_dim_t axisSize,
+                    const table3d_value_t *pValues);
+
 /*
 3D Tables have an origin (0,0) in the top left hand corner. Vertical axis is expressed first.
 Eg: 2x2 table
@@ -50,10 +206,33 @@ Eg: 2x2 table
 (0,0) = 2
 (1,0) = 1
 
+The axis search is compiled per table size. The interpolation is shared by all sizes.
 */
-table3d_value_t get3DTableValue(struct table3DGetValueCache *pValueCache, 
-                    table3d_dim_t axisSize,
+template <table3d_dim_t axisSize>
+static inline table3d_value_t get3DTableValue(struct table3DGetValueCache *pValueCache, 
                     const table3d_value_t *pValues,
                     const table3d_axis_t *pXAxis,
+                    const table3d_bin_recip_t *pXRecips,
                     const table3d_axis_t *pYAxis,
-                    table3d_axis_t y, table3d_axis_t x);
\ No newline at end of file
+                    const table3d_bin_recip_t *pYRecips,
+                    table3d_axis_t Y_in, table3d_axis_t X_in)
+{
+    //0th check is whether the same X and Y values are being sent as last time. 
+    // If they are, this not only prevents a lookup of the axis, but prevents the 
+    //interpolation calcs being performed
+    if( X_in == pValueCache->last_lookup.x && 
+        Y_in == pValueCache->last_lookup.y)
+    {
+      return pValueCache->lastOutput;
+    }
+
+    // Assign this here, as we might modify coords below.
+    pValueCache->last_lookup.x = X_in;
+    pValueCache->last_lookup.y = Y_in;
+
+    // Figure out where on the axes the incoming coord are
+    pValueCache->lastXBinMax = find_bin_max<axisSize>(X_in, pXAxis, pValueCache->lastXBinMax);
+    pValueCache->lastYBinMax = find_bin_max<axisSize>(Y_in, pYAxis, pValueCache->lastYBinMax);
+
+    return blend3DTableValue(pValueCache, axisSize, pValues, pXAxis, pXRecips, pYAxis, pYRecips, Y_in, X_in);
+}
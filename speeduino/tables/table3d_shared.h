@@ -0,0 +1,94 @@
+/** 
+ * @addtogroup table_3d 
+ *  @{
+ */
+
+/** \file
+ * @brief Sharing the axis search between 3D tables that are looked up with the same inputs
+ */
+
+#pragma once
+
+#include <string.h>
+#include "table3d.h"
+
+/**
+ * @brief A group of same typed tables that are always looked up with the same X & Y inputs.
+ * 
+ * E.g. the fuel trim tables are all looked up with fuelLoad & RPM. Tunes 
+ * usually have identical axes for these, in which case searching the axes
+ * for each table is wasted effort: we can search them once for the group &
+ * only blend the values per table.
+ * 
+ * Tables whose axes differ from the first table in the group (or that aren't 
+ * in the group at all) are looked up as normal. Membership is re-checked after
+ * any 3D table axis changes (page write, load from storage etc.)
+ */
+template <typename table_t, uint8_t tableCount>
+class table3d_shared_axes
+{
+public:
+    static_assert(tableCount<=8U, "Group membership is stored as a bit mask");
+
+    /** @brief Construct
+     * @param pTables The tables in the group. The first table's axes are the reference.
+     */
+    explicit table3d_shared_axes(table_t * const *pTables)
+     : _pTables(pTables)
+    {
+    }
+
+    /** @brief Equivalent to get3DTableValue(pTable, y, x) */
+    table3d_value_t getValue(table_t *pTable, table3d_axis_t y, table3d_axis_t x)
+    {
+        if (_axisGeneration!=table3D_axisGeneration) { refresh(); }
+
+        uint8_t index = 0U;
+        while ( (index<tableCount) && (_pTables[index]!=pTable) ) { ++index; }
+        if ( (index==tableCount) || ((_sharedMask & (1U << index))==0U) )
+        {
+            return get3DTableValue(pTable, y, x);
+        }
+
+        const table_t *pReference = _pTables[0];
+        lookup3DTableBins<table_t::value_t::row_size>(&_lookup,
+                            pReference->axisX.axis, pReference->axisX.bin_recip,
+                            pReference->axisY.axis, pReference->axisY.bin_recip,
+                            y, x);
+        return interpolate3DTableValue(&_lookup, table_t::value_t::row_size, pTable->values.values);
+    }
+
+    /** @brief Bit n is set if table n shares the first table's axes */
+    uint8_t sharedMask(void)
+    {
+        if (_axisGeneration!=table3D_axisGeneration) { refresh(); }
+        return _sharedMask;
+    }
+
+private:
+
+    void refresh(void)
+    {
+        _axisGeneration = table3D_axisGeneration;
+        invalidate_bin_lookup(&_lookup);
+
+        const table_t *pReference = _pTables[0];
+        _sharedMask = 1U;
+        for (uint8_t index=1U; index<tableCount; ++index)
+        {
+            if ( (memcmp(_pTables[index]->axisX.axis, pReference->axisX.axis, sizeof(pReference->axisX.axis))==0)
+              && (memcmp(_pTables[index]->axisY.axis, pReference->axisY.axis, sizeof(pReference->axisY.axis))==0) )
+            {
+                _sharedMask |= (uint8_t)(1U << index);
+            }
+        }
+    }
+
+    table_t * const *_pTables;
+    table3DBinLookup _lookup;
+    // Start out of step with table3D_axisGeneration, so the first lookup checks membership
+    uint16_t _axisGeneration = UINT16_MAX;
+    uint8_t _sharedMask = 0U;
+};
+
+/** @} */
@@ -22,6 +22,7 @@ Timers are typically low resolution (Compared to Schedulers), with maximum frequ
 #include "auxiliaries.h"
 #include "comms.h"
 #include "maths.h"
+#include "isrProfiler.h"
 
 #if defined(CORE_AVR)
   #include <avr/wdt.h>
@@ -62,6 +63,18 @@ void initialiseTimers(void)
   tachoOutputFlag = TACHO_INACTIVE;
 }
 
+#if defined(ISR_PROFILING)
+static uint32_t lastOneMSTime = 0;
+//The 1ms timer has no compare value to measure against, so its latency is taken as how far past 1ms after the previous run it started
+static inline uint32_t oneMSLatency(uint32_t entryTime)
+{
+  uint32_t period = entryTime - lastOneMSTime;
+  bool isFirstRun = (lastOneMSTime == 0UL);
+  lastOneMSTime = entryTime;
+  return ( isFirstRun || (period <= 1000UL) ) ? 0UL : (period - 1000UL);
+}
+#endif
+
 static inline void applyOverDwellCheck(IgnitionSchedule &schedule, uint32_t targetOverdwellTime) {
   //Check first whether each spark output is currently on. Only check it's dwell time if it is
   if ((schedule.Status == RUNNING) && (schedule.startTime < targetOverdwellTime)) { 
@@ -78,6 +91,9 @@ ISR(TIMER2_OVF_vect, ISR_NOBLOCK) //cppcheck-suppress misra-c2012-8.2
 void oneMSInterval(void) //Most ARM chips can simply call a function
 #endif
 {
+  ISR_PROFILE_START();
+  ISR_PROFILE_LATENCY_US(ISR_PROFILE_1MS, oneMSLatency(isrEntryTime));
+
   BIT_SET(TIMER_mask, BIT_TIMER_1KHZ);
   ms_counter++;
 
@@ -387,4 +403,6 @@ void oneMSInterval(void) //Most ARM chips can simply call a function
     //Reset Timer2 to trigger in another ~1ms
     TCNT2 = 131;            //Preload timer2 with 100 cycles, leaving 156 till overflow.
 #endif
+
+  ISR_PROFILE_END(ISR_PROFILE_1MS);
 }
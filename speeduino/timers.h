@@ -22,6 +22,11 @@ Hence we will preload the timer with 131 cycles to leave 125 until overflow (1ms
 #include "globals.h"
 
 #define SET_COMPARE(compare, value) compare = (COMPARE_TYPE)(value) // It is important that we cast this to the actual overflow limit of the timer. The compare variables type can be bigger than the timer overflow.
+//The boost, VVT, fan and idle timers. These stay 16-bit on boards that run the schedules from a 32-bit timer (USE_SCHEDULE_TIMER_32BIT), so the board sets AUX_COMPARE_TYPE
+#if !defined(AUX_COMPARE_TYPE)
+  #define AUX_COMPARE_TYPE COMPARE_TYPE
+#endif
+#define SET_AUX_COMPARE(compare, value) compare = (AUX_COMPARE_TYPE)(value)
 
 #if(defined(CORE_TEENSY) || defined(CORE_STM32))
   #define TACHO_PULSE_LOW()         (digitalWrite(pinTachOut, LOW))
@@ -45,7 +50,7 @@ extern volatile unsigned int dwellLimit_uS;
 #if defined (CORE_TEENSY)
   extern IntervalTimer lowResTimer;
   void oneMSInterval(void);
-#elif defined (ARDUINO_ARCH_STM32)
+#elif defined (ARDUINO_ARCH_STM32) || defined(CORE_NATIVE)
   void oneMSInterval(void);
 #endif
 void initialiseTimers(void);
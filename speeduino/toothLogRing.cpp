@@ -0,0 +1,133 @@
+/** \file toothLogRing.cpp
+ * @brief Streaming tooth and composite log. See toothLogRing.h
+ */
+#include "globals.h"
+#include "toothLogRing.h"
+#include <SimplyAtomic.h>
+
+#define TOOTH_LOG_RING_MASK (TOOTH_LOG_RING_SIZE - 1U)
+#define TOOTH_LOG_ENTRY_MAX 6U //A 32-bit value takes up to 5 bytes, plus the status byte
+
+static_assert((TOOTH_LOG_RING_SIZE & TOOTH_LOG_RING_MASK) == 0U, "The ring indexes wrap by masking");
+
+volatile uint16_t toothLogRingOverflows = 0U;
+
+static uint8_t ring[TOOTH_LOG_RING_SIZE];
+static bool ringComposite = false;
+
+//Only written by the trigger interrupts
+static volatile uint16_t ringHead = 0U; //Free running index of the next byte to write
+static volatile uint16_t ringWritten = 0U; //Free running count of the entries written
+static uint32_t ringWriteTime; //Composite logs: time of the last entry written
+
+//Only written by the main loop. The interrupts can land part way through an AVR 16-bit write, so those are made atomic
+static volatile uint16_t ringTail = 0U; //Free running index of the next byte to read
+static volatile uint16_t ringRead = 0U; //Free running count of the entries read
+static uint32_t ringReadTime; //Composite logs: time of the last entry read
+
+void toothLogRingReset(bool composite)
+{
+  ATOMIC()
+  {
+    ringComposite = composite;
+    ringHead = 0U;
+    ringWritten = 0U;
+    ringTail = 0U;
+    ringRead = 0U;
+    ringWriteTime = micros();
+    ringReadTime = ringWriteTime;
+    toothLogRingOverflows = 0U;
+    toothHistoryIndex = 0U;
+    BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY);
+  }
+}
+
+void toothLogRingWrite(uint32_t value, uint8_t status)
+{
+  uint32_t delta = ringComposite ? (value - ringWriteTime) : value;
+  uint8_t entry[TOOTH_LOG_ENTRY_MAX];
+  uint8_t length = 0U;
+  while(delta > 0x7FU)
+  {
+    entry[length++] = (uint8_t)(delta | 0x80U);
+    delta >>= 7;
+  }
+  entry[length++] = (uint8_t)delta;
+  if(ringComposite) { entry[length++] = status; }
+
+  uint16_t head = ringHead;
+  if( (uint16_t)(TOOTH_LOG_RING_SIZE - (uint16_t)(head - ringTail)) < length )
+  {
+    if(toothLogRingOverflows < UINT16_MAX) { toothLogRingOverflows++; }
+    return;
+  }
+
+  for(uint8_t x = 0U; x < length; x++) { ring[(uint16_t)(head + x) & TOOTH_LOG_RING_MASK] = entry[x]; }
+  ringWriteTime = value;
+  ringHead = head + length;
+  ringWritten++; //Must be last, this is what makes the entry visible to the reader
+
+  if((uint16_t)(ringWritten - ringRead) >= TOOTH_LOG_SIZE) { BIT_SET(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
+}
+
+uint16_t toothLogRingAvailable(void)
+{
+  uint16_t written;
+  ATOMIC() { written = ringWritten; }
+  return written - ringRead;
+}
+
+bool toothLogRingRead(uint32_t &value, uint8_t &status)
+{
+  if(toothLogRingAvailable() == 0U) { return false; }
+
+  uint16_t tail = ringTail;
+  uint32_t decoded = 0U;
+  uint8_t shift = 0U;
+  uint8_t data;
+  do
+  {
+    data = ring[tail & TOOTH_LOG_RING_MASK];
+    tail++;
+    decoded |= (uint32_t)(data & 0x7FU) << shift;
+    shift += 7U;
+  } while( (data & 0x80U) != 0U );
+
+  status = 0U;
+  if(ringComposite)
+  {
+    status = ring[tail & TOOTH_LOG_RING_MASK];
+    tail++;
+    ringReadTime += decoded;
+    decoded = ringReadTime;
+  }
+  value = decoded;
+
+  ATOMIC()
+  {
+    ringTail = tail;
+    ringRead++;
+  }
+  return true;
+}
+
+void toothLogRingFill(void)
+{
+  uint32_t value;
+  uint8_t status;
+  while( (toothHistoryIndex < TOOTH_LOG_SIZE) && toothLogRingRead(value, status) )
+  {
+    toothHistory[toothHistoryIndex] = value;
+    compositeLogHistory[toothHistoryIndex] = status;
+    toothHistoryIndex++;
+  }
+}
+
+void toothLogRingBlockSent(void)
+{
+  ATOMIC()
+  {
+    toothHistoryIndex = 0U;
+    if((uint16_t)(ringWritten - ringRead) < TOOTH_LOG_SIZE) { BIT_CLEAR(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); }
+  }
+}
@@ -0,0 +1,59 @@
+/** \file toothLogRing.h
+ * @brief Streaming tooth and composite log
+ *
+ * The trigger interrupts write each logged edge into a single producer, single consumer ring, which the comms drain in
+ * TOOTH_LOG_SIZE blocks (Into toothHistory[] and compositeLogHistory[]) while logging carries on. The log therefore has
+ * no gaps for as long as the comms keep up, rather than being a series of TOOTH_LOG_SIZE snapshots.
+ *
+ * Entries are delta encoded to keep them small: a tooth log entry is the tooth gap, a composite log entry is the uS since
+ * the previous composite entry followed by the status byte. Values are stored 7 bits per byte, least significant first,
+ * with the top bit set on every byte but the last. A gap under 16.4mS takes 2 bytes.
+ *
+ * If the ring fills, new entries are dropped and counted in toothLogRingOverflows. Composite times stay correct across
+ * the drop (The next delta covers it), a tooth log loses those teeth.
+ *
+ * BIT_STATUS1_TOOTHLOG1READY is set once TOOTH_LOG_SIZE entries are waiting, which is what TS polls for.
+ */
+#ifndef TOOTH_LOG_RING_H
+#define TOOTH_LOG_RING_H
+
+#include "globals.h"
+
+#if defined(CORE_AVR)
+  #define TOOTH_LOG_RING_SIZE 256U //Bytes. Must be a power of 2
+#else
+  #define TOOTH_LOG_RING_SIZE 2048U
+#endif
+
+extern volatile uint16_t toothLogRingOverflows; ///< Entries dropped because the ring was full, since the last reset
+
+/** @brief Empties the ring and starts a new log. Must be called before the logger interrupts are attached
+ * @param composite Whether the entries carry a status byte and are timestamps (Composite logs) rather than tooth gaps
+ */
+void toothLogRingReset(bool composite);
+
+/** @brief Adds an entry. Called from the trigger interrupts only
+ * @param value Tooth gap (uS) for a tooth log, micros() of the edge for a composite log
+ * @param status Composite log status byte (COMPOSITE_LOG_PRI etc). Ignored for a tooth log
+ */
+void toothLogRingWrite(uint32_t value, uint8_t status);
+
+/** @brief The number of entries waiting to be read */
+uint16_t toothLogRingAvailable(void);
+
+/** @brief Removes the oldest entry. Called from the main loop only
+ * @param value Tooth gap for a tooth log, micros() of the edge for a composite log
+ * @param status Composite log status byte, 0 for a tooth log
+ * @return false if the ring is empty
+ */
+bool toothLogRingRead(uint32_t &value, uint8_t &status);
+
+/** @brief Moves waiting entries into toothHistory[] and compositeLogHistory[], up to TOOTH_LOG_SIZE. toothHistoryIndex
+ * is left at the number of entries held, for the comms to pad from if TS asks before the block is full */
+void toothLogRingFill(void);
+
+/** @brief Empties toothHistory[] once its block has been sent, and clears BIT_STATUS1_TOOTHLOG1READY unless another full
+ * block is already waiting in the ring */
+void toothLogRingBlockSent(void);
+
+#endif // TOOTH_LOG_RING_H
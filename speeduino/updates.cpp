@@ -20,7 +20,7 @@
 
 void doUpdates(void)
 {
-  #define CURRENT_DATA_VERSION    24
+  #define CURRENT_DATA_VERSION    25
   //Only the latest update for small flash devices must be retained
    #ifndef SMALL_FLASH_MODE
 
@@ -545,16 +545,16 @@ void doUpdates(void)
     // Each table Y axis need to be updated as well if TPS is the source
     if(configPage2.fuelAlgorithm == LOAD_SOURCE_TPS)
     {
-      multiplyTableLoad(&fuelTable,  fuelTable.type_key,  4);
-      multiplyTableLoad(&afrTable,   afrTable.type_key,   4);
-      multiplyTableLoad(&trim1Table, trim1Table.type_key, 4);
-      multiplyTableLoad(&trim2Table, trim2Table.type_key, 4);
-      multiplyTableLoad(&trim3Table, trim3Table.type_key, 4);
-      multiplyTableLoad(&trim4Table, trim4Table.type_key, 4);
-      multiplyTableLoad(&trim5Table, trim5Table.type_key, 4);
-      multiplyTableLoad(&trim6Table, trim6Table.type_key, 4);
-      multiplyTableLoad(&trim7Table, trim7Table.type_key, 4);
-      multiplyTableLoad(&trim8Table, trim8Table.type_key, 4);
+      multiplyTableLoad(&fuelTable, 4);
+      multiplyTableLoad(&afrTable, 4);
+      multiplyTableLoad(&trim1Table, 4);
+      multiplyTableLoad(&trim2Table, 4);
+      multiplyTableLoad(&trim3Table, 4);
+      multiplyTableLoad(&trim4Table, 4);
+      multiplyTableLoad(&trim5Table, 4);
+      multiplyTableLoad(&trim6Table, 4);
+      multiplyTableLoad(&trim7Table, 4);
+      multiplyTableLoad(&trim8Table, 4);
       if(configPage4.sparkMode == IGN_MODE_ROTARY)
       { 
         for(uint8_t x = 0; x < 8; x++)
@@ -563,22 +563,22 @@ void doUpdates(void)
         }
       }
     }
-    if(configPage2.ignAlgorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&ignitionTable, ignitionTable.type_key, 4); }
-    if(configPage10.fuel2Algorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&fuelTable2, fuelTable2.type_key, 4); }
-    if(configPage10.spark2Algorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&ignitionTable2, ignitionTable2.type_key, 4); }
-    multiplyTableLoad(&boostTable, boostTable.type_key, 2); // Boost table used 1.0 previously, so it only needs a 2x multiplier
+    if(configPage2.ignAlgorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&ignitionTable, 4); }
+    if(configPage10.fuel2Algorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&fuelTable2, 4); }
+    if(configPage10.spark2Algorithm == LOAD_SOURCE_TPS) { multiplyTableLoad(&ignitionTable2, 4); }
+    multiplyTableLoad(&boostTable, 2); // Boost table used 1.0 previously, so it only needs a 2x multiplier
 
     if(configPage6.vvtLoadSource == VVT_LOAD_TPS)
     {
       //NOTE: The VVT tables all had 1.0 as the multiply value rather than 2.0 used in all other tables. For this reason they only need to be multiplied by 2 when updating
-      multiplyTableLoad(&vvtTable, vvtTable.type_key, 2);
-      multiplyTableLoad(&vvt2Table, vvt2Table.type_key, 2);
+      multiplyTableLoad(&vvtTable, 2);
+      multiplyTableLoad(&vvt2Table, 2);
     }
     else
     {
       //NOTE: The VVT tables all had 1.0 as the multiply value rather than 2.0 used in all other tables. For this reason they need to be divided by 2 when updating
-      divideTableLoad(&vvtTable, vvtTable.type_key, 2);
-      divideTableLoad(&vvt2Table, vvt2Table.type_key, 2);
+      divideTableLoad(&vvtTable, 2);
+      divideTableLoad(&vvt2Table, 2);
     }
 
 
@@ -665,6 +665,7 @@ void doUpdates(void)
       *table_Y = (120 + 10*i);
       ++table_Y;
     }
+    table_axes_changed(&boostTableLookupDuty);
 
     //AFR Protection added, add default values
     configPage9.afrProtectEnabled = 0; //Disable by default
@@ -789,6 +790,41 @@ void doUpdates(void)
     writeAllConfig();
     storeEEPROMVersion(24);
   }
+
+  if(readEEPROMVersion() == 24)
+  {
+    //Split injection added. Off by default, with 2 even pulses 90 degrees apart when it is turned on
+    configPage15.splitInjEnable = false;
+    configPage15.splitInjPulses = 0;
+    configPage15.splitInjUnused = 0;
+    configPage15.splitInjMaxRPM = 30; //3000 RPM
+    configPage15.splitInjBins[0] = -10 + CALIBRATION_TEMPERATURE_OFFSET;
+    configPage15.splitInjBins[1] = 10 + CALIBRATION_TEMPERATURE_OFFSET;
+    configPage15.splitInjBins[2] = 40 + CALIBRATION_TEMPERATURE_OFFSET;
+    configPage15.splitInjBins[3] = 70 + CALIBRATION_TEMPERATURE_OFFSET;
+    for(byte x=0U; x<4U; x++)
+    {
+      configPage15.splitInjPercent2[x] = 50;
+      configPage15.splitInjPercent3[x] = 0;
+      configPage15.splitInjAngle2[x] = 90;
+      configPage15.splitInjAngle3[x] = 90;
+    }
+
+    //Multi-spark added. Off by default
+    configPage15.multiSparkEnable = false;
+    configPage15.multiSparkCount = 3;
+    configPage15.multiSparkUnused = 0;
+    configPage15.multiSparkMaxRPMdiv10 = 60; //600 RPM
+    configPage15.multiSparkAngle = 20;
+    configPage15.multiSparkDwell = 10; //1ms
+
+    //Fast sync added. Off by default
+    configPage15.fastSyncEnable = false;
+    configPage15.fastSyncUnused = 0;
+
+    writeAllConfig();
+    storeEEPROMVersion(25);
+  }
   
   //Final check is always for 255 and 0 (Brand new arduino)
   if( (readEEPROMVersion() == 0) || (readEEPROMVersion() == 255) )
@@ -814,26 +850,6 @@ void doUpdates(void)
   if( readEEPROMVersion() > CURRENT_DATA_VERSION ) { storeEEPROMVersion(CURRENT_DATA_VERSION); }
 }
 
-void multiplyTableLoad(void *pTable, table_type_t key, uint8_t multiplier)
-{
-  auto y_it = y_begin(pTable, key);
-  while(!y_it.at_end())
-  {
-    *y_it = *y_it * multiplier; 
-    ++y_it;
-  }
-}
-
-void divideTableLoad(void *pTable, table_type_t key, uint8_t divisor)
-{
-  auto y_it = y_begin(pTable, key);
-  while(!y_it.at_end())
-  {
-    *y_it = *y_it / divisor; //Previous TS scale was 2.0, now is 0.5, 4x increase
-    ++y_it;
-  }
-}
-
 void multiplyTableValue(uint8_t pageNum, uint8_t multiplier)
 {
   uint16_t count = getPageSize(pageNum);
@@ -4,9 +4,33 @@
 #include "tables/table3d.h"
 
 void doUpdates(void);
-void multiplyTableLoad(void *pTable, table_type_t key, uint8_t multiplier); //Added 202201 - to update the table Y axis as TPS now works at 0.5% increments. Multiplies the load axis values by 4 (most tables) or by 2 (VVT table)
-void divideTableLoad(void *pTable, table_type_t key, uint8_t divisor); //Added 202201 - to update the table Y axis as TPS now works at 0.5% increments. This should only be needed by the VVT tables when using MAP as load. 
 void multiplyTableValue(uint8_t pageNum, uint8_t multiplier); //Added to update the table values. Multiplies the value by the multiplier
 void divideTableValue(uint8_t pageNum, uint8_t divisor); //Added to update the table values. Divide the value by divisor
 
+//Added 202201 - to update the table Y axis as TPS now works at 0.5% increments. Multiplies the load axis values by 4 (most tables) or by 2 (VVT table)
+template <typename table_t>
+void multiplyTableLoad(table_t *pTable, uint8_t multiplier)
+{
+  auto y_it = pTable->axisY.begin();
+  while(!y_it.at_end())
+  {
+    *y_it = *y_it * multiplier; 
+    ++y_it;
+  }
+  table_axes_changed(pTable);
+}
+
+//Added 202201 - to update the table Y axis as TPS now works at 0.5% increments. This should only be needed by the VVT tables when using MAP as load. 
+template <typename table_t>
+void divideTableLoad(table_t *pTable, uint8_t divisor)
+{
+  auto y_it = pTable->axisY.begin();
+  while(!y_it.at_end())
+  {
+    *y_it = *y_it / divisor; //Previous TS scale was 2.0, now is 0.5, 4x increase
+    ++y_it;
+  }
+  table_axes_changed(pTable);
+}
+
 #endif
@@ -0,0 +1,290 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "config.h"
+#include "init.h"
+#include "engine.h"
+#include "scheduler.h"
+#include "crankMaths.h"
+#include "schedule_calcs.h"
+#include "utilities.h"
+#include "test_inj_timing.h"
+
+/*
+Checks the injector start angles, staging and fuel trims set by calculateInjTiming() and the schedules that
+scheduleFuel() and scheduleIgnition() then arm.
+*/
+
+extern void construct2dTables(void);
+extern void calculateInjTiming(void);
+extern void scheduleFuel(void);
+extern void scheduleIgnition(void);
+extern int16_t getInjectorStartAngle(uint8_t channel);
+extern uint8_t ignitionChannelsOn;
+
+#define TEST_INJ_ANGLE    355U
+#define TEST_REV_TIME     36000UL //100uS per degree, so the pulse widths below convert to whole degrees
+#define TEST_PW           10000U  //100 degrees
+#define TEST_STAGED_PW    5000U   //50 degrees
+
+static void fillTrimTable(trimTable3d &table, uint8_t value)
+{
+    table_axis_iterator itX = table.axisX.begin();
+    for (uint8_t bin = 0; !itX.at_end(); ++bin, ++itX) { *itX = (table3d_axis_t)(5U + (bin * 10U)); }
+    table_axis_iterator itY = table.axisY.begin();
+    for (uint8_t bin = 0; !itY.at_end(); ++bin, ++itY) { *itY = (table3d_axis_t)(20U + (bin * 20U)); }
+    table_axes_changed(&table);
+    table_value_iterator itZ = table.values.begin();
+    while (!itZ.at_end())
+    {
+        table_row_iterator itRow = *itZ;
+        while (!itRow.at_end()) { *itRow = value; ++itRow; }
+        ++itZ;
+    }
+}
+
+static void setupInjection(uint8_t layout, bool staging)
+{
+    nativeReset();
+    resetConfigPages();
+    configPage2.nCylinders = 4;
+    configPage2.strokes = FOUR_STROKE;
+    configPage2.engineType = EVEN_FIRE;
+    configPage2.divider = 2;
+    configPage2.injTiming = true;
+    configPage2.injLayout = layout;
+    configPage10.stagingEnabled = staging;
+    for (uint8_t bin = 0; bin < _countof(configPage2.injAng); bin++)
+    {
+        configPage2.injAng[bin] = TEST_INJ_ANGLE;
+        configPage2.injAngRPM[bin] = 10U + (bin * 20U);
+    }
+    setPinMapping(3);
+    construct2dTables();
+    initialiseSchedulers();
+    inj_opentime_uS = 1000U;
+    engineInit();
+
+    currentStatus.RPM = 1667U;
+    currentStatus.RPMdiv100 = 16U;
+    currentStatus.fuelLoad = 50;
+    currentStatus.hasSync = (layout == INJ_SEQUENTIAL);
+    BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+    BIT_CLEAR(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE);
+    setAngleConverterRevolutionTime(TEST_REV_TIME);
+
+    currentStatus.PW1 = TEST_PW;
+    currentStatus.PW2 = TEST_PW;
+    currentStatus.PW3 = TEST_PW;
+    currentStatus.PW4 = TEST_PW;
+    currentStatus.PW5 = TEST_STAGED_PW;
+    currentStatus.PW6 = TEST_STAGED_PW;
+    currentStatus.PW7 = TEST_STAGED_PW;
+    currentStatus.PW8 = TEST_STAGED_PW;
+}
+
+//The start angle is the injection angle, offset by the channel, less the degrees that the pulse width takes
+static void test_inj_timing_paired(void)
+{
+    setupInjection(INJ_PAIRED, false);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(360, CRANK_ANGLE_MAX_INJ);
+    TEST_ASSERT_EQUAL(TEST_INJ_ANGLE, currentStatus.injAngle);
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    TEST_ASSERT_EQUAL(75, getInjectorStartAngle(1)); //435 wrapped over 360 degrees
+    //Only 2 channels are used
+    TEST_ASSERT_EQUAL(0, getInjectorStartAngle(2));
+    TEST_ASSERT_EQUAL(0, getInjectorStartAngle(3));
+}
+
+static void test_inj_timing_semi_sequential(void)
+{
+    setupInjection(INJ_SEMISEQUENTIAL, false);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(360, CRANK_ANGLE_MAX_INJ);
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    TEST_ASSERT_EQUAL(75, getInjectorStartAngle(1));
+    TEST_ASSERT_EQUAL(0, getInjectorStartAngle(2));
+}
+
+static void test_inj_timing_sequential(void)
+{
+    setupInjection(INJ_SEQUENTIAL, false);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(720, CRANK_ANGLE_MAX_INJ);
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    TEST_ASSERT_EQUAL(435, getInjectorStartAngle(1));
+    TEST_ASSERT_EQUAL(615, getInjectorStartAngle(2));
+    TEST_ASSERT_EQUAL(75, getInjectorStartAngle(3)); //795 wrapped over 720 degrees
+}
+
+//Sequential runs paired on the first 2 channels over 360 degrees until full sync is gained
+static void test_inj_timing_sequential_half_sync(void)
+{
+    setupInjection(INJ_SEQUENTIAL, false);
+    currentStatus.hasSync = false;
+    BIT_SET(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(360, CRANK_ANGLE_MAX_INJ);
+    TEST_ASSERT_EQUAL(2, maxInjOutputs);
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    TEST_ASSERT_EQUAL(75, getInjectorStartAngle(1));
+    TEST_ASSERT_EQUAL(0, getInjectorStartAngle(2));
+    TEST_ASSERT_EQUAL(0, getInjectorStartAngle(3));
+}
+
+//The secondaries open at the same angles as their primaries, but with the shorter secondary pulse width
+static void test_inj_timing_staging(void)
+{
+    setupInjection(INJ_SEQUENTIAL, true);
+    BIT_SET(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    TEST_ASSERT_EQUAL(75, getInjectorStartAngle(3));
+    TEST_ASSERT_EQUAL(305, getInjectorStartAngle(4));
+    TEST_ASSERT_EQUAL(485, getInjectorStartAngle(5));
+    TEST_ASSERT_EQUAL(665, getInjectorStartAngle(6));
+    TEST_ASSERT_EQUAL(125, getInjectorStartAngle(7));
+}
+
+//The secondary angles are left alone while staging is inactive
+static void test_inj_timing_staging_inactive(void)
+{
+    setupInjection(INJ_SEQUENTIAL, true);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+    for (uint8_t x = 4; x < 8; x++) { TEST_ASSERT_EQUAL(0, getInjectorStartAngle(x)); }
+}
+
+static void setupTrims(void)
+{
+    configPage6.fuelTrimEnabled = true;
+    fillTrimTable(trim1Table, OFFSET_FUELTRIM + 10U);
+    fillTrimTable(trim2Table, OFFSET_FUELTRIM);
+    fillTrimTable(trim3Table, OFFSET_FUELTRIM - 10U);
+    fillTrimTable(trim4Table, OFFSET_FUELTRIM + 20U);
+    fillTrimTable(trim5Table, OFFSET_FUELTRIM + 30U);
+    fillTrimTable(trim6Table, OFFSET_FUELTRIM + 30U);
+    fillTrimTable(trim7Table, OFFSET_FUELTRIM + 30U);
+    fillTrimTable(trim8Table, OFFSET_FUELTRIM + 30U);
+}
+
+static void test_inj_timing_trims_sequential(void)
+{
+    setupInjection(INJ_SEQUENTIAL, false);
+    setupTrims();
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(11000U, currentStatus.PW1);
+    TEST_ASSERT_EQUAL(10000U, currentStatus.PW2);
+    TEST_ASSERT_EQUAL(9000U, currentStatus.PW3);
+    TEST_ASSERT_EQUAL(12000U, currentStatus.PW4);
+    //The start angles are worked out from the untrimmed PW1
+    TEST_ASSERT_EQUAL(255, getInjectorStartAngle(0));
+}
+
+//Paired channels each feed 2 cylinders, so there is no per cylinder trim to apply
+static void test_inj_timing_trims_paired(void)
+{
+    setupInjection(INJ_PAIRED, false);
+    setupTrims();
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(TEST_PW, currentStatus.PW1);
+    TEST_ASSERT_EQUAL(TEST_PW, currentStatus.PW2);
+}
+
+//The secondaries keep the shared secondary pulse width
+static void test_inj_timing_trims_staging(void)
+{
+    setupInjection(INJ_SEQUENTIAL, true);
+    setupTrims();
+    BIT_SET(currentStatus.status4, BIT_STATUS4_STAGING_ACTIVE);
+    calculateInjTiming();
+
+    TEST_ASSERT_EQUAL(11000U, currentStatus.PW1);
+    TEST_ASSERT_EQUAL(12000U, currentStatus.PW4);
+    TEST_ASSERT_EQUAL(TEST_STAGED_PW, currentStatus.PW5);
+    TEST_ASSERT_EQUAL(TEST_STAGED_PW, currentStatus.PW8);
+}
+
+//Each channel in use is armed with its own pulse width, the others are left off
+static void test_schedule_fuel_channels(void)
+{
+    setupInjection(INJ_PAIRED, false);
+    calculateInjTiming();
+    scheduleFuel();
+
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule1.Status);
+    TEST_ASSERT_EQUAL(TEST_PW, fuelSchedule1.duration);
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule2.Status);
+    TEST_ASSERT_EQUAL(TEST_PW, fuelSchedule2.duration);
+    TEST_ASSERT_EQUAL(OFF, fuelSchedule3.Status);
+    TEST_ASSERT_EQUAL(OFF, fuelSchedule4.Status);
+}
+
+//A pulse width shorter than the injector opening time is not scheduled
+static void test_schedule_fuel_below_opentime(void)
+{
+    setupInjection(INJ_SEQUENTIAL, false);
+    currentStatus.PW3 = inj_opentime_uS - 1U;
+    calculateInjTiming();
+    scheduleFuel();
+
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule1.Status);
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule2.Status);
+    TEST_ASSERT_EQUAL(OFF, fuelSchedule3.Status);
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule4.Status);
+}
+
+static void test_schedule_ignition_channels(void)
+{
+    setupInjection(INJ_PAIRED, false);
+    currentStatus.dwell = 3000U;
+    ignition1StartAngle = 300;
+    ignition2StartAngle = 120;
+    scheduleFuel(); //Turns the ignition channels on
+    scheduleIgnition();
+
+    TEST_ASSERT_EQUAL(2, maxIgnOutputs);
+    TEST_ASSERT_EQUAL(PENDING, ignitionSchedule1.Status);
+    TEST_ASSERT_EQUAL(3000U, ignitionSchedule1.duration);
+    TEST_ASSERT_EQUAL(PENDING, ignitionSchedule2.Status);
+    TEST_ASSERT_EQUAL(3000U, ignitionSchedule2.duration);
+    TEST_ASSERT_EQUAL(OFF, ignitionSchedule3.Status);
+}
+
+//No ignition is scheduled while the channels are cut
+static void test_schedule_ignition_cut(void)
+{
+    setupInjection(INJ_PAIRED, false);
+    currentStatus.dwell = 3000U;
+    ignition1StartAngle = 300;
+    ignitionChannelsOn = 0;
+    scheduleIgnition();
+
+    TEST_ASSERT_EQUAL(OFF, ignitionSchedule1.Status);
+}
+
+void testInjTiming(void)
+{
+    RUN_TEST(test_inj_timing_paired);
+    RUN_TEST(test_inj_timing_semi_sequential);
+    RUN_TEST(test_inj_timing_sequential);
+    RUN_TEST(test_inj_timing_sequential_half_sync);
+    RUN_TEST(test_inj_timing_staging);
+    RUN_TEST(test_inj_timing_staging_inactive);
+    RUN_TEST(test_inj_timing_trims_sequential);
+    RUN_TEST(test_inj_timing_trims_paired);
+    RUN_TEST(test_inj_timing_trims_staging);
+    RUN_TEST(test_schedule_fuel_channels);
+    RUN_TEST(test_schedule_fuel_below_opentime);
+    RUN_TEST(test_schedule_ignition_channels);
+    RUN_TEST(test_schedule_ignition_cut);
+}
@@ -0,0 +1 @@
+void testInjTiming(void);
@@ -0,0 +1,98 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "config.h"
+#include "init.h"
+#include "speeduino.h"
+#include "engine.h"
+#include "scheduler.h"
+#include "auxiliaries.h"
+#include "decoders.h"
+#include "test_inj_timing.h"
+
+/*
+Checks which stages engineControl() reruns, against the stalled engine that a freshly initialised tune gives, and the
+injection timing and scheduling stages themselves (See test_inj_timing.cpp).
+Native only:
+  pio test -e native -f test_engine
+*/
+
+#define ADVANCE_SENTINEL -99 //Not an advance the load stage can calculate from the default tune
+
+static void setupEngine(void)
+{
+    nativeReset();
+    resetConfigPages();
+    setPinMapping(3);
+    initialiseTriggers();
+    initialiseSchedulers();
+    initialiseFan();
+    initialiseAuxPWM();
+    engineInit();
+
+    //Calculate everything once, as the first loop does
+    engineInputsChanged = 0xFF;
+    loopTimerMask = 0;
+    engineControl();
+}
+
+//The stall check clears the pulse width and VE on every loop, but leaves the advance to the load stage
+static void runWithTimers(uint8_t timerMask)
+{
+    currentStatus.advance = ADVANCE_SENTINEL;
+    loopTimerMask = timerMask;
+    engineControl();
+}
+
+static void test_engine_load_skipped_on_1khz_tick(void)
+{
+    setupEngine();
+
+    runWithTimers(0);
+    TEST_ASSERT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+
+    runWithTimers((1U << BIT_TIMER_1KHZ) | (1U << BIT_TIMER_200HZ) | (1U << BIT_TIMER_50HZ) | (1U << BIT_TIMER_15HZ) | (1U << BIT_TIMER_4HZ) | (1U << BIT_TIMER_1HZ));
+    TEST_ASSERT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+}
+
+static void test_engine_load_rerun_on_taper_ticks(void)
+{
+    setupEngine();
+
+    runWithTimers(1U << BIT_TIMER_10HZ);
+    TEST_ASSERT_NOT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+
+    runWithTimers(1U << BIT_TIMER_30HZ);
+    TEST_ASSERT_NOT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+}
+
+static void test_engine_load_rerun_on_inputs(void)
+{
+    setupEngine();
+
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_SENSORS);
+    runWithTimers(0);
+    TEST_ASSERT_NOT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_TUNE);
+    runWithTimers(0);
+    TEST_ASSERT_NOT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+
+    //A new tooth only reruns the timing stage
+    BIT_SET(engineInputsChanged, ENGINE_INPUT_TOOTH);
+    runWithTimers(0);
+    TEST_ASSERT_EQUAL(ADVANCE_SENTINEL, currentStatus.advance);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_engine_load_skipped_on_1khz_tick);
+    RUN_TEST(test_engine_load_rerun_on_taper_ticks);
+    RUN_TEST(test_engine_load_rerun_on_inputs);
+    testInjTiming();
+    return UNITY_END();
+}
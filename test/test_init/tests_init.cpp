@@ -3,6 +3,7 @@
 #include "init.h"
 #include "../test_utils.h"
 #include "storage.h"
+#include "scheduledIO.h"
 
 void prepareForInitialiseAll(uint8_t boardId);
 
@@ -50,14 +51,14 @@ void test_initialisation_ports(void)
   //Test that all the port values have been set
   prepareForInitialiseAll(3);
   initialiseAll(); //Run the main initialise function
-  TEST_ASSERT_NOT_EQUAL(0, inj1_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, inj2_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, inj3_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, inj4_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, ign1_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, ign2_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, ign3_pin_port);
-  TEST_ASSERT_NOT_EQUAL(0, ign4_pin_port);
+  TEST_ASSERT_NOT_EQUAL(0, injectorOutputs[0].port);
+  TEST_ASSERT_NOT_EQUAL(0, injectorOutputs[1].port);
+  TEST_ASSERT_NOT_EQUAL(0, injectorOutputs[2].port);
+  TEST_ASSERT_NOT_EQUAL(0, injectorOutputs[3].port);
+  TEST_ASSERT_NOT_EQUAL(0, coilOutputs[0].port);
+  TEST_ASSERT_NOT_EQUAL(0, coilOutputs[1].port);
+  TEST_ASSERT_NOT_EQUAL(0, coilOutputs[2].port);
+  TEST_ASSERT_NOT_EQUAL(0, coilOutputs[3].port);
 }
 
 //Test that all mandatory output pins have their mode correctly set to output
@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "isrProfiler.h"
+
+/*
+Checks the ISR profiler histogram bucketing and reset.
+Native only:
+  pio test -e native -f test_isr_profiler
+*/
+
+static void test_isr_histogram_buckets(void)
+{
+    isrProfileReset();
+    isrHistogram_t &histogram = isrProfile[ISR_PROFILE_FUEL].duration;
+
+    isrHistogramAdd(histogram, 0);
+    isrHistogramAdd(histogram, 1);
+    isrHistogramAdd(histogram, 2);
+    isrHistogramAdd(histogram, 3);
+    isrHistogramAdd(histogram, 4);
+    isrHistogramAdd(histogram, 63);
+    isrHistogramAdd(histogram, 64);
+    isrHistogramAdd(histogram, ISR_HISTOGRAM_TOP_US - 1U);
+    isrHistogramAdd(histogram, ISR_HISTOGRAM_TOP_US);
+    isrHistogramAdd(histogram, 100000UL);
+
+    TEST_ASSERT_EQUAL_UINT16(2, histogram.buckets[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, histogram.buckets[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, histogram.buckets[2]);
+    TEST_ASSERT_EQUAL_UINT16(1, histogram.buckets[5]);
+    TEST_ASSERT_EQUAL_UINT16(2, histogram.buckets[6]);
+    TEST_ASSERT_EQUAL_UINT16(2, histogram.buckets[ISR_HISTOGRAM_BUCKETS - 1U]);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, histogram.maxTime);
+}
+
+static void test_isr_histogram_saturates(void)
+{
+    isrProfileReset();
+    isrHistogram_t &histogram = isrProfile[ISR_PROFILE_IGNITION].latency;
+
+    for(uint32_t x = 0; x < (UINT16_MAX + 10UL); x++) { isrHistogramAdd(histogram, 5); }
+
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, histogram.buckets[2]);
+    TEST_ASSERT_EQUAL_UINT16(5, histogram.maxTime);
+}
+
+static void test_isr_profile_reset(void)
+{
+    isrHistogramAdd(isrProfile[ISR_PROFILE_1MS].latency, 20);
+    isrHistogramAdd(isrProfile[ISR_PROFILE_TRIGGER].duration, 20);
+
+    isrProfileReset();
+
+    for(uint8_t bucket = 0; bucket < ISR_HISTOGRAM_BUCKETS; bucket++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(0, isrProfile[ISR_PROFILE_1MS].latency.buckets[bucket]);
+        TEST_ASSERT_EQUAL_UINT16(0, isrProfile[ISR_PROFILE_TRIGGER].duration.buckets[bucket]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, isrProfile[ISR_PROFILE_1MS].latency.maxTime);
+    TEST_ASSERT_EQUAL_UINT16(0, isrProfile[ISR_PROFILE_TRIGGER].duration.maxTime);
+}
+
+static void test_isr_profile_1ms_timer(void)
+{
+    nativeReset();
+    initBoard(); //Starts the 1ms timer
+    nativeAdvanceMicros(1000); //Let the 1ms timer run once so that it has a previous run time
+    isrProfileReset();
+
+    nativeAdvanceMicros(10000);
+
+    //The virtual clock runs the timer exactly on time and doesn't advance while it runs
+    TEST_ASSERT_EQUAL_UINT16(10, isrProfile[ISR_PROFILE_1MS].latency.buckets[0]);
+    TEST_ASSERT_EQUAL_UINT16(10, isrProfile[ISR_PROFILE_1MS].duration.buckets[0]);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_isr_histogram_buckets);
+    RUN_TEST(test_isr_histogram_saturates);
+    RUN_TEST(test_isr_profile_reset);
+    RUN_TEST(test_isr_profile_1ms_timer);
+    return UNITY_END();
+}
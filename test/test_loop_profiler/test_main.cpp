@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "loopProfiler.h"
+
+/*
+Checks the loop profiler statistics using the native board's virtual clock to give each task a known run time.
+Native only:
+  pio test -e native -f test_loop_profiler
+*/
+
+static void runTask(uint8_t task, uint32_t runTime)
+{
+    uint32_t startTime = micros();
+    nativeAdvanceMicros(runTime);
+    loopProfileEnd(task, startTime);
+}
+
+static void test_loop_profiler_min_avg_max(void)
+{
+    nativeReset();
+    loopProfileReset();
+
+    runTask(LOOP_TASK_BOOST, 100);
+    runTask(LOOP_TASK_BOOST, 300);
+    runTask(LOOP_TASK_BOOST, 200);
+    loopProfileLatch();
+
+    TEST_ASSERT_EQUAL_UINT16(100, loopProfile[LOOP_TASK_BOOST].minTime);
+    TEST_ASSERT_EQUAL_UINT16(200, loopProfile[LOOP_TASK_BOOST].avgTime);
+    TEST_ASSERT_EQUAL_UINT16(300, loopProfile[LOOP_TASK_BOOST].maxTime);
+    TEST_ASSERT_EQUAL_UINT16(0, loopProfile[LOOP_TASK_BOOST].overruns);
+    //Tasks that didn't run read as 0
+    TEST_ASSERT_EQUAL_UINT16(0, loopProfile[LOOP_TASK_VVT].maxTime);
+}
+
+static void test_loop_profiler_latch_starts_new_period(void)
+{
+    nativeReset();
+    loopProfileReset();
+
+    runTask(LOOP_TASK_IDLE, 900);
+    loopProfileLatch();
+    runTask(LOOP_TASK_IDLE, 50);
+    loopProfileLatch();
+
+    TEST_ASSERT_EQUAL_UINT16(50, loopProfile[LOOP_TASK_IDLE].minTime);
+    TEST_ASSERT_EQUAL_UINT16(50, loopProfile[LOOP_TASK_IDLE].maxTime);
+
+    loopProfileLatch();
+    TEST_ASSERT_EQUAL_UINT16(0, loopProfile[LOOP_TASK_IDLE].maxTime);
+}
+
+static void test_loop_profiler_overruns(void)
+{
+    nativeReset();
+    loopProfileReset();
+
+    runTask(LOOP_TASK_SD_LOG, LOOP_PROFILE_OVERRUN_US);
+    runTask(LOOP_TASK_SD_LOG, LOOP_PROFILE_OVERRUN_US + 1U);
+    runTask(LOOP_TASK_SD_LOG, 100000UL); //Longer than a uint16 can hold
+    loopProfileLatch();
+    //Overruns are kept across latches
+    loopProfileLatch();
+
+    TEST_ASSERT_EQUAL_UINT16(2, loopProfile[LOOP_TASK_SD_LOG].overruns);
+
+    loopProfileReset();
+    TEST_ASSERT_EQUAL_UINT16(0, loopProfile[LOOP_TASK_SD_LOG].overruns);
+}
+
+static void test_loop_profiler_saturates(void)
+{
+    nativeReset();
+    loopProfileReset();
+
+    runTask(LOOP_TASK_ENGINE, 100000UL);
+    loopProfileLatch();
+
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, loopProfile[LOOP_TASK_ENGINE].maxTime);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, loopProfile[LOOP_TASK_ENGINE].avgTime);
+}
+
+static void test_loop_profiler_slowest_task(void)
+{
+    nativeReset();
+    loopProfileReset();
+
+    runTask(LOOP_TASK_LOOP, 5000); //The whole loop is never reported as the slowest task
+    runTask(LOOP_TASK_30HZ, 2000);
+    runTask(LOOP_TASK_VVT, 1500);
+    runTask(LOOP_TASK_SERIAL, 300);
+    loopProfileLatch();
+
+    TEST_ASSERT_EQUAL_UINT8(LOOP_TASK_30HZ, loopProfileSlowestTask());
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_loop_profiler_min_avg_max);
+    RUN_TEST(test_loop_profiler_latch_starts_new_period);
+    RUN_TEST(test_loop_profiler_overruns);
+    RUN_TEST(test_loop_profiler_saturates);
+    RUN_TEST(test_loop_profiler_slowest_task);
+    return UNITY_END();
+}
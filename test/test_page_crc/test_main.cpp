@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "config.h"
+#include "pages.h"
+#include "page_crc.h"
+
+/*
+Checks that the cached page CRCs track changes to the page data.
+Native only:
+  pio test -e native -f test_page_crc
+*/
+
+static constexpr byte TEST_PAGE = 1U; //veSettingPage, which is all raw bytes
+static constexpr uint16_t TEST_OFFSET = 10U;
+
+static void test_page_crc_cache_matches_calculated(void)
+{
+    invalidateAllPageCRC32();
+    for (uint8_t pageNum = 1U; pageNum < getPageCount(); ++pageNum)
+    {
+        TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(pageNum), getPageCRC32(pageNum));
+    }
+}
+
+static void test_page_crc_set_value_invalidates(void)
+{
+    byte original = getPageValue(TEST_PAGE, TEST_OFFSET);
+    uint32_t before = getPageCRC32(TEST_PAGE);
+
+    setPageValue(TEST_PAGE, TEST_OFFSET, original + 1U);
+    uint32_t after = getPageCRC32(TEST_PAGE);
+    TEST_ASSERT_NOT_EQUAL(before, after);
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(TEST_PAGE), after);
+
+    setPageValue(TEST_PAGE, TEST_OFFSET, original);
+    TEST_ASSERT_EQUAL_UINT32(before, getPageCRC32(TEST_PAGE));
+}
+
+static void test_page_crc_background_update(void)
+{
+    //Bring everything up to date, then mark 2 pages as stale
+    while (updateStalePageCRC32()) { }
+    invalidatePageCRC32(2U);
+    invalidatePageCRC32(TEST_PAGE);
+
+    TEST_ASSERT_TRUE(updateStalePageCRC32());
+    TEST_ASSERT_TRUE(updateStalePageCRC32());
+    TEST_ASSERT_FALSE(updateStalePageCRC32());
+}
+
+static void test_page_crc_verify_catches_direct_writes(void)
+{
+    byte *pRaw = (byte*)&configPage2;
+    byte original = pRaw[TEST_OFFSET];
+    uint32_t before = getPageCRC32(TEST_PAGE);
+
+    //Write straight to the page, bypassing setPageValue()
+    pRaw[TEST_OFFSET] = original + 1U;
+    TEST_ASSERT_EQUAL_UINT32(before, getPageCRC32(TEST_PAGE));
+
+    //One full round of verification must pick up the change
+    for (uint8_t pageNum = 0U; pageNum < PAGE_COUNT; ++pageNum) { verifyNextPageCRC32(); }
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(TEST_PAGE), getPageCRC32(TEST_PAGE));
+    TEST_ASSERT_NOT_EQUAL(before, getPageCRC32(TEST_PAGE));
+
+    pRaw[TEST_OFFSET] = original;
+    invalidatePageCRC32(TEST_PAGE);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_page_crc_cache_matches_calculated);
+    RUN_TEST(test_page_crc_set_value_invalidates);
+    RUN_TEST(test_page_crc_background_update);
+    RUN_TEST(test_page_crc_verify_catches_direct_writes);
+    return UNITY_END();
+}
@@ -0,0 +1,427 @@
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+#include <Arduino.h>
+#include "globals.h"
+#include "config.h"
+#include "decoders.h"
+#include "init.h"
+#include "engine.h"
+#include "scheduler.h"
+#include "auxiliaries.h"
+#include "replay.h"
+
+#define REPLAY_START_US       10000UL //Time on the virtual clock before the first edge. Several decoders treat a tooth time of 0 as 'not seen yet'
+#define REPLAY_SAMPLE_US      1000UL  //The loop emulation and the ground truth comparisons run once per ms
+#define REPLAY_SETTLE_DEGREES 720.0   //RPM and angle errors are only collected after this many degrees past sync, while the decoder history fills
+#define REPLAY_CRANK_HYSTER   15      //Must match CRANK_RUN_HYSTER in engine.cpp
+
+struct replay_event_t {
+    uint32_t time;
+    uint8_t input;
+    uint8_t level;
+};
+
+static const replay_profile_t *replayProfile; //Ground truth for the current run. NULL when replaying a log
+
+/*
+***********************************************************************************************************
+* Wheel patterns
+*/
+void replayPulse(replay_pattern_t &pattern, uint8_t input, double rise, double fall)
+{
+    pattern.push_back({ fmod(rise, REPLAY_CYCLE_DEGREES), input, HIGH });
+    pattern.push_back({ fmod(fall, REPLAY_CYCLE_DEGREES), input, LOW });
+}
+
+/** Adds a tooth (Rising edge at the given angle, falling edge width degrees later) for each angle, repeated every period degrees over the cycle */
+void replayTeeth(replay_pattern_t &pattern, uint8_t input, const double *angles, uint8_t count, double width, double period)
+{
+    for(double offset = 0; offset < REPLAY_CYCLE_DEGREES; offset += period)
+    {
+        for(uint8_t x = 0; x < count; x++) { replayPulse(pattern, input, angles[x] + offset, angles[x] + offset + width); }
+    }
+}
+
+const replay_wheel_t* replayFindWheel(const char *name)
+{
+    for(uint8_t x = 0; x < replayWheelCount; x++)
+    {
+        if(strcmp(replayWheels[x].name, name) == 0) { return &replayWheels[x]; }
+    }
+    return NULL;
+}
+
+/*
+***********************************************************************************************************
+* Ground truth
+*/
+static double replayAcceleration(const replay_profile_t &profile)
+{
+    return (profile.rampSeconds > 0) ? ((profile.endRPM - profile.startRPM) / profile.rampSeconds) : 0;
+}
+
+/** Crank degrees turned t seconds into the profile */
+static double replayAngleAtTime(const replay_profile_t &profile, double t)
+{
+    double accel = replayAcceleration(profile);
+    double ramp = std::min(t, profile.rampSeconds);
+    double angle = 6.0 * ((profile.startRPM * ramp) + (0.5 * accel * ramp * ramp));
+    if(t > profile.rampSeconds) { angle += 6.0 * profile.endRPM * (t - profile.rampSeconds); }
+    return angle;
+}
+
+/** Inverse of the above. Time (in seconds) at which the crank has turned through angle degrees */
+static double replayTimeAtAngle(const replay_profile_t &profile, double angle)
+{
+    double accel = replayAcceleration(profile);
+    double rampAngle = replayAngleAtTime(profile, profile.rampSeconds);
+    if(angle > rampAngle) { return profile.rampSeconds + ((angle - rampAngle) / (6.0 * profile.endRPM)); }
+    if(accel == 0) { return angle / (6.0 * profile.startRPM); }
+    //Solve 3a.t^2 + 6.r0.t - angle = 0
+    return (sqrt((36.0 * profile.startRPM * profile.startRPM) + (12.0 * accel * angle)) - (6.0 * profile.startRPM)) / (6.0 * accel);
+}
+
+static double replayRPMAtTime(const replay_profile_t &profile, double t)
+{
+    if(t >= profile.rampSeconds) { return profile.endRPM; }
+    return profile.startRPM + (replayAcceleration(profile) * t);
+}
+
+/*
+***********************************************************************************************************
+* Harness
+*/
+/** Puts the board, decoder and engine status back to power on state and applies the tune for the given wheel.
+ * If a pattern is given, the trigger inputs start at the level they are at the profile's start angle (The end of the cycle
+ * when there is no profile). The stop position saved in FRAM survives, as it does on the target. */
+void replaySetupWheel(const replay_wheel_t &wheel, const replay_pattern_t *pattern, const replay_profile_t *profile)
+{
+    nativeReset();
+    resetConfigPages();
+    setPinMapping(3);
+
+    configPage2.nCylinders = 4;
+    configPage2.divider = 1;
+    configPage4.crankRPM = 40; //400 RPM
+    configPage4.useResync = 1;
+    configPage4.dwellRun = 30;
+    configPage4.dwellCrank = 40;
+    wheel.configure();
+    configPage15.fastSyncEnable = (profile != NULL) && profile->fastSync;
+
+    memset((void*)&triggerInfo, 0, sizeof(triggerInfo));
+    currentStatus.hasSync = false;
+    BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+    currentStatus.syncLossCounter = 0;
+    currentStatus.startRevolutions = 0;
+    currentStatus.RPM = 0;
+    currentStatus.longRPM = 0;
+    currentStatus.engine = 0;
+    currentStatus.toothLogEnabled = false;
+    currentStatus.compositeTriggerUsed = 0;
+    currentStatus.crankRPM = ((unsigned int)configPage4.crankRPM * 10);
+
+    for(size_t x = 0; (pattern != NULL) && (x < pattern->size()); x++)
+    {
+        nativeSetPin(((*pattern)[x].input == REPLAY_INPUT_PRI) ? pinTrigger : pinTrigger2, (*pattern)[x].level);
+    }
+    double startAngle = (profile != NULL) ? fmod(profile->startAngle, REPLAY_CYCLE_DEGREES) : 0;
+    for(size_t x = 0; (pattern != NULL) && (x < pattern->size()) && ((*pattern)[x].angle < startAngle); x++)
+    {
+        nativeSetPin(((*pattern)[x].input == REPLAY_INPUT_PRI) ? pinTrigger : pinTrigger2, (*pattern)[x].level);
+    }
+
+    triggerLoadStopPosition();
+
+    currentStatus.initialisationComplete = false;
+    initialiseTriggers();
+    initialiseSchedulers();
+    initialiseFan();
+    initialiseAuxPWM();
+    engineInit();
+    currentStatus.initialisationComplete = true;
+}
+
+/** Whether engineControl() has armed any of the fuel or ignition schedules. Channels 1-4 exist in every build and cover the test tunes */
+static bool replayScheduleArmed(void)
+{
+    return (fuelSchedule1.Status != OFF) || (fuelSchedule2.Status != OFF) || (fuelSchedule3.Status != OFF) || (fuelSchedule4.Status != OFF)
+        || (ignitionSchedule1.Status != OFF) || (ignitionSchedule2.Status != OFF) || (ignitionSchedule3.Status != OFF) || (ignitionSchedule4.Status != OFF);
+}
+
+/** Runs the loop's engine control. Until the decoder has sync (Or half sync) only the parts of engineCheckRun() and checkEngineSync()
+ * that feed back into the decoders are emulated, as the decoders' getCrankAngle() index their tooth tables out of range before
+ * then on the host. engineControl() takes over from there and schedules the fuel and ignition as it does on the target */
+static void replayEmulateLoop(void)
+{
+    if( currentStatus.hasSync || BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC) )
+    {
+        engineControl();
+        return;
+    }
+
+    if( engineIsRunning(micros()) )
+    {
+        currentStatus.longRPM = getRPM();
+        currentStatus.RPM = currentStatus.longRPM;
+    }
+    else
+    {
+        currentStatus.RPM = 0;
+        if(triggerInfo.toothLastToothTime != 0UL) { triggerStoreStopPosition(); }
+        resetDecoder();
+        currentStatus.hasSync = false;
+        BIT_CLEAR(currentStatus.status3, BIT_STATUS3_HALFSYNC);
+        currentStatus.startRevolutions = 0;
+        BIT_CLEAR(currentStatus.engine, BIT_ENGINE_CRANK);
+        BIT_CLEAR(currentStatus.engine, BIT_ENGINE_RUN);
+        initialiseTriggers();
+    }
+
+    if( (currentStatus.hasSync || BIT_CHECK(currentStatus.status3, BIT_STATUS3_HALFSYNC)) && (currentStatus.RPM > 0) )
+    {
+        if(currentStatus.RPM > currentStatus.crankRPM)
+        {
+            BIT_SET(currentStatus.engine, BIT_ENGINE_RUN);
+            BIT_CLEAR(currentStatus.engine, BIT_ENGINE_CRANK);
+        }
+        else if( !BIT_CHECK(currentStatus.engine, BIT_ENGINE_RUN) || (currentStatus.RPM < (currentStatus.crankRPM - REPLAY_CRANK_HYSTER)) )
+        {
+            BIT_SET(currentStatus.engine, BIT_ENGINE_CRANK);
+            BIT_CLEAR(currentStatus.engine, BIT_ENGINE_RUN);
+        }
+    }
+}
+
+/** Whether the trigger interrupt attached with the given mode fires on an edge to level */
+static bool replayEdgeFires(byte mode, uint8_t level)
+{
+    return (mode == CHANGE) || ((mode == RISING) && (level == HIGH)) || ((mode == FALLING) && (level == LOW));
+}
+
+/** Wraps an angle difference into -180 to +180. Decoders report either 0-360 or 0-720 depending on the tune, so errors are compared over a single revolution */
+static double replayWrap360(double angle)
+{
+    angle = fmod(angle, 360.0);
+    if(angle >= 180.0) { angle -= 360.0; }
+    if(angle < -180.0) { angle += 360.0; }
+    return angle;
+}
+
+/** Moves the virtual clock on to the given time. Interrupt latency can already have taken it past that */
+static void replayAdvanceTo(uint32_t time)
+{
+    if( (int32_t)(time - micros()) > 0 ) { nativeAdvanceMicros(time - micros()); }
+}
+
+static void replayRun(const std::vector<replay_event_t> &events, replay_result_t &result)
+{
+    memset(&result, 0, sizeof(result));
+    std::vector<double> angleErrors;
+    double sinSum = 0, cosSum = 0, rpmErrorSum = 0;
+    uint32_t rpmSamples = 0;
+    bool wasSynced = false;
+    double priISRTotal = 0, secISRTotal = 0;
+    uint32_t nextSample = REPLAY_START_US;
+
+    for(size_t x = 0; x <= events.size(); x++)
+    {
+        //Run the loop emulation for each ms up to the next edge. After the last edge, run on long enough for a stall to be detected
+        uint32_t edgeTime = (x < events.size()) ? events[x].time : (micros() + MAX_STALL_TIME + REPLAY_SAMPLE_US);
+        while(nextSample <= edgeTime)
+        {
+            replayAdvanceTo(nextSample);
+            replayEmulateLoop();
+            nextSample += REPLAY_SAMPLE_US;
+
+            double t = (double)(micros() - REPLAY_START_US) / 1000000.0;
+            double turned = (replayProfile != NULL) ? replayAngleAtTime(*replayProfile, t) : 0;
+            double angle = (replayProfile != NULL) ? (turned + replayProfile->startAngle) : 0;
+            if( (currentStatus.hasSync == true) && (result.synced == false) )
+            {
+                result.synced = true;
+                result.syncTime = micros() - REPLAY_START_US;
+                result.syncDegrees = turned;
+            }
+            if( replayScheduleArmed() && (result.fired == false) && (x < events.size()) )
+            {
+                result.fired = true;
+                result.fireTime = micros() - REPLAY_START_US;
+                result.fireDegrees = turned;
+            }
+            if( (wasSynced == true) && (currentStatus.hasSync == false) && (x < events.size()) ) { result.syncDrops++; }
+            wasSynced = currentStatus.hasSync;
+
+            if( (replayProfile != NULL) && (currentStatus.hasSync == true) && (currentStatus.RPM > 0) && (turned >= (result.syncDegrees + REPLAY_SETTLE_DEGREES)) )
+            {
+                double trueRPM = replayRPMAtTime(*replayProfile, t);
+                double rpmError = fabs((double)currentStatus.RPM - trueRPM) * 100.0 / trueRPM;
+                rpmErrorSum += rpmError;
+                result.rpmErrorMax = std::max(result.rpmErrorMax, rpmError);
+                rpmSamples++;
+
+                double angleError = replayWrap360((double)getCrankAngle() - fmod(angle, REPLAY_CYCLE_DEGREES));
+                angleErrors.push_back(angleError);
+                sinSum += sin(angleError * M_PI / 180.0);
+                cosSum += cos(angleError * M_PI / 180.0);
+            }
+        }
+        if(x == events.size()) { break; }
+
+        replayAdvanceTo(edgeTime);
+        byte pin = (events[x].input == REPLAY_INPUT_PRI) ? pinTrigger : pinTrigger2;
+        auto start = std::chrono::steady_clock::now();
+        nativeSetPin(pin, events[x].level);
+        double cost = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        //Only the edges that the decoder has attached to are counted, the others do not call into the firmware
+        if( (events[x].input == REPLAY_INPUT_PRI) && replayEdgeFires(primaryTriggerEdge, events[x].level) )
+        {
+            result.priEdges++;
+            priISRTotal += cost;
+            result.priISRMax = std::max(result.priISRMax, cost);
+        }
+        else if( (events[x].input == REPLAY_INPUT_SEC) && replayEdgeFires(secondaryTriggerEdge, events[x].level) )
+        {
+            result.secEdges++;
+            secISRTotal += cost;
+            result.secISRMax = std::max(result.secISRMax, cost);
+        }
+    }
+
+    result.syncLossCounter = currentStatus.syncLossCounter;
+    if(result.priEdges > 0) { result.priISRMean = priISRTotal / result.priEdges; }
+    if(result.secEdges > 0) { result.secISRMean = secISRTotal / result.secEdges; }
+    if(rpmSamples > 0)
+    {
+        result.rpmErrorMean = rpmErrorSum / rpmSamples;
+        result.angleOffset = atan2(sinSum, cosSum) * 180.0 / M_PI;
+        for(size_t x = 0; x < angleErrors.size(); x++) { result.angleErrorMax = std::max(result.angleErrorMax, fabs(replayWrap360(angleErrors[x] - result.angleOffset))); }
+    }
+    else
+    {
+        //No ground truth, or the decoder never ran long enough to compare against it
+        result.rpmErrorMean = result.rpmErrorMax = -1;
+        result.angleOffset = result.angleErrorMax = -1;
+    }
+}
+
+void replayRunWheel(const replay_wheel_t &wheel, const replay_profile_t &profile, replay_result_t &result)
+{
+    replay_pattern_t pattern;
+    wheel.build(pattern);
+    std::stable_sort(pattern.begin(), pattern.end(), [](const replay_edge_t &a, const replay_edge_t &b) { return a.angle < b.angle; });
+    replaySetupWheel(wheel, &pattern, &profile);
+    nativeSetInterruptLatency(profile.interruptLatency);
+
+    std::vector<replay_event_t> events;
+    double duration = profile.rampSeconds + profile.holdSeconds;
+    for(uint32_t cycle = 0; ; cycle++)
+    {
+        double t = 0;
+        for(size_t x = 0; x < pattern.size(); x++)
+        {
+            double angle = (cycle * REPLAY_CYCLE_DEGREES) + pattern[x].angle;
+            if(angle < profile.startAngle) { continue; }
+            t = replayTimeAtAngle(profile, angle - profile.startAngle);
+            if(t > duration) { break; }
+            events.push_back({ (uint32_t)(REPLAY_START_US + llround(t * 1000000.0)), pattern[x].input, pattern[x].level });
+        }
+        if(t > duration) { break; }
+    }
+
+    replayProfile = &profile;
+    replayRun(events, result);
+    replayProfile = NULL;
+}
+
+static size_t replayReadFile(const char *fileName, std::vector<uint8_t> &data)
+{
+    FILE *file = fopen(fileName, "rb");
+    if(file == NULL) { return 0; }
+    uint8_t buffer[256];
+    size_t count;
+    while( (count = fread(buffer, 1, sizeof(buffer), file)) > 0 ) { data.insert(data.end(), buffer, buffer + count); }
+    fclose(file);
+    return data.size();
+}
+
+/** Replays a tooth log: The payload of TSCommClass::sendToothLog(), ie little endian uint32_t gaps (in uS) between primary teeth.
+ * Each tooth is a rising edge, returning low half way to the next one. */
+bool replayRunToothLog(const replay_wheel_t &wheel, const char *fileName, replay_result_t &result)
+{
+    std::vector<uint8_t> data;
+    if(replayReadFile(fileName, data) < 4U) { return false; }
+    replaySetupWheel(wheel, NULL, NULL);
+
+    std::vector<replay_event_t> events;
+    uint32_t time = REPLAY_START_US;
+    for(size_t x = 0; (x + 4U) <= data.size(); x += 4U)
+    {
+        uint32_t gap = (uint32_t)data[x] | ((uint32_t)data[x+1] << 8) | ((uint32_t)data[x+2] << 16) | ((uint32_t)data[x+3] << 24);
+        if(gap == 0U) { continue; } //Padding when the log was sent before it was full
+        if(!events.empty()) { events.push_back({ time - (gap / 2U), REPLAY_INPUT_PRI, LOW }); }
+        time += gap;
+        events.push_back({ time, REPLAY_INPUT_PRI, HIGH });
+    }
+
+    replayRun(events, result);
+    return true;
+}
+
+/** Replays a composite log: The payload of TSCommClass::sendCompositeLog(), ie a little endian uint32_t micros() timestamp followed
+ * by the status byte, whose COMPOSITE_LOG_PRI and COMPOSITE_LOG_SEC bits give the level of each input at that time. */
+bool replayRunCompositeLog(const replay_wheel_t &wheel, const char *fileName, replay_result_t &result)
+{
+    std::vector<uint8_t> data;
+    if(replayReadFile(fileName, data) < 5U) { return false; }
+    replaySetupWheel(wheel, NULL, NULL);
+
+    std::vector<replay_event_t> events;
+    uint32_t firstTime = 0, lastTime = 0;
+    uint8_t priLevel = LOW, secLevel = LOW;
+    for(size_t x = 0; (x + 5U) <= data.size(); x += 5U)
+    {
+        uint32_t logTime = (uint32_t)data[x] | ((uint32_t)data[x+1] << 8) | ((uint32_t)data[x+2] << 16) | ((uint32_t)data[x+3] << 24);
+        uint8_t flags = data[x+4];
+        if(x == 0U) { firstTime = logTime; }
+        else if((logTime - firstTime) <= lastTime) { continue; } //Padding repeats the last timestamp
+        lastTime = logTime - firstTime;
+
+        uint8_t pri = BIT_CHECK(flags, COMPOSITE_LOG_PRI) ? HIGH : LOW;
+        uint8_t sec = BIT_CHECK(flags, COMPOSITE_LOG_SEC) ? HIGH : LOW;
+        if( (x == 0U) || (pri != priLevel) ) { events.push_back({ REPLAY_START_US + lastTime, REPLAY_INPUT_PRI, pri }); }
+        if( (x == 0U) || (sec != secLevel) ) { events.push_back({ REPLAY_START_US + lastTime, REPLAY_INPUT_SEC, sec }); }
+        priLevel = pri;
+        secLevel = sec;
+    }
+
+    replayRun(events, result);
+    return true;
+}
+
+/*
+***********************************************************************************************************
+* Report
+*/
+void replayPrintHeader(void)
+{
+    printf("%-14s %-8s %9s %8s %8s %9s %5s %5s %8s %8s %8s %7s %8s %8s %8s\n",
+           "wheel", "profile", "sync(ms)", "sync(deg)", "fire(ms)", "fire(deg)", "loss", "drops", "rpm(%)", "rpmMax%", "angOff", "angMax", "pri(ns)", "priMax", "sec(ns)");
+}
+
+void replayPrintResult(const char *wheel, const char *profile, const replay_result_t &result)
+{
+    if(result.synced == false)
+    {
+        printf("%-14s %-8s %9s %9s %8s %9s %5u %5u %8s %8s %8s %7s %8.0f %8.0f %8.0f\n", wheel, profile, "none", "-", "-", "-",
+               result.syncLossCounter, result.syncDrops, "-", "-", "-", "-", result.priISRMean, result.priISRMax, result.secISRMean);
+        return;
+    }
+    printf("%-14s %-8s %9.1f %9.0f %8.1f %9.0f %5u %5u %8.2f %8.2f %8.1f %7.2f %8.0f %8.0f %8.0f\n", wheel, profile,
+           result.syncTime / 1000.0, result.syncDegrees, result.fireTime / 1000.0, result.fireDegrees, result.syncLossCounter, result.syncDrops,
+           result.rpmErrorMean, result.rpmErrorMax, result.angleOffset, result.angleErrorMax,
+           result.priISRMean, result.priISRMax, result.secISRMean);
+}
@@ -0,0 +1,90 @@
+/** @file
+ * Trigger wheel replay harness (native only).
+ *
+ * Drives the decoder in use (configPage4.TrigPattern) through the native board's trigger pins on the
+ * virtual clock, either from a synthesised wheel pattern turning at a given RPM/acceleration profile or
+ * from a tooth/composite log captured by TunerStudio. The loop's engineControl() is run once per ms (Emulated until
+ * the decoder has sync) so that RPM, the cranking bit, stall detection and the fuel and ignition schedules behave as
+ * they do on the target.
+ */
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define REPLAY_INPUT_PRI 0
+#define REPLAY_INPUT_SEC 1
+
+#define REPLAY_CYCLE_DEGREES 720.0 //All patterns are described over a full 4 stroke cycle
+
+/** A single edge of a wheel pattern. Angles are crank degrees from the start of the cycle */
+struct replay_edge_t {
+    double angle;
+    uint8_t input; ///< REPLAY_INPUT_PRI or REPLAY_INPUT_SEC
+    uint8_t level; ///< HIGH or LOW
+};
+
+typedef std::vector<replay_edge_t> replay_pattern_t;
+
+/** A synthesised trigger wheel and the tune needed to decode it */
+struct replay_wheel_t {
+    const char *name;
+    void (*configure)(void); ///< Sets configPage2/4/10 for the wheel. Called after the pages have been reset
+    void (*build)(replay_pattern_t &pattern); ///< Adds the edges of one 720 degree cycle
+};
+
+/** Engine speed profile: a linear ramp from startRPM to endRPM followed by a hold at endRPM */
+struct replay_profile_t {
+    const char *name;
+    double startRPM;
+    double endRPM;
+    double rampSeconds;
+    double holdSeconds;
+    uint32_t interruptLatency; ///< uS between each trigger edge and its interrupt being serviced (See nativeSetInterruptLatency())
+    double startAngle;         ///< Crank degrees into the cycle that the engine is at when the run starts
+    bool fastSync;             ///< Sets configPage15.fastSyncEnable. The stop position saved by the previous run is used
+};
+
+/** Results of a single run */
+struct replay_result_t {
+    bool synced;
+    uint32_t syncTime;          ///< uS from the first edge until hasSync was first set
+    double syncDegrees;         ///< Crank degrees turned before hasSync was first set
+    bool fired;
+    uint32_t fireTime;          ///< uS from the first edge until engineControl() first armed a fuel or ignition schedule
+    double fireDegrees;         ///< Crank degrees turned before then
+    uint16_t syncLossCounter;   ///< currentStatus.syncLossCounter at the end of the run
+    uint16_t syncDrops;         ///< Number of times hasSync went from true to false after sync was acquired
+    double rpmErrorMean;        ///< Mean absolute RPM error (%) once running
+    double rpmErrorMax;         ///< Largest absolute RPM error (%) once running
+    double angleOffset;         ///< Mean offset between getCrankAngle() and the wheel position (degrees)
+    double angleErrorMax;       ///< Largest deviation of getCrankAngle() from that offset (degrees)
+    uint32_t priEdges;
+    uint32_t secEdges;
+    double priISRMean;          ///< Mean host time (nS) spent in the primary trigger interrupt
+    double priISRMax;
+    double secISRMean;          ///< Mean host time (nS) spent in the secondary trigger interrupt
+    double secISRMax;
+};
+
+//Wheel pattern helpers
+void replayPulse(replay_pattern_t &pattern, uint8_t input, double rise, double fall);
+void replayTeeth(replay_pattern_t &pattern, uint8_t input, const double *angles, uint8_t count, double width, double period);
+
+#define REPLAY_MAX_WHEELS 40 //Size of the per wheel result tables. wheels.cpp checks replayWheels[] fits
+
+extern const replay_wheel_t replayWheels[];
+extern const uint8_t replayWheelCount;
+const replay_wheel_t* replayFindWheel(const char *name);
+
+void replaySetupWheel(const replay_wheel_t &wheel, const replay_pattern_t *pattern, const replay_profile_t *profile);
+void replayRunWheel(const replay_wheel_t &wheel, const replay_profile_t &profile, replay_result_t &result);
+bool replayRunToothLog(const replay_wheel_t &wheel, const char *fileName, replay_result_t &result);
+bool replayRunCompositeLog(const replay_wheel_t &wheel, const char *fileName, replay_result_t &result);
+
+void replayPrintHeader(void);
+void replayPrintResult(const char *wheel, const char *profile, const replay_result_t &result);
+
+#endif // REPLAY_H
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unity.h>
+#include "globals.h"
+#include "storage.h"
+#include "replay.h"
+
+/*
+Runs every decoder over the synthesised wheels and prints a report of sync acquisition, sync losses, RPM and
+crank angle error and trigger interrupt cost. ISR costs are host nanoseconds: they are only comparable between
+runs on the same machine, but show the relative cost of each decoder and any growth between builds.
+
+A captured log can be replayed through one of the wheel tunes with:
+  REPLAY_WHEEL=<wheel name> REPLAY_TOOTH_LOG=<file> pio test -e native -f test_replay
+  REPLAY_WHEEL=<wheel name> REPLAY_COMPOSITE_LOG=<file> pio test -e native -f test_replay
+where the file holds the raw payload of a tooth or composite log as sent by TSCommClass::sendToothLog()/sendCompositeLog()
+*/
+#define REPLAY_MAX_SYNC_DEGREES 1440.0 //Every decoder must sync within 2 cycles when cranking
+#define REPLAY_LATENCY_US       40      //Trigger interrupt latency for the capture test. 1.44 degrees at 6000 RPM
+#define REPLAY_LATENCY_DEGREES  0.4     //The most the crank angle may move by when that latency is added. Timestamping in the ISR moves it by 1-1.5 degrees
+#define REPLAY_FAST_SYNC_DEGREES 30.0   //Fast sync must be able to fire within 3 teeth of a 36-1 restarting
+
+static const replay_profile_t profiles[] = {
+    { "crank",  200,  200,  0.0, 2.0, 0, 0, false },
+    { "idle",   850,  850,  0.0, 1.0, 0, 0, false },
+    { "snap",   850,  6500, 1.0, 0.5, 0, 0, false },
+    { "decel",  6500, 1200, 1.5, 0.5, 0, 0, false },
+};
+#define PROFILE_COUNT (sizeof(profiles)/sizeof(profiles[0]))
+
+static replay_result_t results[PROFILE_COUNT][REPLAY_MAX_WHEELS];
+
+static void test_replay_all_wheels(void)
+{
+    replayPrintHeader();
+    for(uint8_t wheel = 0; wheel < replayWheelCount; wheel++)
+    {
+        for(uint8_t profile = 0; profile < PROFILE_COUNT; profile++)
+        {
+            replayRunWheel(replayWheels[wheel], profiles[profile], results[profile][wheel]);
+            replayPrintResult(replayWheels[wheel].name, profiles[profile].name, results[profile][wheel]);
+        }
+    }
+}
+
+static void test_replay_sync_when_cranking(void)
+{
+    for(uint8_t wheel = 0; wheel < replayWheelCount; wheel++)
+    {
+        TEST_ASSERT_TRUE(results[0][wheel].synced);
+        TEST_ASSERT_LESS_OR_EQUAL(REPLAY_MAX_SYNC_DEGREES, results[0][wheel].syncDegrees);
+    }
+}
+
+static void test_replay_no_sync_loss(void)
+{
+    for(uint8_t wheel = 0; wheel < replayWheelCount; wheel++)
+    {
+        for(uint8_t profile = 0; profile < PROFILE_COUNT; profile++)
+        {
+            TEST_ASSERT_TRUE(results[profile][wheel].synced);
+            TEST_ASSERT_EQUAL(0, results[profile][wheel].syncDrops);
+        }
+    }
+}
+
+/** The tooth times come from the input capture, so a late trigger interrupt must not move the crank angle or RPM.
+ * The largest error can still change: a sample taken between an edge and its (late) interrupt sees the previous tooth */
+static void test_replay_capture_removes_latency(void)
+{
+    const replay_profile_t prompt = { "run",     850, 6000, 0.5, 0.5, 0, 0, false };
+    const replay_profile_t late =   { "runLate", 850, 6000, 0.5, 0.5, REPLAY_LATENCY_US, 0, false };
+
+    for(uint8_t wheel = 0; wheel < replayWheelCount; wheel++)
+    {
+        replay_result_t promptResult;
+        replay_result_t lateResult;
+        replayRunWheel(replayWheels[wheel], prompt, promptResult);
+        replayRunWheel(replayWheels[wheel], late, lateResult);
+        replayPrintResult(replayWheels[wheel].name, prompt.name, promptResult);
+        replayPrintResult(replayWheels[wheel].name, late.name, lateResult);
+
+        TEST_ASSERT_TRUE(lateResult.synced);
+        TEST_ASSERT_EQUAL(0, lateResult.syncDrops);
+        TEST_ASSERT_TRUE(fabs(lateResult.angleOffset - promptResult.angleOffset) <= REPLAY_LATENCY_DEGREES);
+        TEST_ASSERT_TRUE(fabs(lateResult.rpmErrorMean - promptResult.rpmErrorMean) <= 0.1);
+    }
+}
+
+/** Cranks the 36-1 until it stops part way round, then restarts it from there (Accelerating from rest) with and without fast sync. Fast sync fires
+ * from the stop position at half sync, then gets full sync where normal sync would. If the engine is turned while
+ * stopped the stop position is wrong, which must only cost the half sync. */
+static void test_replay_fast_sync(void)
+{
+    const replay_wheel_t *wheel = replayFindWheel("missingTooth");
+    const double stopAngles[] = { 2162, 2462, 2502 }; //Once synced: Just after the gap, part way round, last tooth before the gap
+
+    for(uint8_t x = 0; x < (sizeof(stopAngles)/sizeof(stopAngles[0])); x++)
+    {
+        const replay_profile_t stop =   { "stop",   200, 200, 0.0, stopAngles[x] / 1200.0, 0, 0, true };
+        const replay_profile_t fast =   { "fast",   100, 250, 0.5, 1.5, 0, stopAngles[x], true };
+        const replay_profile_t normal = { "normal", 100, 250, 0.5, 1.5, 0, stopAngles[x], false };
+        replay_result_t stopResult;
+        replay_result_t fastResult;
+        replay_result_t normalResult;
+        replayRunWheel(*wheel, stop, stopResult);
+        replayRunWheel(*wheel, fast, fastResult);
+        uint16_t fastStopPosition = Storage.readTriggerStopPosition();
+        replayRunWheel(*wheel, normal, normalResult);
+        replayPrintResult(wheel->name, fast.name, fastResult);
+        replayPrintResult(wheel->name, normal.name, normalResult);
+
+        TEST_ASSERT_TRUE(stopResult.synced);
+        TEST_ASSERT_TRUE(fastResult.fired);
+        TEST_ASSERT_TRUE(fastResult.fireDegrees <= REPLAY_FAST_SYNC_DEGREES);
+        TEST_ASSERT_TRUE(fastResult.fireDegrees < normalResult.fireDegrees);
+        TEST_ASSERT_TRUE(fastResult.synced);
+        TEST_ASSERT_TRUE(fastResult.syncDegrees <= normalResult.syncDegrees);
+        TEST_ASSERT_EQUAL(0, fastResult.syncDrops);
+        TEST_ASSERT_EQUAL(0, fastResult.syncLossCounter);
+        TEST_ASSERT_EQUAL(fastStopPosition, Storage.readTriggerStopPosition()); //Nothing is saved while fast sync is off
+    }
+
+    //Turned back 120 degrees while stopped. The wrong stop position can cost no more than the revolution it is found out in
+    const replay_profile_t stop =   { "stop",   200, 200, 0.0, 2462.0 / 1200.0, 0, 0, true };
+    const replay_profile_t moved =  { "moved",  100, 250, 0.5, 1.5, 0, 2342, true };
+    const replay_profile_t normal = { "normal", 100, 250, 0.5, 1.5, 0, 2342, false };
+    replay_result_t stopResult;
+    replay_result_t movedResult;
+    replay_result_t normalResult;
+    replayRunWheel(*wheel, stop, stopResult);
+    replayRunWheel(*wheel, moved, movedResult);
+    replayRunWheel(*wheel, normal, normalResult);
+    replayPrintResult(wheel->name, moved.name, movedResult);
+    replayPrintResult(wheel->name, normal.name, normalResult);
+
+    TEST_ASSERT_TRUE(movedResult.synced);
+    TEST_ASSERT_TRUE(movedResult.syncDegrees <= (normalResult.syncDegrees + 360.0));
+    TEST_ASSERT_EQUAL(0, movedResult.syncDrops);
+}
+
+static void replayLogs(void)
+{
+    const char *wheelName = getenv("REPLAY_WHEEL");
+    const char *toothLog = getenv("REPLAY_TOOTH_LOG");
+    const char *compositeLog = getenv("REPLAY_COMPOSITE_LOG");
+    if( (wheelName == NULL) || ((toothLog == NULL) && (compositeLog == NULL)) ) { return; }
+
+    const replay_wheel_t *wheel = replayFindWheel(wheelName);
+    if(wheel == NULL) { printf("Unknown wheel: %s\n", wheelName); return; }
+
+    replay_result_t result;
+    if( (toothLog != NULL) && replayRunToothLog(*wheel, toothLog, result) ) { replayPrintResult(wheel->name, "toothLog", result); }
+    if( (compositeLog != NULL) && replayRunCompositeLog(*wheel, compositeLog, result) ) { replayPrintResult(wheel->name, "compLog", result); }
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_replay_all_wheels);
+    RUN_TEST(test_replay_sync_when_cranking);
+    RUN_TEST(test_replay_no_sync_loss);
+    RUN_TEST(test_replay_capture_removes_latency);
+    RUN_TEST(test_replay_fast_sync);
+    replayLogs();
+
+    return UNITY_END();
+}
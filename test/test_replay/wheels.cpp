@@ -0,0 +1,478 @@
+#include <Arduino.h>
+#include "globals.h"
+#include "config.h"
+#include "decoders.h"
+#include "replay.h"
+
+/*
+Synthesised trigger wheels, one for each decoder in speeduino/decoders/.
+Angles are crank degrees. Unless noted, a tooth is a pulse that rises at the listed angle and the tune triggers on the rising edge.
+*/
+#define ARRAY_COUNT(a) ((uint8_t)(sizeof(a)/sizeof(a[0])))
+
+static void sequential(void)
+{
+    configPage2.injLayout = INJ_SEQUENTIAL;
+    configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+}
+
+/** Evenly spaced teeth, skipping any slot listed in missing */
+static void evenTeeth(replay_pattern_t &pattern, uint8_t input, uint16_t slots, double period, const uint8_t *missing, uint8_t missingCount, double width)
+{
+    for(double offset = 0; offset < REPLAY_CYCLE_DEGREES; offset += period)
+    {
+        for(uint16_t slot = 0; slot < slots; slot++)
+        {
+            bool skip = false;
+            for(uint8_t x = 0; x < missingCount; x++) { if(missing[x] == slot) { skip = true; } }
+            if(skip == false) { replayPulse(pattern, input, offset + (slot * period / slots), offset + (slot * period / slots) + width); }
+        }
+    }
+}
+
+//Missing tooth: 36-1 on the crank, single tooth cam
+static void configMissingTooth(void)
+{
+    configPage4.TrigPattern = DECODER_MISSING_TOOTH;
+    configPage4.triggerTeeth = 36;
+    configPage4.triggerMissingTeeth = 1;
+    configPage4.TrigSpeed = CRANK_SPEED;
+    configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
+    sequential();
+}
+static void buildMissingTooth(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 35 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, missing, ARRAY_COUNT(missing), 5);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 100, 120);
+}
+
+//Basic distributor: One tooth per cylinder per cam revolution
+static void configBasicDistributor(void)
+{
+    configPage4.TrigPattern = DECODER_BASIC_DISTRIBUTOR;
+}
+static void buildBasicDistributor(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 4, 720, NULL, 0, 30);
+}
+
+//Dual wheel: 36 tooth crank, single tooth cam
+static void configDualWheel(void)
+{
+    configPage4.TrigPattern = DECODER_DUAL_WHEEL;
+    configPage4.triggerTeeth = 36;
+    configPage4.TrigSpeed = CRANK_SPEED;
+    sequential();
+}
+static void buildDualWheel(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, NULL, 0, 5);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 100, 120);
+}
+
+//GM 7X: 6 even teeth plus a sync tooth 10 degrees after one of them
+static void configGM7X(void)
+{
+    configPage4.TrigPattern = DECODER_GM7X;
+}
+static void buildGM7X(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 0, 10, 60, 120, 180, 240, 300 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 3, 360);
+}
+
+//Mitsubishi 4G63: Both edges of the 4 crank windows. Cam falling edges with the crank high and low
+static void config4G63(void)
+{
+    configPage4.TrigPattern = DECODER_4G63;
+    sequential();
+}
+static void build4G63(replay_pattern_t &pattern)
+{
+    replayPulse(pattern, REPLAY_INPUT_PRI, 105, 175);
+    replayPulse(pattern, REPLAY_INPUT_PRI, 285, 355);
+    replayPulse(pattern, REPLAY_INPUT_PRI, 465, 535);
+    replayPulse(pattern, REPLAY_INPUT_PRI, 645, 715);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 340, 400);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 600, 680);
+}
+
+//GM 24X: 24 uneven crank teeth, cam high for half of the cycle
+static void config24X(void)
+{
+    configPage4.TrigPattern = DECODER_24X;
+}
+static void build24X(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 12, 18, 33, 48, 63, 78, 102, 108, 123, 138, 162, 177, 183, 198, 222, 237, 252, 258, 282, 288, 312, 327, 342, 357 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 3, 360);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 5, 365);
+}
+
+//Jeep 2000: 4 groups of 3 crank teeth, cam high for half of the cycle
+static void configJeep2000(void)
+{
+    configPage4.TrigPattern = DECODER_JEEP2000;
+}
+static void buildJeep2000(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 54, 74, 94, 114, 174, 194, 214, 234, 294, 314, 334, 354 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 360);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 144, 504);
+}
+
+//Audi 135: 135 crank teeth, single tooth cam
+static void configAudi135(void)
+{
+    configPage4.TrigPattern = DECODER_AUDI135;
+}
+static void buildAudi135(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 135, 360, NULL, 0, 1);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 100, 120);
+}
+
+//Honda D17: 12 even teeth plus a 13th shortly after the 12th
+static void configHondaD17(void)
+{
+    configPage4.TrigPattern = DECODER_HONDA_D17;
+}
+static void buildHondaD17(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 0, 30, 60, 90, 120, 150, 180, 210, 240, 270, 300, 330, 340 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 3, 360);
+}
+
+//Honda J32: 24 slots with teeth 0 and 8 missing
+static void configHondaJ32(void)
+{
+    configPage4.TrigPattern = DECODER_HONDA_J32;
+    configPage2.nCylinders = 6;
+}
+static void buildHondaJ32(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 0, 8 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 24, 360, missing, ARRAY_COUNT(missing), 5);
+}
+
+//Miata 99-05: 4 crank teeth, cam with a single and a double pulse
+static void configMiata9905(void)
+{
+    configPage4.TrigPattern = DECODER_MIATA_9905;
+    sequential();
+}
+static void buildMiata9905(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 100, 170, 280, 350 };
+    const double cam[] = { 30, 380, 410 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 360);
+    replayTeeth(pattern, REPLAY_INPUT_SEC, cam, ARRAY_COUNT(cam), 5, 720);
+}
+
+//Mazda AU: 4 crank teeth, 3 cam teeth read on the falling edge
+static void configMazdaAU(void)
+{
+    configPage4.TrigPattern = DECODER_MAZDA_AU;
+}
+static void buildMazdaAU(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 96, 168, 276, 348 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 360);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 10, 20);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 370, 380);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 411, 421);
+}
+
+//Non-360 dual wheel: 18 crank teeth (20 degrees each, which needs the angle multiplier of 1), single tooth cam read on the falling edge
+static void configNon360(void)
+{
+    configPage4.TrigPattern = DECODER_NON360;
+    configPage4.triggerTeeth = 18;
+    configPage4.TrigAngMul = 1;
+    sequential();
+}
+static void buildNon360(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 18, 360, NULL, 0, 5);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 90, 110);
+}
+
+//Nissan 360: 360 slot optical cam. The cam slots for each cylinder are read as low windows on the secondary input
+static void configNissan360(void)
+{
+    configPage4.TrigPattern = DECODER_NISSAN_360;
+    configPage4.TrigEdgeSec = 0;
+}
+static void buildNissan360(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 360, 720, NULL, 0, 1);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 30, 178);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 202, 358);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 374, 538);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 546, 718);
+}
+
+//Subaru 6/7: 12 crank teeth and 7 cam teeth over the cycle
+static void configSubaru67(void)
+{
+    configPage4.TrigPattern = DECODER_SUBARU_67;
+}
+static void buildSubaru67(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 83, 115, 170, 263, 295, 350, 443, 475, 530, 623, 655, 710 };
+    const double cam[] = { 10, 30, 50, 200, 380, 400, 560 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 720);
+    replayTeeth(pattern, REPLAY_INPUT_SEC, cam, ARRAY_COUNT(cam), 5, 720);
+}
+
+//Daihatsu +1: One tooth per cylinder plus an extra tooth 30 degrees after the first
+static void configDaihatsu(void)
+{
+    configPage4.TrigPattern = DECODER_DAIHATSU_PLUS1;
+}
+static void buildDaihatsu(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 0, 30, 180, 360, 540 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 720);
+}
+
+//Harley: 2 uneven crank teeth
+static void configHarley(void)
+{
+    configPage4.TrigPattern = DECODER_HARLEY;
+}
+static void buildHarley(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 0, 157 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 20, 360);
+}
+
+//36-2-2-2 (Subaru H4): 36 slots with 3 gaps of 2
+static void config36_2_2_2(void)
+{
+    configPage4.TrigPattern = DECODER_36_2_2_2;
+}
+static void build36_2_2_2(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 13, 14, 31, 32, 34, 35 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, missing, ARRAY_COUNT(missing), 5);
+}
+
+//36-2-1: 36 slots with a single and a double gap
+static void config36_2_1(void)
+{
+    configPage4.TrigPattern = DECODER_36_2_1;
+}
+static void build36_2_1(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 18, 34, 35 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, missing, ARRAY_COUNT(missing), 5);
+}
+
+//Chrysler 420a: 4 groups of 4 crank teeth read on the falling edge. The cam falls once with the crank high and once with it low
+static void config420a(void)
+{
+    configPage4.TrigPattern = DECODER_420A;
+    configPage4.TrigEdge = 1;
+}
+static void build420a(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 111, 131, 151, 171, 291, 311, 331, 351, 471, 491, 511, 531, 651, 671, 691, 711 };
+    for(uint8_t x = 0; x < ARRAY_COUNT(teeth); x++)
+    {
+        //The first tooth after 531 is held high through the gap, the other gaps are low
+        double rise = (teeth[x] == 651) ? 541 : teeth[x] - 10;
+        replayPulse(pattern, REPLAY_INPUT_PRI, rise, teeth[x]);
+    }
+    replayPulse(pattern, REPLAY_INPUT_SEC, 190, 200);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 590, 600);
+}
+
+//Weber-Marelli: 4 crank teeth, 2 cam teeth 90 degrees apart
+static void configWeber(void)
+{
+    configPage4.TrigPattern = DECODER_WEBER;
+    configPage4.triggerTeeth = 4;
+    sequential();
+}
+static void buildWeber(replay_pattern_t &pattern)
+{
+    const double cam[] = { 45, 135 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 4, 360, NULL, 0, 5);
+    replayTeeth(pattern, REPLAY_INPUT_SEC, cam, ARRAY_COUNT(cam), 5, 720);
+}
+
+//Ford ST170: 36-1 crank, 8-3 cam
+static void configST170(void)
+{
+    configPage4.TrigPattern = DECODER_ST170;
+    sequential();
+}
+static void buildST170(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 35 };
+    const double cam[] = { 0, 90, 180, 270, 360 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, missing, ARRAY_COUNT(missing), 5);
+    replayTeeth(pattern, REPLAY_INPUT_SEC, cam, ARRAY_COUNT(cam), 10, 720);
+}
+
+//Suzuki DRZ400: 6 crank teeth, single tooth cam just before tooth 1
+static void configDRZ400(void)
+{
+    configPage4.TrigPattern = DECODER_DRZ400;
+    configPage4.triggerTeeth = 6;
+    configPage2.nCylinders = 1;
+}
+static void buildDRZ400(replay_pattern_t &pattern)
+{
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 6, 360, NULL, 0, 5);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 320, 330);
+}
+
+//Chrysler NGC 4 cylinder: 36+2-2 crank and 7 tooth cam, both with a long high and a long low tooth. Both read on every edge
+static void configNGC(void)
+{
+    configPage4.TrigPattern = DECODER_NGC;
+    sequential();
+}
+static void buildNGC(replay_pattern_t &pattern)
+{
+    for(double offset = 0; offset < REPLAY_CYCLE_DEGREES; offset += 360)
+    {
+        for(uint8_t tooth = 1; tooth <= 34; tooth++)
+        {
+            if( (tooth == 17) || (tooth == 18) ) { continue; }
+            double fall = offset + ((tooth - 1) * 10);
+            double rise = fall - 5;
+            if(tooth == 1) { rise = fall - 25; } //Long high tooth
+            replayPulse(pattern, REPLAY_INPUT_PRI, rise + REPLAY_CYCLE_DEGREES, fall);
+        }
+    }
+    const double cam[] = { 60, 110, 160, 340, 400, 460 };
+    for(uint8_t x = 0; x < ARRAY_COUNT(cam); x++) { replayPulse(pattern, REPLAY_INPUT_SEC, cam[x] - 10, cam[x]); }
+    replayPulse(pattern, REPLAY_INPUT_SEC, 465, 700); //Long high tooth
+}
+
+//Yamaha Vmax: 6 uneven lobes, one of them wide. Both edges are read
+static void configVmax(void)
+{
+    configPage4.TrigPattern = DECODER_VMAX;
+}
+static void buildVmax(replay_pattern_t &pattern)
+{
+    for(double offset = 0; offset < REPLAY_CYCLE_DEGREES; offset += 360)
+    {
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 0, offset + 5);
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 40, offset + 45);
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 110, offset + 115);
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 180, offset + 185);
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 220, offset + 225);
+        replayPulse(pattern, REPLAY_INPUT_PRI, offset + 290, offset + 335);
+    }
+}
+
+//Renix 44-2-2: 4 groups of 9 teeth on a 44 slot wheel
+static void configRenix(void)
+{
+    configPage4.TrigPattern = DECODER_RENIX;
+}
+static void buildRenix(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 9, 10, 20, 21, 31, 32, 42, 43 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 44, 360, missing, ARRAY_COUNT(missing), 3);
+}
+
+//Rover MEMS: 36 slots with 2 single gaps 180 degrees apart (17-17), single tooth cam
+static void configRoverMEMS(void)
+{
+    configPage4.TrigPattern = DECODER_ROVERMEMS;
+    configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
+    sequential();
+}
+static void buildRoverMEMS(replay_pattern_t &pattern)
+{
+    const uint8_t missing[] = { 0, 18 };
+    evenTeeth(pattern, REPLAY_INPUT_PRI, 36, 360, missing, ARRAY_COUNT(missing), 5);
+    replayPulse(pattern, REPLAY_INPUT_SEC, 100, 120);
+}
+
+//Suzuki K6A: 7 uneven cam speed teeth
+static void configSuzukiK6A(void)
+{
+    configPage4.TrigPattern = DECODER_SUZUKI_K6A;
+    configPage2.nCylinders = 3;
+}
+static void buildSuzukiK6A(replay_pattern_t &pattern)
+{
+    const double teeth[] = { 0, 170, 240, 410, 480, 515, 650 };
+    replayTeeth(pattern, REPLAY_INPUT_PRI, teeth, ARRAY_COUNT(teeth), 5, 720);
+}
+
+//Pattern table: The wheels above that have an entry in triggerPatterns, run through the pattern decoder instead of their own
+static void configPattern24X(void)
+{
+    configPage4.TrigPattern = DECODER_PATTERN;
+    configPage4.triggerMissingTeeth = 0;
+    sequential(); //The cam only gives the revolution
+}
+static void configPattern36_2_2_2(void)
+{
+    configPage4.TrigPattern = DECODER_PATTERN;
+    configPage4.triggerMissingTeeth = 1;
+}
+static void configPattern36_2_1(void)
+{
+    configPage4.TrigPattern = DECODER_PATTERN;
+    configPage4.triggerMissingTeeth = 2;
+}
+static void configPatternHondaJ32(void)
+{
+    configPage4.TrigPattern = DECODER_PATTERN;
+    configPage4.triggerMissingTeeth = 3;
+    configPage2.nCylinders = 6;
+}
+static void configPatternSuzukiK6A(void)
+{
+    configPage4.TrigPattern = DECODER_PATTERN;
+    configPage4.triggerMissingTeeth = 4;
+    configPage2.nCylinders = 3;
+}
+
+const replay_wheel_t replayWheels[] = {
+    { "missingTooth", configMissingTooth,     buildMissingTooth },
+    { "basicDist",    configBasicDistributor, buildBasicDistributor },
+    { "dualWheel",    configDualWheel,        buildDualWheel },
+    { "GM7X",         configGM7X,             buildGM7X },
+    { "4G63",         config4G63,             build4G63 },
+    { "24X",          config24X,              build24X },
+    { "jeep2000",     configJeep2000,         buildJeep2000 },
+    { "audi135",      configAudi135,          buildAudi135 },
+    { "hondaD17",     configHondaD17,         buildHondaD17 },
+    { "hondaJ32",     configHondaJ32,         buildHondaJ32 },
+    { "miata9905",    configMiata9905,        buildMiata9905 },
+    { "mazdaAU",      configMazdaAU,          buildMazdaAU },
+    { "non360",       configNon360,           buildNon360 },
+    { "nissan360",    configNissan360,        buildNissan360 },
+    { "subaru67",     configSubaru67,         buildSubaru67 },
+    { "daihatsu",     configDaihatsu,         buildDaihatsu },
+    { "harley",       configHarley,           buildHarley },
+    { "36-2-2-2",     config36_2_2_2,         build36_2_2_2 },
+    { "36-2-1",       config36_2_1,           build36_2_1 },
+    { "420a",         config420a,             build420a },
+    { "weber",        configWeber,            buildWeber },
+    { "ST170",        configST170,            buildST170 },
+    { "DRZ400",       configDRZ400,           buildDRZ400 },
+    { "NGC",          configNGC,              buildNGC },
+    { "vmax",         configVmax,             buildVmax },
+    { "renix",        configRenix,            buildRenix },
+    { "roverMEMS",    configRoverMEMS,        buildRoverMEMS },
+    { "suzukiK6A",    configSuzukiK6A,        buildSuzukiK6A },
+    { "pat24X",       configPattern24X,       build24X },
+    { "pat36-2-2-2",  configPattern36_2_2_2,  build36_2_2_2 },
+    { "pat36-2-1",    configPattern36_2_1,    build36_2_1 },
+    { "patHondaJ32",  configPatternHondaJ32,  buildHondaJ32 },
+    { "patSuzukiK6A", configPatternSuzukiK6A, buildSuzukiK6A },
+};
+const uint8_t replayWheelCount = ARRAY_COUNT(replayWheels);
+static_assert(ARRAY_COUNT(replayWheels) <= REPLAY_MAX_WHEELS, "Raise REPLAY_MAX_WHEELS");
@@ -74,6 +74,34 @@ void test_adjust_crank_angle_running()
     TEST_ASSERT_FALSE(schedule.endScheduleSetByDecoder);
 }
 
+void test_adjust_crank_angle_running_since_tooth()
+{
+    auto counter = decltype(+IGN4_COUNTER){0};
+    auto compare = decltype(+IGN4_COMPARE){0};
+    IgnitionSchedule schedule(counter, compare, nullIgnCallback, nullIgnCallback);
+    
+    schedule.Status = RUNNING;
+    currentStatus.startRevolutions = 2000;
+    setAngleConverterRevolutionTime(10000UL); //6000rpm, 27.7uS per degree
+
+    schedule.compare = 101;
+    schedule.counter = 100;
+    constexpr uint16_t newCrankAngle = 180;
+    constexpr uint16_t chargeAngle = 359;
+
+    // The tooth was 200uS ago, so the spark is 200uS closer than the angle says
+    adjustCrankAngle(schedule, chargeAngle, newCrankAngle, 200U);
+    TEST_ASSERT_EQUAL(schedule.counter+uS_TO_TIMER_COMPARE(angleToTimeMicroSecPerDegree(chargeAngle-newCrankAngle) - 200U), schedule.compare);
+
+    // Too close to the spark to take all of the time off, so it is set as close as it can be
+    adjustCrankAngle(schedule, newCrankAngle + 1, newCrankAngle, 200U);
+    TEST_ASSERT_EQUAL(schedule.counter+uS_TO_TIMER_COMPARE(IGNITION_REFRESH_THRESHOLD), schedule.compare);
+
+    // The spark was due before now
+    adjustCrankAngle(schedule, newCrankAngle + 5, newCrankAngle, 200U);
+    TEST_ASSERT_EQUAL(schedule.counter+uS_TO_TIMER_COMPARE(IGNITION_REFRESH_THRESHOLD), schedule.compare);
+}
+
 void test_adjust_crank_angle()
 {
   SET_UNITY_FILENAME() {
@@ -81,5 +109,6 @@ void test_adjust_crank_angle()
     RUN_TEST(test_adjust_crank_angle_pending_below_minrevolutions);
     RUN_TEST(test_adjust_crank_angle_pending_above_minrevolutions);
     RUN_TEST(test_adjust_crank_angle_running);
+    RUN_TEST(test_adjust_crank_angle_running_since_tooth);
   }
 }
\ No newline at end of file
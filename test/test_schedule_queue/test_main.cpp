@@ -0,0 +1,373 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "scheduler.h"
+#include "schedule_queue.h"
+
+/*
+Runs every fuel and ignition schedule at once through setFuelSchedule()/setIgnitionSchedule() and checks that each
+starts and ends on time. This passes with either scheduler backend, the single timer queue is tested with:
+  pio test -e native_schedule_queue -f test_schedule_queue
+and the per channel compares with:
+  pio test -e native -f test_schedule_queue
+The 32-bit schedule timer is tested with:
+  pio test -e native_timer_32bit -f test_schedule_queue
+*/
+
+static uint32_t fuelStartTime[INJ_CHANNELS];
+static uint32_t fuelEndTime[INJ_CHANNELS];
+static uint8_t fuelPulses[INJ_CHANNELS];
+static uint32_t fuelPulseStart[INJ_CHANNELS][FUEL_SPLIT_MAX_PULSES]; //Start and end of the first FUEL_SPLIT_MAX_PULSES pulses
+static uint32_t fuelPulseEnd[INJ_CHANNELS][FUEL_SPLIT_MAX_PULSES];
+static uint32_t ignStartTime[IGN_CHANNELS];
+static uint32_t ignEndTime[IGN_CHANNELS];
+static uint8_t ignSparks[IGN_CHANNELS];
+
+template <uint8_t channel> static void fuelStart(void)
+{
+    fuelStartTime[channel] = micros();
+    if (fuelPulses[channel] < FUEL_SPLIT_MAX_PULSES) { fuelPulseStart[channel][fuelPulses[channel]] = fuelStartTime[channel]; }
+}
+template <uint8_t channel> static void fuelEnd(void)
+{
+    fuelEndTime[channel] = micros();
+    if (fuelPulses[channel] < FUEL_SPLIT_MAX_PULSES) { fuelPulseEnd[channel][fuelPulses[channel]] = fuelEndTime[channel]; }
+    fuelPulses[channel]++;
+}
+template <uint8_t channel> static void ignStart(void) { ignStartTime[channel] = micros(); }
+template <uint8_t channel> static void ignEnd(void) { ignEndTime[channel] = micros(); ignSparks[channel]++; }
+
+static FuelSchedule * const fuelSchedules[INJ_CHANNELS] = {
+    &fuelSchedule1, &fuelSchedule2, &fuelSchedule3, &fuelSchedule4,
+    &fuelSchedule5, &fuelSchedule6, &fuelSchedule7, &fuelSchedule8,
+};
+static IgnitionSchedule * const ignitionSchedules[IGN_CHANNELS] = {
+    &ignitionSchedule1, &ignitionSchedule2, &ignitionSchedule3, &ignitionSchedule4,
+    &ignitionSchedule5, &ignitionSchedule6, &ignitionSchedule7, &ignitionSchedule8,
+};
+static_assert(INJ_CHANNELS == 8 && IGN_CHANNELS == 8, "The native board has 8 fuel and 8 ignition channels");
+
+static void resetSchedules(void)
+{
+    nativeReset();
+    initialiseSchedulers();
+
+    fuelSchedule1.pStartFunction = fuelStart<0>; fuelSchedule1.pEndFunction = fuelEnd<0>;
+    fuelSchedule2.pStartFunction = fuelStart<1>; fuelSchedule2.pEndFunction = fuelEnd<1>;
+    fuelSchedule3.pStartFunction = fuelStart<2>; fuelSchedule3.pEndFunction = fuelEnd<2>;
+    fuelSchedule4.pStartFunction = fuelStart<3>; fuelSchedule4.pEndFunction = fuelEnd<3>;
+    fuelSchedule5.pStartFunction = fuelStart<4>; fuelSchedule5.pEndFunction = fuelEnd<4>;
+    fuelSchedule6.pStartFunction = fuelStart<5>; fuelSchedule6.pEndFunction = fuelEnd<5>;
+    fuelSchedule7.pStartFunction = fuelStart<6>; fuelSchedule7.pEndFunction = fuelEnd<6>;
+    fuelSchedule8.pStartFunction = fuelStart<7>; fuelSchedule8.pEndFunction = fuelEnd<7>;
+
+    ignitionSchedule1.pStartCallback = ignStart<0>; ignitionSchedule1.pEndCallback = ignEnd<0>;
+    ignitionSchedule2.pStartCallback = ignStart<1>; ignitionSchedule2.pEndCallback = ignEnd<1>;
+    ignitionSchedule3.pStartCallback = ignStart<2>; ignitionSchedule3.pEndCallback = ignEnd<2>;
+    ignitionSchedule4.pStartCallback = ignStart<3>; ignitionSchedule4.pEndCallback = ignEnd<3>;
+    ignitionSchedule5.pStartCallback = ignStart<4>; ignitionSchedule5.pEndCallback = ignEnd<4>;
+    ignitionSchedule6.pStartCallback = ignStart<5>; ignitionSchedule6.pEndCallback = ignEnd<5>;
+    ignitionSchedule7.pStartCallback = ignStart<6>; ignitionSchedule7.pEndCallback = ignEnd<6>;
+    ignitionSchedule8.pStartCallback = ignStart<7>; ignitionSchedule8.pEndCallback = ignEnd<7>;
+
+    memset(fuelStartTime, 0, sizeof(fuelStartTime));
+    memset(fuelEndTime, 0, sizeof(fuelEndTime));
+    memset(fuelPulses, 0, sizeof(fuelPulses));
+    memset(fuelPulseStart, 0, sizeof(fuelPulseStart));
+    memset(fuelPulseEnd, 0, sizeof(fuelPulseEnd));
+    memset(&fuelSplit, 0, sizeof(fuelSplit));
+    memset(ignStartTime, 0, sizeof(ignStartTime));
+    memset(ignEndTime, 0, sizeof(ignEndTime));
+    memset(ignSparks, 0, sizeof(ignSparks));
+    memset(&ignitionMultiSpark, 0, sizeof(ignitionMultiSpark));
+}
+
+static void test_schedule_all_channels_overlapping(void)
+{
+    resetSchedules();
+
+    //Interleave the fuel and ignition events, including 2 that start at the same time
+    for (uint8_t channel = 0U; channel < INJ_CHANNELS; ++channel)
+    {
+        setFuelSchedule(*fuelSchedules[channel], 100U + (channel * 20U), 1000U + (channel * 3U));
+        if (channel < (IGN_CHANNELS - 1U)) { setIgnitionSchedule(*ignitionSchedules[channel], 110U + (channel * 20U), 500U); }
+    }
+    setIgnitionSchedule(ignitionSchedule8, 100U, 700U);
+
+    nativeAdvanceMicros(5000U);
+
+    for (uint8_t channel = 0U; channel < INJ_CHANNELS; ++channel)
+    {
+        TEST_ASSERT_EQUAL_UINT32(100U + (channel * 20U), fuelStartTime[channel]);
+        TEST_ASSERT_EQUAL_UINT32(1100U + (channel * 23U), fuelEndTime[channel]);
+        TEST_ASSERT_EQUAL(OFF, fuelSchedules[channel]->Status);
+    }
+    for (uint8_t channel = 0U; channel < (IGN_CHANNELS - 1U); ++channel)
+    {
+        TEST_ASSERT_EQUAL_UINT32(110U + (channel * 20U), ignStartTime[channel]);
+        TEST_ASSERT_EQUAL_UINT32(610U + (channel * 20U), ignEndTime[channel]);
+        TEST_ASSERT_EQUAL(OFF, ignitionSchedules[channel]->Status);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100U, ignStartTime[IGN_CHANNELS - 1U]);
+    TEST_ASSERT_EQUAL_UINT32(800U, ignEndTime[IGN_CHANNELS - 1U]);
+
+#if defined(USE_SCHEDULE_QUEUE)
+    TEST_ASSERT_FALSE(nativeQueueTimerEnabled); //Nothing left to run
+#endif
+}
+
+static void test_schedule_next_while_running(void)
+{
+    resetSchedules();
+
+    setFuelSchedule(fuelSchedule3, 200U, 2000U);
+    nativeAdvanceMicros(500U);
+    TEST_ASSERT_EQUAL(RUNNING, fuelSchedule3.Status);
+
+    //Queue the next pulse while this one is still open
+    setFuelSchedule(fuelSchedule3, 3000U, 2000U);
+    nativeAdvanceMicros(10000U);
+
+    TEST_ASSERT_EQUAL(2, fuelPulses[2]);
+    TEST_ASSERT_EQUAL_UINT32(3500U, fuelStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(5500U, fuelEndTime[2]);
+}
+
+static void test_schedule_next_requeued(void)
+{
+    resetSchedules();
+
+    setFuelSchedule(fuelSchedule3, 200U, 2000U);
+    setIgnitionSchedule(ignitionSchedule3, 200U, 2000U);
+    nativeAdvanceMicros(500U);
+
+    //Each loop queues the next cycle again. The latest one replaces the queued one, which is never withdrawn in between
+    setFuelSchedule(fuelSchedule3, 3000U, 2000U);
+    setIgnitionSchedule(ignitionSchedule3, 3000U, 2000U);
+    nativeAdvanceMicros(100U);
+    setFuelSchedule(fuelSchedule3, 2950U, 1500U);
+    setIgnitionSchedule(ignitionSchedule3, 2950U, 1500U);
+    TEST_ASSERT_NOT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, fuelSchedule3.nextCycle);
+    TEST_ASSERT_NOT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, ignitionSchedule3.nextCycle);
+    nativeAdvanceMicros(10000U);
+
+    TEST_ASSERT_EQUAL(2, fuelPulses[2]);
+    TEST_ASSERT_EQUAL_UINT32(3550U, fuelStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(5050U, fuelEndTime[2]);
+    TEST_ASSERT_EQUAL(2, ignSparks[2]);
+    TEST_ASSERT_EQUAL_UINT32(3550U, ignStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(5050U, ignEndTime[2]);
+}
+
+//A next cycle queued behind an earlier pulse (The pulse ended while it was being written) is not taken up
+static void test_schedule_next_stale(void)
+{
+    resetSchedules();
+
+    setFuelSchedule(fuelSchedule3, 200U, 2000U);
+    setIgnitionSchedule(ignitionSchedule3, 200U, 2000U);
+    nativeAdvanceMicros(500U);
+    setFuelSchedule(fuelSchedule3, 3000U, 2000U);
+    setIgnitionSchedule(ignitionSchedule3, 3000U, 2000U);
+    fuelSchedule3.cycles[fuelSchedule3.nextCycle].endCount--;
+    ignitionSchedule3.cycles[ignitionSchedule3.nextCycle].endCount--;
+    nativeAdvanceMicros(10000U);
+
+    TEST_ASSERT_EQUAL(1, fuelPulses[2]);
+    TEST_ASSERT_EQUAL(OFF, fuelSchedule3.Status);
+    TEST_ASSERT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, fuelSchedule3.nextCycle);
+    TEST_ASSERT_EQUAL(1, ignSparks[2]);
+    TEST_ASSERT_EQUAL(OFF, ignitionSchedule3.Status);
+}
+
+static void test_schedule_long_timeout(void)
+{
+    resetSchedules();
+
+    //Longer than half the timer period, so the queue has to service itself part way
+    nativeAdvanceMicros(1234U);
+    setFuelSchedule(fuelSchedule1, 60000U, 1000U);
+    setIgnitionSchedule(ignitionSchedule1, 40000U, 30000U);
+    nativeAdvanceMicros(100000U);
+
+    TEST_ASSERT_EQUAL_UINT32(61234U, fuelStartTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(62234U, fuelEndTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(41234U, ignStartTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(71234U, ignEndTime[0]);
+}
+
+static void test_schedule_beyond_16bit_timer(void)
+{
+    resetSchedules();
+
+    //2 seconds is out of range of any 16-bit schedule timer
+    nativeAdvanceMicros(1234U);
+    setFuelSchedule(fuelSchedule1, 2000000U, 1000U);
+    setIgnitionSchedule(ignitionSchedule1, 2000000U, 3000U);
+    nativeAdvanceMicros(2010000U);
+
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+    TEST_ASSERT_EQUAL_UINT32(2001234U, fuelStartTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(2002234U, fuelEndTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(2001234U, ignStartTime[0]);
+    TEST_ASSERT_EQUAL_UINT32(2004234U, ignEndTime[0]);
+#else
+    //Refused rather than scheduled at the wrong time
+    TEST_ASSERT_EQUAL(0, fuelPulses[0]);
+    TEST_ASSERT_EQUAL(0, ignSparks[0]);
+#endif
+}
+
+static void test_schedule_disable_pending(void)
+{
+    resetSchedules();
+
+    setFuelSchedule(fuelSchedule2, 1000U, 500U);
+    setFuelSchedule(fuelSchedule4, 1000U, 500U);
+    disablePendingFuelSchedule(1);
+    nativeAdvanceMicros(5000U);
+
+    TEST_ASSERT_EQUAL(0, fuelPulses[1]);
+    TEST_ASSERT_EQUAL(1, fuelPulses[3]);
+}
+
+static void test_schedule_split_injection(void)
+{
+    resetSchedules();
+
+    //3 pulses: 1000uS of fuel (After 500uS opening time) split 50/30/20
+    fuelSplit.pulses = 2U;
+    fuelSplit.percent[0] = 30U;
+    fuelSplit.percent[1] = 20U;
+    fuelSplit.gap[0] = 2000U;
+    fuelSplit.gap[1] = 1000U;
+    fuelSplit.openTime = 500U;
+    setFuelSchedule(fuelSchedule5, 100U, 1500U);
+    setFuelSchedule(fuelSchedule6, 100U, 1500U);
+
+    //The next cycle can't be queued until the last pulse of this one is running
+    nativeAdvanceMicros(700U);
+    TEST_ASSERT_EQUAL(RUNNING, fuelSchedule5.Status);
+    setFuelSchedule(fuelSchedule5, 5000U, 1500U);
+    TEST_ASSERT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, fuelSchedule5.nextCycle);
+
+    nativeAdvanceMicros(20000U);
+
+    TEST_ASSERT_EQUAL(FUEL_SPLIT_MAX_PULSES, fuelPulses[4]);
+    TEST_ASSERT_EQUAL_UINT32(100U, fuelPulseStart[4][0]);
+    TEST_ASSERT_EQUAL_UINT32(100U + 1000U, fuelPulseEnd[4][0]);
+    TEST_ASSERT_EQUAL_UINT32(1100U + 2000U, fuelPulseStart[4][1]);
+    TEST_ASSERT_EQUAL_UINT32(3100U + 800U, fuelPulseEnd[4][1]);
+    TEST_ASSERT_EQUAL_UINT32(3900U + 1000U, fuelPulseStart[4][2]);
+    TEST_ASSERT_EQUAL_UINT32(4900U + 700U, fuelPulseEnd[4][2]);
+    TEST_ASSERT_EQUAL(OFF, fuelSchedule5.Status);
+
+    //Channels are split independently
+    TEST_ASSERT_EQUAL(FUEL_SPLIT_MAX_PULSES, fuelPulses[5]);
+    TEST_ASSERT_EQUAL_UINT32(5600U, fuelEndTime[5]);
+
+    //Once the last pulse is running, the next cycle is queued behind it as normal
+    setFuelSchedule(fuelSchedule5, 100U, 1500U); //Starts at 20800
+    nativeAdvanceMicros(4100U);
+    TEST_ASSERT_EQUAL(PENDING, fuelSchedule5.Status); //Waiting for the last pulse
+    nativeAdvanceMicros(1000U);
+    TEST_ASSERT_EQUAL(RUNNING, fuelSchedule5.Status);
+    fuelSplit.pulses = 0U;
+    setFuelSchedule(fuelSchedule5, 3000U, 1500U);
+    TEST_ASSERT_NOT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, fuelSchedule5.nextCycle);
+    nativeAdvanceMicros(10000U);
+    TEST_ASSERT_EQUAL((FUEL_SPLIT_MAX_PULSES * 2U) + 1U, fuelPulses[4]);
+    TEST_ASSERT_EQUAL_UINT32(28800U, fuelStartTime[4]);
+    TEST_ASSERT_EQUAL_UINT32(30300U, fuelEndTime[4]);
+}
+
+static void test_schedule_multi_spark(void)
+{
+    resetSchedules();
+
+    //2 repeat sparks, each 500uS after the previous spark with 1000uS of dwell
+    ignitionMultiSpark.sparks = 2U;
+    ignitionMultiSpark.dwell = 1000U;
+    ignitionMultiSpark.rest = 500U;
+    uint16_t startCount = ignitionCount;
+    setIgnitionSchedule(ignitionSchedule2, 100U, 2000U);
+
+    nativeAdvanceMicros(2300U);
+    TEST_ASSERT_EQUAL(1, ignSparks[1]);
+    TEST_ASSERT_EQUAL_UINT32(2100U, ignEndTime[1]);
+    TEST_ASSERT_EQUAL(PENDING, ignitionSchedule2.Status); //Waiting for the spark to finish
+
+    //Repeat sparks are not overwritten by the next cycle
+    setIgnitionSchedule(ignitionSchedule2, 100U, 2000U);
+    nativeAdvanceMicros(500U);
+    TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule2.Status);
+    TEST_ASSERT_EQUAL_UINT32(2600U, ignStartTime[1]);
+    setIgnitionSchedule(ignitionSchedule2, 100U, 2000U);
+    TEST_ASSERT_EQUAL(SCHEDULE_NO_NEXT_CYCLE, ignitionSchedule2.nextCycle);
+
+    nativeAdvanceMicros(5000U);
+    TEST_ASSERT_EQUAL(3, ignSparks[1]);
+    TEST_ASSERT_EQUAL_UINT32(4100U, ignStartTime[1]);
+    TEST_ASSERT_EQUAL_UINT32(5100U, ignEndTime[1]);
+    TEST_ASSERT_EQUAL(OFF, ignitionSchedule2.Status);
+    TEST_ASSERT_EQUAL(1, (uint16_t)(ignitionCount - startCount)); //Only the primary spark is an ignition event
+
+    //The next cycle starts with a new primary spark
+    ignitionMultiSpark.sparks = 0U;
+    setIgnitionSchedule(ignitionSchedule2, 1000U, 2000U);
+    nativeAdvanceMicros(5000U);
+    TEST_ASSERT_EQUAL(4, ignSparks[1]);
+    TEST_ASSERT_EQUAL_UINT32(8800U, ignStartTime[1]);
+    TEST_ASSERT_EQUAL_UINT32(10800U, ignEndTime[1]);
+}
+
+static void test_schedule_update_pending(void)
+{
+    resetSchedules();
+
+    //A pending schedule well away from its start is moved to the new time
+    setIgnitionSchedule(ignitionSchedule3, 2000U, 1000U);
+    nativeAdvanceMicros(500U);
+    setIgnitionSchedule(ignitionSchedule3, 1000U, 1500U);
+    nativeAdvanceMicros(5000U);
+    TEST_ASSERT_EQUAL_UINT32(1500U, ignStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(3000U, ignEndTime[2]);
+
+    //Within SCHEDULE_UPDATE_THRESHOLD of starting it is left alone, so it can't be missed or fire twice
+    setIgnitionSchedule(ignitionSchedule3, 1000U, 1000U);
+    nativeAdvanceMicros(1000U - (SCHEDULE_UPDATE_THRESHOLD / 2U));
+    setIgnitionSchedule(ignitionSchedule3, 2000U, 1500U);
+    nativeAdvanceMicros(5000U);
+    TEST_ASSERT_EQUAL(2, ignSparks[2]);
+    TEST_ASSERT_EQUAL_UINT32(6500U, ignStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(7500U, ignEndTime[2]);
+
+    //Nor is it moved to start within SCHEDULE_UPDATE_THRESHOLD, where it could fire before the move is recorded
+    uint32_t setTime = micros();
+    setFuelSchedule(fuelSchedule3, 1000U, 1000U);
+    nativeAdvanceMicros(500U);
+    setFuelSchedule(fuelSchedule3, SCHEDULE_UPDATE_THRESHOLD / 2U, 1500U);
+    nativeAdvanceMicros(5000U);
+    TEST_ASSERT_EQUAL(1, fuelPulses[2]);
+    TEST_ASSERT_EQUAL_UINT32(setTime + 1000U, fuelStartTime[2]);
+    TEST_ASSERT_EQUAL_UINT32(setTime + 2000U, fuelEndTime[2]);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_schedule_all_channels_overlapping);
+    RUN_TEST(test_schedule_next_while_running);
+    RUN_TEST(test_schedule_next_requeued);
+    RUN_TEST(test_schedule_next_stale);
+    RUN_TEST(test_schedule_long_timeout);
+    RUN_TEST(test_schedule_beyond_16bit_timer);
+    RUN_TEST(test_schedule_disable_pending);
+    RUN_TEST(test_schedule_split_injection);
+    RUN_TEST(test_schedule_multi_spark);
+    RUN_TEST(test_schedule_update_pending);
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <unity.h>
+#include "globals.h"
+#include "config.h"
+#include "init.h"
+#include "scheduledIO.h"
+#include "acc_mc33810.h"
+
+/*
+Checks that the paired injector and coil outputs switch both of their outputs, directly and through the MC33810.
+Native only:
+  pio test -e native -f test_scheduled_io
+*/
+
+#define TEST_MC33810_1_CS 66
+#define TEST_MC33810_2_CS 67
+
+static uint8_t mc33810Outputs[2]; //The last output state sent to each IC by an on/off command
+static uint8_t mc33810Command;
+static bool mc33810CommandByte = true; //transfer16() sends the command, then the data
+
+static uint8_t mc33810Device(uint8_t data)
+{
+    if(mc33810CommandByte) { mc33810Command = data; }
+    else if(mc33810Command == MC33810_ONOFF_CMD)
+    {
+        if(nativeGetPin(TEST_MC33810_1_CS) == LOW) { mc33810Outputs[0] = data; }
+        if(nativeGetPin(TEST_MC33810_2_CS) == LOW) { mc33810Outputs[1] = data; }
+    }
+    mc33810CommandByte = !mc33810CommandByte;
+    return 0U;
+}
+
+static void setupOutputs(uint8_t outputControl)
+{
+    nativeReset();
+    setPinMapping(3);
+    configPage4.IgInv = GOING_LOW; //Coils charge with their output high
+    injectorOutputControl = outputControl;
+    ignitionOutputControl = outputControl;
+    if(outputControl == OUTPUT_CONTROL_MC33810)
+    {
+        pinMC33810_1_CS = TEST_MC33810_1_CS;
+        pinMC33810_2_CS = TEST_MC33810_2_CS;
+        mc33810CommandByte = true;
+        SPI.attachDevice(mc33810Device);
+        initMC33810();
+    }
+    initialiseOutputDrivers();
+}
+
+static void test_scheduled_io_pair_direct(void)
+{
+    setupOutputs(OUTPUT_CONTROL_DIRECT);
+
+    openInjector1and3();
+    TEST_ASSERT_EQUAL(HIGH, nativeGetPin(pinInjector1));
+    TEST_ASSERT_EQUAL(HIGH, nativeGetPin(pinInjector3));
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinInjector2));
+    closeInjector1and3();
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinInjector1));
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinInjector3));
+
+    beginCoil2and4Charge();
+    TEST_ASSERT_EQUAL(HIGH, nativeGetPin(pinCoil2));
+    TEST_ASSERT_EQUAL(HIGH, nativeGetPin(pinCoil4));
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinCoil1));
+    endCoil2and4Charge();
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinCoil2));
+    TEST_ASSERT_EQUAL(LOW, nativeGetPin(pinCoil4));
+}
+
+static void test_scheduled_io_pair_mc33810(void)
+{
+    setupOutputs(OUTPUT_CONTROL_MC33810);
+    const uint8_t savedInj1 = MC33810_BIT_INJ1;
+    const uint8_t savedInj3 = MC33810_BIT_INJ3;
+    //Changed after the drivers were selected, as a board's setup can. The pairs must follow the same bits as the single outputs
+    MC33810_BIT_INJ1 = 6;
+    MC33810_BIT_INJ3 = 7;
+
+    openInjector1and3();
+    TEST_ASSERT_EQUAL_UINT8((1U << 6) | (1U << 7), mc33810Outputs[0]);
+    closeInjector1and3();
+    TEST_ASSERT_EQUAL_UINT8(0U, mc33810Outputs[0]);
+
+    openInjector1();
+    openInjector3();
+    const uint8_t singleOutputs = mc33810Outputs[0];
+    closeInjector1();
+    closeInjector3();
+    openInjector1and3();
+    TEST_ASSERT_EQUAL_UINT8(singleOutputs, mc33810Outputs[0]);
+    closeInjector1and3();
+
+    //A pair across both ICs sends a command to each
+    openInjector1and5();
+    TEST_ASSERT_EQUAL_UINT8((1U << 6), mc33810Outputs[0]);
+    TEST_ASSERT_EQUAL_UINT8((1U << MC33810_BIT_INJ5), mc33810Outputs[1]);
+    closeInjector1and5();
+    TEST_ASSERT_EQUAL_UINT8(0U, mc33810Outputs[0]);
+    TEST_ASSERT_EQUAL_UINT8(0U, mc33810Outputs[1]);
+
+    MC33810_BIT_INJ1 = savedInj1;
+    MC33810_BIT_INJ3 = savedInj3;
+    SPI.attachDevice(NULL);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_scheduled_io_pair_direct);
+    RUN_TEST(test_scheduled_io_pair_mc33810);
+    return UNITY_END();
+}
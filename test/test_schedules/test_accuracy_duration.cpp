@@ -18,7 +18,7 @@ void test_accuracy_duration_inj(FuelSchedule &schedule)
     schedule.pStartFunction = startCallback;
     schedule.pEndFunction = endCallback;
     setFuelSchedule(schedule, TIMEOUT, DURATION);
-    while(schedule.Status != OFF) /*Wait*/ ;
+    WAIT_WHILE(schedule.Status != OFF);
     TEST_ASSERT_UINT32_WITHIN(DELTA, DURATION, end_time - start_time);
 }
 
@@ -76,7 +76,7 @@ void test_accuracy_duration_ign(IgnitionSchedule &schedule)
     schedule.pStartCallback = startCallback;
     schedule.pEndCallback = endCallback;
     setIgnitionSchedule(schedule, TIMEOUT, DURATION);
-    while(schedule.Status != OFF) /*Wait*/ ;
+    WAIT_WHILE(schedule.Status != OFF);
     TEST_ASSERT_UINT32_WITHIN(DELTA, DURATION, end_time - start_time);    
 
 }
@@ -20,7 +20,7 @@ void test_accuracy_timeout_inj(FuelSchedule &schedule)
     schedule.pEndFunction = endCallback;
     start_time = micros();
     setFuelSchedule(schedule, TIMEOUT, DURATION);
-    while(schedule.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(schedule.Status == PENDING);
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -79,7 +79,7 @@ void test_accuracy_timeout_ign(IgnitionSchedule &schedule)
     schedule.pEndCallback = endCallback;
     start_time = micros();
     setIgnitionSchedule(schedule, TIMEOUT, DURATION);
-    while(schedule.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(schedule.Status == PENDING);
     TEST_ASSERT_UINT32_WITHIN(DELTA, TIMEOUT, end_time - start_time);
 }
 
@@ -131,6 +131,33 @@ void test_accuracy_timeout_ign8(void)
 }
 #endif
 
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+//Further away than a 16-bit schedule timer can reach at any resolution that the boards use
+#define LONG_TIMEOUT 1500000UL
+
+void test_accuracy_timeout_long_inj1(void)
+{
+    initialiseSchedulers();
+    fuelSchedule1.pStartFunction = startCallback;
+    fuelSchedule1.pEndFunction = endCallback;
+    start_time = micros();
+    setFuelSchedule(fuelSchedule1, LONG_TIMEOUT, DURATION);
+    WAIT_WHILE(fuelSchedule1.Status == PENDING);
+    TEST_ASSERT_UINT32_WITHIN(DELTA, LONG_TIMEOUT, end_time - start_time);
+}
+
+void test_accuracy_timeout_long_ign1(void)
+{
+    initialiseSchedulers();
+    ignitionSchedule1.pStartCallback = startCallback;
+    ignitionSchedule1.pEndCallback = endCallback;
+    start_time = micros();
+    setIgnitionSchedule(ignitionSchedule1, LONG_TIMEOUT, DURATION);
+    WAIT_WHILE(ignitionSchedule1.Status == PENDING);
+    TEST_ASSERT_UINT32_WITHIN(DELTA, LONG_TIMEOUT, end_time - start_time);
+}
+#endif
+
 void test_accuracy_timeout(void)
 {
   SET_UNITY_FILENAME() {
@@ -167,6 +194,10 @@ void test_accuracy_timeout(void)
 #endif
 #if IGN_CHANNELS >= 8
     RUN_TEST(test_accuracy_timeout_ign8);
+#endif
+#if defined(USE_SCHEDULE_TIMER_32BIT)
+    RUN_TEST(test_accuracy_timeout_long_inj1);
+    RUN_TEST(test_accuracy_timeout_long_ign1);
 #endif
   }
 }
@@ -1,17 +1,15 @@
 #include <Arduino.h>
 #include <unity.h>
+#include <globals.h>
 #include <init.h>
+#if defined(SIMULATOR)
 #include <avr/sleep.h>
+#endif
 
 #include "test_schedules.h"
 
-void setup()
+static int runSchedulesTests(void)
 {
-  pinMode(LED_BUILTIN, OUTPUT);
-#if !defined(SIMULATOR)
-    delay(2000);
-#endif
-
   UNITY_BEGIN(); // start unit testing
 
   initialiseAll(); //Run the main initialise function
@@ -23,7 +21,32 @@ void setup()
   test_accuracy_timeout();
   test_accuracy_duration();
   
-  UNITY_END(); // stop unit testing
+  return UNITY_END(); // stop unit testing
+}
+
+#if defined(NATIVE_BOARD)
+/*
+The native board runs the schedules from its virtual clock, which WAIT_WHILE() advances (See test_utils.h):
+  pio test -e native -f test_schedules
+  pio test -e native_timer_32bit -f test_schedules
+*/
+int main(int argc, char **argv)
+{
+  (void)argc;
+  (void)argv;
+
+  nativeReset();
+  return runSchedulesTests();
+}
+#else
+void setup()
+{
+  pinMode(LED_BUILTIN, OUTPUT);
+#if !defined(SIMULATOR)
+    delay(2000);
+#endif
+
+  (void)runSchedulesTests();
 
 #if defined(SIMULATOR)       // Tell SimAVR we are done
     cli();
@@ -38,4 +61,5 @@ void loop()
     delay(250);
     digitalWrite(LED_BUILTIN, LOW);
     delay(250);
-}
\ No newline at end of file
+};
+#endif
@@ -13,7 +13,7 @@ void test_status_pending_to_running_inj1(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule1, TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule1.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule1.Status);
 }
 
@@ -21,7 +21,7 @@ void test_status_pending_to_running_inj2(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule2, TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule2.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule2.Status);
 }
 
@@ -29,7 +29,7 @@ void test_status_pending_to_running_inj3(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule3, TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule3.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule3.Status);
 }
 
@@ -37,7 +37,7 @@ void test_status_pending_to_running_inj4(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule4, TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule4.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule4.Status);
 }
 
@@ -46,7 +46,7 @@ void test_status_pending_to_running_inj5(void)
 #if INJ_CHANNELS >= 5
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule5, TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule5.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule5.Status);
 #endif
 }
@@ -56,7 +56,7 @@ void test_status_pending_to_running_inj6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule6, TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule6.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule6.Status);
 #endif
 }
@@ -66,7 +66,7 @@ void test_status_pending_to_running_inj7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule7, TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule7.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule7.Status);
 #endif
 }
@@ -76,7 +76,7 @@ void test_status_pending_to_running_inj8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule8, TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule8.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, fuelSchedule8.Status);
 #endif
 }
@@ -88,7 +88,7 @@ void test_status_pending_to_running_ign1(void)
     ignitionSchedule1.pStartCallback = emptyCallback;
     ignitionSchedule1.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule1, TIMEOUT, DURATION);
-    while(ignitionSchedule1.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule1.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule1.Status);
 }
 
@@ -98,7 +98,7 @@ void test_status_pending_to_running_ign2(void)
     ignitionSchedule2.pStartCallback = emptyCallback;
     ignitionSchedule2.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule2, TIMEOUT, DURATION);
-    while(ignitionSchedule2.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule2.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule2.Status);
 }
 
@@ -108,7 +108,7 @@ void test_status_pending_to_running_ign3(void)
     ignitionSchedule3.pStartCallback = emptyCallback;
     ignitionSchedule3.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule3, TIMEOUT, DURATION);
-    while(ignitionSchedule3.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule3.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule3.Status);
 }
 
@@ -118,7 +118,7 @@ void test_status_pending_to_running_ign4(void)
     ignitionSchedule4.pStartCallback = emptyCallback;
     ignitionSchedule4.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule4, TIMEOUT, DURATION);
-    while(ignitionSchedule4.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule4.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule4.Status);
 }
 
@@ -129,7 +129,7 @@ void test_status_pending_to_running_ign5(void)
     ignitionSchedule5.pStartCallback = emptyCallback;
     ignitionSchedule5.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule5, TIMEOUT, DURATION);
-    while(ignitionSchedule5.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule5.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule5.Status);
 #endif
 }
@@ -141,7 +141,7 @@ void test_status_pending_to_running_ign6(void)
     ignitionSchedule6.pStartCallback = emptyCallback;
     ignitionSchedule6.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule6, TIMEOUT, DURATION);
-    while(ignitionSchedule6.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule6.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule6.Status);
 #endif
 }
@@ -153,7 +153,7 @@ void test_status_pending_to_running_ign7(void)
     ignitionSchedule7.pStartCallback = emptyCallback;
     ignitionSchedule7.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule7, TIMEOUT, DURATION);
-    while(ignitionSchedule7.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule7.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule7.Status);
 #endif
 }
@@ -165,7 +165,7 @@ void test_status_pending_to_running_ign8(void)
     ignitionSchedule8.pStartCallback = emptyCallback;
     ignitionSchedule8.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule8, TIMEOUT, DURATION);
-    while(ignitionSchedule8.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule8.Status == PENDING);
     TEST_ASSERT_EQUAL(RUNNING, ignitionSchedule8.Status);
 #endif
 }
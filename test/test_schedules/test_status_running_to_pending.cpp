@@ -13,9 +13,9 @@ void test_status_running_to_pending_inj1(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule1, TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule1.Status == PENDING);
     setFuelSchedule(fuelSchedule1, 2*TIMEOUT, DURATION);
-    while(fuelSchedule1.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule1.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule1.Status);
 }
 
@@ -23,9 +23,9 @@ void test_status_running_to_pending_inj2(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule2, TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule2.Status == PENDING);
     setFuelSchedule(fuelSchedule2, 2*TIMEOUT, DURATION);
-    while(fuelSchedule2.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule2.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule2.Status);
 }
 
@@ -33,9 +33,9 @@ void test_status_running_to_pending_inj3(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule3, TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule3.Status == PENDING);
     setFuelSchedule(fuelSchedule3, 2*TIMEOUT, DURATION);
-    while(fuelSchedule3.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule3.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule3.Status);
 }
 
@@ -43,9 +43,9 @@ void test_status_running_to_pending_inj4(void)
 {
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule4, TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule4.Status == PENDING);
     setFuelSchedule(fuelSchedule4, 2*TIMEOUT, DURATION);
-    while(fuelSchedule4.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule4.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule4.Status);
 }
 
@@ -54,9 +54,9 @@ void test_status_running_to_pending_inj5(void)
 #if INJ_CHANNELS >= 5
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule5, TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule5.Status == PENDING);
     setFuelSchedule(fuelSchedule5, 2*TIMEOUT, DURATION);
-    while(fuelSchedule5.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule5.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule5.Status);
 #endif
 }
@@ -66,9 +66,9 @@ void test_status_running_to_pending_inj6(void)
 #if INJ_CHANNELS >= 6
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule6, TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule6.Status == PENDING);
     setFuelSchedule(fuelSchedule6, 2*TIMEOUT, DURATION);
-    while(fuelSchedule6.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule6.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule6.Status);
 #endif
 }
@@ -78,9 +78,9 @@ void test_status_running_to_pending_inj7(void)
 #if INJ_CHANNELS >= 7
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule7, TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule7.Status == PENDING);
     setFuelSchedule(fuelSchedule7, 2*TIMEOUT, DURATION);
-    while(fuelSchedule7.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule7.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule7.Status);
 #endif
 }
@@ -90,9 +90,9 @@ void test_status_running_to_pending_inj8(void)
 #if INJ_CHANNELS >= 8
     initialiseSchedulers();
     setFuelSchedule(fuelSchedule8, TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule8.Status == PENDING);
     setFuelSchedule(fuelSchedule8, 2*TIMEOUT, DURATION);
-    while(fuelSchedule8.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(fuelSchedule8.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, fuelSchedule8.Status);
 #endif
 }
@@ -104,9 +104,9 @@ void test_status_running_to_pending_ign1(void)
     ignitionSchedule1.pStartCallback = emptyCallback;
     ignitionSchedule1.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule1, TIMEOUT, DURATION);
-    while(ignitionSchedule1.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule1.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule1, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule1.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule1.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule1.Status);
 }
 
@@ -116,9 +116,9 @@ void test_status_running_to_pending_ign2(void)
     ignitionSchedule2.pStartCallback = emptyCallback;
     ignitionSchedule2.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule2, TIMEOUT, DURATION);
-    while(ignitionSchedule2.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule2.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule2, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule2.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule2.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule2.Status);
 }
 
@@ -128,9 +128,9 @@ void test_status_running_to_pending_ign3(void)
     ignitionSchedule3.pStartCallback = emptyCallback;
     ignitionSchedule3.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule3, TIMEOUT, DURATION);
-    while(ignitionSchedule3.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule3.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule3, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule3.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule3.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule3.Status);
 }
 
@@ -140,9 +140,9 @@ void test_status_running_to_pending_ign4(void)
     ignitionSchedule4.pStartCallback = emptyCallback;
     ignitionSchedule4.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule4, TIMEOUT, DURATION);
-    while(ignitionSchedule4.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule4.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule4, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule4.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule4.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule4.Status);
 }
 
@@ -153,9 +153,9 @@ void test_status_running_to_pending_ign5(void)
     ignitionSchedule5.pStartCallback = emptyCallback;
     ignitionSchedule5.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule5, TIMEOUT, DURATION);
-    while(ignitionSchedule5.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule5.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule5, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule5.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule5.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule5.Status);
 #endif
 }
@@ -167,9 +167,9 @@ void test_status_running_to_pending_ign6(void)
     ignitionSchedule6.pStartCallback = emptyCallback;
     ignitionSchedule6.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule6, TIMEOUT, DURATION);
-    while(ignitionSchedule6.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule6.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule6, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule6.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule6.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule6.Status);
 #endif
 }
@@ -181,9 +181,9 @@ void test_status_running_to_pending_ign7(void)
     ignitionSchedule7.pStartCallback = emptyCallback;
     ignitionSchedule7.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule7, TIMEOUT, DURATION);
-    while(ignitionSchedule7.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule7.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule7, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule7.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule7.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule7.Status);
 #endif
 }
@@ -195,9 +195,9 @@ void test_status_running_to_pending_ign8(void)
     ignitionSchedule8.pStartCallback = emptyCallback;
     ignitionSchedule8.pEndCallback = emptyCallback;
     setIgnitionSchedule(ignitionSchedule8, TIMEOUT, DURATION);
-    while(ignitionSchedule8.Status == PENDING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule8.Status == PENDING);
     setIgnitionSchedule(ignitionSchedule8, 2*TIMEOUT, DURATION);
-    while(ignitionSchedule8.Status == RUNNING) /*Wait*/ ;
+    WAIT_WHILE(ignitionSchedule8.Status == RUNNING);
     TEST_ASSERT_EQUAL(PENDING, ignitionSchedule8.Status);
 #endif
 }
@@ -0,0 +1,365 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <stdio.h>
+#include "globals.h"
+#include "config.h"
+#include "../test_utils.h"
+#include "../timer.hpp"
+#include "bench_tables.h"
+
+/*
+Each trace is run twice per table. The first pass classifies every lookup by the path it takes through
+get3DTableValue()/find_bin_max() or table2D_getValue() and the second times the lookups alone. The cost of
+generating the trace is timed separately and subtracted.
+*/
+#if defined(__AVR__)
+#define BENCH_REPEATS 2U
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_REPEATS 200U
+#define BENCH_UNIT "ns"
+#endif
+
+struct bench_stats_t {
+    uint16_t lookups;
+    uint16_t exact;         ///< Same input(s) as the previous lookup, the cached output is returned
+    uint16_t sameBin;       ///< Per axis: Still in the cached bin
+    uint16_t neighbour;     ///< Per axis: In the bin either side of the cached one
+    uint16_t clamped;       ///< Per axis: Outside the axis
+    uint16_t searched;      ///< Per axis: Found by the linear search
+    uint32_t searchSteps;   ///< Bins tested by the linear searches
+    uint32_t timePerLookup; ///< BENCH_UNIT
+};
+
+static volatile int16_t benchSink; //Stops the lookups being optimised away
+
+/*
+***********************************************************************************************************
+* Traces
+* Each sample is a change of inputs, as seen by the next loop. Loops that see the same inputs as the last one
+* are answered from the lookup cache and are not included.
+*/
+static uint16_t noiseState;
+
+static void benchSeed(void) { noiseState = 0xACE1U; }
+
+//16 bit Galois LFSR. Gives the same sequence on every platform. Returns a value from -range to +range
+static int16_t benchNoise(int16_t range)
+{
+    noiseState = (noiseState >> 1U) ^ ((uint16_t)(-(int16_t)(noiseState & 1U)) & 0xB400U);
+    return (int16_t)(noiseState % (uint16_t)((2 * range) + 1)) - range;
+}
+
+static void benchWarm(bench_sample_t &sample)
+{
+    sample.clt = 128 + benchNoise(1); //88C
+    sample.iat = 75 + benchNoise(1);  //35C
+    sample.battery = 139 + benchNoise(2);
+}
+
+static void traceIdle(uint16_t index, bench_sample_t &sample)
+{
+    (void)index;
+    sample.rpm = 850 + benchNoise(25);
+    sample.load = 35 + benchNoise(2);
+    sample.tps2 = 1 + benchNoise(1);
+    benchWarm(sample);
+}
+
+static void traceWOT(uint16_t index, bench_sample_t &sample)
+{
+    //2000 to 7000rpm pull at full load
+    sample.rpm = 2000 + (int16_t)(((uint32_t)index * 5000UL) / 1024UL) + benchNoise(10);
+    sample.load = 98 + benchNoise(2);
+    sample.tps2 = 200;
+    benchWarm(sample);
+}
+
+static void traceSnap(uint16_t index, bench_sample_t &sample)
+{
+    //Idle, snap the throttle open, rev to 4500 then lift off
+    if(index < 64U)
+    {
+        traceIdle(index, sample);
+        return;
+    }
+    benchWarm(sample);
+    if(index < 384U)
+    {
+        uint16_t open = index - 64U;
+        sample.tps2 = (open < 8U) ? (int16_t)(25U * (open + 1U)) : 200;
+        sample.load = (open < 64U) ? (int16_t)(35U + open) : (int16_t)(98 + benchNoise(2));
+        sample.rpm = 850 + (int16_t)(((uint32_t)open * 3650UL) / 320UL) + benchNoise(10);
+    }
+    else
+    {
+        uint16_t closed = index - 384U;
+        sample.tps2 = 0;
+        sample.load = 22 + benchNoise(2);
+        sample.rpm = 4500 - (int16_t)(((uint32_t)closed * 3300UL) / 128UL) + benchNoise(10);
+    }
+}
+
+const bench_trace_t benchTraceIdle = { "idle", 512, traceIdle };
+const bench_trace_t benchTraceWOT  = { "WOT pull", 1024, traceWOT };
+const bench_trace_t benchTraceSnap = { "snap throttle", 512, traceSnap };
+
+/*
+***********************************************************************************************************
+* Tables
+*/
+TEST_DATA_P table3d_axis_t rpmAxis16[]  = { 500, 700, 900, 1200, 1600, 2000, 2500, 3100, 3500, 4100, 4700, 5300, 5900, 6500, 6750, 7000 };
+TEST_DATA_P table3d_axis_t loadAxis16[] = { 16, 26, 30, 36, 40, 46, 50, 56, 60, 66, 70, 76, 86, 90, 96, 100 };
+TEST_DATA_P table3d_axis_t rpmAxis8[]   = { 500, 1000, 1500, 2000, 3000, 4000, 5000, 6500 };
+TEST_DATA_P table3d_axis_t tpsAxis8[]   = { 0, 20, 40, 60, 80, 120, 160, 200 };
+TEST_DATA_P table3d_axis_t rpmAxis6[]   = { 500, 1500, 2500, 3500, 5000, 7000 };
+TEST_DATA_P table3d_axis_t loadAxis6[]  = { 20, 40, 60, 80, 100, 120 };
+
+static void fillAxis(table_axis_iterator it, const table3d_axis_t *pValues)
+{
+    while (!it.at_end())
+    {
+#if defined(PROGMEM)
+        *it = (table3d_axis_t)pgm_read_word(pValues);
+#else
+        *it = *pValues;
+#endif
+        ++pValues;
+        ++it;
+    }
+}
+
+template <typename table3d_t>
+static void fillTable(table3d_t &table, const table3d_axis_t *pXValues, const table3d_axis_t *pYValues, table3d_value_t (*value)(uint8_t row, uint8_t col))
+{
+    fillAxis(table.axisX.begin(), pXValues);
+    fillAxis(table.axisY.begin(), pYValues);
+    table_axes_changed(&table);
+    table_value_iterator itZ = table.values.begin();
+    for (uint8_t row = 0; !itZ.at_end(); ++row, ++itZ)
+    {
+        table_row_iterator itRow = *itZ;
+        for (uint8_t col = 0; !itRow.at_end(); ++col, ++itRow) { *itRow = value(row, col); }
+    }
+}
+
+static table3d_value_t veValue(uint8_t row, uint8_t col) { return 30U + (col * 4U) + (row * 3U); }
+static table3d_value_t advanceValue(uint8_t row, uint8_t col) { return 50U + (col * 3U) + row; }
+static table3d_value_t afrValue(uint8_t row, uint8_t col) { return 147U - (row * 2U) + (col & 1U); }
+//Trims are normally flat, with a correction over part of the map
+static table3d_value_t trimValue(uint8_t row, uint8_t col) { return ((row >= 3U) && (col >= 3U)) ? 132U : 128U; }
+static table3d_value_t boostValue(uint8_t row, uint8_t col) { return 100U + (col * 5U) + (row * 2U); }
+static table3d_value_t vvtValue(uint8_t row, uint8_t col) { return 20U + (col * 3U) + row; }
+
+void benchSetupTables(void)
+{
+    fillTable(fuelTable, rpmAxis16, loadAxis16, veValue);
+    fillTable(ignitionTable, rpmAxis16, loadAxis16, advanceValue);
+    fillTable(afrTable, rpmAxis16, loadAxis16, afrValue);
+    fillTable(trim1Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim2Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim3Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim4Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim5Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim6Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim7Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(trim8Table, rpmAxis6, loadAxis6, trimValue);
+    fillTable(boostTable, rpmAxis8, tpsAxis8, boostValue);
+    fillTable(vvtTable, rpmAxis8, tpsAxis8, vvtValue);
+
+    //The 2D tables use the same storage as initialiseAll() gives them
+    construct2dTable(WUETable, _countof(configPage2.wueValues), configPage2.wueValues, configPage4.wueBins);
+    construct2dTable(injectorVCorrectionTable, _countof(configPage6.injVoltageCorrectionValues), configPage6.injVoltageCorrectionValues, configPage6.voltageCorrectionBins);
+    construct2dTable(IATDensityCorrectionTable, _countof(configPage6.airDenRates), configPage6.airDenRates, configPage6.airDenBins);
+    construct2dTable(CLTAdvanceTable, _countof(configPage4.cltAdvValues), configPage4.cltAdvValues, configPage4.cltAdvBins);
+
+    static const uint8_t wueBins[] = { 0, 11, 22, 33, 44, 55, 68, 86, 106, 130 };
+    static const uint8_t wueValues[] = { 180, 175, 168, 154, 134, 121, 112, 104, 102, 100 };
+    populate_2dtable(&WUETable, wueValues, wueBins);
+    static const uint8_t batteryBins[] = { 60, 80, 100, 120, 140, 160 };
+    static const uint8_t batteryValues[] = { 150, 132, 118, 108, 100, 95 };
+    populate_2dtable(&injectorVCorrectionTable, batteryValues, batteryBins);
+    static const uint8_t iatBins[] = { 20, 40, 50, 60, 70, 80, 100, 120, 140 };
+    static const uint8_t iatValues[] = { 116, 108, 104, 100, 97, 94, 89, 84, 80 };
+    populate_2dtable(&IATDensityCorrectionTable, iatValues, iatBins);
+    static const uint8_t cltAdvBins[] = { 0, 30, 60, 90, 120, 150 };
+    static const uint8_t cltAdvValues[] = { 20, 18, 16, 15, 15, 13 };
+    populate_2dtable(&CLTAdvanceTable, cltAdvValues, cltAdvBins);
+}
+
+/*
+***********************************************************************************************************
+* Lookup path classification
+*/
+//Axes are stored largest value first, so bin b covers (pAxis[b+1], pAxis[b]]. Follows the order of the checks in find_bin_max()
+static void classifyAxis(bench_stats_t &stats, table3d_axis_t value, const table3d_axis_t *pAxis, table3d_dim_t size, table3d_dim_t lastBinMax)
+{
+    if( (value > pAxis[lastBinMax + 1U]) && (value <= pAxis[lastBinMax]) ) { stats.sameBin++; return; }
+    if( (value > pAxis[0]) || (value <= pAxis[size - 1U]) ) { stats.clamped++; return; }
+
+    table3d_dim_t bin = 0;
+    while(value <= pAxis[bin + 1U]) { bin++; }
+    if( ((bin + 1U) == lastBinMax) || (bin == (lastBinMax + 1U)) ) { stats.neighbour++; }
+    else
+    {
+        stats.searched++;
+        stats.searchSteps += bin + 1U;
+    }
+}
+
+template <typename table3d_t>
+static void classify3D(bench_stats_t &stats, table3d_t &table, table3d_axis_t y, table3d_axis_t x)
+{
+    const table3DGetValueCache &cache = table.get_value_cache;
+    stats.lookups++;
+    if( (x == cache.last_lookup.x) && (y == cache.last_lookup.y) ) { stats.exact++; return; }
+    classifyAxis(stats, x, table.axisX.axis, table3d_t::value_t::row_size, cache.lastXBinMax);
+    classifyAxis(stats, y, table.axisY.axis, table3d_t::value_t::row_size, cache.lastYBinMax);
+}
+
+//2D axes are stored smallest value first. Follows the order of the checks in table2D_getValue()
+static void classify2D(bench_stats_t &stats, table2D &table, int16_t x)
+{
+    stats.lookups++;
+    if(x == table.lastInput) { stats.exact++; return; }
+    if( (x >= table2D_getAxisValue(&table, table.xSize - 1U)) || (x <= table2D_getAxisValue(&table, 0)) ) { stats.clamped++; return; }
+    if( (table.lastXMax < table.xSize) && (x <= table2D_getAxisValue(&table, table.lastXMax)) && (x > table2D_getAxisValue(&table, table.lastXMin)) ) { stats.sameBin++; return; }
+
+    uint8_t bin = table.xSize - 1U;
+    while(x <= table2D_getAxisValue(&table, bin - 1U)) { bin--; }
+    stats.searched++;
+    stats.searchSteps += table.xSize - bin;
+}
+
+/*
+***********************************************************************************************************
+* Timing
+*/
+template <typename TLookup>
+static uint32_t timeTrace(const bench_trace_t &trace, TLookup lookup)
+{
+    timer measure;
+    bench_sample_t sample;
+    measure.start();
+    for (uint16_t repeat = 0; repeat < BENCH_REPEATS; ++repeat)
+    {
+        benchSeed();
+        for (uint16_t index = 0; index < trace.length; ++index)
+        {
+            trace.next(index, sample);
+            lookup(sample);
+        }
+    }
+    measure.stop();
+    return measure.duration_micros();
+}
+
+static uint32_t traceOverhead;
+
+static uint32_t timePerLookup(const bench_trace_t &trace, uint32_t durationMicros)
+{
+    durationMicros = (durationMicros > traceOverhead) ? (durationMicros - traceOverhead) : 0U;
+    uint64_t lookups = (uint64_t)trace.length * BENCH_REPEATS;
+#if defined(__AVR__)
+    return (uint32_t)(((uint64_t)durationMicros * clockCyclesPerMicrosecond()) / lookups);
+#else
+    return (uint32_t)(((uint64_t)durationMicros * 1000ULL) / lookups);
+#endif
+}
+
+/*
+***********************************************************************************************************
+* Report
+*/
+static uint16_t percent10(uint32_t count, uint32_t total) { return (total == 0U) ? 0U : (uint16_t)((count * 1000UL) / total); }
+
+static void printStats(const char *name, const bench_stats_t &stats)
+{
+    uint32_t axisLookups = (uint32_t)stats.sameBin + stats.neighbour + stats.clamped + stats.searched;
+    uint16_t exact = percent10(stats.exact, stats.lookups);
+    uint16_t sameBin = percent10(stats.sameBin, axisLookups);
+    uint16_t neighbour = percent10(stats.neighbour, axisLookups);
+    uint16_t clamped = percent10(stats.clamped, axisLookups);
+    uint16_t searched = percent10(stats.searched, axisLookups);
+    uint16_t steps = (stats.searched == 0U) ? 0U : (uint16_t)((stats.searchSteps * 10UL) / stats.searched);
+
+    char buffer[160];
+    sprintf(buffer, "%-26s exact %3u.%u%% | bin %3u.%u%% next %3u.%u%% clamp %3u.%u%% search %3u.%u%% (%u.%u steps) | %5" PRIu32 " " BENCH_UNIT,
+            name, exact / 10U, exact % 10U, sameBin / 10U, sameBin % 10U, neighbour / 10U, neighbour % 10U,
+            clamped / 10U, clamped % 10U, searched / 10U, searched % 10U, steps / 10U, steps % 10U, stats.timePerLookup);
+    TEST_MESSAGE(buffer);
+}
+
+/*
+***********************************************************************************************************
+* Benchmarks
+*/
+template <typename table3d_t>
+static void bench3D(const char *name, table3d_t &table, const bench_trace_t &trace, int16_t bench_sample_t::*yInput)
+{
+    bench_stats_t stats = {};
+    bench_sample_t sample;
+
+    table.get_value_cache = table3DGetValueCache();
+    benchSeed();
+    for (uint16_t index = 0; index < trace.length; ++index)
+    {
+        trace.next(index, sample);
+        classify3D(stats, table, sample.*yInput, sample.rpm);
+        benchSink = get3DTableValue(&table, sample.*yInput, sample.rpm);
+    }
+
+    table.get_value_cache = table3DGetValueCache();
+    stats.timePerLookup = timePerLookup(trace, timeTrace(trace, [&](const bench_sample_t &s) { benchSink = get3DTableValue(&table, s.*yInput, s.rpm); }));
+
+    TEST_ASSERT_EQUAL_UINT16(trace.length, stats.lookups);
+    printStats(name, stats);
+}
+
+static void bench2D(const char *name, table2D &table, const bench_trace_t &trace, int16_t bench_sample_t::*input)
+{
+    bench_stats_t stats = {};
+    bench_sample_t sample;
+
+    table.lastInput = table.lastXMax = table.lastXMin = INT16_MAX;
+    benchSeed();
+    for (uint16_t index = 0; index < trace.length; ++index)
+    {
+        trace.next(index, sample);
+        classify2D(stats, table, sample.*input);
+        benchSink = table2D_getValue(&table, sample.*input);
+    }
+
+    table.lastInput = table.lastXMax = table.lastXMin = INT16_MAX;
+    stats.timePerLookup = timePerLookup(trace, timeTrace(trace, [&](const bench_sample_t &s) { benchSink = table2D_getValue(&table, s.*input); }));
+
+    TEST_ASSERT_EQUAL_UINT16(trace.length, stats.lookups);
+    printStats(name, stats);
+}
+
+void benchRunTrace(const bench_trace_t &trace)
+{
+    char buffer[64];
+    sprintf(buffer, "Trace: %s (%u samples)", trace.name, trace.length);
+    TEST_MESSAGE(buffer);
+
+    traceOverhead = timeTrace(trace, [](const bench_sample_t &s) { benchSink = s.rpm; });
+
+    bench3D("fuelTable", fuelTable, trace, &bench_sample_t::load);
+    bench3D("ignitionTable", ignitionTable, trace, &bench_sample_t::load);
+    bench3D("afrTable", afrTable, trace, &bench_sample_t::load);
+    bench3D("trim1Table", trim1Table, trace, &bench_sample_t::load);
+    bench3D("trim2Table", trim2Table, trace, &bench_sample_t::load);
+    bench3D("trim3Table", trim3Table, trace, &bench_sample_t::load);
+    bench3D("trim4Table", trim4Table, trace, &bench_sample_t::load);
+    bench3D("trim5Table", trim5Table, trace, &bench_sample_t::load);
+    bench3D("trim6Table", trim6Table, trace, &bench_sample_t::load);
+    bench3D("trim7Table", trim7Table, trace, &bench_sample_t::load);
+    bench3D("trim8Table", trim8Table, trace, &bench_sample_t::load);
+    bench3D("boostTable", boostTable, trace, &bench_sample_t::tps2);
+    bench3D("vvtTable", vvtTable, trace, &bench_sample_t::tps2);
+    bench2D("WUETable", WUETable, trace, &bench_sample_t::clt);
+    bench2D("IATDensityCorrectionTable", IATDensityCorrectionTable, trace, &bench_sample_t::iat);
+    bench2D("injectorVCorrectionTable", injectorVCorrectionTable, trace, &bench_sample_t::battery);
+    bench2D("CLTAdvanceTable", CLTAdvanceTable, trace, &bench_sample_t::clt);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+/** One loop's worth of the inputs used by the table lookups */
+struct bench_sample_t {
+    int16_t rpm;
+    int16_t load;     ///< MAP (kPa), used as fuelLoad/ignLoad
+    int16_t tps2;     ///< TPS * 2, as used by the boost and VVT tables
+    int16_t clt;      ///< Coolant + CALIBRATION_TEMPERATURE_OFFSET
+    int16_t iat;      ///< IAT + CALIBRATION_TEMPERATURE_OFFSET
+    int16_t battery;  ///< battery10
+};
+
+/** A sequence of loop samples. next() is called with 0..length-1 and must give the same sequence on every pass */
+struct bench_trace_t {
+    const char *name;
+    uint16_t length;
+    void (*next)(uint16_t index, bench_sample_t &sample);
+};
+
+extern const bench_trace_t benchTraceIdle;
+extern const bench_trace_t benchTraceWOT;
+extern const bench_trace_t benchTraceSnap;
+
+void benchSetupTables(void);
+void benchRunTrace(const bench_trace_t &trace);
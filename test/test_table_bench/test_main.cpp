@@ -0,0 +1,70 @@
+#include <Arduino.h>
+#include <unity.h>
+#if defined(SIMULATOR)
+#include <avr/sleep.h>
+#endif
+#include "bench_tables.h"
+
+/*
+Table lookup micro-benchmarks. Runs RPM/load traces through the 3D and 2D table lookups and reports, per table, how
+often each path of the bin search is taken and the time per lookup (CPU cycles on AVR, host nanoseconds otherwise).
+Run with one of:
+  pio test -e megaatmega2560_sim_unittest -f test_table_bench
+  pio test -e native -f test_table_bench
+The numbers are only comparable with other runs of the same environment, before and after a change to the lookups.
+*/
+
+static void test_table_bench_idle(void) { benchRunTrace(benchTraceIdle); }
+static void test_table_bench_wot(void) { benchRunTrace(benchTraceWOT); }
+static void test_table_bench_snap(void) { benchRunTrace(benchTraceSnap); }
+
+static void runBenchmarks(void)
+{
+    benchSetupTables();
+
+    RUN_TEST(test_table_bench_idle);
+    RUN_TEST(test_table_bench_wot);
+    RUN_TEST(test_table_bench_snap);
+}
+
+#if defined(NATIVE_BOARD)
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    runBenchmarks();
+    return UNITY_END();
+}
+#else
+void setup()
+{
+    pinMode(LED_BUILTIN, OUTPUT);
+
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+#if !defined(SIMULATOR)
+    delay(2000);
+#endif
+
+    UNITY_BEGIN();    // IMPORTANT LINE!
+    runBenchmarks();
+    UNITY_END(); // stop unit testing
+
+#if defined(SIMULATOR)       // Tell SimAVR we are done
+    cli();
+    sleep_enable();
+    sleep_cpu();
+#endif
+}
+
+void loop()
+{
+    // Blink to indicate end of test
+    digitalWrite(LED_BUILTIN, HIGH);
+    delay(250);
+    digitalWrite(LED_BUILTIN, LOW);
+    delay(250);
+}
+#endif
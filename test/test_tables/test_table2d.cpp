@@ -3,7 +3,7 @@
 #include <stdio.h>
 typedef uint8_t byte;
 #include "test_table2d.h"
-#include "table2d.h"
+#include "tables/table2d.h"
 #include "../test_utils.h"
 
 
@@ -145,6 +145,38 @@ void test_table2d_all_decrementing(void)
     }
 }
 
+void test_table2d_cache_invalidation(void)
+{
+    setup_test_subjects();
+    const int16_t x = table2d_axis_u8[3]+((table2d_axis_u8[4]-table2d_axis_u8[3])/2);
+
+    TEST_ASSERT_EQUAL(147, table2D_getValue(&table2d_u8_u8, x));
+
+    //A change to the table data is only picked up once the tables have been invalidated
+    const uint8_t oldValue = table2d_data_u8[3];
+    table2d_data_u8[3] = oldValue + 20U;
+    TEST_ASSERT_EQUAL(147, table2D_getValue(&table2d_u8_u8, x));
+    table2D_invalidateAll();
+    TEST_ASSERT_EQUAL(157, table2D_getValue(&table2d_u8_u8, x));
+
+    table2d_data_u8[3] = oldValue;
+    table2D_invalidateAll();
+}
+
+void test_table2d_cache_never_calculated(void)
+{
+    //A zero initialised table (As a global is before its first lookup) must not look like a cached output of 0 for an input of 0
+    table2D table = {};
+    setup_test_subject(table, table2d_data_u8, table2d_axis_u8);
+    TEST_ASSERT_EQUAL(251, table2D_getValue(&table, 0));
+
+    //Nor once the generation counter has wrapped
+    table2D_generation = UINT16_MAX;
+    table2D_invalidateAll();
+    table2D wrapped = {};
+    setup_test_subject(wrapped, table2d_data_u8, table2d_axis_u8);
+    TEST_ASSERT_EQUAL(251, table2D_getValue(&wrapped, 0));
+}
 
 void testTable2d()
 {
@@ -155,5 +187,7 @@ void testTable2d()
     RUN_TEST(test_table2dLookup_overMax);
     RUN_TEST(test_table2dLookup_underMin);
     RUN_TEST(test_table2d_all_decrementing); 
+    RUN_TEST(test_table2d_cache_invalidation);
+    RUN_TEST(test_table2d_cache_never_calculated);
   }
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 // #include <string.h> // memcpy
 #include <unity.h>
 #include <stdio.h>
+#include <string.h>
 #include "tests_tables.h"
-#include "table3d.h"
+#include "tables/table3d.h"
+#include "tables/table3d_shared.h"
 #include "../test_utils.h"
 
 TEST_DATA_P table3d_value_t values[] = {
@@ -72,6 +74,8 @@ void testTables()
   RUN_TEST(test_tableLookup_underMinX);
   RUN_TEST(test_tableLookup_underMinY);
   RUN_TEST(test_tableLookup_roundUp);
+  RUN_TEST(test_tableLookup_reciprocalsMatchDivision);
+  RUN_TEST(test_tableLookup_sharedAxes);
   //RUN_TEST(test_all_incrementing);
 
   }  
@@ -167,6 +171,61 @@ void test_tableLookup_roundUp(void)
   TEST_ASSERT_EQUAL(testTable.get_value_cache.lastYBinMax, (table3d_dim_t)14);
 }
 
+void test_tableLookup_reciprocalsMatchDivision(void)
+{
+  // Interpolating with the precomputed bin reciprocals must give exactly the same
+  // result as dividing by the bin width (which is used if there are no reciprocals)
+  setup_TestTable();
+  static table3d16RpmLoad divisionTable;
+  divisionTable = testTable;
+  memset(divisionTable.axisX.bin_recip, 0, sizeof(divisionTable.axisX.bin_recip));
+  memset(divisionTable.axisY.bin_recip, 0, sizeof(divisionTable.axisY.bin_recip));
+
+  for(uint16_t rpm = xMin-50; rpm<xMax+50; rpm+=7)
+  {
+    for(uint8_t load = yMin-2; load<yMax+2; load++)
+    {
+      TEST_ASSERT_EQUAL(get3DTableValue(&divisionTable, load, rpm), get3DTableValue(&testTable, load, rpm));
+    }
+  }
+}
+
+void test_tableLookup_sharedAxes(void)
+{
+  // Tables with the same axes as the first table in the group share its axis search & 
+  // must give the same results as an individual lookup
+  setup_TestTable();
+  static table3d16RpmLoad sameAxesTable;
+  static table3d16RpmLoad otherAxesTable;
+  static table3d16RpmLoad * const groupTables[] = { &testTable, &sameAxesTable, &otherAxesTable };
+  static table3d_shared_axes<table3d16RpmLoad, 3> group(groupTables);
+
+  sameAxesTable = testTable;
+  otherAxesTable = testTable;
+  for (uint16_t i=0; i<_countof(sameAxesTable.values.values); ++i)
+  {
+    sameAxesTable.values.values[i] = 255U - sameAxesTable.values.values[i];
+  }
+  otherAxesTable.axisX.axis[3] = otherAxesTable.axisX.axis[3] + 10;
+  otherAxesTable.axisX.rebuild_reciprocals();
+  TEST_ASSERT_EQUAL(0x03, group.sharedMask());
+
+  for(uint16_t rpm = xMin-50; rpm<xMax+50; rpm+=53)
+  {
+    for(uint8_t load = yMin-2; load<yMax+2; load+=3)
+    {
+      TEST_ASSERT_EQUAL(get3DTableValue(&testTable, load, rpm), group.getValue(&testTable, load, rpm));
+      TEST_ASSERT_EQUAL(get3DTableValue(&sameAxesTable, load, rpm), group.getValue(&sameAxesTable, load, rpm));
+      TEST_ASSERT_EQUAL(get3DTableValue(&otherAxesTable, load, rpm), group.getValue(&otherAxesTable, load, rpm));
+    }
+  }
+
+  // Membership is re-checked after an axis changes
+  otherAxesTable.axisX.axis[3] = testTable.axisX.axis[3];
+  otherAxesTable.axisX.rebuild_reciprocals();
+  TEST_ASSERT_EQUAL(0x07, group.sharedMask());
+}
+
 void test_all_incrementing(void)
 {
   //Test the when going up both the load and RPM axis that the returned value is always equal or higher to the previous one
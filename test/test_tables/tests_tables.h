@@ -8,4 +8,6 @@ void test_tableLookup_overMaxY(void);
 void test_tableLookup_underMinX(void);
 void test_tableLookup_underMinY(void);
 void test_tableLookup_roundUp(void);
+void test_tableLookup_reciprocalsMatchDivision(void);
+void test_tableLookup_sharedAxes(void);
 void test_all_incrementing(void);
@@ -0,0 +1,152 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "globals.h"
+#include "toothLogRing.h"
+
+/*
+Checks the encoding, overflow handling and streaming of the tooth log ring.
+Native only:
+  pio test -e native -f test_tooth_log
+*/
+
+static void test_tooth_log_values(void)
+{
+    const uint32_t values[] = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, UINT32_MAX };
+    #define VALUE_COUNT (sizeof(values)/sizeof(values[0]))
+
+    toothLogRingReset(false);
+    for(uint8_t x = 0; x < VALUE_COUNT; x++) { toothLogRingWrite(values[x], 0xFF); }
+    TEST_ASSERT_EQUAL_UINT16(VALUE_COUNT, toothLogRingAvailable());
+
+    uint32_t value;
+    uint8_t status;
+    for(uint8_t x = 0; x < VALUE_COUNT; x++)
+    {
+        TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+        TEST_ASSERT_EQUAL_UINT32(values[x], value);
+        TEST_ASSERT_EQUAL_UINT8(0, status); //Tooth logs have no status
+    }
+    TEST_ASSERT_FALSE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT16(0, toothLogRingOverflows);
+}
+
+static void test_tooth_log_composite_times(void)
+{
+    nativeReset();
+    nativeAdvanceMicros(UINT32_MAX - 100UL); //The times must survive micros() wrapping
+    toothLogRingReset(true);
+
+    const uint32_t start = micros();
+    toothLogRingWrite((uint32_t)(start + 10UL), 0x01);
+    toothLogRingWrite((uint32_t)(start + 500UL), 0x02);
+    toothLogRingWrite((uint32_t)(start + 400000UL), 0x83);
+
+    uint32_t value;
+    uint8_t status;
+    TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + 10UL), value);
+    TEST_ASSERT_EQUAL_UINT8(0x01, status);
+    TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + 500UL), value);
+    TEST_ASSERT_EQUAL_UINT8(0x02, status);
+    TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + 400000UL), value);
+    TEST_ASSERT_EQUAL_UINT8(0x83, status);
+}
+
+static void test_tooth_log_overflow(void)
+{
+    toothLogRingReset(true);
+    const uint32_t start = micros();
+
+    //Each entry is 3 bytes (2 byte delta + status), so the ring holds TOOTH_LOG_RING_SIZE / 3 of them
+    const uint16_t capacity = TOOTH_LOG_RING_SIZE / 3U;
+    for(uint16_t x = 1; x <= (capacity + 10U); x++) { toothLogRingWrite((uint32_t)(start + (x * 200UL)), (uint8_t)x); }
+    TEST_ASSERT_EQUAL_UINT16(capacity, toothLogRingAvailable());
+    TEST_ASSERT_EQUAL_UINT16(10, toothLogRingOverflows);
+
+    //Reading makes room again. The next entry's time is still correct as its delta covers the dropped ones
+    uint32_t value;
+    uint8_t status;
+    TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + 200UL), value);
+    toothLogRingWrite((uint32_t)(start + 200000UL), 0x55);
+    while(toothLogRingAvailable() > 1U) { toothLogRingRead(value, status); }
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + (capacity * 200UL)), value);
+    TEST_ASSERT_TRUE(toothLogRingRead(value, status));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(start + 200000UL), value);
+    TEST_ASSERT_EQUAL_UINT8(0x55, status);
+}
+
+static void test_tooth_log_ready_flag(void)
+{
+    toothLogRingReset(false);
+    for(uint8_t x = 0; x < (TOOTH_LOG_SIZE - 1U); x++) { toothLogRingWrite(1000, 0); }
+    TEST_ASSERT_FALSE(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY));
+    toothLogRingWrite(1000, 0);
+    TEST_ASSERT_TRUE(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY));
+
+    //Sending a block with a second full block already waiting leaves the flag set
+    for(uint8_t x = 0; x < TOOTH_LOG_SIZE; x++) { toothLogRingWrite(1000, 0); }
+    toothLogRingFill();
+    TEST_ASSERT_EQUAL(TOOTH_LOG_SIZE, toothHistoryIndex);
+    toothLogRingBlockSent();
+    TEST_ASSERT_EQUAL(0, toothHistoryIndex);
+    TEST_ASSERT_TRUE(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY));
+
+    toothLogRingFill();
+    toothLogRingBlockSent();
+    TEST_ASSERT_FALSE(BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY));
+}
+
+/** A 36-1 wheel at 7000 RPM for a minute, with TS taking up to a full block every 20mS. Every tooth must come out, in
+ * order */
+static void test_tooth_log_streaming(void)
+{
+    const uint32_t toothGap = 238; //uS. 7000 RPM, 36 teeth
+    const uint32_t pollPeriod = 20000;
+    toothLogRingReset(false);
+
+    uint32_t written = 0;
+    uint32_t read = 0;
+    uint32_t nextPoll = pollPeriod;
+    for(uint32_t time = 0; time < 60000000UL; time += toothGap)
+    {
+        written++;
+        toothLogRingWrite((written % 36U) == 0U ? (toothGap * 2U) : (toothGap + (written % 7U)), 0);
+
+        //TOOTH_LOG_SIZE is cut down for the unit tests, so a poll takes as many blocks as make up a full size one
+        if(time < nextPoll) { continue; }
+        nextPoll = time + pollPeriod;
+        for(uint8_t block = 0; (block < (127U / TOOTH_LOG_SIZE)) && BIT_CHECK(currentStatus.status1, BIT_STATUS1_TOOTHLOG1READY); block++)
+        {
+            toothLogRingFill();
+            TEST_ASSERT_EQUAL(TOOTH_LOG_SIZE, toothHistoryIndex);
+            for(uint8_t x = 0; x < TOOTH_LOG_SIZE; x++)
+            {
+                read++;
+                uint32_t expected = (read % 36U) == 0U ? (toothGap * 2U) : (toothGap + (read % 7U));
+                if(toothHistory[x] != expected) { TEST_FAIL_MESSAGE("Tooth out of order"); }
+            }
+            toothLogRingBlockSent();
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, toothLogRingOverflows);
+    TEST_ASSERT_EQUAL_UINT32(written, read + toothLogRingAvailable());
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tooth_log_values);
+    RUN_TEST(test_tooth_log_composite_times);
+    RUN_TEST(test_tooth_log_overflow);
+    RUN_TEST(test_tooth_log_ready_flag);
+    RUN_TEST(test_tooth_log_streaming);
+
+    return UNITY_END();
+}
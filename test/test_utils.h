@@ -5,8 +5,8 @@
 #include <unity.h>
 #include <Arduino.h>
 #include <unity.h>
-#include "table2d.h"
-#include "table3d.h"
+#include "tables/table2d.h"
+#include "tables/table3d.h"
 
 template<size_t MAX_LEN, size_t N>
 constexpr void STR_LEN_CHECK(char const (&)[N]) 
@@ -18,6 +18,14 @@ constexpr void STR_LEN_CHECK(char const (&)[N])
 #define _countof(x) (sizeof(x) / sizeof (x[0]))
 #endif
 
+// Spin while a condition that an interrupt will change holds, e.g. a schedule status.
+// The native board's virtual clock only moves when it is advanced, so there each spin moves it on by 1uS
+#if defined(NATIVE_BOARD)
+#define WAIT_WHILE(cond) while(cond) { nativeAdvanceMicros(1U); }
+#else
+#define WAIT_WHILE(cond) while(cond) { /*Wait*/ }
+#endif
+
 // Unity macro to reduce memory usage (RAM, .bss)
 //
 // Unity supplied RUN_TEST captures the function name
@@ -101,6 +109,7 @@ static inline void populate_table_P(table3d_t &table,
       ++itY;
     }
   }
+  table_axes_changed(&table);
   {
     table_value_iterator itZ = table.values.begin();
     while (!itZ.at_end())
@@ -128,14 +137,14 @@ static inline void populate_2dtable(table2D *pTable, uint8_t value, uint8_t bin)
     ((uint8_t*)pTable->values)[index] = value;
     ((uint8_t*)pTable->axisX)[index] = bin;
   }
-  pTable->cacheTime = UINT8_MAX;
+  table2D_invalidateAll();
 }
 
 template <typename TValue, typename TBin>
 static inline void populate_2dtable(table2D *pTable, const TValue values[], const TBin bins[]) {
   memcpy(pTable->axisX, bins, pTable->xSize * sizeof(TBin));
   memcpy(pTable->values, values, pTable->xSize * sizeof(TValue));
-  pTable->cacheTime = UINT8_MAX;
+  table2D_invalidateAll();
 }
 
 // Populate a 2d table (from PROGMEM if available)
@@ -145,7 +154,7 @@ static inline void populate_2dtable_P(table2D *pTable, const TValue values[], co
 #if defined(PROGMEM)
   memcpy_P(pTable->axisX, bins, pTable->xSize * sizeof(TBin));
   memcpy_P(pTable->values, values, pTable->xSize * sizeof(TValue));
-  pTable->cacheTime = UINT8_MAX;
+  table2D_invalidateAll();
 #else
   populate_2dtable(pTable, values, bins)
 #endif